@@ -180,7 +180,7 @@ static Elf_Internal_Syminfo * dynamic_syminfo;
 static unsigned long dynamic_syminfo_offset;
 static unsigned int dynamic_syminfo_nent;
 static char program_interpreter[PATH_MAX];
-static bfd_vma dynamic_info[DT_ENCODING];
+static bfd_vma dynamic_info[DT_RELRENT + 1];
 static bfd_vma dynamic_info_DT_GNU_HASH;
 static bfd_vma version_info[16];
 static Elf_Internal_Ehdr elf_header;
@@ -1771,6 +1771,10 @@ get_dynamic_type (unsigned long type)
 
     case DT_PREINIT_ARRAY: return "PREINIT_ARRAY";
     case DT_PREINIT_ARRAYSZ: return "PREINIT_ARRAYSZ";
+    case DT_SYMTAB_SHNDX: return "SYMTAB_SHNDX";
+    case DT_RELRSZ:	return "RELRSZ";
+    case DT_RELR:	return "RELR";
+    case DT_RELRENT:	return "RELRENT";
 
     case DT_CHECKSUM:	return "CHECKSUM";
     case DT_PLTPADSZ:	return "PLTPADSZ";
@@ -3515,6 +3519,7 @@ get_section_type_name (unsigned int sh_type)
     case SHT_GNU_HASH:		return "GNU_HASH";
     case SHT_GROUP:		return "GROUP";
     case SHT_SYMTAB_SHNDX:	return "SYMTAB SECTION INDICIES";
+    case SHT_RELR:		return "RELR";
     case SHT_GNU_verdef:	return "VERDEF";
     case SHT_GNU_verneed:	return "VERNEED";
     case SHT_GNU_versym:	return "VERSYM";
@@ -5853,6 +5858,80 @@ process_ia64_vms_dynamic_relocs (FILE *file)
   return res;
 }
 
+/* Display the contents of the packed relative relocation data found
+   at the specified offset.  Each entry is either an even address, which
+   is relocated, or a bitmap with the low bit set.  Bit N of a bitmap
+   says whether to relocate the word N - 1 words past the end of the
+   words covered by the previous entry.  */
+
+static void
+dump_relr_relocations (FILE * file,
+		       unsigned long rel_offset,
+		       unsigned long rel_size)
+{
+  unsigned int entsize = is_32bit_elf ? 4 : 8;
+  unsigned int span = entsize * 8 - 1;
+  unsigned char * data;
+  unsigned long nentries;
+  unsigned long noffsets;
+  unsigned long i;
+  int pass;
+
+  data = (unsigned char *) get_data (NULL, file, rel_offset, 1, rel_size,
+				     _("packed relocation data"));
+  if (data == NULL)
+    return;
+
+  nentries = rel_size / entsize;
+
+  /* Count the relocated words on the first pass, and print them on the
+     second.  */
+  noffsets = 0;
+  for (pass = 0; pass < 2; pass++)
+    {
+      bfd_vma where = 0;
+
+      if (pass == 1)
+	printf (_("  %lu offsets\n"), noffsets);
+
+      for (i = 0; i < nentries; i++)
+	{
+	  bfd_vma entry = byte_get (data + i * entsize, entsize);
+
+	  if ((entry & 1) == 0)
+	    {
+	      if (pass == 0)
+		noffsets++;
+	      else
+		{
+		  print_vma (entry, LONG_HEX);
+		  putchar ('\n');
+		}
+	      where = entry + entsize;
+	    }
+	  else
+	    {
+	      unsigned int bit;
+
+	      for (bit = 1; bit <= span; bit++)
+		if ((entry >> bit) & 1)
+		  {
+		    if (pass == 0)
+		      noffsets++;
+		    else
+		      {
+			print_vma (where + (bit - 1) * entsize, LONG_HEX);
+			putchar ('\n');
+		      }
+		  }
+	      where += span * entsize;
+	    }
+	}
+    }
+
+  free (data);
+}
+
 static struct
 {
   const char * name;
@@ -5924,6 +6003,20 @@ process_relocs (FILE * file)
 	    }
 	}
 
+      rel_size = dynamic_info[DT_RELRSZ];
+      rel_offset = dynamic_info[DT_RELR];
+      has_dynamic_reloc |= rel_size;
+      if (rel_size)
+	{
+	  printf
+	    (_("\n'RELR' relocation section at offset 0x%lx contains %ld bytes:\n"),
+	     rel_offset, rel_size);
+
+	  dump_relr_relocations (file,
+				 offset_from_vma (file, rel_offset, rel_size),
+				 rel_size);
+	}
+
       if (is_ia64_vms ())
         has_dynamic_reloc |= process_ia64_vms_dynamic_relocs (file);
 
@@ -5941,13 +6034,30 @@ process_relocs (FILE * file)
 	   i++, section++)
 	{
 	  if (   section->sh_type != SHT_RELA
-	      && section->sh_type != SHT_REL)
+	      && section->sh_type != SHT_REL
+	      && section->sh_type != SHT_RELR)
 	    continue;
 
 	  rel_offset = section->sh_offset;
 	  rel_size   = section->sh_size;
 
-	  if (rel_size)
+	  if (rel_size && section->sh_type == SHT_RELR)
+	    {
+	      printf (_("\nRelocation section "));
+
+	      if (string_table == NULL)
+		printf ("%d", section->sh_name);
+	      else
+		printf ("'%s'", SECTION_NAME (section));
+
+	      printf (_(" at offset 0x%lx contains %lu entries:\n"),
+		      rel_offset,
+		      rel_size / (is_32bit_elf ? 4 : 8));
+
+	      dump_relr_relocations (file, rel_offset, rel_size);
+	      found = 1;
+	    }
+	  else if (rel_size)
 	    {
 	      Elf_Internal_Shdr * strsec;
 	      int is_rela;
@@ -8524,6 +8634,7 @@ process_dynamic_section (FILE * file)
 	case DT_STRTAB	:
 	case DT_SYMTAB	:
 	case DT_RELA	:
+	case DT_RELR	:
 	case DT_INIT	:
 	case DT_FINI	:
 	case DT_SONAME	:
@@ -8587,6 +8698,8 @@ process_dynamic_section (FILE * file)
 	case DT_RELAENT	:
 	case DT_SYMENT	:
 	case DT_RELENT	:
+	case DT_RELRSZ	:
+	case DT_RELRENT	:
 	  dynamic_info[entry->d_tag] = entry->d_un.d_val;
 	case DT_PLTPADSZ:
 	case DT_MOVEENT	:
@@ -22,6 +22,7 @@
 #include "gdb_assert.h"
 #include "command.h"
 #include "gdbcmd.h"
+#include "worker-pool.h"
 
 extern void _initialize_complaints (void);
 
@@ -168,11 +169,16 @@ vcomplaint (struct complaints **c, const char *file,
 	    int line, const char *fmt,
 	    va_list args)
 {
-  struct complaints *complaints = get_complaints (c);
-  struct complain *complaint = find_complaint (complaints, file, 
-					       line, fmt);
+  struct complaints *complaints;
+  struct complain *complaint;
   enum complaint_series series;
 
+  /* The complaint counters belong to the main thread.  */
+  if (in_worker_thread ())
+    worker_abandon_item ();
+
+  complaints = get_complaints (c);
+  complaint = find_complaint (complaints, file, line, fmt);
   gdb_assert (complaints != NULL);
 
   complaint->counter++;
@@ -70,6 +70,8 @@
 #include "source.h"
 #include "filestuff.h"
 #include "build-id.h"
+#include "worker-pool.h"
+#include "index-cache.h"
 
 #include <fcntl.h>
 #include <string.h>
@@ -551,6 +553,10 @@ struct dwarf2_cu
      this information, but later versions do.  */
 
   unsigned int processing_has_namespace_info : 1;
+
+  /* Non-NULL while a worker thread reads this CU's partial DIEs; see
+     preload_psymtab_comp_unit.  */
+  struct psymtab_preload *preload;
 };
 
 /* Persistent data held for a compilation unit, even when not
@@ -1109,6 +1115,10 @@ struct partial_die_info
     /* Flag set if spec_offset uses DW_FORM_GNU_ref_alt.  */
     unsigned int spec_is_dwz : 1;
 
+    /* Flag set if NAME still has to be passed through
+       dwarf2_canonicalize_name.  */
+    unsigned int canonicalize_name : 1;
+
     /* The name of this DIE.  Normally the value of DW_AT_name, but
        sometimes a default name for unnamed DIEs.  */
     const char *name;
@@ -1404,6 +1414,10 @@ static void add_partial_subprogram (struct partial_die_info *pdi,
 static void dwarf2_read_symtab (struct partial_symtab *,
 				struct objfile *);
 
+static struct cleanup *dwarf2_read_symtabs_ahead (struct objfile *,
+						   struct partial_symtab **,
+						   int);
+
 static void psymtab_to_symtab_1 (struct partial_symtab *);
 
 static struct abbrev_info *abbrev_table_lookup_abbrev
@@ -1474,7 +1488,8 @@ static const gdb_byte *read_n_bytes (bfd *, const gdb_byte *, unsigned int);
 
 static const char *read_direct_string (bfd *, const gdb_byte *, unsigned int *);
 
-static const char *read_indirect_string (bfd *, const gdb_byte *,
+static const char *read_indirect_string (struct dwarf2_per_objfile *,
+					 bfd *, const gdb_byte *,
 					 const struct comp_unit_head *,
 					 unsigned int *);
 
@@ -1781,6 +1796,8 @@ static int create_all_type_units (struct objfile *);
 static void load_full_comp_unit (struct dwarf2_per_cu_data *,
 				 enum language);
 
+static struct cleanup *start_full_cu_preload (VEC (dwarf2_per_cu_ptr) *);
+
 static void process_full_comp_unit (struct dwarf2_per_cu_data *,
 				    enum language);
 
@@ -1806,6 +1823,8 @@ static void queue_comp_unit (struct dwarf2_per_cu_data *per_cu,
 
 static void process_queue (void);
 
+static void save_index_to_cache (struct objfile *objfile);
+
 static void find_file_and_directory (struct die_info *die,
 				     struct dwarf2_cu *cu,
 				     const char **name, const char **comp_dir);
@@ -2958,44 +2977,36 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
-   ok to use deprecated sections.
+/* A helper function that reads the index at ADDR, SIZE bytes long, and
+   fills in MAP.  FILENAME is the name of the file the index belongs
+   to; it is used for error reporting.  DEPRECATED_OK is nonzero if it
+   is ok to use deprecated indices.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
    Returns 1 if all went well, 0 otherwise.  */
 
 static int
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 int deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
+read_index_from_buffer (const char *filename,
+			int deprecated_ok,
+			const gdb_byte *addr,
+			bfd_size_type size,
+			struct mapped_index *map,
+			const gdb_byte **cu_list,
+			offset_type *cu_list_elements,
+			const gdb_byte **types_list,
+			offset_type *types_list_elements)
 {
-  const gdb_byte *addr;
   offset_type version;
   offset_type *metadata;
   int i;
 
-  if (dwarf2_section_empty_p (section))
+  /* The version and the five offsets that follow it.  */
+  if (size < 6 * sizeof (offset_type))
     return 0;
 
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
-    return 0;
-
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3049,10 +3060,16 @@ to use the section anyway."),
     return 0;
 
   map->version = version;
-  map->total_size = section->size;
+  map->total_size = size;
 
   metadata = (offset_type *) (addr + sizeof (offset_type));
 
+  /* Don't trust the offsets blindly.  */
+  for (i = 0; i < 5; ++i)
+    if (MAYBE_SWAP (metadata[i]) > size
+	|| (i > 0 && MAYBE_SWAP (metadata[i - 1]) > MAYBE_SWAP (metadata[i])))
+      return 0;
+
   i = 0;
   *cu_list = addr + MAYBE_SWAP (metadata[i]);
   *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
@@ -3081,6 +3098,108 @@ to use the section anyway."),
   return 1;
 }
 
+/* A helper function that reads the .gdb_index from SECTION and fills
+   in MAP.  FILENAME is the name of the file containing the section;
+   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
+   ok to use deprecated sections.  The remaining arguments are as for
+   read_index_from_buffer.
+
+   Returns 1 if all went well, 0 otherwise.  */
+
+static int
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 int deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  return read_index_from_buffer (filename, deprecated_ok,
+				 section->buffer, section->size, map,
+				 cu_list, cu_list_elements,
+				 types_list, types_list_elements);
+}
+
+/* Return non-zero if OBJFILE has a .gnu_debugaltlink section, that is,
+   if it refers to a .dwz file.  Unlike dwarf2_get_dwz_file, this does
+   not look for the .dwz file, and so does not throw an error if it is
+   missing.  */
+
+static int
+dwarf2_has_dwz_link (struct objfile *objfile)
+{
+  bfd_size_type buildid_len;
+  bfd_byte *buildid;
+  char *data;
+
+  if (dwarf2_per_objfile->dwz_file != NULL)
+    return 1;
+
+  bfd_set_error (bfd_error_no_error);
+  data = bfd_get_alt_debug_link_info (objfile->obfd, &buildid_len, &buildid);
+  if (data == NULL)
+    {
+      /* If the section exists but cannot be read, play it safe.  */
+      return bfd_get_error () != bfd_error_no_error;
+    }
+
+  xfree (data);
+  xfree (buildid);
+  return 1;
+}
+
+/* Like read_index_from_section, but read the index of OBJFILE from the
+   index cache.  */
+
+static int
+read_index_from_cache (struct objfile *objfile,
+		       struct mapped_index *map,
+		       const gdb_byte **cu_list,
+		       offset_type *cu_list_elements,
+		       const gdb_byte **types_list,
+		       offset_type *types_list_elements)
+{
+  const gdb_byte *buffer;
+  bfd_size_type size;
+
+  if (!index_cache_enabled_p ())
+    return 0;
+
+  /* The index of a file using a .dwz file has to be split in two;
+     save_index_to_cache doesn't do that.  */
+  if (dwarf2_has_dwz_link (objfile))
+    return 0;
+
+  buffer = index_cache_lookup (objfile->obfd, &objfile->objfile_obstack,
+			       &size);
+  if (buffer == NULL)
+    return 0;
+
+  if (!read_index_from_buffer (objfile_name (objfile), 0, buffer, size, map,
+			       cu_list, cu_list_elements,
+			       types_list, types_list_elements))
+    return 0;
+
+  if (dwarf2_read_debug)
+    fprintf_unfiltered (gdb_stdlog, "Using the cached index of %s\n",
+			objfile_name (objfile));
+
+  return 1;
+}
+
 
 /* Read the index file.  If everything went ok, initialize the "quick"
    elements of all the CUs and return 1.  Otherwise, return 0.  */
@@ -3097,7 +3216,10 @@ dwarf2_read_index (struct objfile *objfile)
 				use_deprecated_index_sections,
 				&dwarf2_per_objfile->gdb_index, &local_map,
 				&cu_list, &cu_list_elements,
-				&types_list, &types_list_elements))
+				&types_list, &types_list_elements)
+      && !read_index_from_cache (objfile, &local_map,
+				 &cu_list, &cu_list_elements,
+				 &types_list, &types_list_elements))
     return 0;
 
   /* Don't use the index if it's empty.  */
@@ -3700,10 +3822,22 @@ dw2_expand_symtabs_for_function (struct objfile *objfile,
 static void
 dw2_expand_all_symtabs (struct objfile *objfile)
 {
+  VEC (dwarf2_per_cu_ptr) *per_cus = NULL;
+  struct cleanup *cleanup;
   int i;
 
   dw2_setup (objfile);
 
+  cleanup = make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &per_cus);
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
+
+      if (per_cu->v.quick->symtab == NULL)
+	VEC_safe_push (dwarf2_per_cu_ptr, per_cus, per_cu);
+    }
+  start_full_cu_preload (per_cus);
+
   for (i = 0; i < (dwarf2_per_objfile->n_comp_units
 		   + dwarf2_per_objfile->n_type_units); ++i)
     {
@@ -3711,6 +3845,8 @@ dw2_expand_all_symtabs (struct objfile *objfile)
 
       dw2_instantiate_symtab (per_cu);
     }
+
+  do_cleanups (cleanup);
 }
 
 static void
@@ -3778,6 +3914,9 @@ dw2_expand_symtabs_matching
   int i;
   offset_type iter;
   struct mapped_index *index;
+  VEC (dwarf2_per_cu_ptr) *to_expand = NULL;
+  struct dwarf2_per_cu_data *per_cu;
+  struct cleanup *back_to;
 
   dw2_setup (objfile);
 
@@ -3785,6 +3924,7 @@ dw2_expand_symtabs_matching
   if (!dwarf2_per_objfile->index_table)
     return;
   index = dwarf2_per_objfile->index_table;
+  back_to = make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &to_expand);
 
   if (file_matcher != NULL)
     {
@@ -3942,10 +4082,18 @@ dw2_expand_symtabs_matching
 	    }
 
 	  per_cu = dw2_get_cu (cu_index);
-	  if (file_matcher == NULL || per_cu->v.quick->mark)
-	    dw2_instantiate_symtab (per_cu);
+	  if ((file_matcher == NULL || per_cu->v.quick->mark)
+	      && per_cu->v.quick->symtab == NULL)
+	    VEC_safe_push (dwarf2_per_cu_ptr, to_expand, per_cu);
 	}
     }
+
+  /* Expand the CUs in the order they were found, reading their DIEs
+     ahead of time if possible.  */
+  start_full_cu_preload (to_expand);
+  for (i = 0; VEC_iterate (dwarf2_per_cu_ptr, to_expand, i, per_cu); ++i)
+    dw2_instantiate_symtab (per_cu);
+  do_cleanups (back_to);
 }
 
 /* A helper for dw2_find_pc_sect_symtab which finds the most specific
@@ -4162,6 +4310,8 @@ dwarf2_build_psymtabs (struct objfile *objfile)
     }
   if (except.reason < 0)
     exception_print (gdb_stderr, except);
+  else
+    save_index_to_cache (objfile);
 }
 
 /* Return the total length of the CU described by HEADER.  */
@@ -5934,11 +6084,287 @@ create_partial_symtab (struct dwarf2_per_cu_data *per_cu, const char *name)
   /* This is the glue that links PST into GDB's symbol API.  */
   pst->read_symtab_private = per_cu;
   pst->read_symtab = dwarf2_read_symtab;
+  pst->read_symtabs_ahead = dwarf2_read_symtabs_ahead;
   per_cu->v.psymtab = pst;
 
   return pst;
 }
 
+/* Reading the partial DIEs of a CU is mostly decoding, and can be done
+   on a worker thread (see worker-pool.h) while the main thread builds
+   the psymtab of the previous CU.  Everything else -- looking up DIEs
+   in other CUs, canonicalizing C++ names, adding partial symbols to
+   the objfile -- stays on the main thread, and happens in CU order,
+   so that the psymtabs come out exactly as if they had all been read
+   serially.  A CU the worker thread cannot handle by itself, or that
+   would need a complaint or an error reported, is abandoned and read
+   the ordinary way.  */
+
+/* A partial symbol that load_partial_dies found while running on a
+   worker thread, to be added by finish_preloaded_partial_dies.  */
+
+struct preloaded_psymbol
+{
+  /* The name of the symbol.  */
+  const char *name;
+
+  /* Non-zero if NAME must still be canonicalized.  */
+  unsigned int canonicalize : 1;
+
+  /* Non-zero for an enumerator, zero for a simple type.  */
+  unsigned int is_enumerator : 1;
+};
+
+typedef struct preloaded_psymbol preloaded_psymbol;
+DEF_VEC_O (preloaded_psymbol);
+
+/* The partial DIEs of one CU, as read by preload_psymtab_comp_unit.  */
+
+struct psymtab_preload
+{
+  /* The CU, with its abbrev table and partial DIEs.  PER_CU->CU is
+     not set.  NULL if the CU has not been read, or has been handed
+     over to process_psymtab_comp_unit.  */
+  struct dwarf2_cu *cu;
+
+  /* What init_cutu_and_read_dies passes to its die_reader_func.  */
+  const gdb_byte *info_ptr;
+  struct die_info *comp_unit_die;
+  int has_children;
+
+  /* The result of load_partial_dies.  */
+  struct partial_die_info *first_die;
+
+  /* The partial symbols load_partial_dies would have added.  */
+  VEC (preloaded_psymbol) *psymbols;
+};
+
+/* The state of the preloading done by dwarf2_build_psymtabs_hard.  */
+
+struct psymtab_preload_job
+{
+  /* The job, or NULL if there are no worker threads.  */
+  struct worker_job *job;
+
+  /* One element per CU.  */
+  struct psymtab_preload *preloads;
+
+  /* The number of CUs whose preloaded DIEs were used.  */
+  int n_used;
+};
+
+/* Release what PRELOAD holds.  */
+
+static void
+free_psymtab_preload (struct psymtab_preload *preload)
+{
+  if (preload->cu != NULL)
+    {
+      dwarf2_free_abbrev_table (preload->cu);
+      obstack_free (&preload->cu->comp_unit_obstack, NULL);
+      xfree (preload->cu);
+      preload->cu = NULL;
+    }
+  VEC_free (preloaded_psymbol, preload->psymbols);
+}
+
+/* Record that load_partial_dies, running for CU on a worker thread,
+   found a partial symbol for PDI.  */
+
+static void
+defer_partial_symbol (struct dwarf2_cu *cu, struct partial_die_info *pdi,
+		      int is_enumerator)
+{
+  struct preloaded_psymbol *psym;
+
+  psym = VEC_safe_push (preloaded_psymbol, cu->preload->psymbols, NULL);
+  psym->name = pdi->name;
+  psym->canonicalize = pdi->canonicalize_name;
+  psym->is_enumerator = is_enumerator;
+}
+
+/* worker_job_ftype function that reads the partial DIEs of CU number
+   ITEM into element ITEM of the psymtab_preload array DATA.  This
+   mirrors what init_cutu_and_read_dies and load_partial_dies do for
+   process_psymtab_comp_unit, for the simple cases only.  */
+
+static void
+preload_psymtab_comp_unit (void *data, int item)
+{
+  struct psymtab_preload *preload = (struct psymtab_preload *) data + item;
+  struct dwarf2_per_cu_data *this_cu = dw2_get_cu (item);
+  struct dwarf2_section_info *section = this_cu->section;
+  struct dwarf2_section_info *abbrev_section;
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  struct die_reader_specs reader;
+  struct die_info *comp_unit_die;
+  struct dwarf2_cu *cu;
+  int has_children;
+
+  if (this_cu->is_dwz || this_cu->load_all_dies)
+    worker_abandon_item ();
+
+  cu = XNEW (struct dwarf2_cu);
+  memset (cu, 0, sizeof (*cu));
+  cu->per_cu = this_cu;
+  cu->objfile = this_cu->objfile;
+  obstack_init (&cu->comp_unit_obstack);
+  preload->cu = cu;
+
+  abbrev_section = get_abbrev_section_for_cu (this_cu);
+  begin_info_ptr = section->buffer + this_cu->offset.sect_off;
+  info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+					    abbrev_section, begin_info_ptr, 0);
+  if (this_cu->length != get_cu_length (&cu->header)
+      || info_ptr >= begin_info_ptr + this_cu->length
+      || peek_abbrev_code (get_section_bfd_owner (section), info_ptr) == 0)
+    worker_abandon_item ();
+
+  dwarf2_read_abbrevs (cu, abbrev_section);
+  init_cu_die_reader (&reader, cu, section, NULL);
+  info_ptr = read_full_die (&reader, &comp_unit_die, info_ptr, &has_children);
+
+  /* DWO files and attributes that dwarf2_attr would follow into other
+     DIEs are left to the main thread.  */
+  if (comp_unit_die->tag != DW_TAG_compile_unit
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_GNU_dwo_name) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_specification) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_abstract_origin) != NULL)
+    worker_abandon_item ();
+
+  prepare_one_comp_unit (cu, comp_unit_die, language_minimal);
+
+  /* Other languages need more care in read_partial_die, e.g. Fortran
+     may call set_main_name.  */
+  if (cu->language != language_c
+      && cu->language != language_cplus
+      && cu->language != language_asm)
+    worker_abandon_item ();
+
+  preload->info_ptr = info_ptr;
+  preload->comp_unit_die = comp_unit_die;
+  preload->has_children = has_children;
+  if (has_children)
+    {
+      cu->preload = preload;
+      preload->first_die = load_partial_dies (&reader, info_ptr, 1);
+      cu->preload = NULL;
+    }
+}
+
+/* Start reading the partial DIEs of the CUs of OBJFILE on worker
+   threads, filling in JOB.  JOB->JOB is left NULL if this cannot be
+   done.  */
+
+static void
+start_psymtab_preload (struct objfile *objfile,
+		       struct psymtab_preload_job *job)
+{
+  int n_comp_units = dwarf2_per_objfile->n_comp_units;
+
+  memset (job, 0, sizeof (*job));
+
+  /* Debugging output can only be written by the main thread.  */
+  if (dwarf2_die_debug || n_comp_units < 2)
+    return;
+
+  /* Read the sections the worker threads use up front, so that they
+     never modify the dwarf2_section_info objects.  */
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+
+  job->preloads = XCNEWVEC (struct psymtab_preload, n_comp_units);
+  job->job = worker_job_start (n_comp_units, preload_psymtab_comp_unit,
+			       job->preloads);
+  if (job->job == NULL)
+    {
+      xfree (job->preloads);
+      job->preloads = NULL;
+    }
+}
+
+/* A cleanup that stops the worker threads started by
+   start_psymtab_preload and frees everything.  ARG is the
+   psymtab_preload_job.  */
+
+static void
+finish_psymtab_preload (void *arg)
+{
+  struct psymtab_preload_job *job = arg;
+  int i;
+
+  if (job->job == NULL)
+    return;
+
+  worker_job_finish (job->job);
+  job->job = NULL;
+
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    free_psymtab_preload (&job->preloads[i]);
+  xfree (job->preloads);
+  job->preloads = NULL;
+}
+
+/* Canonicalize the names of PDI, its siblings and all of their
+   children that still need it.  */
+
+static void
+canonicalize_partial_die_names (struct partial_die_info *pdi,
+				struct dwarf2_cu *cu)
+{
+  for (; pdi != NULL; pdi = pdi->die_sibling)
+    {
+      if (pdi->canonicalize_name)
+	{
+	  pdi->name = dwarf2_canonicalize_name (pdi->name, cu,
+						&cu->objfile->objfile_obstack);
+	  pdi->canonicalize_name = 0;
+	}
+      canonicalize_partial_die_names (pdi->die_child, cu);
+    }
+}
+
+/* Do the part of load_partial_dies that preload_psymtab_comp_unit left
+   for the main thread, and return the first partial DIE of CU.  */
+
+static struct partial_die_info *
+finish_preloaded_partial_dies (struct psymtab_preload *preload,
+			       struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+  struct preloaded_psymbol *psym;
+  int ix;
+
+  for (ix = 0;
+       VEC_iterate (preloaded_psymbol, preload->psymbols, ix, psym);
+       ++ix)
+    {
+      const char *name = psym->name;
+
+      if (psym->canonicalize)
+	name = dwarf2_canonicalize_name (name, cu,
+					 &objfile->objfile_obstack);
+
+      if (psym->is_enumerator)
+	add_psymbol_to_list (name, strlen (name), 0,
+			     VAR_DOMAIN, LOC_CONST,
+			     (cu->language == language_cplus
+			      || cu->language == language_java)
+			     ? &objfile->global_psymbols
+			     : &objfile->static_psymbols,
+			     0, (CORE_ADDR) 0, cu->language, objfile);
+      else
+	add_psymbol_to_list (name, strlen (name), 0,
+			     VAR_DOMAIN, LOC_TYPEDEF,
+			     &objfile->static_psymbols,
+			     0, (CORE_ADDR) 0, cu->language, objfile);
+    }
+
+  canonicalize_partial_die_names (preload->first_die, cu);
+
+  return preload->first_die;
+}
+
 /* The DATA object passed to process_psymtab_comp_unit_reader has this
    type.  */
 
@@ -5952,6 +6378,10 @@ struct process_psymtab_comp_unit_data
      language.  */
 
   enum language pretend_language;
+
+  /* If non-NULL, the partial DIEs have already been read into this.  */
+
+  struct psymtab_preload *preload;
 };
 
 /* die_reader_func for process_psymtab_comp_unit.  */
@@ -6023,7 +6453,10 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
       lowpc = ((CORE_ADDR) -1);
       highpc = ((CORE_ADDR) 0);
 
-      first_die = load_partial_dies (reader, info_ptr, 1);
+      if (info->preload != NULL)
+	first_die = finish_preloaded_partial_dies (info->preload, cu);
+      else
+	first_die = load_partial_dies (reader, info_ptr, 1);
 
       scan_partial_symbols (first_die, &lowpc, &highpc,
 			    ! has_pc_info, cu);
@@ -6090,12 +6523,15 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 }
 
 /* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
-   Process compilation unit THIS_CU for a psymtab.  */
+   Process compilation unit THIS_CU for a psymtab.  If PRELOAD is
+   non-NULL and holds THIS_CU's partial DIEs, they are used instead of
+   reading them again; the memory is then taken over from PRELOAD.  */
 
 static void
 process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
 			   int want_partial_unit,
-			   enum language pretend_language)
+			   enum language pretend_language,
+			   struct psymtab_preload *preload)
 {
   struct process_psymtab_comp_unit_data info;
 
@@ -6110,9 +6546,35 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   gdb_assert (! this_cu->is_debug_types);
   info.want_partial_unit = want_partial_unit;
   info.pretend_language = pretend_language;
-  init_cutu_and_read_dies (this_cu, NULL, 0, 0,
-			   process_psymtab_comp_unit_reader,
-			   &info);
+  info.preload = NULL;
+
+  /* The worker thread cannot know whether we decided to load all of
+     the DIEs of THIS_CU after it started.  */
+  if (preload != NULL && preload->cu != NULL && !this_cu->load_all_dies)
+    {
+      struct dwarf2_cu *cu = preload->cu;
+      struct die_reader_specs reader;
+      struct cleanup *free_cu_cleanup;
+
+      /* Do what init_cutu_and_read_dies would have done with the
+	 DIEs read by preload_psymtab_comp_unit.  */
+      preload->cu = NULL;
+      this_cu->cu = cu;
+      free_cu_cleanup = make_cleanup (free_heap_comp_unit, cu);
+      make_cleanup (dwarf2_free_abbrev_table, cu);
+
+      info.preload = preload;
+      init_cu_die_reader (&reader, cu, this_cu->section, NULL);
+      process_psymtab_comp_unit_reader (&reader, preload->info_ptr,
+					preload->comp_unit_die,
+					preload->has_children, &info);
+
+      do_cleanups (free_cu_cleanup);
+    }
+  else
+    init_cutu_and_read_dies (this_cu, NULL, 0, 0,
+			     process_psymtab_comp_unit_reader,
+			     &info);
 
   /* Age out any secondary CUs.  */
   age_cached_comp_units ();
@@ -6259,6 +6721,7 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
 {
   struct cleanup *back_to, *addrmap_cleanup;
   struct obstack temp_obstack;
+  struct psymtab_preload_job preload_job;
   int i;
 
   if (dwarf2_read_debug)
@@ -6286,13 +6749,31 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   objfile->psymtabs_addrmap = addrmap_create_mutable (&temp_obstack);
   addrmap_cleanup = make_cleanup (psymtabs_addrmap_cleanup, objfile);
 
+  start_psymtab_preload (objfile, &preload_job);
+  make_cleanup (finish_psymtab_preload, &preload_job);
+
   for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
     {
       struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
+      struct psymtab_preload *preload = NULL;
 
-      process_psymtab_comp_unit (per_cu, 0, language_minimal);
+      if (preload_job.job != NULL
+	  && worker_job_wait (preload_job.job, i))
+	{
+	  preload = &preload_job.preloads[i];
+	  ++preload_job.n_used;
+	}
+      process_psymtab_comp_unit (per_cu, 0, language_minimal, preload);
+      if (preload_job.job != NULL)
+	free_psymtab_preload (&preload_job.preloads[i]);
     }
 
+  if (dwarf2_read_debug && preload_job.job != NULL)
+    fprintf_unfiltered (gdb_stdlog,
+			"Read the partial DIEs of %d of %d units"
+			" on worker threads\n",
+			preload_job.n_used, dwarf2_per_objfile->n_comp_units);
+
   set_partial_user (objfile);
 
   objfile->psymtabs_addrmap = addrmap_create_fixed (objfile->psymtabs_addrmap,
@@ -6513,7 +6994,7 @@ scan_partial_symbols (struct partial_die_info *first_die, CORE_ADDR *lowpc,
 
 		/* Go read the partial unit, if needed.  */
 		if (per_cu->v.psymtab == NULL)
-		  process_psymtab_comp_unit (per_cu, 1, cu->language);
+		  process_psymtab_comp_unit (per_cu, 1, cu->language, NULL);
 
 		VEC_safe_push (dwarf2_per_cu_ptr,
 			       cu->per_cu->imported_symtabs, per_cu);
@@ -7227,6 +7708,40 @@ dwarf2_read_symtab (struct partial_symtab *self,
   process_cu_includes ();
 }
 
+/* Implement the read_symtabs_ahead method of a partial_symtab: start
+   reading the full DIEs of the CUs of those of the N psymtabs PSTS of
+   OBJFILE that the DWARF reader created.  */
+
+static struct cleanup *
+dwarf2_read_symtabs_ahead (struct objfile *objfile,
+			   struct partial_symtab **psts, int n)
+{
+  VEC (dwarf2_per_cu_ptr) *per_cus = NULL;
+  struct cleanup *back_to;
+  int i;
+
+  /* Restore our global data.  */
+  dwarf2_per_objfile = objfile_data (objfile, dwarf2_objfile_data_key);
+
+  back_to = make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &per_cus);
+  for (i = 0; i < n; ++i)
+    {
+      struct partial_symtab *pst = psts[i];
+
+      /* This is what psymtab_to_symtab reads for a shared psymtab.  */
+      while (pst->user != NULL)
+	pst = pst->user;
+
+      if (pst->read_symtab == dwarf2_read_symtab
+	  && !pst->readin
+	  && pst->read_symtab_private != NULL)
+	VEC_safe_push (dwarf2_per_cu_ptr, per_cus, pst->read_symtab_private);
+    }
+  start_full_cu_preload (per_cus);
+
+  return back_to;
+}
+
 /* Reading in full CUs.  */
 
 /* Add PER_CU to the queue.  */
@@ -7463,6 +7978,292 @@ die_eq (const void *item_lhs, const void *item_rhs)
   return die_lhs->offset.sect_off == die_rhs->offset.sect_off;
 }
 
+/* When many symtabs are expanded at once, e.g. by "info functions" or
+   "rbreak", reading the full DIEs of the CUs can be done ahead of time
+   on worker threads (see worker-pool.h), while the main thread builds
+   the symtab of an earlier CU.  Only the DIE reading is done there; the
+   symtabs themselves are still built by process_queue on the main
+   thread, in the same order as without worker threads.  As for the
+   partial DIEs, a CU that needs more than plain decoding is abandoned
+   and read the ordinary way by load_full_comp_unit.  */
+
+/* The state of the full DIE reading started by start_full_cu_preload.  */
+
+struct full_cu_preload_job
+{
+  /* The job.  */
+  struct worker_job *job;
+
+  /* The objfile the CUs belong to.  */
+  struct dwarf2_per_objfile *per_objfile;
+
+  /* The CUs to read, in the order they are expected to be expanded,
+     and their number.  */
+  struct dwarf2_per_cu_data **per_cus;
+  int n_cus;
+
+  /* One element per CU: the CU with its DIEs, as read by
+     preload_full_comp_unit, or NULL.  PER_CU->CU is not set.  */
+  struct dwarf2_cu **cus;
+
+  /* Maps a CU to its element of PER_CUS.  */
+  htab_t index;
+
+  /* The first item not waited for yet.  */
+  int next;
+
+  /* The number of CUs whose preloaded DIEs were used.  */
+  int n_used;
+};
+
+/* The full DIE reading in progress, or NULL.  */
+
+static struct full_cu_preload_job *full_cu_preload;
+
+/* Hash function for the index of a full_cu_preload_job.  The entries
+   are pointers into its PER_CUS array.  */
+
+static hashval_t
+hash_full_cu_preload_entry (const void *item)
+{
+  struct dwarf2_per_cu_data * const *entry = item;
+
+  return htab_hash_pointer (*entry);
+}
+
+/* Equality function for the index of a full_cu_preload_job.  */
+
+static int
+eq_full_cu_preload_entry (const void *item_lhs, const void *item_rhs)
+{
+  struct dwarf2_per_cu_data * const *lhs = item_lhs;
+  struct dwarf2_per_cu_data * const *rhs = item_rhs;
+
+  return *lhs == *rhs;
+}
+
+/* Free CU, which preload_full_comp_unit allocated.  */
+
+static void
+free_preloaded_full_comp_unit (struct dwarf2_cu *cu)
+{
+  dwarf2_free_abbrev_table (cu);
+  obstack_free (&cu->comp_unit_obstack, NULL);
+  xfree (cu);
+}
+
+/* worker_job_ftype function that reads the full DIEs of element ITEM
+   of the PER_CUS of the full_cu_preload_job DATA.  This does what
+   init_cutu_and_read_dies and load_full_comp_unit_reader do for
+   load_full_comp_unit, for the simple cases only.  */
+
+static void
+preload_full_comp_unit (void *data, int item)
+{
+  struct full_cu_preload_job *job = data;
+  struct dwarf2_per_cu_data *this_cu = job->per_cus[item];
+  struct dwarf2_section_info *section = this_cu->section;
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  struct die_reader_specs reader;
+  struct die_info *comp_unit_die;
+  struct dwarf2_cu *cu;
+  int has_children;
+
+  cu = XNEW (struct dwarf2_cu);
+  memset (cu, 0, sizeof (*cu));
+  cu->per_cu = this_cu;
+  cu->objfile = this_cu->objfile;
+  obstack_init (&cu->comp_unit_obstack);
+  job->cus[item] = cu;
+
+  begin_info_ptr = section->buffer + this_cu->offset.sect_off;
+  info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+					    &job->per_objfile->abbrev,
+					    begin_info_ptr, 0);
+  if (this_cu->length != get_cu_length (&cu->header)
+      || info_ptr >= begin_info_ptr + this_cu->length
+      || peek_abbrev_code (get_section_bfd_owner (section), info_ptr) == 0)
+    worker_abandon_item ();
+
+  dwarf2_read_abbrevs (cu, &job->per_objfile->abbrev);
+  init_cu_die_reader (&reader, cu, section, NULL);
+  info_ptr = read_full_die (&reader, &comp_unit_die, info_ptr, &has_children);
+
+  /* DWO files, and attributes that prepare_one_comp_unit would follow
+     into other DIEs, are left to the main thread.  */
+  if (dwarf2_attr_no_follow (comp_unit_die, DW_AT_GNU_dwo_name) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_specification) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_abstract_origin) != NULL)
+    worker_abandon_item ();
+
+  cu->die_hash =
+    htab_create_alloc_ex (cu->header.length / 12,
+			  die_hash,
+			  die_eq,
+			  NULL,
+			  &cu->comp_unit_obstack,
+			  hashtab_obstack_allocate,
+			  dummy_obstack_deallocate);
+
+  if (has_children)
+    comp_unit_die->child = read_die_and_siblings (&reader, info_ptr,
+						  &info_ptr, comp_unit_die);
+  cu->dies = comp_unit_die;
+
+  dwarf2_free_abbrev_table (cu);
+}
+
+/* A cleanup that stops the worker threads started by
+   start_full_cu_preload and frees everything.  ARG is the
+   full_cu_preload_job.  */
+
+static void
+finish_full_cu_preload (void *arg)
+{
+  struct full_cu_preload_job *job = arg;
+  int i;
+
+  if (job->job != NULL)
+    {
+      worker_job_finish (job->job);
+
+      if (dwarf2_read_debug)
+	fprintf_unfiltered (gdb_stdlog,
+			    "Read the full DIEs of %d of %d units"
+			    " on worker threads\n",
+			    job->n_used, job->n_cus);
+    }
+
+  for (i = 0; i < job->n_cus; ++i)
+    if (job->cus[i] != NULL)
+      free_preloaded_full_comp_unit (job->cus[i]);
+
+  if (full_cu_preload == job)
+    full_cu_preload = NULL;
+  htab_delete (job->index);
+  xfree (job->cus);
+  xfree (job->per_cus);
+  xfree (job);
+}
+
+/* Start reading the full DIEs of PER_CUS, a list of CUs of the current
+   objfile, on worker threads, in the order of the list.  The CUs are
+   then expanded as usual; load_full_comp_unit uses the DIEs read
+   ahead of time.  Return a cleanup that stops the worker threads.  */
+
+static struct cleanup *
+start_full_cu_preload (VEC (dwarf2_per_cu_ptr) *per_cus)
+{
+  struct full_cu_preload_job *job;
+  struct dwarf2_per_cu_data *per_cu;
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+  int ix;
+
+  /* Debugging output can only be written by the main thread, and only
+     one list of CUs is read ahead at a time.  */
+  if (dwarf2_die_debug || full_cu_preload != NULL
+      || VEC_length (dwarf2_per_cu_ptr, per_cus) < 2
+      || worker_thread_count () == 0)
+    return make_cleanup (null_cleanup, NULL);
+
+  /* Read the sections the worker threads use up front, so that they
+     never modify the dwarf2_section_info objects.  */
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->info);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+
+  job = XCNEW (struct full_cu_preload_job);
+  job->per_objfile = dwarf2_per_objfile;
+  job->per_cus = XNEWVEC (struct dwarf2_per_cu_data *,
+			  VEC_length (dwarf2_per_cu_ptr, per_cus));
+  job->index = htab_create_alloc (VEC_length (dwarf2_per_cu_ptr, per_cus),
+				  hash_full_cu_preload_entry,
+				  eq_full_cu_preload_entry,
+				  NULL, xcalloc, xfree);
+
+  /* Only plain compilation units that are not read in yet are worth
+     reading ahead.  */
+  for (ix = 0; VEC_iterate (dwarf2_per_cu_ptr, per_cus, ix, per_cu); ++ix)
+    {
+      void **slot;
+
+      if (per_cu->is_debug_types || per_cu->is_dwz
+	  || per_cu->section != &dwarf2_per_objfile->info
+	  || per_cu->cu != NULL)
+	continue;
+
+      job->per_cus[job->n_cus] = per_cu;
+      slot = htab_find_slot (job->index, &job->per_cus[job->n_cus], INSERT);
+      if (*slot != NULL)
+	continue;
+      *slot = &job->per_cus[job->n_cus];
+      ++job->n_cus;
+    }
+
+  job->cus = XCNEWVEC (struct dwarf2_cu *, job->n_cus);
+  if (job->n_cus >= 2)
+    job->job = worker_job_start (job->n_cus, preload_full_comp_unit, job);
+  if (job->job == NULL)
+    {
+      job->n_cus = 0;
+      finish_full_cu_preload (job);
+      return make_cleanup (null_cleanup, NULL);
+    }
+
+  full_cu_preload = job;
+  return make_cleanup (finish_full_cu_preload, job);
+}
+
+/* If the full DIEs of THIS_CU have been read ahead of time, make them
+   THIS_CU->cu, as load_full_comp_unit would, and return non-zero.
+   Otherwise return zero.  */
+
+static int
+use_preloaded_full_comp_unit (struct dwarf2_per_cu_data *this_cu,
+			      enum language pretend_language)
+{
+  struct full_cu_preload_job *job = full_cu_preload;
+  struct dwarf2_per_cu_data **entry;
+  struct dwarf2_cu *cu;
+  int item, done;
+
+  if (job == NULL || job->per_objfile != dwarf2_per_objfile
+      || this_cu->cu != NULL)
+    return 0;
+
+  entry = htab_find (job->index, &this_cu);
+  if (entry == NULL)
+    return 0;
+
+  /* Items can only be waited for in increasing order.  A CU that is
+     loaded out of order, because another CU refers to it, is read by
+     the main thread unless it is further down the list.  */
+  item = entry - job->per_cus;
+  if (item < job->next)
+    return 0;
+  job->next = item + 1;
+
+  done = worker_job_wait (job->job, item);
+  cu = job->cus[item];
+  job->cus[item] = NULL;
+  if (!done)
+    {
+      if (cu != NULL)
+	free_preloaded_full_comp_unit (cu);
+      return 0;
+    }
+
+  this_cu->cu = cu;
+  prepare_one_comp_unit (cu, cu->dies, pretend_language);
+
+  /* Link this CU into read_in_chain.  */
+  cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+  dwarf2_per_objfile->read_in_chain = this_cu;
+
+  ++job->n_used;
+  return 1;
+}
+
 /* die_reader_func for load_full_comp_unit.
    This is identical to read_signatured_type_reader,
    but is kept separate for now.  */
@@ -7510,6 +8311,9 @@ load_full_comp_unit (struct dwarf2_per_cu_data *this_cu,
 {
   gdb_assert (! this_cu->is_debug_types);
 
+  if (use_preloaded_full_comp_unit (this_cu, pretend_language))
+    return;
+
   init_cutu_and_read_dies (this_cu, NULL, 1, 1,
 			   load_full_comp_unit_reader, &pretend_language);
 }
@@ -15002,10 +15806,15 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || part_die->tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && part_die->name != NULL)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &objfile->static_psymbols,
-				 0, (CORE_ADDR) 0, cu->language, objfile);
+	    {
+	      if (cu->preload != NULL)
+		defer_partial_symbol (cu, part_die, 0);
+	      else
+		add_psymbol_to_list (part_die->name, strlen (part_die->name),
+				     0, VAR_DOMAIN, LOC_TYPEDEF,
+				     &objfile->static_psymbols,
+				     0, (CORE_ADDR) 0, cu->language, objfile);
+	    }
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
 	}
@@ -15037,6 +15846,8 @@ load_partial_dies (const struct die_reader_specs *reader,
 	  if (part_die->name == NULL)
 	    complaint (&symfile_complaints,
 		       _("malformed enumerator DIE ignored"));
+	  else if (building_psymtab && cu->preload != NULL)
+	    defer_partial_symbol (cu, part_die, 1);
 	  else if (building_psymtab)
 	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
 				 VAR_DOMAIN, LOC_CONST,
@@ -15197,9 +16008,17 @@ read_partial_die (const struct die_reader_specs *reader,
 	      part_die->name = DW_STRING (&attr);
 	      break;
 	    default:
-	      part_die->name
-		= dwarf2_canonicalize_name (DW_STRING (&attr), cu,
-					    &objfile->objfile_obstack);
+	      /* The C++ name parser is not thread-safe; leave this to
+		 finish_preloaded_partial_dies.  */
+	      if (cu->preload != NULL && cu->language == language_cplus)
+		{
+		  part_die->name = DW_STRING (&attr);
+		  part_die->canonicalize_name = 1;
+		}
+	      else
+		part_die->name
+		  = dwarf2_canonicalize_name (DW_STRING (&attr), cu,
+					      &objfile->objfile_obstack);
 	      break;
 	    }
 	  break;
@@ -15343,6 +16162,9 @@ read_partial_die (const struct die_reader_specs *reader,
 	{
 	  struct gdbarch *gdbarch = get_objfile_arch (objfile);
 
+	  /* paddress is not thread-safe.  */
+	  if (in_worker_thread ())
+	    worker_abandon_item ();
 	  complaint (&symfile_complaints,
 		     _("DW_AT_low_pc %s is zero "
 		       "for DIE at 0x%x [in module %s]"),
@@ -15354,6 +16176,8 @@ read_partial_die (const struct die_reader_specs *reader,
 	{
 	  struct gdbarch *gdbarch = get_objfile_arch (objfile);
 
+	  if (in_worker_thread ())
+	    worker_abandon_item ();
 	  complaint (&symfile_complaints,
 		     _("DW_AT_low_pc %s is not < DW_AT_high_pc %s "
 		       "for DIE at 0x%x [in module %s]"),
@@ -15660,8 +16484,12 @@ read_attribute_value (const struct die_reader_specs *reader,
     case DW_FORM_strp:
       if (!cu->per_cu->is_dwz)
 	{
-	  DW_STRING (attr) = read_indirect_string (abfd, info_ptr, cu_header,
-						   &bytes_read);
+	  /* Not dwarf2_per_objfile: while a worker thread reads this
+	     CU, the main thread may switch that to another objfile.  */
+	  DW_STRING (attr)
+	    = read_indirect_string (objfile_data (cu->objfile,
+						  dwarf2_objfile_data_key),
+				    abfd, info_ptr, cu_header, &bytes_read);
 	  DW_STRING_IS_CANONICAL (attr) = 0;
 	  info_ptr += bytes_read;
 	  break;
@@ -15669,9 +16497,14 @@ read_attribute_value (const struct die_reader_specs *reader,
       /* FALLTHROUGH */
     case DW_FORM_GNU_strp_alt:
       {
-	struct dwz_file *dwz = dwarf2_get_dwz_file ();
-	LONGEST str_offset = read_offset (abfd, info_ptr, cu_header,
-					  &bytes_read);
+	struct dwz_file *dwz;
+	LONGEST str_offset;
+
+	/* Only the main thread may open the dwz file.  */
+	if (in_worker_thread ())
+	  worker_abandon_item ();
+	dwz = dwarf2_get_dwz_file ();
+	str_offset = read_offset (abfd, info_ptr, cu_header, &bytes_read);
 
 	DW_STRING (attr) = read_indirect_string_from_dwz (dwz, str_offset);
 	DW_STRING_IS_CANONICAL (attr) = 0;
@@ -15798,6 +16631,9 @@ read_attribute_value (const struct die_reader_specs *reader,
       && form == DW_FORM_data4
       && DW_UNSND (attr) >= 0xffffffff)
     {
+      /* hex_string is not thread-safe.  */
+      if (in_worker_thread ())
+	worker_abandon_item ();
       complaint
         (&symfile_complaints,
          _("Suspicious DW_AT_byte_size value treated as zero instead of %s"),
@@ -16069,21 +16905,27 @@ read_direct_string (bfd *abfd, const gdb_byte *buf,
   return (const char *) buf;
 }
 
+/* Read a string at offset STR_OFFSET in the .debug_str section of
+   PER_OBJFILE.  Throw an error if the offset is too large.  If the
+   string consists of a single NUL byte, return NULL; otherwise return
+   a pointer to the string.  */
+
 static const char *
-read_indirect_string_at_offset (bfd *abfd, LONGEST str_offset)
+read_indirect_string_at_offset (struct dwarf2_per_objfile *per_objfile,
+				bfd *abfd, LONGEST str_offset)
 {
-  dwarf2_read_section (dwarf2_per_objfile->objfile, &dwarf2_per_objfile->str);
-  if (dwarf2_per_objfile->str.buffer == NULL)
+  dwarf2_read_section (per_objfile->objfile, &per_objfile->str);
+  if (per_objfile->str.buffer == NULL)
     error (_("DW_FORM_strp used without .debug_str section [in module %s]"),
 	   bfd_get_filename (abfd));
-  if (str_offset >= dwarf2_per_objfile->str.size)
+  if (str_offset >= per_objfile->str.size)
     error (_("DW_FORM_strp pointing outside of "
 	     ".debug_str section [in module %s]"),
 	   bfd_get_filename (abfd));
   gdb_assert (HOST_CHAR_BIT == 8);
-  if (dwarf2_per_objfile->str.buffer[str_offset] == '\0')
+  if (per_objfile->str.buffer[str_offset] == '\0')
     return NULL;
-  return (const char *) (dwarf2_per_objfile->str.buffer + str_offset);
+  return (const char *) (per_objfile->str.buffer + str_offset);
 }
 
 /* Read a string at offset STR_OFFSET in the .debug_str section from
@@ -16111,13 +16953,14 @@ read_indirect_string_from_dwz (struct dwz_file *dwz, LONGEST str_offset)
 }
 
 static const char *
-read_indirect_string (bfd *abfd, const gdb_byte *buf,
+read_indirect_string (struct dwarf2_per_objfile *per_objfile,
+		      bfd *abfd, const gdb_byte *buf,
 		      const struct comp_unit_head *cu_header,
 		      unsigned int *bytes_read_ptr)
 {
   LONGEST str_offset = read_offset (abfd, buf, cu_header, bytes_read_ptr);
 
-  return read_indirect_string_at_offset (abfd, str_offset);
+  return read_indirect_string_at_offset (per_objfile, abfd, str_offset);
 }
 
 static ULONGEST
@@ -20381,7 +21224,8 @@ dwarf_decode_macro_bytes (bfd *abfd,
 		    body = read_indirect_string_from_dwz (dwz, str_offset);
 		  }
 		else
-		  body = read_indirect_string_at_offset (abfd, str_offset);
+		  body = read_indirect_string_at_offset (dwarf2_per_objfile,
+							 abfd, str_offset);
 	      }
 
 	    is_define = (macinfo_type == DW_MACRO_GNU_define
@@ -22099,7 +22943,7 @@ write_psymbols (struct mapped_symtab *symtab,
       struct partial_symbol *psym = *psymp;
       void **slot;
 
-      if (SYMBOL_LANGUAGE (psym) == language_ada)
+      if (PSYMBOL_LANGUAGE (psym) == language_ada)
 	error (_("Ada is not currently supported by the index"));
 
       /* Only add a given psymbol once.  */
@@ -22109,7 +22953,7 @@ write_psymbols (struct mapped_symtab *symtab,
 	  gdb_index_symbol_kind kind = symbol_kind (psym);
 
 	  *slot = psym;
-	  add_index_entry (symtab, SYMBOL_SEARCH_NAME (psym),
+	  add_index_entry (symtab, PSYMBOL_SEARCH_NAME (psym),
 			   is_static, kind, cu_index);
 	}
     }
@@ -22214,20 +23058,19 @@ recursively_write_psymbols (struct objfile *objfile,
 		  1);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* Write the index of OBJFILE to the file FILENAME.  */
 
 static void
-write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+write_psymtabs_to_index (struct objfile *objfile, const char *filename)
 {
   struct cleanup *cleanup;
-  char *filename, *cleanup_filename;
+  const char *cleanup_filename;
   struct obstack contents, addr_obstack, constant_pool, symtab_obstack;
   struct obstack cu_list, types_cu_list;
   int i;
   FILE *out_file;
   struct mapped_symtab *symtab;
   offset_type val, size_of_contents, total_len;
-  struct stat st;
   htab_t psyms_seen;
   htab_t cu_index_htab;
   struct psymtab_cu_index_map *psymtab_cu_index_map;
@@ -22241,19 +23084,12 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   if (!objfile->psymtabs || !objfile->psymtabs_addrmap)
     return;
 
-  if (stat (objfile_name (objfile), &st) < 0)
-    perror_with_name (objfile_name (objfile));
-
-  filename = concat (dir, SLASH_STRING, lbasename (objfile_name (objfile)),
-		     INDEX_SUFFIX, (char *) NULL);
-  cleanup = make_cleanup (xfree, filename);
-
   out_file = gdb_fopen_cloexec (filename, "wb");
   if (!out_file)
     error (_("Can't open `%s' for writing"), filename);
 
   cleanup_filename = filename;
-  make_cleanup (unlink_if_set, &cleanup_filename);
+  cleanup = make_cleanup (unlink_if_set, &cleanup_filename);
 
   symtab = create_mapped_symtab ();
   make_cleanup (cleanup_mapped_symtab, symtab);
@@ -22426,18 +23262,78 @@ save_gdb_index_command (char *arg, int from_tty)
       {
 	volatile struct gdb_exception except;
 
+	char *filename;
+	struct cleanup *cleanup;
+
+	filename = concat (arg, SLASH_STRING,
+			   lbasename (objfile_name (objfile)), INDEX_SUFFIX,
+			   (char *) NULL);
+	cleanup = make_cleanup (xfree, filename);
+
 	TRY_CATCH (except, RETURN_MASK_ERROR)
 	  {
-	    write_psymtabs_to_index (objfile, arg);
+	    write_psymtabs_to_index (objfile, filename);
 	  }
 	if (except.reason < 0)
 	  exception_fprintf (gdb_stderr, except,
 			     _("Error while writing index for `%s': "),
 			     objfile_name (objfile));
+
+	do_cleanups (cleanup);
       }
   }
 }
 
+/* Store the index of OBJFILE, whose partial symbols were just read, in
+   the index cache.  Failures are not reported, except when debugging:
+   the cache is only an optimization.  */
+
+static void
+save_index_to_cache (struct objfile *objfile)
+{
+  volatile struct gdb_exception except;
+  struct cleanup *cleanup;
+  char *filename, *tmp_filename;
+
+  if (!index_cache_enabled_p ())
+    return;
+
+  /* See read_index_from_cache.  */
+  if (dwarf2_has_dwz_link (objfile))
+    return;
+
+  filename = index_cache_file_name (objfile->obfd, 1);
+  if (filename == NULL)
+    return;
+  cleanup = make_cleanup (xfree, filename);
+
+  /* Write to a temporary file and rename it into place, so that another
+     GDB never sees a partially written index.  */
+  tmp_filename = xstrprintf ("%s.tmp%ld", filename, (long) getpid ());
+  make_cleanup (xfree, tmp_filename);
+
+  TRY_CATCH (except, RETURN_MASK_ERROR)
+    {
+      write_psymtabs_to_index (objfile, tmp_filename);
+      if (rename (tmp_filename, filename) != 0)
+	{
+	  unlink (tmp_filename);
+	  perror_with_name (filename);
+	}
+    }
+  if (except.reason < 0)
+    {
+      if (dwarf2_read_debug)
+	exception_fprintf (gdb_stdlog, except,
+			   _("Error while caching the index of `%s': "),
+			   objfile_name (objfile));
+    }
+  else
+    index_cache_stored ();
+
+  do_cleanups (cleanup);
+}
+
 
 
 int dwarf2_always_disassemble;
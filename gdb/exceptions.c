@@ -28,6 +28,7 @@
 #include <string.h>
 #include "serial.h"
 #include "gdbthread.h"
+#include "worker-pool.h"
 
 const struct gdb_exception exception_none = { 0, GDB_NO_ERROR, NULL };
 
@@ -221,6 +222,10 @@ exceptions_state_mc_action_iter_1 (void)
 void
 throw_exception (struct gdb_exception exception)
 {
+  /* A worker thread has no catchers or cleanups of its own.  */
+  if (in_worker_thread ())
+    worker_abandon_item ();
+
   clear_quit_flag ();
   immediate_quit = 0;
 
@@ -370,8 +375,13 @@ throw_it (enum return_reason reason, enum errors error, const char *fmt,
 {
   struct gdb_exception e;
   char *new_message;
-  int depth = catcher_list_size ();
+  int depth;
+
+  /* EXCEPTION_MESSAGES belongs to the main thread.  */
+  if (in_worker_thread ())
+    worker_abandon_item ();
 
+  depth = catcher_list_size ();
   gdb_assert (depth > 0);
 
   /* Note: The new message may use an old message's text.  */
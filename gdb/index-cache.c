@@ -0,0 +1,514 @@
+/* Caching of GDB index files.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "bfd.h"
+#include "elf-bfd.h"
+#include "gdb_obstack.h"
+#include "index-cache.h"
+#include "build-id.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "filenames.h"
+#include "filestuff.h"
+#include "vec.h"
+#include "value.h"
+#include <string.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <time.h>
+
+#ifdef USE_WIN32API
+#undef mkdir
+#define mkdir(pathname, mode) mkdir (pathname)
+#endif
+
+/* The suffix of the files in the index cache.  */
+
+#define INDEX_CACHE_SUFFIX ".gdb-index"
+
+/* Whether GDB uses and fills the index cache.  */
+
+static int index_cache_enabled = 0;
+
+/* The directory holding the index cache.  */
+
+static char *index_cache_directory;
+
+/* The maximum size of the index cache in megabytes, or -1 for no
+   limit.  */
+
+static int index_cache_size_limit = 1024;
+
+/* How often index_cache_lookup found, and did not find, an index
+   since GDB started.  */
+
+static unsigned int index_cache_hits;
+static unsigned int index_cache_misses;
+
+/* A file in the index cache.  */
+
+struct index_cache_entry
+{
+  /* The malloc'd name of the file, without the directory.  */
+  char *name;
+
+  /* Its size in bytes.  */
+  off_t size;
+
+  /* Its modification time.  */
+  time_t mtime;
+};
+
+typedef struct index_cache_entry index_cache_entry_s;
+DEF_VEC_O (index_cache_entry_s);
+
+/* Create DIR and any missing parent directories.  Return zero and set
+   errno on failure.  */
+
+static int
+mkdir_recursive (const char *dir)
+{
+  char *copy = xstrdup (dir);
+  char *p = copy;
+  int ok = 1;
+
+  /* Skip a leading separator, so that "/" is not created.  */
+  if (IS_DIR_SEPARATOR (*p))
+    ++p;
+
+  for (;; ++p)
+    {
+      if (*p == '\0' || IS_DIR_SEPARATOR (*p))
+	{
+	  char c = *p;
+
+	  *p = '\0';
+	  if (mkdir (copy, 0700) != 0 && errno != EEXIST)
+	    {
+	      ok = 0;
+	      break;
+	    }
+	  *p = c;
+	  if (c == '\0')
+	    break;
+	}
+    }
+
+  xfree (copy);
+  return ok;
+}
+
+/* See index-cache.h.  */
+
+int
+index_cache_enabled_p (void)
+{
+  return (index_cache_enabled
+	  && index_cache_directory != NULL
+	  && *index_cache_directory != '\0');
+}
+
+/* See index-cache.h.  */
+
+char *
+index_cache_file_name (bfd *abfd, int create)
+{
+  const struct elf_build_id *build_id;
+  char *filename, *p;
+  size_t i;
+
+  if (!index_cache_enabled_p ())
+    return NULL;
+
+  build_id = build_id_bfd_get (abfd);
+  if (build_id == NULL || build_id->size == 0)
+    return NULL;
+
+  if (create && !mkdir_recursive (index_cache_directory))
+    return NULL;
+
+  filename = xmalloc (strlen (index_cache_directory) + 1
+		      + 2 * build_id->size + strlen (INDEX_CACHE_SUFFIX) + 1);
+  p = filename;
+  strcpy (p, index_cache_directory);
+  p += strlen (p);
+  *p++ = '/';
+  for (i = 0; i < build_id->size; ++i)
+    {
+      sprintf (p, "%02x", (unsigned) build_id->data[i]);
+      p += 2;
+    }
+  strcpy (p, INDEX_CACHE_SUFFIX);
+
+  return filename;
+}
+
+/* See index-cache.h.  */
+
+const gdb_byte *
+index_cache_lookup (bfd *abfd, struct obstack *obstack, bfd_size_type *size)
+{
+  char *filename;
+  struct cleanup *cleanup;
+  struct stat st;
+  gdb_byte *buffer;
+  FILE *file;
+
+  filename = index_cache_file_name (abfd, 0);
+  if (filename == NULL)
+    return NULL;
+  cleanup = make_cleanup (xfree, filename);
+
+  file = gdb_fopen_cloexec (filename, "rb");
+  if (file == NULL)
+    {
+      ++index_cache_misses;
+      do_cleanups (cleanup);
+      return NULL;
+    }
+  make_cleanup_fclose (file);
+
+  if (fstat (fileno (file), &st) != 0 || st.st_size == 0)
+    {
+      ++index_cache_misses;
+      do_cleanups (cleanup);
+      return NULL;
+    }
+
+  buffer = obstack_alloc (obstack, st.st_size);
+  if (fread (buffer, 1, st.st_size, file) != (size_t) st.st_size)
+    {
+      obstack_free (obstack, buffer);
+      ++index_cache_misses;
+      do_cleanups (cleanup);
+      return NULL;
+    }
+
+  ++index_cache_hits;
+  *size = st.st_size;
+  do_cleanups (cleanup);
+  return buffer;
+}
+
+/* qsort comparison function for index_cache_entry objects: oldest
+   first.  */
+
+static int
+compare_index_cache_entries (const void *ap, const void *bp)
+{
+  const struct index_cache_entry *a = ap;
+  const struct index_cache_entry *b = bp;
+
+  if (a->mtime != b->mtime)
+    return a->mtime < b->mtime ? -1 : 1;
+  return strcmp (a->name, b->name);
+}
+
+/* Return the files in the index cache, oldest first.  */
+
+static VEC (index_cache_entry_s) *
+list_index_cache (void)
+{
+  VEC (index_cache_entry_s) *entries = NULL;
+  size_t suffix_len = strlen (INDEX_CACHE_SUFFIX);
+  struct dirent *dirent;
+  DIR *dir;
+
+  if (index_cache_directory == NULL || *index_cache_directory == '\0')
+    return NULL;
+
+  dir = opendir (index_cache_directory);
+  if (dir == NULL)
+    return NULL;
+
+  while ((dirent = readdir (dir)) != NULL)
+    {
+      size_t len = strlen (dirent->d_name);
+      struct index_cache_entry entry;
+      struct stat st;
+      char *path;
+      int ok;
+
+      if (len <= suffix_len
+	  || strcmp (dirent->d_name + len - suffix_len,
+		     INDEX_CACHE_SUFFIX) != 0)
+	continue;
+
+      path = concat (index_cache_directory, SLASH_STRING, dirent->d_name,
+		     (char *) NULL);
+      ok = stat (path, &st) == 0 && S_ISREG (st.st_mode);
+      xfree (path);
+      if (!ok)
+	continue;
+
+      entry.name = xstrdup (dirent->d_name);
+      entry.size = st.st_size;
+      entry.mtime = st.st_mtime;
+      VEC_safe_push (index_cache_entry_s, entries, &entry);
+    }
+  closedir (dir);
+
+  if (!VEC_empty (index_cache_entry_s, entries))
+    qsort (VEC_address (index_cache_entry_s, entries),
+	   VEC_length (index_cache_entry_s, entries),
+	   sizeof (struct index_cache_entry), compare_index_cache_entries);
+
+  return entries;
+}
+
+/* Free the vector returned by list_index_cache.  */
+
+static void
+free_index_cache_list (VEC (index_cache_entry_s) *entries)
+{
+  struct index_cache_entry *entry;
+  int ix;
+
+  for (ix = 0; VEC_iterate (index_cache_entry_s, entries, ix, entry); ++ix)
+    xfree (entry->name);
+  VEC_free (index_cache_entry_s, entries);
+}
+
+/* Remove the oldest files from the index cache until it uses at most
+   LIMIT bytes.  Return the number of files removed.  */
+
+static int
+prune_index_cache (ULONGEST limit)
+{
+  VEC (index_cache_entry_s) *entries = list_index_cache ();
+  struct index_cache_entry *entry;
+  ULONGEST total = 0;
+  int ix, removed = 0;
+
+  for (ix = 0; VEC_iterate (index_cache_entry_s, entries, ix, entry); ++ix)
+    total += entry->size;
+
+  for (ix = 0;
+       total > limit
+	 && VEC_iterate (index_cache_entry_s, entries, ix, entry);
+       ++ix)
+    {
+      char *path = concat (index_cache_directory, SLASH_STRING, entry->name,
+			   (char *) NULL);
+
+      if (unlink (path) == 0)
+	{
+	  total -= entry->size;
+	  ++removed;
+	}
+      xfree (path);
+    }
+
+  free_index_cache_list (entries);
+  return removed;
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache_stored (void)
+{
+  if (index_cache_size_limit != -1)
+    prune_index_cache ((ULONGEST) index_cache_size_limit * 1024 * 1024);
+}
+
+/* Implement "maint info index-cache".  */
+
+static void
+maintenance_info_index_cache (char *args, int from_tty)
+{
+  VEC (index_cache_entry_s) *entries;
+  struct index_cache_entry *entry;
+  ULONGEST total = 0;
+  int ix;
+
+  printf_filtered (_("Index cache directory: %s (%s)\n"),
+		   index_cache_directory != NULL ? index_cache_directory : "",
+		   index_cache_enabled ? _("enabled") : _("disabled"));
+  printf_filtered (_("Lookups since GDB started: %u hits, %u misses\n"),
+		   index_cache_hits, index_cache_misses);
+
+  entries = list_index_cache ();
+  for (ix = 0; VEC_iterate (index_cache_entry_s, entries, ix, entry); ++ix)
+    {
+      printf_filtered ("  %s  %s bytes\n", entry->name,
+		       pulongest (entry->size));
+      total += entry->size;
+    }
+
+  if (index_cache_size_limit == -1)
+    printf_filtered (_("%d files, %s bytes (no size limit)\n"),
+		     (int) VEC_length (index_cache_entry_s, entries),
+		     pulongest (total));
+  else
+    printf_filtered (_("%d files, %s bytes (limit %d MB)\n"),
+		     (int) VEC_length (index_cache_entry_s, entries),
+		     pulongest (total), index_cache_size_limit);
+
+  free_index_cache_list (entries);
+}
+
+/* Implement "maint prune-index-cache".  */
+
+static void
+maintenance_prune_index_cache (char *args, int from_tty)
+{
+  ULONGEST limit;
+  int removed;
+
+  if (args != NULL && *args != '\0')
+    {
+      LONGEST megabytes = parse_and_eval_long (args);
+
+      if (megabytes < 0)
+	error (_("Invalid size %s."), plongest (megabytes));
+      limit = (ULONGEST) megabytes * 1024 * 1024;
+    }
+  else if (index_cache_size_limit == -1)
+    error (_("The index cache has no size limit; "
+	     "specify the size to prune to in megabytes."));
+  else
+    limit = (ULONGEST) index_cache_size_limit * 1024 * 1024;
+
+  removed = prune_index_cache (limit);
+  printf_filtered (_("Removed %d files from the index cache.\n"), removed);
+}
+
+static struct cmd_list_element *set_index_cache_list;
+static struct cmd_list_element *show_index_cache_list;
+
+/* Implement "set index-cache".  */
+
+static void
+set_index_cache_command (char *args, int from_tty)
+{
+  help_list (set_index_cache_list, "set index-cache ", -1, gdb_stdout);
+}
+
+/* Implement "show index-cache".  */
+
+static void
+show_index_cache_command (char *args, int from_tty)
+{
+  cmd_show_list (show_index_cache_list, from_tty, "");
+}
+
+/* Implement "show index-cache enabled".  */
+
+static void
+show_index_cache_enabled (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The index cache is %s.\n"), value);
+}
+
+/* Implement "show index-cache directory".  */
+
+static void
+show_index_cache_directory (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The index cache directory is \"%s\".\n"),
+		    value);
+}
+
+/* Implement "show index-cache size-limit".  */
+
+static void
+show_index_cache_size_limit (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("The size limit of the index cache is %s "
+		      "megabytes.\n"),
+		    value);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_index_cache;
+
+void
+_initialize_index_cache (void)
+{
+  const char *cache_home = getenv ("XDG_CACHE_HOME");
+
+  if (cache_home != NULL && IS_ABSOLUTE_PATH (cache_home))
+    index_cache_directory = concat (cache_home, SLASH_STRING, "gdb",
+				    (char *) NULL);
+  else
+    {
+      const char *home = getenv ("HOME");
+
+      if (home != NULL)
+	index_cache_directory = concat (home, SLASH_STRING, ".cache",
+					SLASH_STRING, "gdb", (char *) NULL);
+    }
+
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command, _("\
+Set index cache options.\n\
+GDB can save the index it builds for a file without one in a cache\n\
+directory, and use it the next time the file is loaded."),
+		  &set_index_cache_list, "set index-cache ",
+		  0/*allow-unknown*/, &setlist);
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command, _("\
+Show index cache options."),
+		  &show_index_cache_list, "show index-cache ",
+		  0/*allow-unknown*/, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files, &index_cache_enabled, _("\
+Set whether GDB uses the index cache."), _("\
+Show whether GDB uses the index cache."), _("\
+When on, GDB looks for the index of a file without a .gdb_index section\n\
+in the index cache, and saves the index it builds otherwise.  Files are\n\
+identified by their build-id; files without one are not cached."),
+			   NULL, show_index_cache_enabled,
+			   &set_index_cache_list, &show_index_cache_list);
+
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("\
+Set the directory of the index cache."), _("\
+Show the directory of the index cache."), _("\
+The default is $XDG_CACHE_HOME/gdb, or $HOME/.cache/gdb."),
+			    NULL, show_index_cache_directory,
+			    &set_index_cache_list, &show_index_cache_list);
+
+  add_setshow_zuinteger_unlimited_cmd ("size-limit", class_files,
+				       &index_cache_size_limit, _("\
+Set the size limit of the index cache, in megabytes."), _("\
+Show the size limit of the index cache, in megabytes."), _("\
+When a new index makes the cache larger than this, the oldest files are\n\
+removed."),
+				       NULL, show_index_cache_size_limit,
+				       &set_index_cache_list,
+				       &show_index_cache_list);
+
+  add_cmd ("index-cache", class_maintenance, maintenance_info_index_cache,
+	   _("List the files in the index cache."),
+	   &maintenanceinfolist);
+
+  add_cmd ("prune-index-cache", class_maintenance,
+	   maintenance_prune_index_cache, _("\
+Remove the oldest files from the index cache.\n\
+Usage: maintenance prune-index-cache [MEGABYTES]\n\
+Files are removed until the cache is no larger than MEGABYTES, which\n\
+defaults to the size limit of the cache (see \"set index-cache size-limit\")."),
+	   &maintenancelist);
+}
@@ -0,0 +1,52 @@
+/* Caching of GDB index files.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INDEX_CACHE_H
+#define INDEX_CACHE_H
+
+/* The index cache is a directory of .gdb_index files that GDB writes
+   for objfiles that have none, so that they load quickly the next
+   time.  Each file is named after the build-id of the objfile it
+   belongs to.  */
+
+/* Return non-zero if the index cache is enabled and has a
+   directory.  */
+
+extern int index_cache_enabled_p (void);
+
+/* Return the name of the file in the index cache that holds the index
+   of ABFD, in a malloc'd string.  If CREATE is non-zero, also create
+   the cache directory if needed.  Return NULL if the index cache is
+   disabled, ABFD has no build-id, or the directory cannot be
+   created.  */
+
+extern char *index_cache_file_name (bfd *abfd, int create);
+
+/* Read the cached index of ABFD into memory allocated on OBSTACK, and
+   store its size in *SIZE.  Return NULL if there is no such index.  */
+
+extern const gdb_byte *index_cache_lookup (bfd *abfd, struct obstack *obstack,
+					   bfd_size_type *size);
+
+/* Called after a file has been added to the index cache.  Remove the
+   oldest files until the cache fits in its size limit.  */
+
+extern void index_cache_stored (void);
+
+#endif /* INDEX_CACHE_H */
@@ -51,6 +51,7 @@
 #include "cp-support.h"
 #include "language.h"
 #include "cli/cli-utils.h"
+#include "name-index.h"
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -173,6 +174,7 @@ lookup_minimal_symbol_internal (const char *name, const char *sfile,
 
   int needtofreename = 0;
   const char *modified_name;
+  struct name_index_search search;
 
   if (sfile != NULL)
     sfile = lbasename (sfile);
@@ -190,14 +192,25 @@ lookup_minimal_symbol_internal (const char *name, const char *sfile,
 	}
     }
 
+  /* When searching every objfile, skip those that have no symbol of
+     that name.  */
+  if (objf == NULL && !name_index_start_search (&search, modified_name))
+    {
+      if (needtofreename)
+	xfree ((void *) modified_name);
+      return found_symbol;
+    }
+
   for (objfile = object_files;
        objfile != NULL && found_symbol.minsym == NULL;
        objfile = objfile->next)
     {
       struct minimal_symbol *msymbol;
 
-      if (objf == NULL || objf == objfile
-	  || objf == objfile->separate_debug_objfile_backlink)
+      if (objf == NULL
+	  ? name_index_objfile_p (&search, objfile)
+	  : (objf == objfile
+	     || objf == objfile->separate_debug_objfile_backlink))
 	{
 	  /* Do two passes: the first over the ordinary hash table,
 	     and the second over the demangled hash table.  */
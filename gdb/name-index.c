@@ -0,0 +1,433 @@
+/* An index of the symbol names of each program space, for GDB.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "symtab.h"
+#include "symfile.h"
+#include "objfiles.h"
+#include "progspace.h"
+#include "block.h"
+#include "minsyms.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "psymtab.h"
+#include "name-index.h"
+
+/* Without the index, a lookup of a name that is not defined, or only
+   defined in the last of many objfiles, searches each objfile in turn:
+   the full symtabs, the minimal symbol hash tables and, worst of all,
+   each partial symtab with a binary search.
+
+   The index records, for each objfile, the set of keys of the names of
+   its minimal, partial (or .gdb_index) and full symbols, and for each
+   program space how many of its objfiles have each key.  The key of a
+   name is its msymbol_hash_iw hash, so that names strcmp_iw considers
+   equal have the same key.  Partial symbols are indexed by their
+   linkage names, and by their demangled names only when those are
+   already known or the linkage name looks mangled, so that building
+   the index does not demangle every partial symbol.
+
+   The index of an objfile is built the first time a lookup needs it,
+   and is extended when the objfile gets new symbols, e.g. when one of
+   its symtabs is expanded.  The partial symbols of an objfile are not
+   read just to index them: until they have been read for some other
+   reason, the objfile is searched by every lookup.  */
+
+/* Nonzero if lookups use the name index.  */
+
+static int name_index_enabled = 1;
+
+/* How many objfiles of a program space have a key.  */
+
+struct name_index_count
+{
+  unsigned int key;
+  unsigned int count;
+};
+
+/* The name index of a program space.  */
+
+struct pspace_name_index
+{
+  /* The struct name_index_count of each key that at least one objfile
+     of the program space has.  */
+
+  htab_t counts;
+};
+
+/* The name index of an objfile.  */
+
+struct objfile_name_index
+{
+  /* The keys of the names of the symbols of the objfile.  They are
+     stored directly in the table, cast to pointers.  */
+
+  htab_t keys;
+
+  /* Nonzero once the names known to the quick symbol functions of the
+     objfile, e.g. those of its partial symbols, are in KEYS.  */
+
+  int quick_indexed;
+
+  /* The partial symtabs, symtabs and minimal symbols of the objfile
+     when it was last indexed.  New psymtabs and symtabs are put at the
+     front of their lists, so those up to these ones are new.  */
+
+  struct partial_symtab *psymtabs;
+  struct symtab *symtabs;
+  struct minimal_symbol *msymbols;
+};
+
+static const struct program_space_data *pspace_name_index_key;
+static const struct objfile_data *objfile_name_index_key;
+
+/* Return the key of NAME.  The top bit is always set, so that no key
+   looks like the empty or deleted entry of a hash table.  */
+
+static unsigned int
+name_index_key (const char *name)
+{
+  return msymbol_hash_iw (name) | 0x80000000u;
+}
+
+/* Hash and equality functions for the counts of a program space.  */
+
+static hashval_t
+hash_name_index_count (const void *p)
+{
+  const struct name_index_count *count = p;
+
+  return count->key;
+}
+
+static int
+eq_name_index_count (const void *a, const void *b)
+{
+  const struct name_index_count *count_a = a;
+  const struct name_index_count *count_b = b;
+
+  return count_a->key == count_b->key;
+}
+
+/* Hash function for the keys of an objfile.  */
+
+static hashval_t
+hash_name_index_key (const void *p)
+{
+  return (hashval_t) (uintptr_t) p;
+}
+
+/* Return the name index of PSPACE, creating it if needed.  */
+
+static struct pspace_name_index *
+get_pspace_name_index (struct program_space *pspace)
+{
+  struct pspace_name_index *index;
+
+  index = program_space_data (pspace, pspace_name_index_key);
+  if (index == NULL)
+    {
+      index = XCNEW (struct pspace_name_index);
+      index->counts = htab_create_alloc (1024, hash_name_index_count,
+					 eq_name_index_count, xfree,
+					 xcalloc, xfree);
+      set_program_space_data (pspace, pspace_name_index_key, index);
+    }
+
+  return index;
+}
+
+/* Free the name index of a program space.  */
+
+static void
+free_pspace_name_index (struct program_space *pspace, void *arg)
+{
+  struct pspace_name_index *index = arg;
+
+  htab_delete (index->counts);
+  xfree (index);
+}
+
+/* Add DELTA to the number of objfiles of PSPACE that have KEY.  */
+
+static void
+adjust_name_index_count (struct program_space *pspace, unsigned int key,
+			 int delta)
+{
+  struct pspace_name_index *index = get_pspace_name_index (pspace);
+  struct name_index_count entry, *count;
+  void **slot;
+
+  entry.key = key;
+  slot = htab_find_slot_with_hash (index->counts, &entry, key,
+				   delta > 0 ? INSERT : NO_INSERT);
+  if (slot == NULL)
+    return;
+
+  count = *slot;
+  if (count == NULL)
+    {
+      count = XNEW (struct name_index_count);
+      count->key = key;
+      count->count = 0;
+      *slot = count;
+    }
+
+  count->count += delta;
+  if (count->count == 0)
+    htab_clear_slot (index->counts, slot);
+}
+
+/* Callback for free_objfile_name_index, via htab_traverse.  DATA is
+   the objfile.  */
+
+static int
+release_name_index_key (void **slot, void *data)
+{
+  struct objfile *objfile = data;
+
+  adjust_name_index_count (objfile->pspace, (uintptr_t) *slot, -1);
+  return 1;
+}
+
+/* Free the name index of OBJFILE, and forget its keys in the index of
+   its program space.  This is also called when the symbols of OBJFILE
+   are reread.  */
+
+static void
+free_objfile_name_index (struct objfile *objfile, void *arg)
+{
+  struct objfile_name_index *index = arg;
+
+  htab_traverse_noresize (index->keys, release_name_index_key, objfile);
+  htab_delete (index->keys);
+  xfree (index);
+}
+
+/* Add the key of NAME to the index of OBJFILE.  */
+
+static void
+add_name_to_index (struct objfile *objfile, struct objfile_name_index *index,
+		   const char *name)
+{
+  unsigned int key = name_index_key (name);
+  void **slot;
+
+  slot = htab_find_slot_with_hash (index->keys, (void *) (uintptr_t) key,
+				   key, INSERT);
+  if (*slot == NULL)
+    {
+      *slot = (void *) (uintptr_t) key;
+      adjust_name_index_count (objfile->pspace, key, 1);
+    }
+}
+
+/* The data passed to add_quick_name_to_index.  */
+
+struct add_quick_name_data
+{
+  struct objfile *objfile;
+  struct objfile_name_index *index;
+};
+
+/* A name matcher for the expand_symtabs_matching quick symbol function
+   that adds each name to the index, and matches nothing.  This is also
+   the callback for map_partial_symbol_search_names.  */
+
+static int
+add_quick_name_to_index (const char *name, void *arg)
+{
+  struct add_quick_name_data *data = arg;
+
+  add_name_to_index (data->objfile, data->index, name);
+  return 0;
+}
+
+/* Return nonzero if the partial symbols of OBJFILE have been read, or
+   there is nothing to read.  */
+
+static int
+quick_symbols_read_p (struct objfile *objfile)
+{
+  return (objfile->sf == NULL
+	  || (objfile->flags & OBJF_PSYMTABS_READ) != 0
+	  || objfile->sf->sym_read_psymbols == NULL);
+}
+
+/* Bring the index of OBJFILE up to date, and return it.  */
+
+static struct objfile_name_index *
+update_objfile_name_index (struct objfile *objfile)
+{
+  struct objfile_name_index *index;
+  struct symtab *s;
+
+  index = objfile_data (objfile, objfile_name_index_key);
+  if (index == NULL)
+    {
+      index = XCNEW (struct objfile_name_index);
+      index->keys = htab_create_alloc (256, hash_name_index_key,
+				       htab_eq_pointer, NULL,
+				       xcalloc, xfree);
+      set_objfile_data (objfile, objfile_name_index_key, index);
+    }
+
+  if (objfile->msymbols != NULL && index->msymbols != objfile->msymbols)
+    {
+      struct minimal_symbol *msymbol;
+
+      ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
+	{
+	  add_name_to_index (objfile, index, SYMBOL_LINKAGE_NAME (msymbol));
+	  if (SYMBOL_SEARCH_NAME (msymbol) != SYMBOL_LINKAGE_NAME (msymbol))
+	    add_name_to_index (objfile, index, SYMBOL_SEARCH_NAME (msymbol));
+	}
+      index->msymbols = objfile->msymbols;
+    }
+
+  if (quick_symbols_read_p (objfile)
+      && (!index->quick_indexed || index->psymtabs != objfile->psymtabs))
+    {
+      if (objfile->sf != NULL)
+	{
+	  struct add_quick_name_data data;
+
+	  data.objfile = objfile;
+	  data.index = index;
+	  /* Matching each partial symbol would demangle its name; see
+	     map_partial_symbol_search_names.  */
+	  if (objfile->sf->qf == &psym_functions)
+	    map_partial_symbol_search_names (objfile,
+					     add_quick_name_to_index, &data);
+	  else
+	    objfile->sf->qf->expand_symtabs_matching (objfile, NULL,
+						      add_quick_name_to_index,
+						      ALL_DOMAIN, &data);
+	}
+      index->quick_indexed = 1;
+      index->psymtabs = objfile->psymtabs;
+    }
+
+  for (s = objfile->symtabs; s != index->symtabs; s = s->next)
+    {
+      int i;
+
+      if (!s->primary || BLOCKVECTOR (s) == NULL)
+	continue;
+
+      for (i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
+	{
+	  struct block_iterator iter;
+	  struct symbol *sym;
+
+	  ALL_BLOCK_SYMBOLS (BLOCKVECTOR_BLOCK (BLOCKVECTOR (s), i),
+			     iter, sym)
+	    add_name_to_index (objfile, index, SYMBOL_SEARCH_NAME (sym));
+	}
+    }
+  index->symtabs = objfile->symtabs;
+
+  return index;
+}
+
+/* See name-index.h.  */
+
+int
+name_index_start_search (struct name_index_search *search, const char *name)
+{
+  struct pspace_name_index *pspace_index;
+  struct name_index_count entry;
+  struct objfile *objfile;
+
+  search->key = name_index_key (name);
+  search->search_all = !name_index_enabled;
+  if (search->search_all)
+    return 1;
+
+  ALL_OBJFILES (objfile)
+    {
+      struct objfile_name_index *index;
+
+      index = update_objfile_name_index (objfile);
+      if (!index->quick_indexed)
+	search->search_all = 1;
+    }
+
+  if (search->search_all)
+    return 1;
+
+  pspace_index = get_pspace_name_index (current_program_space);
+  entry.key = search->key;
+  return htab_find_with_hash (pspace_index->counts, &entry,
+			      search->key) != NULL;
+}
+
+/* See name-index.h.  */
+
+int
+name_index_objfile_p (const struct name_index_search *search,
+		      struct objfile *objfile)
+{
+  struct objfile_name_index *index;
+  unsigned int key = search->key;
+
+  if (!name_index_enabled)
+    return 1;
+
+  index = update_objfile_name_index (objfile);
+  if (!index->quick_indexed)
+    return 1;
+
+  return htab_find_with_hash (index->keys, (void *) (uintptr_t) key,
+			      key) != NULL;
+}
+
+/* Implement "maint show symbol-name-index".  */
+
+static void
+show_name_index_enabled (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Whether symbol lookups use the symbol name "
+			    "index is %s.\n"), value);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_name_index;
+
+void
+_initialize_name_index (void)
+{
+  pspace_name_index_key
+    = register_program_space_data_with_cleanup (NULL,
+						free_pspace_name_index);
+  objfile_name_index_key
+    = register_objfile_data_with_cleanup (NULL, free_objfile_name_index);
+
+  add_setshow_boolean_cmd ("symbol-name-index", class_maintenance,
+			   &name_index_enabled, _("\
+Set whether symbol lookups use the symbol name index."), _("\
+Show whether symbol lookups use the symbol name index."), _("\
+When on, lookups of a name in all object files skip the object files\n\
+that have no symbol of that name, using an index of the names of each\n\
+object file that GDB builds when it is first needed."),
+			   NULL, show_name_index_enabled,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+}
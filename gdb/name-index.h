@@ -0,0 +1,57 @@
+/* An index of the symbol names of each program space, for GDB.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+struct objfile;
+
+/* Lookups that search every objfile of the current program space for
+   a name, such as lookup_symbol_aux_symtabs or lookup_minimal_symbol,
+   use the name index to skip the objfiles that cannot define a symbol
+   of that name.  The index never rules out an objfile that could, but
+   may let a few through that do not.  */
+
+struct name_index_search
+{
+  /* The key of the name searched for.  */
+
+  unsigned int key;
+
+  /* Nonzero if the index is not used, and every objfile has to be
+     searched.  */
+
+  int search_all;
+};
+
+/* Prepare SEARCH for a lookup of NAME in the objfiles of the current
+   program space, bringing the index up to date first.  Return zero if
+   no objfile can define a symbol named NAME, in which case the lookup
+   can stop right away.  */
+
+extern int name_index_start_search (struct name_index_search *search,
+				    const char *name);
+
+/* Return nonzero if OBJFILE may define a symbol with the name SEARCH
+   was started with.  */
+
+extern int name_index_objfile_p (const struct name_index_search *search,
+				 struct objfile *objfile);
+
+#endif /* NAME_INDEX_H */
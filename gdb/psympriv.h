@@ -24,6 +24,35 @@
 
 struct psymbol_allocation_list;
 
+/* The name of one or more partial symbols.  Partial symbols do not
+   carry their own copy of a demangled name: all of the partial
+   symbols of an objfile with the same linkage name and language share
+   one of these, and the demangled name is only computed the first time
+   it is asked for, e.g. to print or match the symbol.  */
+
+struct psymbol_name
+{
+  /* The linkage name.  For languages like C++ that make a distinction
+     between the mangled name and demangled name, this is the mangled
+     name.  It is either copied to the partial symbol bcache or stored
+     permanently elsewhere, e.g. in a debug section.  */
+
+  const char *linkage_name;
+
+  /* The demangled name, NULL if there is none, or
+     psymbol_name_not_demangled if it has not been computed yet.  */
+
+  const char *demangled_name;
+
+  /* The language of the partial symbols.  */
+
+  ENUM_BITFIELD(language) language : 8;
+};
+
+/* See struct psymbol_name.  */
+
+extern const char psymbol_name_not_demangled[];
+
 /* A partial_symbol records the name, domain, and address class of
    symbols whose types we have not parsed yet.  For functions, it also
    contains their memory address, so we can find them from a PC value.
@@ -32,14 +61,26 @@ struct psymbol_allocation_list;
    normal symtab once the partial_symtab has been referenced.  */
 
 /* This structure is space critical.  See space comments at the top of
-   symtab.h.  */
+   symtab.h.  Unlike the other kinds of symbols, it does not use a
+   general_symbol_info: it has no language specific data, and its
+   name is shared with the other partial symbols of the same name.  */
 
 struct partial_symbol
 {
+  /* Value of the symbol.  This is an address for LOC_STATIC,
+     LOC_LABEL and LOC_BLOCK symbols, and a constant otherwise.  */
 
-  /* The general symbol info required for all types of symbols.  */
+  union
+  {
+    LONGEST ivalue;
+
+    CORE_ADDR address;
+  }
+  value;
+
+  /* The name of the symbol.  */
 
-  struct general_symbol_info ginfo;
+  struct psymbol_name *name;
 
   /* Name space code.  */
 
@@ -51,10 +92,40 @@ struct partial_symbol
 
   ENUM_BITFIELD(address_class) aclass : 6;
 
+  /* Which section is this symbol in?  This is an index into
+     section_offsets for this objfile.  Negative means that the symbol
+     does not get relocated relative to a section.  */
+
+  short section;
 };
 
 #define PSYMBOL_DOMAIN(psymbol)	(psymbol)->domain
 #define PSYMBOL_CLASS(psymbol)		(psymbol)->aclass
+#define PSYMBOL_VALUE(psymbol)		(psymbol)->value.ivalue
+#define PSYMBOL_VALUE_ADDRESS(psymbol)	(psymbol)->value.address
+#define PSYMBOL_LANGUAGE(psymbol)	(psymbol)->name->language
+#define PSYMBOL_SECTION(psymbol)	(psymbol)->section
+#define PSYMBOL_OBJ_SECTION(objfile, psymbol)			\
+  (((psymbol)->section >= 0)					\
+   ? (&(((objfile)->sections)[(psymbol)->section]))		\
+   : NULL)
+
+/* The partial symbol counterparts of SYMBOL_LINKAGE_NAME,
+   SYMBOL_NATURAL_NAME, SYMBOL_DEMANGLED_NAME, SYMBOL_SEARCH_NAME and
+   SYMBOL_MATCHES_SEARCH_NAME.  */
+
+#define PSYMBOL_LINKAGE_NAME(psymbol)	(psymbol)->name->linkage_name
+#define PSYMBOL_NATURAL_NAME(psymbol)	psymbol_natural_name (psymbol)
+#define PSYMBOL_DEMANGLED_NAME(psymbol)	psymbol_demangled_name (psymbol)
+#define PSYMBOL_SEARCH_NAME(psymbol)	psymbol_search_name (psymbol)
+#define PSYMBOL_MATCHES_SEARCH_NAME(psymbol, name)			\
+  (strcmp_iw (PSYMBOL_SEARCH_NAME (psymbol), (name)) == 0)
+
+extern const char *psymbol_natural_name (const struct partial_symbol *);
+
+extern const char *psymbol_demangled_name (const struct partial_symbol *);
+
+extern const char *psymbol_search_name (const struct partial_symbol *);
 
 /* A convenience enum to give names to some constants used when
    searching psymtabs.  This is internal to psymtab and should not be
@@ -202,6 +273,16 @@ struct partial_symtab
 
   void (*read_symtab) (struct partial_symtab *, struct objfile *);
 
+  /* If non-NULL, a function called before the symtabs of several
+     psymtabs of an objfile, given as an array and its length, are read
+     in one after the other; this psymtab is one of them.  It may start
+     reading them ahead of time, e.g. on worker threads, and returns a
+     cleanup that stops this.  It must ignore the psymtabs of other
+     symbol readers.  */
+
+  struct cleanup *(*read_symtabs_ahead) (struct objfile *,
+					 struct partial_symtab **, int);
+
   /* Information that lets read_symtab() locate the part of the symbol table
      that this psymtab corresponds to.  This information is private to the
      format-dependent symbol reading routines.  For further detail examine
@@ -36,6 +36,8 @@
 #include "language.h"
 #include "cp-support.h"
 #include "gdbcmd.h"
+#include "gdb_obstack.h"
+#include "ada-lang.h"
 
 #ifndef DEV_TTY
 #define DEV_TTY "/dev/tty"
@@ -44,6 +46,16 @@
 struct psymbol_bcache
 {
   struct bcache *bcache;
+
+  /* The names of the partial symbols, a table of struct psymbol_name
+     keyed by linkage name and language.  */
+
+  htab_t names;
+
+  /* The storage for the entries of NAMES, and for the linkage names
+     that have to be copied.  */
+
+  struct obstack name_obstack;
 };
 
 static struct partial_symbol *match_partial_symbol (struct objfile *,
@@ -265,7 +277,7 @@ find_pc_sect_psymtab_closer (struct objfile *objfile,
 	     object's symbol table.  */
 	  p = find_pc_sect_psymbol (objfile, tpst, pc, section);
 	  if (p != NULL
-	      && SYMBOL_VALUE_ADDRESS (p)
+	      && PSYMBOL_VALUE_ADDRESS (p)
 	      == SYMBOL_VALUE_ADDRESS (msymbol))
 	    return tpst;
 
@@ -274,7 +286,7 @@ find_pc_sect_psymtab_closer (struct objfile *objfile,
 	     symbol tables with line information but no debug
 	     symbols (e.g. those produced by an assembler).  */
 	  if (p != NULL)
-	    this_addr = SYMBOL_VALUE_ADDRESS (p);
+	    this_addr = PSYMBOL_VALUE_ADDRESS (p);
 	  else
 	    this_addr = tpst->textlow;
 
@@ -330,7 +342,7 @@ find_pc_sect_psymtab (struct objfile *objfile, CORE_ADDR pc,
 		 object's symbol table.  */
 	      p = find_pc_sect_psymbol (objfile, pst, pc, section);
 	      if (!p
-		  || SYMBOL_VALUE_ADDRESS (p)
+		  || PSYMBOL_VALUE_ADDRESS (p)
 		  != SYMBOL_VALUE_ADDRESS (msymbol))
 		goto next;
 	    }
@@ -419,21 +431,21 @@ find_pc_sect_psymbol (struct objfile *objfile,
        pp++)
     {
       p = *pp;
-      if (SYMBOL_DOMAIN (p) == VAR_DOMAIN
+      if (PSYMBOL_DOMAIN (p) == VAR_DOMAIN
 	  && PSYMBOL_CLASS (p) == LOC_BLOCK
-	  && pc >= SYMBOL_VALUE_ADDRESS (p)
-	  && (SYMBOL_VALUE_ADDRESS (p) > best_pc
+	  && pc >= PSYMBOL_VALUE_ADDRESS (p)
+	  && (PSYMBOL_VALUE_ADDRESS (p) > best_pc
 	      || (psymtab->textlow == 0
-		  && best_pc == 0 && SYMBOL_VALUE_ADDRESS (p) == 0)))
+		  && best_pc == 0 && PSYMBOL_VALUE_ADDRESS (p) == 0)))
 	{
 	  if (section)		/* Match on a specific section.  */
 	    {
 	      fixup_psymbol_section (p, objfile);
-	      if (!matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, p),
+	      if (!matching_obj_sections (PSYMBOL_OBJ_SECTION (objfile, p),
 					  section))
 		continue;
 	    }
-	  best_pc = SYMBOL_VALUE_ADDRESS (p);
+	  best_pc = PSYMBOL_VALUE_ADDRESS (p);
 	  best = p;
 	}
     }
@@ -444,21 +456,21 @@ find_pc_sect_psymbol (struct objfile *objfile,
        pp++)
     {
       p = *pp;
-      if (SYMBOL_DOMAIN (p) == VAR_DOMAIN
+      if (PSYMBOL_DOMAIN (p) == VAR_DOMAIN
 	  && PSYMBOL_CLASS (p) == LOC_BLOCK
-	  && pc >= SYMBOL_VALUE_ADDRESS (p)
-	  && (SYMBOL_VALUE_ADDRESS (p) > best_pc
+	  && pc >= PSYMBOL_VALUE_ADDRESS (p)
+	  && (PSYMBOL_VALUE_ADDRESS (p) > best_pc
 	      || (psymtab->textlow == 0
-		  && best_pc == 0 && SYMBOL_VALUE_ADDRESS (p) == 0)))
+		  && best_pc == 0 && PSYMBOL_VALUE_ADDRESS (p) == 0)))
 	{
 	  if (section)		/* Match on a specific section.  */
 	    {
 	      fixup_psymbol_section (p, objfile);
-	      if (!matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, p),
+	      if (!matching_obj_sections (PSYMBOL_OBJ_SECTION (objfile, p),
 					  section))
 		continue;
 	    }
-	  best_pc = SYMBOL_VALUE_ADDRESS (p);
+	  best_pc = PSYMBOL_VALUE_ADDRESS (p);
 	  best = p;
 	}
     }
@@ -469,12 +481,13 @@ find_pc_sect_psymbol (struct objfile *objfile,
 static void
 fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
 {
+  struct general_symbol_info ginfo;
   CORE_ADDR addr;
 
   if (!psym)
     return;
 
-  if (SYMBOL_SECTION (psym) >= 0)
+  if (PSYMBOL_SECTION (psym) >= 0)
     return;
 
   gdb_assert (objfile);
@@ -484,7 +497,7 @@ fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
     case LOC_STATIC:
     case LOC_LABEL:
     case LOC_BLOCK:
-      addr = SYMBOL_VALUE_ADDRESS (psym);
+      addr = PSYMBOL_VALUE_ADDRESS (psym);
       break;
     default:
       /* Nothing else will be listed in the minsyms -- no use looking
@@ -492,7 +505,13 @@ fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
       return;
     }
 
-  fixup_section (&psym->ginfo, addr, objfile);
+  /* fixup_section works on the general symbol info of full and
+     minimal symbols; give it one that only carries our name.  */
+  memset (&ginfo, 0, sizeof (ginfo));
+  ginfo.name = PSYMBOL_LINKAGE_NAME (psym);
+  ginfo.section = -1;
+  fixup_section (&ginfo, addr, objfile);
+  PSYMBOL_SECTION (psym) = ginfo.section;
 }
 
 static struct symtab *
@@ -582,9 +601,9 @@ match_partial_symbol (struct objfile *objfile,
 	  center = bottom + (top - bottom) / 2;
 	  gdb_assert (center < top);
 	  if (!do_linear_search
-	      && (SYMBOL_LANGUAGE (*center) == language_java))
+	      && (PSYMBOL_LANGUAGE (*center) == language_java))
 	    do_linear_search = 1;
-	  if (ordered_compare (SYMBOL_SEARCH_NAME (*center), name) >= 0)
+	  if (ordered_compare (PSYMBOL_SEARCH_NAME (*center), name) >= 0)
 	    top = center;
 	  else
 	    bottom = center + 1;
@@ -592,10 +611,10 @@ match_partial_symbol (struct objfile *objfile,
       gdb_assert (top == bottom);
 
       while (top <= real_top
-	     && match (SYMBOL_SEARCH_NAME (*top), name) == 0)
+	     && match (PSYMBOL_SEARCH_NAME (*top), name) == 0)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*top),
-				     SYMBOL_DOMAIN (*top), domain))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*top),
+				     PSYMBOL_DOMAIN (*top), domain))
 	    return *top;
 	  top++;
 	}
@@ -608,9 +627,9 @@ match_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*psym),
-				     SYMBOL_DOMAIN (*psym), domain)
-	      && match (SYMBOL_SEARCH_NAME (*psym), name) == 0)
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*psym),
+				     PSYMBOL_DOMAIN (*psym), domain)
+	      && match (PSYMBOL_SEARCH_NAME (*psym), name) == 0)
 	    return *psym;
 	}
     }
@@ -697,11 +716,11 @@ lookup_partial_symbol (struct objfile *objfile,
 	    internal_error (__FILE__, __LINE__,
 			    _("failed internal consistency check"));
 	  if (!do_linear_search
-	      && SYMBOL_LANGUAGE (*center) == language_java)
+	      && PSYMBOL_LANGUAGE (*center) == language_java)
 	    {
 	      do_linear_search = 1;
 	    }
-	  if (strcmp_iw_ordered (SYMBOL_SEARCH_NAME (*center),
+	  if (strcmp_iw_ordered (PSYMBOL_SEARCH_NAME (*center),
 				 search_name) >= 0)
 	    {
 	      top = center;
@@ -716,17 +735,17 @@ lookup_partial_symbol (struct objfile *objfile,
 			_("failed internal consistency check"));
 
       /* For `case_sensitivity == case_sensitive_off' strcmp_iw_ordered will
-	 search more exactly than what matches SYMBOL_MATCHES_SEARCH_NAME.  */
-      while (top >= start && SYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
+	 search more exactly than what matches PSYMBOL_MATCHES_SEARCH_NAME.  */
+      while (top >= start && PSYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
 	top--;
 
-      /* Fixup to have a symbol which matches SYMBOL_MATCHES_SEARCH_NAME.  */
+      /* Fixup to have a symbol which matches PSYMBOL_MATCHES_SEARCH_NAME.  */
       top++;
 
-      while (top <= real_top && SYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
+      while (top <= real_top && PSYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*top),
-				     SYMBOL_DOMAIN (*top), domain))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*top),
+				     PSYMBOL_DOMAIN (*top), domain))
 	    {
 	      do_cleanups (cleanup);
 	      return (*top);
@@ -742,9 +761,9 @@ lookup_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*psym),
-				     SYMBOL_DOMAIN (*psym), domain)
-	      && SYMBOL_MATCHES_SEARCH_NAME (*psym, search_name))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*psym),
+				     PSYMBOL_DOMAIN (*psym), domain)
+	      && PSYMBOL_MATCHES_SEARCH_NAME (*psym, search_name))
 	    {
 	      do_cleanups (cleanup);
 	      return (*psym);
@@ -783,6 +802,35 @@ psymtab_to_symtab (struct objfile *objfile, struct partial_symtab *pst)
   return pst->symtab;
 }
 
+typedef struct partial_symtab *partial_symtab_p;
+DEF_VEC_P (partial_symtab_p);
+
+/* Get the symbol tables that correspond to the psymtabs PSTS of
+   OBJFILE, in order, as psymtab_to_symtab would for each of them.  */
+
+static void
+psymtabs_to_symtabs (struct objfile *objfile, VEC (partial_symtab_p) *psts)
+{
+  struct cleanup *back_to = make_cleanup (null_cleanup, NULL);
+  struct partial_symtab *pst;
+  int ix;
+
+  /* Let the symbol reader read them ahead of time.  Once is enough.  */
+  for (ix = 0; VEC_iterate (partial_symtab_p, psts, ix, pst); ++ix)
+    if (pst->read_symtabs_ahead != NULL)
+      {
+	(*pst->read_symtabs_ahead) (objfile,
+				    VEC_address (partial_symtab_p, psts),
+				    VEC_length (partial_symtab_p, psts));
+	break;
+      }
+
+  for (ix = 0; VEC_iterate (partial_symtab_p, psts, ix, pst); ++ix)
+    psymtab_to_symtab (objfile, pst);
+
+  do_cleanups (back_to);
+}
+
 static void
 relocate_psymtabs (struct objfile *objfile,
 		   const struct section_offsets *new_offsets,
@@ -802,18 +850,18 @@ relocate_psymtabs (struct objfile *objfile,
        psym++)
     {
       fixup_psymbol_section (*psym, objfile);
-      if (SYMBOL_SECTION (*psym) >= 0)
-	SYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
-						  SYMBOL_SECTION (*psym));
+      if (PSYMBOL_SECTION (*psym) >= 0)
+	PSYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
+						  PSYMBOL_SECTION (*psym));
     }
   for (psym = objfile->static_psymbols.list;
        psym < objfile->static_psymbols.next;
        psym++)
     {
       fixup_psymbol_section (*psym, objfile);
-      if (SYMBOL_SECTION (*psym) >= 0)
-	SYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
-						  SYMBOL_SECTION (*psym));
+      if (PSYMBOL_SECTION (*psym) >= 0)
+	PSYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
+						  PSYMBOL_SECTION (*psym));
     }
 }
 
@@ -871,13 +919,13 @@ print_partial_symbols (struct gdbarch *gdbarch,
   while (count-- > 0)
     {
       QUIT;
-      fprintf_filtered (outfile, "    `%s'", SYMBOL_LINKAGE_NAME (*p));
-      if (SYMBOL_DEMANGLED_NAME (*p) != NULL)
+      fprintf_filtered (outfile, "    `%s'", PSYMBOL_LINKAGE_NAME (*p));
+      if (PSYMBOL_DEMANGLED_NAME (*p) != NULL)
 	{
-	  fprintf_filtered (outfile, "  `%s'", SYMBOL_DEMANGLED_NAME (*p));
+	  fprintf_filtered (outfile, "  `%s'", PSYMBOL_DEMANGLED_NAME (*p));
 	}
       fputs_filtered (", ", outfile);
-      switch (SYMBOL_DOMAIN (*p))
+      switch (PSYMBOL_DOMAIN (*p))
 	{
 	case UNDEF_DOMAIN:
 	  fputs_filtered ("undefined domain, ", outfile);
@@ -947,7 +995,7 @@ print_partial_symbols (struct gdbarch *gdbarch,
 	  break;
 	}
       fputs_filtered (", ", outfile);
-      fputs_filtered (paddress (gdbarch, SYMBOL_VALUE_ADDRESS (*p)), outfile);
+      fputs_filtered (paddress (gdbarch, PSYMBOL_VALUE_ADDRESS (*p)), outfile);
       fprintf_filtered (outfile, "\n");
       p++;
     }
@@ -1101,11 +1149,18 @@ static void
 expand_partial_symbol_tables (struct objfile *objfile)
 {
   struct partial_symtab *psymtab;
+  VEC (partial_symtab_p) *psts = NULL;
+  struct cleanup *cleanup;
+
+  cleanup = make_cleanup (VEC_cleanup (partial_symtab_p), &psts);
 
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, psymtab)
     {
-      psymtab_to_symtab (objfile, psymtab);
+      VEC_safe_push (partial_symtab_p, psts, psymtab);
     }
+
+  psymtabs_to_symtabs (objfile, psts);
+  do_cleanups (cleanup);
 }
 
 static void
@@ -1346,7 +1401,7 @@ recursively_search_psymtabs (struct partial_symtab *ps,
 		   && PSYMBOL_CLASS (*psym) == LOC_BLOCK)
 	       || (kind == TYPES_DOMAIN
 		   && PSYMBOL_CLASS (*psym) == LOC_TYPEDEF))
-	      && (*name_matcher) (SYMBOL_SEARCH_NAME (*psym), data))
+	      && (*name_matcher) (PSYMBOL_SEARCH_NAME (*psym), data))
 	    {
 	      /* Found a match, so notify our caller.  */
 	      result = PST_SEARCHED_AND_FOUND;
@@ -1369,6 +1424,10 @@ expand_symtabs_matching_via_partial
    void *data)
 {
   struct partial_symtab *ps;
+  VEC (partial_symtab_p) *to_expand = NULL;
+  struct cleanup *cleanup;
+
+  cleanup = make_cleanup (VEC_cleanup (partial_symtab_p), &to_expand);
 
   /* Clear the search flags.  */
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
@@ -1407,8 +1466,11 @@ expand_symtabs_matching_via_partial
 	}
 
       if (recursively_search_psymtabs (ps, objfile, kind, name_matcher, data))
-	psymtab_to_symtab (objfile, ps);
+	VEC_safe_push (partial_symtab_p, to_expand, ps);
     }
+
+  psymtabs_to_symtabs (objfile, to_expand);
+  do_cleanups (cleanup);
 }
 
 static int
@@ -1439,7 +1501,13 @@ const struct quick_symbol_functions psym_functions =
 
 
 /* This compares two partial symbols by names, using strcmp_iw_ordered
-   for the comparison.  */
+   for the comparison.
+
+   lookup_partial_symbol does a binary search on the search names, so
+   this has to compare them too, and that demangles the names of all
+   the global partial symbols when they are sorted.  Only the names of
+   the static partial symbols, which are not sorted, stay un-demangled
+   until they are needed.  */
 
 static int
 compare_psymbols (const void *s1p, const void *s2p)
@@ -1447,8 +1515,8 @@ compare_psymbols (const void *s1p, const void *s2p)
   struct partial_symbol *const *s1 = s1p;
   struct partial_symbol *const *s2 = s2p;
 
-  return strcmp_iw_ordered (SYMBOL_SEARCH_NAME (*s1),
-			    SYMBOL_SEARCH_NAME (*s2));
+  return strcmp_iw_ordered (PSYMBOL_SEARCH_NAME (*s1),
+			    PSYMBOL_SEARCH_NAME (*s2));
 }
 
 void
@@ -1485,31 +1553,29 @@ start_psymtab_common (struct objfile *objfile,
 }
 
 /* Calculate a hash code for the given partial symbol.  The hash is
-   calculated using the symbol's value, language, domain, class
-   and name.  These are the values which are set by
-   add_psymbol_to_bcache.  */
+   calculated using the symbol's value, name, domain and class.  These
+   are the values which are set by add_psymbol_to_bcache.  The
+   language is part of the name entry.  */
 
 static unsigned long
 psymbol_hash (const void *addr, int length)
 {
   unsigned long h = 0;
   struct partial_symbol *psymbol = (struct partial_symbol *) addr;
-  unsigned int lang = psymbol->ginfo.language;
   unsigned int domain = PSYMBOL_DOMAIN (psymbol);
   unsigned int class = PSYMBOL_CLASS (psymbol);
 
-  h = hash_continue (&psymbol->ginfo.value, sizeof (psymbol->ginfo.value), h);
-  h = hash_continue (&lang, sizeof (unsigned int), h);
+  h = hash_continue (&psymbol->value, sizeof (psymbol->value), h);
+  h = hash_continue (&psymbol->name, sizeof (psymbol->name), h);
   h = hash_continue (&domain, sizeof (unsigned int), h);
   h = hash_continue (&class, sizeof (unsigned int), h);
-  h = hash_continue (psymbol->ginfo.name, strlen (psymbol->ginfo.name), h);
 
   return h;
 }
 
 /* Returns true if the symbol at addr1 equals the symbol at addr2.
-   For the comparison this function uses a symbols value,
-   language, domain, class and name.  */
+   For the comparison this function uses a symbols value, name,
+   domain and class.  */
 
 static int
 psymbol_compare (const void *addr1, const void *addr2, int length)
@@ -1517,12 +1583,259 @@ psymbol_compare (const void *addr1, const void *addr2, int length)
   struct partial_symbol *sym1 = (struct partial_symbol *) addr1;
   struct partial_symbol *sym2 = (struct partial_symbol *) addr2;
 
-  return (memcmp (&sym1->ginfo.value, &sym1->ginfo.value,
-                  sizeof (sym1->ginfo.value)) == 0
-	  && sym1->ginfo.language == sym2->ginfo.language
+  return (memcmp (&sym1->value, &sym2->value, sizeof (sym1->value)) == 0
           && PSYMBOL_DOMAIN (sym1) == PSYMBOL_DOMAIN (sym2)
           && PSYMBOL_CLASS (sym1) == PSYMBOL_CLASS (sym2)
-          && sym1->ginfo.name == sym2->ginfo.name);
+          && sym1->name == sym2->name);
+}
+
+/* See struct psymbol_name.  The contents do not matter, only the
+   address does.  */
+
+const char psymbol_name_not_demangled[] = "";
+
+/* Hash function for the name table of a psymbol_bcache.  */
+
+static hashval_t
+hash_psymbol_name (const void *p)
+{
+  const struct psymbol_name *name = p;
+
+  return htab_hash_string (name->linkage_name) * 67 + name->language;
+}
+
+/* Equality function for the name table of a psymbol_bcache.  */
+
+static int
+eq_psymbol_name (const void *a, const void *b)
+{
+  const struct psymbol_name *name_a = a;
+  const struct psymbol_name *name_b = b;
+
+  return (name_a->language == name_b->language
+	  && strcmp (name_a->linkage_name, name_b->linkage_name) == 0);
+}
+
+/* Free the demangled name of an entry of the name table of a
+   psymbol_bcache.  The entry itself lives on the name obstack.  */
+
+static void
+free_psymbol_name (void *p)
+{
+  struct psymbol_name *name = p;
+
+  if (name->demangled_name != NULL
+      && name->demangled_name != psymbol_name_not_demangled)
+    xfree ((char *) name->demangled_name);
+}
+
+/* Return the demangled name of NAME, computing it the first time it
+   is asked for.  This follows symbol_demangled_name, except that the
+   Ada decoded name is cached the same way as the others.  */
+
+static const char *
+psymbol_name_demangled_name (struct psymbol_name *name)
+{
+  if (name->demangled_name == psymbol_name_not_demangled)
+    {
+      char *demangled = NULL;
+
+      switch (name->language)
+	{
+	case language_ada:
+	  demangled = xstrdup (ada_decode (name->linkage_name));
+	  break;
+	case language_cplus:
+	case language_d:
+	case language_go:
+	case language_java:
+	case language_objc:
+	  {
+	    struct general_symbol_info gsymbol;
+
+	    memset (&gsymbol, 0, sizeof (gsymbol));
+	    gsymbol.language = name->language;
+	    demangled = symbol_find_demangled_name (&gsymbol,
+						    name->linkage_name);
+	  }
+	  break;
+	default:
+	  break;
+	}
+
+      name->demangled_name = demangled;
+    }
+
+  return name->demangled_name;
+}
+
+/* Return the demangled name of PSYM, or NULL if there is none.  */
+
+const char *
+psymbol_demangled_name (const struct partial_symbol *psym)
+{
+  return psymbol_name_demangled_name (psym->name);
+}
+
+/* Return the source code name of PSYM.  In languages where demangling
+   is necessary, this is the demangled name.  */
+
+const char *
+psymbol_natural_name (const struct partial_symbol *psym)
+{
+  const char *demangled = psymbol_name_demangled_name (psym->name);
+
+  if (demangled != NULL)
+    return demangled;
+  return PSYMBOL_LINKAGE_NAME (psym);
+}
+
+/* Return the name PSYM is searched by, as symbol_search_name does for
+   full symbols.  */
+
+const char *
+psymbol_search_name (const struct partial_symbol *psym)
+{
+  if (PSYMBOL_LANGUAGE (psym) == language_ada)
+    return PSYMBOL_LINKAGE_NAME (psym);
+  return psymbol_natural_name (psym);
+}
+
+/* Return nonzero if the demangler of the language of NAME might
+   demangle its linkage name.  This is a cheap test that errs on the
+   side of yes: the C++, Java, D and Objective-C demanglers only accept
+   names that start with an underscore or contain "__", and the Go
+   demangler names that contain a dot.  The other languages have no
+   demangled names, or, like Ada, are searched by linkage name.  */
+
+static int
+psymbol_name_may_be_mangled (const struct psymbol_name *name)
+{
+  const char *s = name->linkage_name;
+
+  switch (name->language)
+    {
+    case language_cplus:
+    case language_java:
+    case language_d:
+    case language_objc:
+      return s[0] == '_' || strstr (s, "__") != NULL;
+    case language_go:
+      return strchr (s, '.') != NULL;
+    default:
+      return 0;
+    }
+}
+
+/* Call FUN with PSYM's linkage name, and with its search name if that
+   may differ.  */
+
+static void
+map_partial_symbol_search_name (struct partial_symbol *psym,
+				int (*fun) (const char *, void *),
+				void *data)
+{
+  struct psymbol_name *name = psym->name;
+  const char *demangled;
+
+  (*fun) (name->linkage_name, data);
+
+  if (PSYMBOL_LANGUAGE (psym) == language_ada)
+    return;
+  if (name->demangled_name == psymbol_name_not_demangled
+      && !psymbol_name_may_be_mangled (name))
+    return;
+
+  demangled = psymbol_name_demangled_name (name);
+  if (demangled != NULL)
+    (*fun) (demangled, data);
+}
+
+/* See psymtab.h.  */
+
+void
+map_partial_symbol_search_names (struct objfile *objfile,
+				 int (*fun) (const char *, void *),
+				 void *data)
+{
+  struct partial_symbol **psym;
+
+  for (psym = objfile->global_psymbols.list;
+       psym < objfile->global_psymbols.next;
+       psym++)
+    map_partial_symbol_search_name (*psym, fun, data);
+
+  for (psym = objfile->static_psymbols.list;
+       psym < objfile->static_psymbols.next;
+       psym++)
+    map_partial_symbol_search_name (*psym, fun, data);
+}
+
+/* Return the entry of the name table of BCACHE for the NAMELENGTH
+   characters at NAME in LANGUAGE, creating it if needed.  NAME is
+   copied unless COPY_NAME is 0 and NAME is NUL-terminated, in which
+   case it must live as long as the objfile.  */
+
+static struct psymbol_name *
+psymbol_bcache_name (struct psymbol_bcache *bcache,
+		     const char *name, int namelength, int copy_name,
+		     enum language language)
+{
+  struct psymbol_name entry;
+  struct psymbol_name **slot;
+  const char *demangled = psymbol_name_not_demangled;
+
+  /* The stabs reader generally provides names that are not
+     NUL-terminated.  */
+  if (name[namelength] != '\0')
+    {
+      char *name_copy = alloca (namelength + 1);
+
+      memcpy (name_copy, name, namelength);
+      name_copy[namelength] = '\0';
+      name = name_copy;
+      copy_name = 1;
+    }
+
+  /* If the reader does not know the language of the symbol, the
+     demangler finds it out, so this is the one case where the name has
+     to be demangled right away.  */
+  if (language == language_unknown || language == language_auto)
+    {
+      struct general_symbol_info gsymbol;
+
+      memset (&gsymbol, 0, sizeof (gsymbol));
+      gsymbol.language = language;
+      demangled = symbol_find_demangled_name (&gsymbol, name);
+      language = gsymbol.language;
+
+      /* Ada symbols are decoded when needed, see above.  */
+      if (language == language_ada)
+	demangled = psymbol_name_not_demangled;
+    }
+
+  entry.linkage_name = name;
+  entry.language = language;
+  slot = (struct psymbol_name **) htab_find_slot (bcache->names, &entry,
+						  INSERT);
+  if (*slot == NULL)
+    {
+      struct psymbol_name *new_name;
+
+      new_name = OBSTACK_ZALLOC (&bcache->name_obstack, struct psymbol_name);
+      if (copy_name)
+	new_name->linkage_name = obstack_copy0 (&bcache->name_obstack,
+						name, namelength);
+      else
+	new_name->linkage_name = name;
+      new_name->demangled_name = demangled;
+      new_name->language = language;
+      *slot = new_name;
+    }
+  else if (demangled != NULL && demangled != psymbol_name_not_demangled)
+    xfree ((char *) demangled);
+
+  return *slot;
 }
 
 /* Initialize a partial symbol bcache.  */
@@ -1532,6 +1845,10 @@ psymbol_bcache_init (void)
 {
   struct psymbol_bcache *bcache = XCALLOC (1, struct psymbol_bcache);
   bcache->bcache = bcache_xmalloc (psymbol_hash, psymbol_compare);
+  bcache->names = htab_create_alloc (256, hash_psymbol_name,
+				     eq_psymbol_name, free_psymbol_name,
+				     xcalloc, xfree);
+  obstack_init (&bcache->name_obstack);
   return bcache;
 }
 
@@ -1543,9 +1860,51 @@ psymbol_bcache_free (struct psymbol_bcache *bcache)
     return;
 
   bcache_xfree (bcache->bcache);
+  htab_delete (bcache->names);
+  obstack_free (&bcache->name_obstack, NULL);
   xfree (bcache);
 }
 
+/* Callback for psymbol_bcache_name_statistics, via htab_traverse.
+   DATA is an array of two size_ts: the number of names that have been
+   demangled, whether or not that gave a demangled name, and the memory
+   the demangled names use.  */
+
+static int
+count_demangled_psymbol_name (void **slot, void *data)
+{
+  struct psymbol_name *name = *slot;
+  size_t *counts = data;
+
+  if (name->demangled_name != psymbol_name_not_demangled)
+    {
+      counts[0]++;
+      if (name->demangled_name != NULL)
+	counts[1] += strlen (name->demangled_name) + 1;
+    }
+
+  return 1;
+}
+
+/* Set *N_NAMES to the number of distinct partial symbol names in
+   BCACHE and *N_DEMANGLED to the number of them that have been
+   demangled so far.  Return the memory used by the names.  */
+
+size_t
+psymbol_bcache_name_statistics (struct psymbol_bcache *bcache,
+				size_t *n_names, size_t *n_demangled)
+{
+  size_t counts[2] = { 0, 0 };
+
+  htab_traverse_noresize (bcache->names, count_demangled_psymbol_name,
+			  counts);
+  *n_names = htab_elements (bcache->names);
+  *n_demangled = counts[0];
+  return ((size_t) obstack_memory_used (&bcache->name_obstack)
+	  + htab_size (bcache->names) * sizeof (void *)
+	  + counts[1]);
+}
+
 /* Return the internal bcache of the psymbol_bcache BCACHE.  */
 
 struct bcache *
@@ -1595,18 +1954,20 @@ add_psymbol_to_bcache (const char *name, int namelength, int copy_name,
   /* val and coreaddr are mutually exclusive, one of them *will* be zero.  */
   if (val != 0)
     {
-      SYMBOL_VALUE (&psymbol) = val;
+      PSYMBOL_VALUE (&psymbol) = val;
     }
   else
     {
-      SYMBOL_VALUE_ADDRESS (&psymbol) = coreaddr;
+      PSYMBOL_VALUE_ADDRESS (&psymbol) = coreaddr;
     }
-  SYMBOL_SECTION (&psymbol) = -1;
-  SYMBOL_SET_LANGUAGE (&psymbol, language, &objfile->objfile_obstack);
+  PSYMBOL_SECTION (&psymbol) = -1;
   PSYMBOL_DOMAIN (&psymbol) = domain;
   PSYMBOL_CLASS (&psymbol) = class;
 
-  SYMBOL_SET_NAMES (&psymbol, name, namelength, copy_name, objfile);
+  /* The demangled name, if any, is only computed when it is needed;
+     see psymbol_demangled_name.  */
+  psymbol.name = psymbol_bcache_name (objfile->psymbol_cache,
+				      name, namelength, copy_name, language);
 
   /* Stash the partial symbol away in the cache.  */
   return psymbol_bcache_full (&psymbol,
@@ -2039,12 +2400,12 @@ maintenance_check_psymtabs (char *ignore, int from_tty)
     length = ps->n_static_syms;
     while (length--)
       {
-	sym = lookup_block_symbol (b, SYMBOL_LINKAGE_NAME (*psym),
-				   SYMBOL_DOMAIN (*psym));
+	sym = lookup_block_symbol (b, PSYMBOL_LINKAGE_NAME (*psym),
+				   PSYMBOL_DOMAIN (*psym));
 	if (!sym)
 	  {
 	    printf_filtered ("Static symbol `");
-	    puts_filtered (SYMBOL_LINKAGE_NAME (*psym));
+	    puts_filtered (PSYMBOL_LINKAGE_NAME (*psym));
 	    printf_filtered ("' only found in ");
 	    puts_filtered (ps->filename);
 	    printf_filtered (" psymtab\n");
@@ -2056,12 +2417,12 @@ maintenance_check_psymtabs (char *ignore, int from_tty)
     length = ps->n_global_syms;
     while (length--)
       {
-	sym = lookup_block_symbol (b, SYMBOL_LINKAGE_NAME (*psym),
-				   SYMBOL_DOMAIN (*psym));
+	sym = lookup_block_symbol (b, PSYMBOL_LINKAGE_NAME (*psym),
+				   PSYMBOL_DOMAIN (*psym));
 	if (!sym)
 	  {
 	    printf_filtered ("Global symbol `");
-	    puts_filtered (SYMBOL_LINKAGE_NAME (*psym));
+	    puts_filtered (PSYMBOL_LINKAGE_NAME (*psym));
 	    printf_filtered ("' only found in ");
 	    puts_filtered (ps->filename);
 	    printf_filtered (" psymtab\n");
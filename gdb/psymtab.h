@@ -29,6 +29,8 @@ struct psymbol_bcache;
 extern struct psymbol_bcache *psymbol_bcache_init (void);
 extern void psymbol_bcache_free (struct psymbol_bcache *);
 extern struct bcache *psymbol_bcache_get_bcache (struct psymbol_bcache *);
+extern size_t psymbol_bcache_name_statistics (struct psymbol_bcache *,
+					      size_t *, size_t *);
 
 void expand_partial_symbol_names (int (*fun) (const char *, void *),
 				  void *data);
@@ -36,6 +38,18 @@ void expand_partial_symbol_names (int (*fun) (const char *, void *),
 void map_partial_symbol_filenames (symbol_filename_ftype *fun, void *data,
 				   int need_fullname);
 
+/* Call FUN with DATA for each name by which a partial symbol of
+   OBJFILE may be looked up.  This is the linkage name of each partial
+   symbol and, if it may differ, its search name.  Unlike
+   expand_symtabs_matching, this only demangles the names that the
+   demangler might accept, so FUN may be called with a name that is
+   not the search name of any symbol, but never misses one that is.
+   The return value of FUN is ignored.  */
+
+void map_partial_symbol_search_names (struct objfile *objfile,
+				      int (*fun) (const char *, void *),
+				      void *data);
+
 extern const struct quick_symbol_functions psym_functions;
 
 extern const struct quick_symbol_functions dwarf2_gdb_index_functions;
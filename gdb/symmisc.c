@@ -42,6 +42,7 @@
 #include "readline/readline.h"
 
 #include "psymtab.h"
+#include "psympriv.h"
 
 #ifndef DEV_TTY
 #define DEV_TTY "/dev/tty"
@@ -774,6 +775,64 @@ maintenance_info_symtabs (char *regexp, int from_tty)
     }
 }
 
+/* Implement the 'maint info memory' command.  */
+
+static void
+maintenance_info_memory (char *regexp, int from_tty)
+{
+  struct program_space *pspace;
+  struct objfile *objfile;
+
+  dont_repeat ();
+
+  if (regexp)
+    re_comp (regexp);
+
+  ALL_PSPACES (pspace)
+    ALL_PSPACE_OBJFILES (pspace, objfile)
+    {
+      size_t psymbol_lists, psymbol_cache, psymbol_names;
+      size_t objfile_obstack, bfd_obstack;
+      size_t n_names, n_demangled;
+
+      QUIT;
+
+      if (regexp != NULL && ! re_exec (objfile_name (objfile)))
+	continue;
+
+      psymbol_lists = ((objfile->global_psymbols.size
+			+ objfile->static_psymbols.size)
+		       * sizeof (struct partial_symbol *));
+      psymbol_cache = bcache_memory_used (psymbol_bcache_get_bcache
+					  (objfile->psymbol_cache));
+      psymbol_names
+	= psymbol_bcache_name_statistics (objfile->psymbol_cache,
+					  &n_names, &n_demangled);
+      objfile_obstack = obstack_memory_used (&objfile->objfile_obstack);
+      bfd_obstack = obstack_memory_used (&objfile->per_bfd->storage_obstack);
+
+      printf_filtered (_("Memory used by '%s':\n"), objfile_name (objfile));
+      printf_filtered (_("  Partial symbols: %s, %s bytes each\n"),
+		       pulongest (OBJSTAT (objfile, n_psyms)),
+		       pulongest (sizeof (struct partial_symbol)));
+      printf_filtered (_("  Partial symbol lists: %s bytes\n"),
+		       pulongest (psymbol_lists));
+      printf_filtered (_("  Partial symbol cache: %s bytes\n"),
+		       pulongest (psymbol_cache));
+      printf_filtered (_("  Partial symbol names: %s, %s bytes\n"),
+		       pulongest (n_names), pulongest (psymbol_names));
+      printf_filtered (_("  Partial symbol names demangled so far: %s\n"),
+		       pulongest (n_demangled));
+      printf_filtered (_("  Objfile obstack: %s bytes\n"),
+		       pulongest (objfile_obstack));
+      printf_filtered (_("  BFD obstack: %s bytes\n"),
+		       pulongest (bfd_obstack));
+      printf_filtered (_("  Total: %s bytes\n"),
+		       pulongest (psymbol_lists + psymbol_cache + psymbol_names
+				  + objfile_obstack + bfd_obstack));
+    }
+}
+
 /* Check consistency of symtabs.
    An example of what this checks for is NULL blockvectors.
    They can happen if there's a bug during debug info reading.
@@ -953,6 +1012,14 @@ linetables --- just the symbol table structures themselves.\n\
 With an argument REGEXP, list the symbol tables with matching names."),
 	   &maintenanceinfolist);
 
+  add_cmd ("memory", class_maintenance, maintenance_info_memory, _("\
+List the memory used by the symbols of each object file.\n\
+This shows how much memory the partial symbols, their names and the\n\
+obstacks of each object file use, and how many of the partial symbol\n\
+names have been demangled so far.\n\
+With an argument REGEXP, list the object files with matching names."),
+	   &maintenanceinfolist);
+
   add_cmd ("check-symtabs", class_maintenance, maintenance_check_symtabs,
 	   _("\
 Check consistency of currently expanded symtabs."),
@@ -63,6 +63,7 @@
 #include "ada-lang.h"
 
 #include "psymtab.h"
+#include "name-index.h"
 #include "parser-defs.h"
 
 /* Prototypes for local functions */
@@ -620,7 +621,7 @@ create_demangled_names_hash (struct objfile *objfile)
    then set the language appropriately.  The returned name is allocated
    by the demangler and should be xfree'd.  */
 
-static char *
+char *
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
@@ -1498,6 +1499,10 @@ lookup_static_symbol_aux (const char *name, const domain_enum domain)
 {
   struct objfile *objfile;
   struct symbol *sym;
+  struct name_index_search search;
+
+  if (!name_index_start_search (&search, name))
+    return NULL;
 
   sym = lookup_symbol_aux_symtabs (STATIC_BLOCK, name, domain);
   if (sym != NULL)
@@ -1505,6 +1510,9 @@ lookup_static_symbol_aux (const char *name, const domain_enum domain)
 
   ALL_OBJFILES (objfile)
   {
+    if (!name_index_objfile_p (&search, objfile))
+      continue;
+
     sym = lookup_symbol_aux_quick (objfile, STATIC_BLOCK, name, domain);
     if (sym != NULL)
       return sym;
@@ -1676,9 +1684,16 @@ lookup_symbol_aux_symtabs (int block_index, const char *name,
 {
   struct symbol *sym;
   struct objfile *objfile;
+  struct name_index_search search;
+
+  if (!name_index_start_search (&search, name))
+    return NULL;
 
   ALL_OBJFILES (objfile)
   {
+    if (!name_index_objfile_p (&search, objfile))
+      continue;
+
     sym = lookup_symbol_aux_objfile (objfile, block_index, name, domain);
     if (sym)
       return sym;
@@ -1841,6 +1856,9 @@ struct global_sym_lookup_data
   /* The domain to use for our search.  */
   domain_enum domain;
 
+  /* The name index search for NAME.  */
+  struct name_index_search search;
+
   /* The field where the callback should store the symbol if found.
      It should be initialized to NULL before the search is started.  */
   struct symbol *result;
@@ -1860,6 +1878,9 @@ lookup_symbol_global_iterator_cb (struct objfile *objfile,
 
   gdb_assert (data->result == NULL);
 
+  if (!name_index_objfile_p (&data->search, objfile))
+    return 0;
+
   data->result = lookup_symbol_aux_objfile (objfile, GLOBAL_BLOCK,
 					    data->name, data->domain);
   if (data->result == NULL)
@@ -1893,6 +1914,8 @@ lookup_symbol_global (const char *name,
   memset (&lookup_data, 0, sizeof (lookup_data));
   lookup_data.name = name;
   lookup_data.domain = domain;
+  if (!name_index_start_search (&lookup_data.search, name))
+    return NULL;
   gdbarch_iterate_over_objfiles_in_search_order
     (objfile != NULL ? get_objfile_arch (objfile) : target_gdbarch (),
      lookup_symbol_global_iterator_cb, &lookup_data, objfile);
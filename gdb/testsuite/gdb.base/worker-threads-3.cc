@@ -0,0 +1,67 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The template chain gives this CU a few hundred functions whose
+   names need canonicalizing, so that the main thread is still busy
+   with it while the worker threads read the CUs after it.  */
+
+namespace wt_ns
+{
+  template<int N>
+  struct wt_chain
+  {
+    static int sum () { return N + wt_chain<N - 1>::sum (); }
+  };
+
+  template<>
+  struct wt_chain<0>
+  {
+    static int sum () { return 0; }
+  };
+
+  template<typename T>
+  struct wt_holder
+  {
+    T value;
+
+    T get () const { return value; }
+  };
+
+  template<typename T>
+  T
+  wt_identity (T t)
+  {
+    return t;
+  }
+
+  int wt_ns_var = 5;
+
+  int
+  wt_ns_func (int x)
+  {
+    return wt_identity<int> (x) + 1;
+  }
+}
+
+wt_ns::wt_holder<long> wt_holder_var = { 7 };
+
+int
+wt_third_func (void)
+{
+  return (wt_ns::wt_ns_func (wt_ns::wt_ns_var) + wt_holder_var.get ()
+	  + wt_ns::wt_chain<300>::sum ());
+}
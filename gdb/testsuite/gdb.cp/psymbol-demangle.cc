@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The file-local functions and variables below are static partial
+   symbols, whose names are only demangled when GDB needs them.  */
+
+namespace psd
+{
+  static int
+  static_func_1 (int x)
+  {
+    return x + 1;
+  }
+
+  static int
+  static_func_2 (int x)
+  {
+    return x + 2;
+  }
+
+  static int static_var = 3;
+
+  int
+  global_func (int x)
+  {
+    return static_func_1 (x) + static_func_2 (x) + static_var;
+  }
+}
+
+int
+main ()
+{
+  return psd::global_func (0);
+}
@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+
+static void
+end (void)
+{}
+
+int
+main (void)
+{
+  char libname[40];
+  int i;
+
+  for (i = 0; i < SOLIB_COUNT; i++)
+    {
+      sprintf (libname, "symbol-lookup-lib%d", i);
+      if (dlopen (libname, RTLD_LAZY) == NULL)
+	{
+	  printf ("ERROR on dlopen %s\n", libname);
+	  exit (-1);
+	}
+    }
+
+  end ();
+
+  return 0;
+}
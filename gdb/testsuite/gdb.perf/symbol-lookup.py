@@ -0,0 +1,46 @@
+# Copyright (C) 2013 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when it looks up global
+# symbols in many shared libraries, with and without the symbol name
+# index.
+
+from perftest import perftest
+
+class SymbolLookup(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, solib_count, lookup_count):
+        super(SymbolLookup, self).__init__("symbol-lookup")
+        self.solib_count = solib_count
+        self.lookup_count = lookup_count
+
+    def _test(self):
+        last = self.solib_count - 1
+        for _ in range(0, self.lookup_count):
+            # A global defined in the last library loaded, a static
+            # defined there, and a name defined nowhere.
+            gdb.lookup_global_symbol("shr%d_var" % last)
+            gdb.lookup_symbol("shr%d_static" % last)
+            gdb.lookup_symbol("no_such_symbol")
+            gdb.lookup_global_symbol("no_such_symbol")
+
+    def warm_up(self):
+        # Read the partial symbols of every library, and build the
+        # index.
+        self._test()
+
+    def execute_test(self):
+        for setting in ["off", "on"]:
+            gdb.execute("maint set symbol-name-index %s" % setting)
+            self.measure.measure(self._test, "symbol-name-index-%s" % setting)
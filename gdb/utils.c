@@ -71,6 +71,7 @@
 #include "gdb_usleep.h"
 #include "interps.h"
 #include "gdb_regex.h"
+#include "worker-pool.h"
 
 #if !HAVE_DECL_MALLOC
 extern PTR malloc ();		/* ARI: PTR */
@@ -541,6 +542,10 @@ free_current_contents (void *ptr)
 void
 vwarning (const char *string, va_list args)
 {
+  /* Only the main thread may print.  */
+  if (in_worker_thread ())
+    worker_abandon_item ();
+
   if (deprecated_warning_hook)
     (*deprecated_warning_hook) (string, args);
   else
@@ -698,7 +703,13 @@ internal_vproblem (struct internal_problem *problem,
   int quit_p;
   int dump_core_p;
   char *reason;
-  struct cleanup *cleanup = make_cleanup (null_cleanup, NULL);
+  struct cleanup *cleanup;
+
+  /* Leave the problem for the main thread to report.  */
+  if (in_worker_thread ())
+    worker_abandon_item ();
+
+  cleanup = make_cleanup (null_cleanup, NULL);
 
   /* Don't allow infinite error/warning recursion.  */
   {
@@ -0,0 +1,403 @@
+/* Worker threads for GDB.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "worker-pool.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "gdb_assert.h"
+
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE)
+#define USE_WORKER_THREADS 1
+#endif
+
+#ifdef USE_WORKER_THREADS
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+/* The maximum number of worker threads, as set by "maint set
+   worker-threads".  -1 means "unlimited": one thread for each
+   processor other than the one the main thread runs on.  */
+
+static int max_worker_threads = -1;
+
+/* Implement "maint show worker-threads".  */
+
+static void
+show_max_worker_threads (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  if (max_worker_threads == -1)
+    fprintf_filtered (file,
+		      _("The number of worker threads GDB may use is "
+			"unlimited (currently %d).\n"),
+		      worker_thread_count ());
+  else
+    fprintf_filtered (file,
+		      _("The number of worker threads GDB may use is %s.\n"),
+		      value);
+}
+
+/* See worker-pool.h.  */
+
+int
+worker_thread_count (void)
+{
+#ifdef USE_WORKER_THREADS
+  if (max_worker_threads == -1)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      long nprocs = sysconf (_SC_NPROCESSORS_ONLN);
+
+      if (nprocs > 1)
+	return nprocs - 1;
+#endif
+      return 0;
+    }
+  return max_worker_threads;
+#else
+  return 0;
+#endif
+}
+
+#ifdef USE_WORKER_THREADS
+
+/* How many items per worker thread worker_job_wait lets the worker
+   threads run ahead of the main thread.  */
+
+#define WORKER_JOB_WINDOW 4
+
+/* The state of an item of a job.  */
+
+enum worker_item_state
+{
+  /* Not started yet.  */
+  WORKER_ITEM_PENDING,
+
+  /* Running on a worker thread.  */
+  WORKER_ITEM_RUNNING,
+
+  /* Completed on a worker thread.  */
+  WORKER_ITEM_DONE,
+
+  /* Abandoned on a worker thread.  */
+  WORKER_ITEM_ABANDONED,
+
+  /* Waited for before it was started; it will not be run.  */
+  WORKER_ITEM_SKIPPED
+};
+
+struct worker_job
+{
+  /* The function to run for each item, and its first argument.  */
+  worker_job_ftype *func;
+  void *data;
+
+  /* The number of items.  */
+  int nitems;
+
+  /* The next item a worker thread should start.  */
+  int next_item;
+
+  /* Items below this one may be started.  */
+  int limit;
+
+  /* How far LIMIT may be ahead of the item being waited for.  */
+  int window;
+
+  /* Set when the job is being finished.  */
+  int stopping;
+
+  /* The state of each item, an enum worker_item_state.  */
+  unsigned char *states;
+
+  /* Protects all of the fields above.  */
+  pthread_mutex_t lock;
+
+  /* Signalled when an item finishes.  */
+  pthread_cond_t item_finished;
+
+  /* Signalled when LIMIT or STOPPING changes.  */
+  pthread_cond_t work_available;
+
+  /* The worker threads.  */
+  int nthreads;
+  pthread_t *threads;
+};
+
+/* What a worker thread keeps in thread-specific data.  */
+
+struct worker_thread
+{
+  /* Where worker_abandon_item returns to.  */
+  jmp_buf abandon;
+};
+
+/* The key of the thread-specific worker_thread data, and whether it
+   was created.  */
+
+static pthread_key_t worker_key;
+static int worker_key_created;
+
+/* The body of a worker thread of JOB_PTR.  */
+
+static void *
+worker_thread_main (void *job_ptr)
+{
+  struct worker_job *job = job_ptr;
+  struct worker_thread self;
+
+  pthread_setspecific (worker_key, &self);
+
+  pthread_mutex_lock (&job->lock);
+  for (;;)
+    {
+      int item;
+      enum worker_item_state state;
+
+      while (!job->stopping
+	     && job->next_item < job->nitems
+	     && job->next_item >= job->limit)
+	pthread_cond_wait (&job->work_available, &job->lock);
+      if (job->stopping || job->next_item >= job->nitems)
+	break;
+
+      item = job->next_item++;
+      if (job->states[item] == WORKER_ITEM_SKIPPED)
+	continue;
+      job->states[item] = WORKER_ITEM_RUNNING;
+      pthread_mutex_unlock (&job->lock);
+
+      if (setjmp (self.abandon) == 0)
+	{
+	  job->func (job->data, item);
+	  state = WORKER_ITEM_DONE;
+	}
+      else
+	state = WORKER_ITEM_ABANDONED;
+
+      pthread_mutex_lock (&job->lock);
+      job->states[item] = state;
+      pthread_cond_broadcast (&job->item_finished);
+    }
+  pthread_mutex_unlock (&job->lock);
+
+  return NULL;
+}
+
+/* Free JOB, whose threads have all exited.  */
+
+static void
+free_worker_job (struct worker_job *job)
+{
+  pthread_cond_destroy (&job->work_available);
+  pthread_cond_destroy (&job->item_finished);
+  pthread_mutex_destroy (&job->lock);
+  xfree (job->threads);
+  xfree (job->states);
+  xfree (job);
+}
+
+/* See worker-pool.h.  */
+
+struct worker_job *
+worker_job_start (int nitems, worker_job_ftype *func, void *data)
+{
+  struct worker_job *job;
+  int nthreads = worker_thread_count ();
+  sigset_t all_signals, old_mask;
+  int i;
+
+  if (nthreads > nitems)
+    nthreads = nitems;
+  if (nthreads <= 0 || !worker_key_created)
+    return NULL;
+
+  job = XCNEW (struct worker_job);
+  job->func = func;
+  job->data = data;
+  job->nitems = nitems;
+  job->window = nthreads * WORKER_JOB_WINDOW;
+  job->limit = job->window < nitems ? job->window : nitems;
+  job->states = xcalloc (nitems, sizeof (unsigned char));
+  pthread_mutex_init (&job->lock, NULL);
+  pthread_cond_init (&job->item_finished, NULL);
+  pthread_cond_init (&job->work_available, NULL);
+  job->threads = XNEWVEC (pthread_t, nthreads);
+
+  /* Signals must keep going to the main thread, so block all of them
+     in the worker threads; they inherit this mask.  */
+  sigfillset (&all_signals);
+  pthread_sigmask (SIG_BLOCK, &all_signals, &old_mask);
+  for (i = 0; i < nthreads; ++i)
+    if (pthread_create (&job->threads[job->nthreads], NULL,
+			worker_thread_main, job) == 0)
+      ++job->nthreads;
+  pthread_sigmask (SIG_SETMASK, &old_mask, NULL);
+
+  if (job->nthreads == 0)
+    {
+      free_worker_job (job);
+      return NULL;
+    }
+
+  return job;
+}
+
+/* See worker-pool.h.  */
+
+int
+worker_job_wait (struct worker_job *job, int item)
+{
+  int state;
+
+  gdb_assert (item >= 0 && item < job->nitems);
+
+  pthread_mutex_lock (&job->lock);
+
+  /* Let the worker threads run further ahead.  */
+  if (item + 1 + job->window > job->limit)
+    {
+      job->limit = item + 1 + job->window;
+      if (job->limit > job->nitems)
+	job->limit = job->nitems;
+      pthread_cond_broadcast (&job->work_available);
+    }
+
+  /* Rather than wait for an item that no worker thread has picked up
+     yet, let the caller do it.  */
+  if (job->states[item] == WORKER_ITEM_PENDING)
+    job->states[item] = WORKER_ITEM_SKIPPED;
+
+  while (job->states[item] == WORKER_ITEM_RUNNING)
+    pthread_cond_wait (&job->item_finished, &job->lock);
+  state = job->states[item];
+
+  pthread_mutex_unlock (&job->lock);
+
+  return state == WORKER_ITEM_DONE;
+}
+
+/* See worker-pool.h.  */
+
+void
+worker_job_finish (struct worker_job *job)
+{
+  int i;
+
+  pthread_mutex_lock (&job->lock);
+  job->stopping = 1;
+  pthread_cond_broadcast (&job->work_available);
+  pthread_mutex_unlock (&job->lock);
+
+  for (i = 0; i < job->nthreads; ++i)
+    pthread_join (job->threads[i], NULL);
+
+  free_worker_job (job);
+}
+
+/* See worker-pool.h.  */
+
+int
+in_worker_thread (void)
+{
+  return worker_key_created && pthread_getspecific (worker_key) != NULL;
+}
+
+/* See worker-pool.h.  */
+
+void
+worker_abandon_item (void)
+{
+  struct worker_thread *self = pthread_getspecific (worker_key);
+
+  /* Not gdb_assert: that would come back here.  */
+  if (self == NULL)
+    abort ();
+  longjmp (self->abandon, 1);
+}
+
+#else /* USE_WORKER_THREADS */
+
+/* See worker-pool.h.  */
+
+struct worker_job *
+worker_job_start (int nitems, worker_job_ftype *func, void *data)
+{
+  return NULL;
+}
+
+/* See worker-pool.h.  */
+
+int
+worker_job_wait (struct worker_job *job, int item)
+{
+  gdb_assert_not_reached ("no worker threads");
+}
+
+/* See worker-pool.h.  */
+
+void
+worker_job_finish (struct worker_job *job)
+{
+  gdb_assert_not_reached ("no worker threads");
+}
+
+/* See worker-pool.h.  */
+
+int
+in_worker_thread (void)
+{
+  return 0;
+}
+
+/* See worker-pool.h.  */
+
+void
+worker_abandon_item (void)
+{
+  abort ();
+}
+
+#endif /* USE_WORKER_THREADS */
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_worker_pool;
+
+void
+_initialize_worker_pool (void)
+{
+#ifdef USE_WORKER_THREADS
+  worker_key_created = pthread_key_create (&worker_key, NULL) == 0;
+#endif
+
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &max_worker_threads, _("\
+Set the number of worker threads GDB may use."), _("\
+Show the number of worker threads GDB may use."), _("\
+GDB uses worker threads to read debug information in parallel.\n\
+Zero disables them.  The default, \"unlimited\", uses one thread for\n\
+each processor other than the one GDB itself runs on."),
+				       NULL, show_max_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+}
@@ -0,0 +1,86 @@
+/* Worker threads for GDB.
+
+   Copyright (C) 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/* Worker threads run self-contained, CPU-bound pieces of work, such
+   as decoding DWARF, while the main thread gets on with something
+   else.  A "job" is a sequence of numbered items; the worker threads
+   start the items in increasing order, and the main thread waits for
+   them in the same order, consuming each result as it goes.
+
+   Nothing in GDB proper is thread-safe.  Code running on a worker
+   thread must only touch data that belongs to its item or that the
+   main thread will not modify while the job runs.  It may not print,
+   use cleanups, or catch exceptions.  An error, warning, internal
+   problem, or complaint raised on a worker thread abandons the item
+   instead (see worker_abandon_item); the main thread is then expected
+   to do the work for that item itself, the ordinary way, which reports
+   the problem properly.  */
+
+struct worker_job;
+
+/* The function run for each item of a job.  DATA is the pointer
+   passed to worker_job_start and ITEM the index of the item.  */
+
+typedef void (worker_job_ftype) (void *data, int item);
+
+/* Return the number of worker threads GDB may use.  Zero means that
+   all work must be done on the main thread.  */
+
+extern int worker_thread_count (void);
+
+/* Start a job of NITEMS items, running FUNC (DATA, I) on the worker
+   threads for each I from 0 to NITEMS - 1.  Only a limited number of
+   items beyond the last one waited for are started ahead of time, so
+   that the results waiting to be consumed do not use too much memory.
+   Return NULL if there are no worker threads to run the job; the
+   caller must then do all of the work itself.  */
+
+extern struct worker_job *worker_job_start (int nitems,
+					    worker_job_ftype *func,
+					    void *data);
+
+/* Wait for item ITEM of JOB.  Items must be waited for in increasing
+   order.  Return non-zero if FUNC ran to completion for ITEM.  Return
+   zero if ITEM was abandoned, or had not been started yet (in which
+   case it never will be); the caller must then do the work for ITEM
+   itself, after releasing anything FUNC recorded in DATA before it
+   was abandoned.  */
+
+extern int worker_job_wait (struct worker_job *job, int item);
+
+/* Stop JOB, wait for the items that are running to finish, and free
+   JOB.  Items that were not started yet are never run.  The results
+   of completed items that were not waited for are left in DATA for
+   the caller to release.  */
+
+extern void worker_job_finish (struct worker_job *job);
+
+/* Return non-zero if called from a worker thread.  */
+
+extern int in_worker_thread (void);
+
+/* Abandon the item the calling worker thread is running; see
+   worker_job_wait.  This must only be called on a worker thread.  */
+
+extern void worker_abandon_item (void) ATTRIBUTE_NORETURN;
+
+#endif /* WORKER_POOL_H */
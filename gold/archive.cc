@@ -24,9 +24,13 @@
 #include "gold.h"
 
 #include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <climits>
 #include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "libiberty.h"
 #include "filenames.h"
 
@@ -41,6 +45,7 @@
 #include "archive.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -165,6 +170,7 @@ struct Archive::Archive_header
 unsigned int Archive::total_archives;
 unsigned int Archive::total_members;
 unsigned int Archive::total_members_loaded;
+std::vector<Archive::Archive_stats> Archive::archive_stats;
 
 // Archive methods.
 
@@ -184,9 +190,10 @@ Archive::Archive(const std::string& name, Input_file* input_file,
                  bool is_thin_archive, Dirsearch* dirpath, Task* task)
   : Library_base(task), name_(name), input_file_(input_file), armap_(),
     armap_names_(), extended_names_(), armap_checked_(), seen_offsets_(),
-    members_(), is_thin_archive_(is_thin_archive), included_member_(false),
+    members_(), candidate_offsets_(), is_thin_archive_(is_thin_archive),
+    included_member_(false),
     nested_archives_(), dirpath_(dirpath), num_members_(0),
-    included_all_members_(false)
+    included_all_members_(false), stats_index_(-1U)
 {
   this->no_export_ =
     parameters->options().check_excluded_libs(input_file->found_name());
@@ -727,6 +734,154 @@ Archive::read_symbols(off_t off)
   this->members_[off] = member;
 }
 
+// A job which reads candidate archive members.  Each piece creates
+// the object for one member and reads its symbols.  This does not
+// touch the symbol table, so the members which are actually included
+// in the link, and the order in which they are included, are still
+// decided by the loop in Archive::add_symbols.
+
+class Archive::Read_members_job : public Parallel_job
+{
+ public:
+  Read_members_job(Archive* archive, const std::vector<off_t>& offsets,
+		   std::vector<Archive_member>* members)
+    : archive_(archive), offsets_(offsets), members_(members)
+  { }
+
+  void
+  run_piece(unsigned int);
+
+ private:
+  Archive* archive_;
+  const std::vector<off_t>& offsets_;
+  std::vector<Archive_member>* members_;
+};
+
+void
+Archive::Read_members_job::run_piece(unsigned int i)
+{
+  Input_file* input_file;
+  off_t memoff;
+  off_t memsize;
+  std::string member_name;
+  if (!this->archive_->get_file_and_offset(this->offsets_[i], &input_file,
+					   &memoff, &memsize, &member_name))
+    return;
+
+  const unsigned char* ehdr;
+  int read_size;
+  if (!is_elf_object(input_file, memoff, &ehdr, &read_size))
+    return;
+
+  // Leave a member with an unsupported target to include_member,
+  // which decides whether that is an error.
+  bool unconfigured = false;
+  Object* obj = make_elf_object((this->archive_->filename()
+				 + "(" + member_name + ")"),
+				input_file, memoff, ehdr, read_size,
+				&unconfigured);
+  if (obj == NULL)
+    return;
+  obj->set_no_export(this->archive_->no_export());
+
+  Read_symbols_data* sd = new Read_symbols_data;
+  obj->read_symbols(sd);
+  (*this->members_)[i] = Archive_member(obj, sd);
+}
+
+// Read the members which the archive map says define a symbol which
+// is currently undefined.  Most of these will be included in the
+// link by the next pass of add_symbols.  Reading them here lets us
+// read them on several threads, rather than one at a time as
+// include_member finds them.
+
+void
+Archive::read_candidate_members(Symbol_table* symtab, Layout* layout)
+{
+  // Plugins may claim members, which must be done in order.  The
+  // members of a thin archive are separate files which we would have
+  // to open.  If we do not yet know the target, the first member we
+  // read would set it.
+  if (parallel_thread_count() <= 1
+      || this->is_thin_archive_
+      || parameters->options().has_plugins()
+      || !parameters->target_valid())
+    return;
+
+  std::vector<off_t> offsets;
+  Unordered_set<off_t, Seen_hash> candidates;
+  char* tmpbuf = NULL;
+  size_t tmpbuflen = 0;
+  const size_t armap_size = this->armap_.size();
+  for (size_t i = 0; i < armap_size; ++i)
+    {
+      if (this->armap_checked_[i])
+	continue;
+      off_t off = this->armap_[i].file_offset;
+      if (this->seen_offsets_.find(off) != this->seen_offsets_.end()
+	  || this->members_.find(off) != this->members_.end()
+	  || candidates.find(off) != candidates.end())
+	continue;
+
+      const char* sym_name = (this->armap_names_.data()
+			      + this->armap_[i].name_offset);
+      Symbol* sym;
+      std::string why;
+      if (Archive::should_include_member(symtab, layout, sym_name, &sym,
+					 &why, &tmpbuf, &tmpbuflen)
+	  != Archive::SHOULD_INCLUDE_YES)
+	continue;
+
+      candidates.insert(off);
+      offsets.push_back(off);
+    }
+  if (tmpbuf != NULL)
+    free(tmpbuf);
+
+  // A single member is read just as quickly by include_member.
+  if (offsets.size() < 2)
+    return;
+
+  std::vector<Archive_member> members(offsets.size());
+  Read_members_job job(this, offsets, &members);
+  File_read& file(this->input_file_->file());
+  file.begin_parallel_access();
+  run_in_parallel(&job, offsets.size());
+  file.end_parallel_access();
+
+  for (size_t i = 0; i < offsets.size(); ++i)
+    {
+      if (members[i].obj_ == NULL)
+	continue;
+      this->members_[offsets[i]] = members[i];
+      this->candidate_offsets_.insert(offsets[i]);
+      if (this->stats_index_ != -1U)
+	++Archive::archive_stats[this->stats_index_].members_read;
+    }
+}
+
+// Free the members read by read_candidate_members which were not
+// included in the link, usually because another member defined the
+// symbol first.  The archive is still locked, so we may free the
+// views of the member symbols.
+
+void
+Archive::release_candidate_members()
+{
+  for (Unordered_set<off_t, Seen_hash>::const_iterator p =
+	 this->candidate_offsets_.begin();
+       p != this->candidate_offsets_.end();
+       ++p)
+    {
+      std::map<off_t, Archive_member>::iterator q = this->members_.find(*p);
+      gold_assert(q != this->members_.end());
+      delete q->second.sd_;
+      delete q->second.obj_;
+      this->members_.erase(q);
+    }
+  this->candidate_offsets_.clear();
+}
+
 // Select members from the archive and add them to the link.  We walk
 // through the elements in the archive map, and look each one up in
 // the symbol table.  If it exists as a strong undefined symbol, we
@@ -742,6 +897,33 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 {
   ++Archive::total_archives;
 
+  Timer timer;
+  if (parameters->options().stats())
+    {
+      if (this->stats_index_ == -1U)
+	{
+	  this->stats_index_ = Archive::archive_stats.size();
+	  Archive::archive_stats.push_back(Archive_stats(this->name()));
+	}
+      timer.start();
+    }
+
+  bool ret = this->do_add_symbols(symtab, layout, input_objects, mapfile);
+
+  if (this->stats_index_ != -1U)
+    Archive::archive_stats[this->stats_index_].time +=
+      timer.get_elapsed_time().wall;
+
+  return ret;
+}
+
+// Select members from the archive and add them to the link, for
+// add_symbols.
+
+bool
+Archive::do_add_symbols(Symbol_table* symtab, Layout* layout,
+			Input_objects* input_objects, Mapfile* mapfile)
+{
   if (this->input_file_->options().whole_archive())
     return this->include_all_members(symtab, layout, input_objects,
 				     mapfile);
@@ -766,6 +948,7 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   do
     {
       added_new_object = false;
+      this->read_candidate_members(symtab, layout);
       for (size_t i = 0; i < armap_size; ++i)
 	{
           if (this->armap_checked_[i])
@@ -809,6 +992,7 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 	    {
 	      if (tmpbuf != NULL)
 		free(tmpbuf);
+	      this->release_candidate_members();
 	      return false;
 	    }
 
@@ -820,6 +1004,8 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   if (tmpbuf != NULL)
     free(tmpbuf);
 
+  this->release_candidate_members();
+
   input_objects->archive_stop(this);
 
   return true;
@@ -933,17 +1119,29 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
 			Mapfile* mapfile, Symbol* sym, const char* why)
 {
   ++Archive::total_members_loaded;
+  if (this->stats_index_ != -1U)
+    ++Archive::archive_stats[this->stats_index_].members_loaded;
 
-  std::map<off_t, Archive_member>::const_iterator p = this->members_.find(off);
+  std::map<off_t, Archive_member>::iterator p = this->members_.find(off);
   if (p != this->members_.end())
     {
       Object* obj = p->second.obj_;
 
       Read_symbols_data* sd = p->second.sd_;
+
+      // A member read by read_candidate_members is only used once.
+      if (this->candidate_offsets_.erase(off) > 0)
+	{
+	  this->members_.erase(p);
+	  if (this->stats_index_ != -1U)
+	    ++Archive::archive_stats[this->stats_index_].members_read_used;
+	}
       if (mapfile != NULL)
         mapfile->report_include_archive_member(obj->name(), sym, why);
       if (input_objects->add_object(obj))
         {
+	  if (layout->incremental_inputs() != NULL)
+	    layout->incremental_inputs()->report_object(obj, 0, this, NULL);
           obj->layout(symtab, layout, sd);
           obj->add_symbols(symtab, sd, layout);
 	  this->included_member_ = true;
@@ -1036,6 +1234,16 @@ Archive::print_stats()
           program_name, Archive::total_members);
   fprintf(stderr, _("%s: loaded archive members: %u\n"),
           program_name, Archive::total_members_loaded);
+  for (std::vector<Archive_stats>::const_iterator p =
+	 Archive::archive_stats.begin();
+       p != Archive::archive_stats.end();
+       ++p)
+    fprintf(stderr,
+	    _("%s: archive %s: %ld.%06ld seconds, %u members loaded, "
+	      "%u members read in parallel, %u of them loaded\n"),
+	    program_name, p->name.c_str(), p->time / 1000,
+	    (p->time % 1000) * 1000, p->members_loaded, p->members_read,
+	    p->members_read_used);
 }
 
 // Add_archive_symbols methods.
@@ -1125,10 +1333,194 @@ Add_archive_symbols::run(Workqueue* workqueue)
     }
 }
 
+// Class Input_cache.
+
+// The first line of each cache entry.  This is followed by the key,
+// and then by the symbol names, one per line.
+
+static const char input_cache_magic[] = "gold input cache 1";
+
+bool Input_cache::is_enabled_;
+bool Input_cache::is_writable_;
+
+// Create the cache directory.
+
+void
+Input_cache::initialize()
+{
+  const char* dir = parameters->options().input_cache();
+  if (::mkdir(dir, 0777) < 0 && errno != EEXIST)
+    {
+      gold_warning(_("cannot create --input-cache directory %s: %s"),
+		   dir, strerror(errno));
+      return;
+    }
+
+  struct stat st;
+  if (::stat(dir, &st) < 0 || !S_ISDIR(st.st_mode))
+    {
+      gold_warning(_("--input-cache %s is not a directory"), dir);
+      return;
+    }
+  Input_cache::is_enabled_ = true;
+
+  if (::access(dir, W_OK) < 0)
+    {
+      gold_warning(_("cannot write to --input-cache directory %s: %s"),
+		   dir, strerror(errno));
+      return;
+    }
+  Input_cache::is_writable_ = true;
+}
+
+// Set *KEY to the key for INPUT_FILE, and *PATH to the name of its
+// cache entry.  The name is a hash of the key; the key itself is
+// stored in the entry to guard against collisions.
+
+bool
+Input_cache::entry(Input_file* input_file, std::string* key,
+		   std::string* path)
+{
+  const std::string& filename(input_file->filename());
+  struct stat st;
+  if (::stat(filename.c_str(), &st) < 0)
+    return false;
+
+  long nsec;
+#ifdef HAVE_STAT_ST_MTIM
+  nsec = st.st_mtim.tv_nsec;
+#else
+  nsec = 0;
+#endif
+  char buf[128];
+  snprintf(buf, sizeof buf, " %llu %llu %lld.%09ld %lld",
+	   static_cast<unsigned long long>(st.st_dev),
+	   static_cast<unsigned long long>(st.st_ino),
+	   static_cast<long long>(st.st_mtime), nsec,
+	   static_cast<long long>(st.st_size));
+  *key = filename;
+  key->append(buf);
+
+  // A 64-bit FNV-1a hash of the key.
+  unsigned long long h = 14695981039346656037ULL;
+  for (std::string::const_iterator p = key->begin(); p != key->end(); ++p)
+    {
+      h ^= static_cast<unsigned char>(*p);
+      h *= 1099511628211ULL;
+    }
+  snprintf(buf, sizeof buf, "/%016llx", h);
+  *path = parameters->options().input_cache();
+  path->append(buf);
+  return true;
+}
+
+// Look up INPUT_FILE in the cache.
+
+bool
+Input_cache::lookup(Input_file* input_file, std::vector<std::string>* names)
+{
+  std::string key;
+  std::string path;
+  if (!Input_cache::entry(input_file, &key, &path))
+    return false;
+
+  FILE* f = fopen(path.c_str(), "r");
+  if (f == NULL)
+    return false;
+
+  std::string contents;
+  char buf[8192];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof buf, f)) > 0)
+    contents.append(buf, len);
+  fclose(f);
+
+  std::string header(input_cache_magic);
+  header += '\n';
+  header += key;
+  header += '\n';
+  if (contents.compare(0, header.length(), header) != 0)
+    return false;
+
+  size_t pos = header.length();
+  while (pos < contents.length())
+    {
+      size_t end = contents.find('\n', pos);
+      if (end == std::string::npos)
+	return false;
+      names->push_back(contents.substr(pos, end - pos));
+      pos = end + 1;
+    }
+
+  return true;
+}
+
+// Collect the names of the global symbols defined by an object.
+
+class Input_cache_visitor : public Library_base::Symbol_visitor_base
+{
+ public:
+  Input_cache_visitor(std::string* contents)
+    : contents_(contents)
+  { }
+
+  void
+  visit(const char* name)
+  {
+    this->contents_->append(name);
+    *this->contents_ += '\n';
+  }
+
+ private:
+  std::string* contents_;
+};
+
+// Record the symbols defined by OBJ in the cache.  We write the entry
+// to a temporary file and rename it, so that a concurrent link never
+// sees a partial entry.  Failing to write the cache is not an error.
+
+void
+Input_cache::record(Input_file* input_file, Object* obj,
+		    Read_symbols_data* sd)
+{
+  if (!Input_cache::is_writable_)
+    return;
+
+  std::string key;
+  std::string path;
+  if (!Input_cache::entry(input_file, &key, &path))
+    return;
+
+  std::string contents(input_cache_magic);
+  contents += '\n';
+  contents += key;
+  contents += '\n';
+  Input_cache_visitor v(&contents);
+  obj->for_all_global_symbols(sd, &v);
+
+  std::string tmpname(path + ".XXXXXX");
+  char* tmp = xstrdup(tmpname.c_str());
+  int o = ::mkstemp(tmp);
+  if (o < 0)
+    {
+      free(tmp);
+      return;
+    }
+  bool ok = (::write(o, contents.data(), contents.length())
+	     == static_cast<ssize_t>(contents.length()));
+  if (::close(o) < 0)
+    ok = false;
+  if (!ok || ::rename(tmp, path.c_str()) < 0)
+    ::unlink(tmp);
+  free(tmp);
+}
+
 // Class Lib_group static variables.
 unsigned int Lib_group::total_lib_groups;
 unsigned int Lib_group::total_members;
 unsigned int Lib_group::total_members_loaded;
+unsigned int Lib_group::total_cached_members;
+unsigned int Lib_group::total_cached_members_loaded;
 
 Lib_group::Lib_group(const Input_file_lib* lib, Task* task)
   : Library_base(task), members_()
@@ -1156,6 +1548,11 @@ Lib_group::add_symbols(Symbol_table* symtab, Layout* layout,
   ++Lib_group::total_lib_groups;
 
   Lib_group::total_members += this->members_.size();
+  for (std::vector<Archive_member>::const_iterator p = this->members_.begin();
+       p != this->members_.end();
+       ++p)
+    if (p->cached_symbols_ != NULL)
+      ++Lib_group::total_cached_members;
 
   bool added_new_object;
   do
@@ -1168,10 +1565,28 @@ Lib_group::add_symbols(Symbol_table* symtab, Layout* layout,
 	  Object* obj = member.obj_;
 	  std::string why;
 
+	  if (member.cached_symbols_ != NULL)
+	    {
+	      if (!this->should_include_cached_member(symtab, layout, member,
+						      &why))
+		{
+		  ++i;
+		  continue;
+		}
+
+	      Archive_member m = this->read_cached_member(member);
+	      if (m.obj_ != NULL)
+		{
+		  ++Lib_group::total_cached_members_loaded;
+		  this->include_member(symtab, layout, input_objects, m);
+		  added_new_object = true;
+		}
+	      delete member.cached_symbols_;
+	    }
           // Skip files with no symbols. Plugin objects have
           // member.sd_ == NULL.
-          if (obj != NULL
-	      && (member.sd_ == NULL || member.sd_->symbol_names != NULL))
+          else if (obj != NULL
+		   && (member.sd_ == NULL || member.sd_->symbol_names != NULL))
             {
 	      Archive::Should_include t = obj->should_include_member(symtab,
 								     layout,
@@ -1208,6 +1623,69 @@ Lib_group::add_symbols(Symbol_table* symtab, Layout* layout,
   while (added_new_object);
 }
 
+// Return whether MEMBER, found in the --input-cache, should be
+// included in the link.  This is the same test as
+// Sized_relobj_file::do_should_include_member, using the cached names.
+
+bool
+Lib_group::should_include_cached_member(Symbol_table* symtab, Layout* layout,
+					const Archive_member& member,
+					std::string* why)
+{
+  char* tmpbuf = NULL;
+  size_t tmpbuflen = 0;
+  bool ret = false;
+  for (std::vector<std::string>::const_iterator p =
+	 member.cached_symbols_->begin();
+       p != member.cached_symbols_->end();
+       ++p)
+    {
+      Symbol* sym;
+      if (Library_base::should_include_member(symtab, layout, p->c_str(),
+					      &sym, why, &tmpbuf, &tmpbuflen)
+	  == Library_base::SHOULD_INCLUDE_YES)
+	{
+	  ret = true;
+	  break;
+	}
+    }
+  if (tmpbuf != NULL)
+    free(tmpbuf);
+  return ret;
+}
+
+// Read the symbols of MEMBER, which was found in the --input-cache and
+// so has not been read yet.  Return a member with the object and its
+// symbols, or with a NULL object on error.
+
+Archive_member
+Lib_group::read_cached_member(const Archive_member& member)
+{
+  Input_file* input_file = member.input_file_;
+  input_file->file().lock(this->task_);
+
+  Archive_member ret;
+  const unsigned char* ehdr;
+  int read_size;
+  if (!is_elf_object(input_file, 0, &ehdr, &read_size))
+    gold_error(_("%s: not an object file"), input_file->filename().c_str());
+  else
+    {
+      Object* obj = make_elf_object(input_file->filename(), input_file, 0,
+				    ehdr, read_size, NULL);
+      if (obj != NULL)
+	{
+	  Read_symbols_data* sd = new Read_symbols_data;
+	  obj->read_symbols(sd);
+	  ret = Archive_member(obj, sd);
+	  ret.arg_serial_ = member.arg_serial_;
+	}
+    }
+
+  input_file->file().unlock(this->task_);
+  return ret;
+}
+
 // Include a lib group member in the link.
 
 void
@@ -1243,6 +1721,28 @@ Lib_group::include_member(Symbol_table* symtab, Layout* layout,
   obj->unlock(this->task_);
 }
 
+// Free the members found in the --input-cache which were not included
+// in the link.  Nothing reads them after the lib group is done.
+
+void
+Lib_group::release_cached_members()
+{
+  unsigned int i = 0;
+  while (i < this->members_.size())
+    {
+      Archive_member& member = this->members_[i];
+      if (member.cached_symbols_ == NULL)
+	{
+	  ++i;
+	  continue;
+	}
+      delete member.cached_symbols_;
+      delete member.input_file_;
+      this->members_[i] = this->members_.back();
+      this->members_.pop_back();
+    }
+}
+
 // Iterate over all unused symbols, and call the visitor class V for each.
 
 void
@@ -1254,6 +1754,15 @@ Lib_group::do_for_all_unused_symbols(Symbol_visitor_base* v) const
        p != this->members_.end();
        ++p)
     {
+      if (p->cached_symbols_ != NULL)
+	{
+	  for (std::vector<std::string>::const_iterator q =
+		 p->cached_symbols_->begin();
+	       q != p->cached_symbols_->end();
+	       ++q)
+	    v->visit(q->c_str());
+	  continue;
+	}
       Object* obj = p->obj_;
       obj->for_all_global_symbols(p->sd_, v);
     }
@@ -1270,6 +1779,14 @@ Lib_group::print_stats()
           program_name, Lib_group::total_members);
   fprintf(stderr, _("%s: loaded lib groups members: %u\n"),
           program_name, Lib_group::total_members_loaded);
+  if (parameters->options().user_set_input_cache())
+    {
+      fprintf(stderr, _("%s: lib groups members found in input cache: %u\n"),
+	      program_name, Lib_group::total_cached_members);
+      fprintf(stderr, _("%s: loaded lib groups members from input cache: "
+			"%u\n"),
+	      program_name, Lib_group::total_cached_members_loaded);
+    }
 }
 
 Task_token*
@@ -1300,6 +1817,8 @@ Add_lib_group_symbols::run(Workqueue*)
 
   if (incremental_inputs != NULL)
     incremental_inputs->report_archive_end(this->lib_);
+
+  this->lib_->release_cached_members();
 }
 
 Add_lib_group_symbols::~Add_lib_group_symbols()
@@ -48,10 +48,12 @@ class Incremental_archive_entry;
 struct Archive_member
 {
   Archive_member()
-      : obj_(NULL), sd_(NULL), arg_serial_(0)
+      : obj_(NULL), sd_(NULL), arg_serial_(0), input_file_(NULL),
+	cached_symbols_(NULL)
   { }
   Archive_member(Object* obj, Read_symbols_data* sd)
-      : obj_(obj), sd_(sd), arg_serial_(0)
+      : obj_(obj), sd_(sd), arg_serial_(0), input_file_(NULL),
+	cached_symbols_(NULL)
   { }
   // The object file.
   Object* obj_;
@@ -59,6 +61,56 @@ struct Archive_member
   Read_symbols_data* sd_;
   // The serial number of the file in the argument list.
   unsigned int arg_serial_;
+  // For a lib group member found in the --input-cache, the input file,
+  // which has not been read, and the global symbols it defines.  OBJ_
+  // and SD_ are NULL until the member is included.
+  Input_file* input_file_;
+  std::vector<std::string>* cached_symbols_;
+};
+
+// This class manages the --input-cache directory.  For each object in
+// a --start-lib group, it records the names of the global symbols the
+// object defines, which is all we need to decide whether to include
+// the object.  On later links, objects found in the cache are not read
+// unless they are included.  An entry is keyed by the name, device,
+// inode, modification time and size of the file.  Entries are never
+// removed; an entry for a file which has changed is simply not used
+// again, so the directory should be cleaned out from time to time.
+
+class Input_cache
+{
+ public:
+  // Create the cache directory if it does not exist.  This is called
+  // before any input files are read.  If the directory can not be
+  // created, we warn and do not use the cache.  If it can not be
+  // written, we warn and do not record new entries.
+  static void
+  initialize();
+
+  // Return whether to look up files in the cache.
+  static bool
+  is_enabled()
+  { return Input_cache::is_enabled_; }
+
+  // Look up INPUT_FILE in the cache.  If it is found, store the names
+  // of the symbols it defines in *NAMES and return true.
+  static bool
+  lookup(Input_file* input_file, std::vector<std::string>* names);
+
+  // Record the symbols defined by OBJ, read from INPUT_FILE into SD.
+  static void
+  record(Input_file* input_file, Object* obj, Read_symbols_data* sd);
+
+ private:
+  // Set *KEY to the key for INPUT_FILE, and *PATH to the name of the
+  // cache entry.  Return false if the file can not be cached.
+  static bool
+  entry(Input_file* input_file, std::string* key, std::string* path);
+
+  // Whether the cache directory exists.
+  static bool is_enabled_;
+  // Whether we can write new entries to the cache directory.
+  static bool is_writable_;
 };
 
 // This class serves as a base class for Archive and Lib_group objects.
@@ -284,6 +336,31 @@ class Archive : public Library_base
   // Number of archive members loaded.
   static unsigned int total_members_loaded;
 
+  // Statistics kept for each archive for --stats.
+  struct Archive_stats
+  {
+    Archive_stats(const std::string& n)
+      : name(n), time(0), members_loaded(0), members_read(0),
+	members_read_used(0)
+    { }
+
+    // The name of the archive.
+    std::string name;
+    // The wall clock time spent selecting members, in milliseconds.
+    long time;
+    // The number of members included in the link.
+    unsigned int members_loaded;
+    // The number of members read by read_candidate_members.
+    unsigned int members_read;
+    // The number of those which were included in the link.
+    unsigned int members_read_used;
+  };
+
+  // Statistics for each archive, in the order in which they were
+  // first searched.  Archive objects are deleted before we print the
+  // statistics, so we keep them here.
+  static std::vector<Archive_stats> archive_stats;
+
   // Get a view into the underlying file.
   const unsigned char*
   get_view(off_t start, section_size_type size, bool aligned, bool cache)
@@ -327,6 +404,25 @@ class Archive : public Library_base
   void
   read_symbols(off_t off);
 
+  // Read, on several threads, the members which the archive map
+  // says define a symbol which is currently undefined, so that
+  // include_member finds them in members_.
+  void
+  read_candidate_members(Symbol_table*, Layout*);
+
+  // A job which reads candidate archive members.
+  class Read_members_job;
+
+  // Free the members read by read_candidate_members which were not
+  // included in the link.
+  void
+  release_candidate_members();
+
+  // Select members from the archive and add them to the link, for
+  // add_symbols.
+  bool
+  do_add_symbols(Symbol_table*, Layout*, Input_objects*, Mapfile*);
+
   // Include all the archive members in the link.
   bool
   include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*);
@@ -393,6 +489,9 @@ class Archive : public Library_base
   Unordered_set<off_t, Seen_hash> seen_offsets_;
   // Table of objects whose symbols have been pre-read.
   std::map<off_t, Archive_member> members_;
+  // The offsets of the members in members_ which were read by
+  // read_candidate_members and have not been included yet.
+  Unordered_set<off_t, Seen_hash> candidate_offsets_;
   // True if this is a thin archive.
   const bool is_thin_archive_;
   // True if we have included at least one object from this archive.
@@ -407,6 +506,8 @@ class Archive : public Library_base
   bool no_export_;
   // True if this library has been included as a --whole-archive.
   bool included_all_members_;
+  // Index of the entry for this archive in archive_stats, or -1U.
+  unsigned int stats_index_;
 };
 
 // This class is used to read an archive and pick out the desired
@@ -479,6 +580,12 @@ class Lib_group : public Library_base
   void
   include_member(Symbol_table*, Layout*, Input_objects*, const Archive_member&);
 
+  // Free the members found in the --input-cache which were not
+  // included in the link.  This is called once the unused symbols
+  // have been reported.
+  void
+  release_cached_members();
+
   Archive_member*
   get_member(int i)
   {
@@ -491,12 +598,26 @@ class Lib_group : public Library_base
   static unsigned int total_members;
   // Number of archive members loaded.
   static unsigned int total_members_loaded;
+  // Number of archive members found in the --input-cache.
+  static unsigned int total_cached_members;
+  // Number of those members which were loaded.
+  static unsigned int total_cached_members_loaded;
 
   // Dump statistical information to stderr.
   static void
   print_stats();
 
  private:
+  // Return whether the member MEMBER found in the --input-cache
+  // should be included in the link.
+  bool
+  should_include_cached_member(Symbol_table*, Layout*,
+			       const Archive_member& member, std::string* why);
+
+  // Read the symbols of MEMBER, found in the --input-cache.
+  Archive_member
+  read_cached_member(const Archive_member& member);
+
   // The file name.
   const std::string&
   do_filename() const;
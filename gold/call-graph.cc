@@ -0,0 +1,318 @@
+// call-graph.cc -- order functions using a call graph profile
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "elfcpp.h"
+#include "symtab.h"
+#include "layout.h"
+#include "output.h"
+#include "call-graph.h"
+
+namespace gold
+{
+
+// The largest cluster we build.  Beyond this, placing a function
+// near its caller gains little.
+const uint64_t max_cluster_size = 1024 * 1024;
+
+// We do not merge a cluster into the cluster of its most frequent
+// caller if that would make the density of the caller's cluster fall
+// below 1/max_density_degradation of its current density.
+const unsigned int max_density_degradation = 8;
+
+// Class Call_graph_sort.
+
+// Return the node for the function NAME, creating it if necessary.
+// Return -1U if NAME is not a function defined in an input section
+// which we are including in the link.
+
+unsigned int
+Call_graph_sort::find_node(const char* name, const Task* task,
+			   const Symbol_table* symtab)
+{
+  Symbol* sym = symtab->lookup(name);
+  if (sym == NULL
+      || sym->source() != Symbol::FROM_OBJECT
+      || !sym->is_defined())
+    return -1U;
+
+  bool is_ordinary;
+  unsigned int shndx = sym->shndx(&is_ordinary);
+  Object* obj = sym->object();
+  if (!is_ordinary || obj->is_dynamic() || obj->pluginobj() != NULL)
+    return -1U;
+
+  // The section may have been discarded by --gc-sections or as a
+  // duplicate COMDAT section.
+  if (obj->output_section(shndx) == NULL)
+    return -1U;
+
+  Section_id secn(obj, shndx);
+  Node_index::const_iterator p = this->node_index_.find(secn);
+  if (p != this->node_index_.end())
+    return p->second;
+
+  Task_lock_obj<Object> tl(task, obj);
+  if ((obj->section_flags(shndx) & elfcpp::SHF_EXECINSTR) == 0)
+    return -1U;
+
+  unsigned int index = this->nodes_.size();
+  this->nodes_.push_back(Node(secn, obj->section_name(shndx),
+			      obj->section_size(shndx)));
+  this->node_index_[secn] = index;
+  return index;
+}
+
+// Read the profile in FILENAME.
+
+void
+Call_graph_sort::read_profile(const char* filename, const Task* task,
+			      const Symbol_table* symtab)
+{
+  std::ifstream in;
+  in.open(filename);
+  if (!in)
+    gold_fatal(_("unable to open --call-graph-profile file %s: %s"),
+	       filename, strerror(errno));
+
+  std::string line;
+  unsigned int lineno = 0;
+  while (std::getline(in, line))
+    {
+      ++lineno;
+      if (!line.empty() && line[line.length() - 1] == '\r')
+	line.resize(line.length() - 1);
+      if (line.empty() || line[0] == '#')
+	continue;
+
+      std::istringstream fields(line);
+      std::string caller;
+      std::string callee;
+      uint64_t count;
+      if (!(fields >> caller >> callee >> count))
+	{
+	  gold_warning(_("%s:%u: ignoring malformed call graph profile line"),
+		       filename, lineno);
+	  continue;
+	}
+
+      unsigned int from = this->find_node(caller.c_str(), task, symtab);
+      unsigned int to = this->find_node(callee.c_str(), task, symtab);
+      if (from == -1U)
+	++this->unknown_names_;
+      if (to == -1U)
+	++this->unknown_names_;
+      if (from == -1U || to == -1U || from == to || count == 0)
+	continue;
+
+      // We can only place the functions near each other if they are
+      // in the same output section.
+      const Section_id& from_secn(this->nodes_[from].secn);
+      const Section_id& to_secn(this->nodes_[to].secn);
+      if (from_secn.first->output_section(from_secn.second)
+	  != to_secn.first->output_section(to_secn.second))
+	continue;
+
+      this->edges_[std::make_pair(from, to)] += count;
+    }
+}
+
+// Compare clusters by decreasing density.  Clusters with the same
+// density stay in the order of their indexes, so that the result
+// does not depend on the sort implementation.
+
+class Call_graph_sort::Cluster_density_compare
+{
+ public:
+  Cluster_density_compare(const std::vector<Cluster>& clusters)
+    : clusters_(clusters)
+  { }
+
+  bool
+  operator()(unsigned int a, unsigned int b) const
+  {
+    double da = this->clusters_[a].density();
+    double db = this->clusters_[b].density();
+    if (da != db)
+      return da > db;
+    return a < b;
+  }
+
+ private:
+  const std::vector<Cluster>& clusters_;
+};
+
+// Return the index of the cluster which holds node I.  LEADERS maps
+// each node to a node in the same cluster, ending at the node which
+// started the cluster.
+
+static unsigned int
+find_leader(std::vector<unsigned int>* leaders, unsigned int i)
+{
+  while ((*leaders)[i] != i)
+    {
+      (*leaders)[i] = (*leaders)[(*leaders)[i]];
+      i = (*leaders)[i];
+    }
+  return i;
+}
+
+// Compute the order of the nodes.  Each node starts in a cluster of
+// its own.  We visit the clusters in order of decreasing density,
+// and append each one to the cluster holding the node which calls it
+// most often, unless that would make the cluster too large or too
+// sparse.  Finally the clusters are placed in order of decreasing
+// density.
+
+void
+Call_graph_sort::compute_order()
+{
+  const unsigned int count = this->nodes_.size();
+
+  // The edges are sorted by caller, so on a tie we pick the caller
+  // which the profile named first.
+  for (Edges::const_iterator p = this->edges_.begin();
+       p != this->edges_.end();
+       ++p)
+    {
+      Node& to(this->nodes_[p->first.second]);
+      to.weight += p->second;
+      if (p->second > to.best_pred_weight)
+	{
+	  to.best_pred = p->first.first;
+	  to.best_pred_weight = p->second;
+	}
+    }
+
+  this->clusters_.resize(count);
+  std::vector<unsigned int> leaders(count);
+  std::vector<unsigned int> sorted(count);
+  for (unsigned int i = 0; i < count; ++i)
+    {
+      Cluster& c(this->clusters_[i]);
+      c.nodes.push_back(i);
+      c.size = this->nodes_[i].size;
+      c.weight = this->nodes_[i].weight;
+      leaders[i] = i;
+      sorted[i] = i;
+    }
+  std::sort(sorted.begin(), sorted.end(),
+	    Cluster_density_compare(this->clusters_));
+
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      const Node& node(this->nodes_[*p]);
+
+      // Skip a function which is not called often enough by any one
+      // caller for the placement to matter.
+      if (node.best_pred == -1U
+	  || node.best_pred_weight * 10 <= node.weight)
+	continue;
+
+      unsigned int pred = find_leader(&leaders, node.best_pred);
+      if (pred == *p)
+	continue;
+
+      Cluster& c(this->clusters_[*p]);
+      Cluster& pc(this->clusters_[pred]);
+      if (c.size + pc.size > max_cluster_size)
+	continue;
+      double new_density = (static_cast<double>(c.weight + pc.weight)
+			    / (c.size + pc.size + 1));
+      if (new_density < pc.density() / max_density_degradation)
+	continue;
+
+      pc.nodes.insert(pc.nodes.end(), c.nodes.begin(), c.nodes.end());
+      pc.size += c.size;
+      pc.weight += c.weight;
+      c.nodes.clear();
+      c.size = 0;
+      c.weight = 0;
+      leaders[*p] = pred;
+    }
+
+  sorted.clear();
+  for (unsigned int i = 0; i < count; ++i)
+    if (leaders[i] == i)
+      sorted.push_back(i);
+  std::sort(sorted.begin(), sorted.end(),
+	    Cluster_density_compare(this->clusters_));
+
+  this->order_.clear();
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      const Cluster& c(this->clusters_[*p]);
+      this->order_.insert(this->order_.end(), c.nodes.begin(), c.nodes.end());
+    }
+}
+
+// Set the order of the input sections.  The sections named in the
+// profile are placed after the other input sections in their output
+// section, in the order we computed.  In .text, the sections such as
+// .text.unlikely and .text.hot are still grouped as usual, and the
+// order applies within each group.
+
+void
+Call_graph_sort::apply_order(Layout* layout) const
+{
+  Output_section::Section_layout_order order_map;
+  for (unsigned int i = 0; i < this->order_.size(); ++i)
+    order_map[this->nodes_[this->order_[i]].secn] = i + 1;
+
+  for (Layout::Section_list::const_iterator p = layout->section_list().begin();
+       p != layout->section_list().end();
+       ++p)
+    (*p)->update_section_layout(&order_map);
+}
+
+// Print the order, for --print-order.
+
+void
+Call_graph_sort::print_order() const
+{
+  for (unsigned int i = 0; i < this->order_.size(); ++i)
+    {
+      const Node& node(this->nodes_[this->order_[i]]);
+      gold_info(_("%s: call graph order %u: section '%s' in file '%s' "
+		  "(size %llu, calls %llu)"),
+		program_name, i + 1, node.name.c_str(),
+		node.secn.first->name().c_str(),
+		static_cast<unsigned long long>(node.size),
+		static_cast<unsigned long long>(node.weight));
+    }
+  if (this->unknown_names_ > 0)
+    gold_info(_("%s: ignored %u names in the call graph profile which are "
+		"not functions in the link"),
+	      program_name, this->unknown_names_);
+}
+
+} // End namespace gold.
@@ -0,0 +1,151 @@
+// call-graph.h -- order functions using a call graph profile  -*- C++ -*-
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_CALL_GRAPH_H
+#define GOLD_CALL_GRAPH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "object.h"
+
+namespace gold
+{
+
+class Task;
+class Symbol_table;
+class Layout;
+
+// This class implements --call-graph-profile.  It reads a profile of
+// the calls between functions and orders the input sections which
+// hold the functions so that each function is placed near the
+// function which calls it most often, using the C3 heuristic of
+// Ottoni and Maher, "Optimizing Function Placement for Large-Scale
+// Data-Center Applications".
+
+// The profile is a text file.  Each line holds the name of a calling
+// function, the name of the called function and the number of calls,
+// separated by white space.  This is the format used by the
+// --call-graph-ordering-file option of other linkers, and the call
+// edges which perf records can be converted to it.  Lines beginning
+// with '#' are comments.
+
+class Call_graph_sort
+{
+ public:
+  Call_graph_sort()
+    : nodes_(), node_index_(), edges_(), clusters_(), order_(),
+      unknown_names_(0)
+  { }
+
+  // Read the profile in FILENAME.  The functions are looked up in
+  // SYMTAB; functions which are not defined in an input section in
+  // the same output section as the other function of the call are
+  // ignored.  TASK is used to lock the objects.
+  void
+  read_profile(const char* filename, const Task* task,
+	       const Symbol_table* symtab);
+
+  // Compute the order of the input sections.
+  void
+  compute_order();
+
+  // Set the order of the input sections in the output sections of
+  // LAYOUT.
+  void
+  apply_order(Layout* layout) const;
+
+  // Print the order on stderr, for --print-order.
+  void
+  print_order() const;
+
+ private:
+  // An input section which holds a function named in the profile.
+  struct Node
+  {
+    Node(const Section_id& s, const std::string& n, uint64_t sz)
+      : secn(s), name(n), size(sz), weight(0), best_pred(-1U),
+	best_pred_weight(0)
+    { }
+
+    // The input section.
+    Section_id secn;
+    // The name of the section.
+    std::string name;
+    // The size of the section.
+    uint64_t size;
+    // The number of calls to the section.
+    uint64_t weight;
+    // The node which calls this one most often, or -1U.
+    unsigned int best_pred;
+    // The number of those calls.
+    uint64_t best_pred_weight;
+  };
+
+  // A cluster of nodes which are placed together.
+  struct Cluster
+  {
+    Cluster()
+      : nodes(), size(0), weight(0)
+    { }
+
+    // The density of the cluster: the number of calls per byte.
+    double
+    density() const
+    { return static_cast<double>(this->weight) / (this->size + 1); }
+
+    // The nodes in the cluster, in order.
+    std::vector<unsigned int> nodes;
+    // The total size of the nodes.
+    uint64_t size;
+    // The total weight of the nodes.
+    uint64_t weight;
+  };
+
+  typedef Unordered_map<Section_id, unsigned int, Section_id_hash>
+    Node_index;
+  typedef std::map<std::pair<unsigned int, unsigned int>, uint64_t> Edges;
+
+  // Return the node for the function NAME, or -1U.
+  unsigned int
+  find_node(const char* name, const Task* task, const Symbol_table* symtab);
+
+  // Compare clusters by decreasing density.
+  class Cluster_density_compare;
+
+  // The nodes, in the order in which the profile names them.
+  std::vector<Node> nodes_;
+  // Map from input section to node index.
+  Node_index node_index_;
+  // The number of calls between each pair of nodes.
+  Edges edges_;
+  // The clusters, indexed by the node which started them.
+  std::vector<Cluster> clusters_;
+  // The nodes in their final order.
+  std::vector<unsigned int> order_;
+  // The number of names in the profile which we could not find.
+  unsigned int unknown_names_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_CALL_GRAPH_H)
@@ -26,8 +26,12 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
+#include <vector>
+
 #include "parameters.h"
 #include "options.h"
+#include "gold-threads.h"
 #include "compressed_output.h"
 
 namespace gold
@@ -35,6 +39,163 @@ namespace gold
 
 #ifdef HAVE_ZLIB_H
 
+// A job which compresses a buffer in independent chunks.  Each
+// chunk is compressed as raw deflate data, ending with a full flush
+// so that the next chunk starts on a byte boundary with an empty
+// dictionary.  The chunks can then simply be concatenated, between a
+// zlib header and the combined Adler-32 checksum, to form a single
+// zlib stream.  The output depends only on the chunk size, not on
+// the number of threads.
+
+class Zlib_compress_job : public Parallel_job
+{
+ public:
+  Zlib_compress_job(const unsigned char* data, unsigned long size,
+		    unsigned long chunk_size, int level)
+    : data_(data), size_(size), chunk_size_(chunk_size), level_(level),
+      chunks_((size + chunk_size - 1) / chunk_size)
+  { }
+
+  ~Zlib_compress_job()
+  {
+    for (std::vector<Chunk>::iterator p = this->chunks_.begin();
+	 p != this->chunks_.end();
+	 ++p)
+      delete[] p->data;
+  }
+
+  // The number of chunks.
+  unsigned int
+  chunk_count() const
+  { return this->chunks_.size(); }
+
+  // Compress chunk I.
+  void
+  run_piece(unsigned int i);
+
+  // Write the zlib stream to OUT, which must hold stream_size()
+  // bytes, and return its size.  Return 0 if any chunk failed to compress.
+  unsigned long
+  write_stream(unsigned char* out) const;
+
+  // The size of the zlib stream, once all the chunks are compressed.
+  unsigned long
+  stream_size() const;
+
+ private:
+  // The compressed data for a chunk.
+  struct Chunk
+  {
+    Chunk()
+      : data(NULL), size(0), adler(0)
+    { }
+
+    // The compressed data, or NULL if compression failed.
+    unsigned char* data;
+    // The size of the compressed data.
+    unsigned long size;
+    // The Adler-32 checksum of the uncompressed chunk.
+    unsigned long adler;
+  };
+
+  const unsigned char* data_;
+  unsigned long size_;
+  unsigned long chunk_size_;
+  int level_;
+  std::vector<Chunk> chunks_;
+};
+
+void
+Zlib_compress_job::run_piece(unsigned int i)
+{
+  unsigned long start = i * this->chunk_size_;
+  unsigned long len = std::min(this->chunk_size_, this->size_ - start);
+  bool is_last = i + 1 == this->chunks_.size();
+  Chunk* chunk = &this->chunks_[i];
+
+  z_stream strm;
+  strm.zalloc = NULL;
+  strm.zfree = NULL;
+  strm.opaque = NULL;
+  if (deflateInit2(&strm, this->level_, Z_DEFLATED, -MAX_WBITS, 8,
+		   Z_DEFAULT_STRATEGY) != Z_OK)
+    return;
+
+  // A full flush adds at most an empty stored block to the bound.
+  unsigned long alc = deflateBound(&strm, len) + 8;
+  unsigned char* out = new unsigned char[alc];
+  strm.next_in = const_cast<Bytef*>(this->data_ + start);
+  strm.avail_in = len;
+  strm.next_out = out;
+  strm.avail_out = alc;
+  int rc = deflate(&strm, is_last ? Z_FINISH : Z_FULL_FLUSH);
+  bool ok = (is_last
+	     ? rc == Z_STREAM_END
+	     : rc == Z_OK && strm.avail_in == 0 && strm.avail_out != 0);
+  deflateEnd(&strm);
+  if (!ok)
+    {
+      delete[] out;
+      return;
+    }
+
+  chunk->data = out;
+  chunk->size = alc - strm.avail_out;
+  chunk->adler = adler32(adler32(0, NULL, 0), this->data_ + start, len);
+}
+
+unsigned long
+Zlib_compress_job::stream_size() const
+{
+  // Two bytes of header and four bytes of checksum.
+  unsigned long size = 6;
+  for (std::vector<Chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    size += p->size;
+  return size;
+}
+
+unsigned long
+Zlib_compress_job::write_stream(unsigned char* out) const
+{
+  // The zlib header: deflate with a 32K window, and the compression
+  // level in the same form that zlib uses.
+  unsigned int cmf = 0x78;
+  unsigned int flevel;
+  if (this->level_ < 2)
+    flevel = 0;
+  else if (this->level_ < 6)
+    flevel = 1;
+  else if (this->level_ == 6)
+    flevel = 2;
+  else
+    flevel = 3;
+  unsigned int flg = flevel << 6;
+  flg += 31 - (cmf * 256 + flg) % 31;
+
+  unsigned char* p = out;
+  *p++ = cmf;
+  *p++ = flg;
+
+  unsigned long adler = adler32(0, NULL, 0);
+  for (unsigned int i = 0; i < this->chunks_.size(); ++i)
+    {
+      const Chunk& chunk(this->chunks_[i]);
+      if (chunk.data == NULL)
+	return 0;
+      memcpy(p, chunk.data, chunk.size);
+      p += chunk.size;
+      unsigned long len = std::min(this->chunk_size_,
+				   this->size_ - i * this->chunk_size_);
+      adler = adler32_combine(adler, chunk.adler, len);
+    }
+
+  elfcpp::Swap_unaligned<32, true>::writeval(p, adler);
+  p += 4;
+  return p - out;
+}
+
 // Compress UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns true
 // if it successfully compressed, false if it failed for any reason
 // (including not having zlib support in the library).  If it returns
@@ -42,7 +203,9 @@ namespace gold
 // sets *COMPRESSED_DATA and *COMPRESSED_SIZE to appropriate values.
 // It also writes a header before COMPRESSED_DATA: 4 bytes saying
 // "ZLIB", and 8 bytes indicating the uncompressed size, in big-endian
-// order.
+// order.  If --compress-debug-sections-chunk-size is used, data
+// larger than that is compressed in chunks, on several threads if we
+// are using threads.
 
 static bool
 zlib_compress(const unsigned char* uncompressed_data,
@@ -51,8 +214,6 @@ zlib_compress(const unsigned char* uncompressed_data,
               unsigned long* compressed_size)
 {
   const int header_size = 12;
-  *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
-  *compressed_data = new unsigned char[*compressed_size + header_size];
 
   int compress_level;
   if (parameters->options().optimize() >= 1)
@@ -60,25 +221,53 @@ zlib_compress(const unsigned char* uncompressed_data,
   else
     compress_level = 1;
 
-  int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data) + header_size,
-                     compressed_size,
-                     reinterpret_cast<const Bytef*>(uncompressed_data),
-                     uncompressed_size,
-                     compress_level);
-  if (rc == Z_OK)
+  // zlib takes the amount of input and output space for each call to
+  // deflate as a 32-bit uInt, so we keep chunks well below 4G.
+  const unsigned long max_chunk_size = 1UL << 30;
+  unsigned long chunk_size =
+    parameters->options().compress_debug_sections_chunk_size();
+  if (chunk_size > max_chunk_size)
+    chunk_size = max_chunk_size;
+  if (chunk_size != 0 && uncompressed_size > chunk_size)
     {
-      memcpy(*compressed_data, "ZLIB", 4);
-      elfcpp::Swap_unaligned<64, true>::writeval(*compressed_data + 4,
-						 uncompressed_size);
-      *compressed_size += header_size;
-      return true;
+      Zlib_compress_job job(uncompressed_data, uncompressed_size, chunk_size,
+			    compress_level);
+      run_in_parallel(&job, job.chunk_count());
+
+      *compressed_data = new unsigned char[job.stream_size()
+					   + header_size];
+      *compressed_size = job.write_stream(*compressed_data + header_size);
+      if (*compressed_size == 0)
+	{
+	  delete[] *compressed_data;
+	  *compressed_data = NULL;
+	  return false;
+	}
     }
   else
     {
-      delete[] *compressed_data;
-      *compressed_data = NULL;
-      return false;
+      *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
+      *compressed_data = new unsigned char[*compressed_size + header_size];
+
+      int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data)
+			 + header_size,
+			 compressed_size,
+			 reinterpret_cast<const Bytef*>(uncompressed_data),
+			 uncompressed_size,
+			 compress_level);
+      if (rc != Z_OK)
+	{
+	  delete[] *compressed_data;
+	  *compressed_data = NULL;
+	  return false;
+	}
     }
+
+  memcpy(*compressed_data, "ZLIB", 4);
+  elfcpp::Swap_unaligned<64, true>::writeval(*compressed_data + 4,
+					     uncompressed_size);
+  *compressed_size += header_size;
+  return true;
 }
 
 // Decompress COMPRESSED_DATA of size COMPRESSED_SIZE, into a buffer
@@ -487,17 +487,25 @@ Dwarf_pubnames_table::read_section(Relobj* object, const unsigned char* symtab,
   section_size_type buffer_size;
   unsigned int shndx = 0;
 
-  // Find the .debug_pubnames/pubtypes section.
+  // Find the .debug_pubnames/pubtypes section.  Prefer the GNU-style
+  // section if there is one, since it also records the symbol kinds.
   const char* name = (this->is_pubtypes_
                       ? ".debug_pubtypes"
                       : ".debug_pubnames");
+  const char* gnu_name = (this->is_pubtypes_
+			  ? ".debug_gnu_pubtypes"
+			  : ".debug_gnu_pubnames");
   for (unsigned int i = 1; i < object->shnum(); ++i)
     {
-      if (object->section_name(i) == name)
+      std::string section_name = object->section_name(i);
+      if (section_name == gnu_name
+	  || (section_name == name && shndx == 0))
         {
           shndx = i;
           this->output_section_offset_ = object->output_section_offset(i);
-          break;
+	  this->is_gnu_style_ = section_name == gnu_name;
+	  if (this->is_gnu_style_)
+	    break;
         }
     }
   if (shndx == 0)
@@ -593,7 +601,7 @@ Dwarf_pubnames_table::read_header(off_t offset)
 // Read the next name from the set.
 
 const char*
-Dwarf_pubnames_table::next_name()
+Dwarf_pubnames_table::next_name(uint8_t* flag_byte)
 {
   const unsigned char* pinfo = this->pinfo_;
 
@@ -607,6 +615,17 @@ Dwarf_pubnames_table::next_name()
   if (offset == 0)
     return NULL;
 
+  // In a GNU-style table, the flag byte precedes the name.
+  uint8_t flags = 0;
+  if (this->is_gnu_style_)
+    {
+      if (pinfo >= this->buffer_end_)
+	return NULL;
+      flags = *pinfo++;
+    }
+  if (flag_byte != NULL)
+    *flag_byte = flags;
+
   // Return a pointer to the string at the current location,
   // and advance the pointer to the next entry.
   const char* ret = reinterpret_cast<const char*>(pinfo);
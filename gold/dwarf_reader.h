@@ -393,7 +393,9 @@ class Dwarf_ranges_table
 };
 
 // This class is used to read the pubnames and pubtypes tables from the
-// .debug_pubnames and .debug_pubtypes sections of the object file.
+// .debug_pubnames and .debug_pubtypes sections of the object file, or
+// from the .debug_gnu_pubnames and .debug_gnu_pubtypes sections, which
+// add a flag byte to each name.
 
 class Dwarf_pubnames_table
 {
@@ -401,7 +403,8 @@ class Dwarf_pubnames_table
   Dwarf_pubnames_table(Dwarf_info_reader* dwinfo, bool is_pubtypes)
     : dwinfo_(dwinfo), buffer_(NULL), buffer_end_(NULL), owns_buffer_(false),
       offset_size_(0), pinfo_(NULL), is_pubtypes_(is_pubtypes),
-      output_section_offset_(0), unit_length_(0), cu_offset_(0)
+      is_gnu_style_(false), output_section_offset_(0), unit_length_(0),
+      cu_offset_(0)
   { }
 
   ~Dwarf_pubnames_table()
@@ -431,9 +434,12 @@ class Dwarf_pubnames_table
   subsection_size()
   { return this->unit_length_; }
 
-  // Read the next name from the set.
+  // Read the next name from the set.  If FLAG_BYTE is not NULL, set
+  // *FLAG_BYTE to the flag byte of a GNU-style table, which holds the
+  // symbol kind and static flag in the form used by .gdb_index, or to
+  // zero for a standard table.
   const char*
-  next_name();
+  next_name(uint8_t* flag_byte);
 
  private:
   // The Dwarf_info_reader, for reading data.
@@ -449,6 +455,8 @@ class Dwarf_pubnames_table
   const unsigned char* pinfo_;
   // TRUE if this is a .debug_pubtypes section.
   bool is_pubtypes_;
+  // TRUE if this is a .debug_gnu_pubnames or .debug_gnu_pubtypes section.
+  bool is_gnu_style_;
   // For incremental update links, this will hold the offset of the
   // input section within the output section.  Offsets read from
   // relocated data will be relative to the output section, and need
@@ -45,6 +45,7 @@
 #include "compressed_output.h"
 #include "stringpool.h"
 #include "dwarf_reader.h"
+#include "gold-threads.h"
 
 static void
 usage(FILE* fd, int) ATTRIBUTE_NORETURN;
@@ -99,6 +100,23 @@ struct Unit_set
   { }
 };
 
+// A compilation unit or type unit found in the .debug_info.dwo or
+// .debug_types.dwo section of a .dwo file.
+
+struct Unit_entry
+{
+  // The DWO id of a compilation unit, or the signature of a type unit.
+  uint64_t signature;
+  // The offset and length of the unit within the input section.
+  section_offset_type offset;
+  section_size_type length;
+
+  Unit_entry(uint64_t s, section_offset_type o, section_size_type l)
+    : signature(s), offset(o), length(l)
+  { }
+};
+typedef std::vector<Unit_entry> Unit_list;
+
 // An input file.
 // This class may represent a .dwo file, a .dwp file
 // produced by an earlier run, or an executable file whose
@@ -108,9 +126,15 @@ class Dwo_file
 {
  public:
   Dwo_file(const char* name)
-    : name_(name), obj_(NULL), input_file_(NULL), is_compressed_(),
-      sect_offsets_(), str_offset_map_()
-  { }
+    : name_(name), obj_(NULL), input_file_(NULL), machine_(0), size_(0),
+      big_endian_(false), osabi_(0), abiversion_(0), is_compressed_(),
+      debug_types_(), debug_str_(0), debug_cu_index_(0), debug_tu_index_(0),
+      strings_(), info_units_(), types_units_(), sect_offsets_(),
+      str_offset_map_()
+  {
+    for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
+      this->debug_shndx_[i] = 0;
+  }
 
   ~Dwo_file();
 
@@ -119,9 +143,18 @@ class Dwo_file
   void
   read_executable(File_list* files);
 
-  // Read the input file and send its contents to OUTPUT_FILE.
+  // Read the input file and do the work which does not depend on the
+  // other input files: decompress the sections, hash the strings, and
+  // find the compilation and type units.  This may be run on any
+  // thread.
   void
-  read(Dwp_output_file* output_file);
+  read_input();
+
+  // Send the contents of the input file, read by read_input, to
+  // OUTPUT_FILE.  The input files must be added in order, so that the
+  // output does not depend on the number of threads.
+  void
+  add_to_output(Dwp_output_file* output_file);
 
   // Verify a .dwp file given a list of .dwo files referenced by the
   // corresponding executable file.  Returns true if no problems
@@ -144,16 +177,28 @@ class Dwo_file
     { return i1.first < i2.first; }
   };
 
+  // A string in the input string table, with its hash code.
+  struct Input_string
+  {
+    const char* str;
+    size_t len;
+    size_t hash_code;
+
+    Input_string(const char* s, size_t l, size_t h)
+      : str(s), len(l), hash_code(h)
+    { }
+  };
+  typedef std::vector<Input_string> Input_strings;
+
   // Create a Sized_relobj_dwo of the given size and endianness,
-  // and record the target info.  P is a pointer to the ELF header
+  // and save the target info.  P is a pointer to the ELF header
   // in memory.
   Relobj*
-  make_object(Dwp_output_file* output_file);
+  make_object();
 
   template <int size, bool big_endian>
   Relobj*
-  sized_make_object(const unsigned char* p, Input_file* input_file,
-		    Dwp_output_file* output_file);
+  sized_make_object(const unsigned char* p, Input_file* input_file);
 
   // Return the number of sections in the input object file.
   unsigned int
@@ -198,9 +243,13 @@ class Dwo_file
   bool
   sized_verify_dwo_list(unsigned int, const File_list& files);
 
+  // Read the input string table section and hash the strings.
+  void
+  read_strings(unsigned int);
+
   // Merge the input string table section into the output file.
   void
-  add_strings(Dwp_output_file*, unsigned int);
+  add_strings(Dwp_output_file*);
 
   // Copy a section from the input file to the output file.
   Section_bounds
@@ -220,11 +269,11 @@ class Dwo_file
   unsigned int
   remap_str_offset(section_offset_type val);
 
-  // Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-  // to OUTPUT_FILE.
+  // Add the units in UNITS, from a .debug_info.dwo or .debug_types.dwo
+  // section, and the related sections to OUTPUT_FILE.
   void
   add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-	       bool is_debug_types);
+	       bool is_debug_types, const Unit_list& units);
 
   // The filename.
   const char* name_;
@@ -232,8 +281,31 @@ class Dwo_file
   Relobj* obj_;
   // The Input_file object.
   Input_file* input_file_;
+  // ELF header parameters.
+  int machine_;
+  int size_;
+  bool big_endian_;
+  int osabi_;
+  int abiversion_;
   // Flags indicating which sections are compressed.
   std::vector<bool> is_compressed_;
+  // The section index of each debug section, indexed by DW_SECT.
+  // The DW_SECT_TYPES entry is set when processing each section in
+  // DEBUG_TYPES_.
+  unsigned int debug_shndx_[elfcpp::DW_SECT_MAX + 1];
+  // The .debug_types.dwo sections.
+  std::vector<unsigned int> debug_types_;
+  // The .debug_str.dwo section.
+  unsigned int debug_str_;
+  // The .debug_cu_index and .debug_tu_index sections of a .dwp file.
+  unsigned int debug_cu_index_;
+  unsigned int debug_tu_index_;
+  // The strings in the .debug_str.dwo section.
+  Input_strings strings_;
+  // The compilation units in the .debug_info.dwo section.
+  Unit_list info_units_;
+  // The type units in each of the DEBUG_TYPES_ sections.
+  std::vector<Unit_list> types_units_;
   // Map input section index onto output section offset and size.
   std::vector<Section_bounds> sect_offsets_;
   // Map input string offsets to output string offsets.
@@ -254,11 +326,10 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   Sized_relobj_dwo(const char* name, Input_file* input_file,
 		   const elfcpp::Ehdr<size, big_endian>& ehdr)
     : Sized_relobj<size, big_endian>(name, input_file),
-      elf_file_(this, ehdr)
+      elf_file_(this, ehdr), decompressed_sections_()
   { }
 
-  ~Sized_relobj_dwo()
-  { }
+  ~Sized_relobj_dwo();
 
   // Setup the section information.
   void
@@ -285,8 +356,8 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   do_section_contents(unsigned int, section_size_type*, bool);
 
   // Return a view of the uncompressed contents of a section.  Set *PLEN
-  // to the size.  Set *IS_NEW to true if the contents need to be deleted
-  // by the caller.
+  // to the size.  We keep the decompressed contents until the object is
+  // deleted, so *IS_NEW is always set to false.
   const unsigned char*
   do_decompressed_section_contents(unsigned int shndx,
 				   section_size_type* plen,
@@ -444,8 +515,16 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   { gold_unreachable(); }
 
  private:
+  // The decompressed contents of a compressed section.
+  typedef std::pair<unsigned char*, section_size_type> Decompressed_section;
+
   // General access to the ELF file.
   elfcpp::Elf_file<size, big_endian, Object> elf_file_;
+  // The decompressed contents of the compressed sections, indexed by
+  // section index.  These are decompressed when read_input first asks
+  // for them, perhaps on another thread, and used again when the
+  // sections are added to the output file.
+  std::vector<Decompressed_section> decompressed_sections_;
 };
 
 // The output file.
@@ -460,7 +539,7 @@ class Dwp_output_file
       abiversion_(0), fd_(NULL), next_file_offset_(0), shnum_(1), sections_(),
       section_id_map_(), shoff_(0), shstrndx_(0), have_strings_(false),
       stringpool_(), shstrtab_(), cu_index_(), tu_index_(), last_type_sig_(0),
-      last_tu_slot_(0)
+      last_tu_slot_(0), spill_contributions_(false)
   {
     this->section_id_map_.resize(elfcpp::DW_SECT_MAX + 1);
     this->stringpool_.set_no_zero_null();
@@ -471,11 +550,21 @@ class Dwp_output_file
   record_target_info(const char* name, int machine, int size, bool big_endian,
 		     int osabi, int abiversion);
 
-  // Add a string to the debug strings section.
+  // Add a string to the debug strings section.  HASH_CODE is the
+  // hash code of the string, computed by string_hash.
   section_offset_type
-  add_string(const char* str, size_t len);
+  add_string(const char* str, size_t len, size_t hash_code);
+
+  // Write the contributions to sections other than .debug_info.dwo to
+  // temporary files rather than keeping them in memory.  This is used
+  // when the input files are read in parallel, since the files read
+  // ahead also take memory.
+  void
+  set_spill_contributions(bool spill)
+  { this->spill_contributions_ = spill; }
 
   // Add a section to the output file, and return the new section offset.
+  // The caller retains ownership of CONTENTS.
   section_offset_type
   add_contribution(elfcpp::DW_SECT section_id, const unsigned char* contents,
 		   section_size_type len, int align);
@@ -506,7 +595,9 @@ class Dwp_output_file
     const unsigned char* contents;
   };
 
-  // Sections in the output file.
+  // Sections in the output file.  Until we know where a section goes
+  // in the output file, its contributions are kept in memory or, if
+  // SPILL_CONTRIBUTIONS_ is set, written to a temporary file.
   struct Section
   {
     const char* name;
@@ -514,9 +605,11 @@ class Dwp_output_file
     section_size_type size;
     int align;
     std::vector<Contribution> contributions;
+    FILE* temp_fd;
 
     Section(const char* n, int a)
-      : name(n), offset(0), size(0), align(a), contributions()
+      : name(n), offset(0), size(0), align(a), contributions(),
+	temp_fd(NULL)
     { }
   };
 
@@ -640,9 +733,13 @@ class Dwp_output_file
 		   unsigned int link, unsigned int info,
 		   unsigned int align, unsigned int ent_size);
 
+  // Seek to OFFSET in the output file.
+  void
+  seek(off_t offset);
+
   // Write the contributions to an output section.
   void
-  write_contributions(const Section& sect);
+  write_contributions(Section* sect);
 
   // Write a CU or TU index section.
   template<bool big_endian>
@@ -685,6 +782,9 @@ class Dwp_output_file
   uint64_t last_type_sig_;
   // Cache of the slot index for the last type signature.
   unsigned int last_tu_slot_;
+  // TRUE if contributions are written to temporary files rather than
+  // kept in memory.
+  bool spill_contributions_;
 };
 
 // A specialization of Dwarf_info_reader, for reading dwo_names from
@@ -719,23 +819,23 @@ class Dwo_name_info_reader : public Dwarf_info_reader
   File_list* files_;
 };
 
-// A specialization of Dwarf_info_reader, for reading DWARF CUs and TUs
-// and adding them to the output file.
+// A specialization of Dwarf_info_reader, for finding the DWARF CUs
+// and TUs in a .dwo file.
 
 class Unit_reader : public Dwarf_info_reader
 {
  public:
   Unit_reader(bool is_type_unit, Relobj* object, unsigned int shndx)
     : Dwarf_info_reader(is_type_unit, object, NULL, 0, shndx, 0, 0),
-      output_file_(NULL), sections_(NULL)
+      units_(NULL)
   { }
 
   ~Unit_reader()
   { }
 
-  // Read the CUs or TUs and add them to the output file.
+  // Read the CUs or TUs and add them to UNITS.
   void
-  add_units(Dwp_output_file*, unsigned int debug_abbrev, Section_bounds*);
+  get_units(unsigned int debug_abbrev, Unit_list* units);
 
  protected:
   // Visit a compilation unit.
@@ -748,8 +848,55 @@ class Unit_reader : public Dwarf_info_reader
 		  uint64_t signature, Dwarf_die*);
 
  private:
+  // The list of units to populate.
+  Unit_list* units_;
+};
+
+// A job which reads the input files and adds them to the output file.
+// The files are read in parallel, but they are added to the output
+// file one at a time, in order, so that the output does not depend on
+// the number of threads.  Each piece of the job is a thread which
+// adds the next file to the output file if it has been read and no
+// other thread is adding a file, and otherwise reads the next file.
+// We only read ahead a limited number of files, to limit the memory
+// we use.
+
+class Dwo_read_job : public Parallel_job
+{
+ public:
+  Dwo_read_job(const File_list& files, Dwp_output_file* output_file,
+	       unsigned int read_ahead, bool verbose)
+    : files_(files), output_file_(output_file), read_ahead_(read_ahead),
+      verbose_(verbose), dwo_files_(files.size(), NULL), next_read_(0),
+      next_add_(0), adding_(false), lock_(), condvar_(lock_)
+  { gold_assert(read_ahead > 0); }
+
+  void
+  run_piece(unsigned int);
+
+ private:
+  // The input files.
+  const File_list& files_;
+  // The output file.
   Dwp_output_file* output_file_;
-  Section_bounds* sections_;
+  // The number of files which may be read but not yet added.
+  unsigned int read_ahead_;
+  // Whether to print the name of each file as we add it.
+  bool verbose_;
+  // The files which have been read but not yet added.  The entries
+  // of files which have not been read, or which have been added, are
+  // NULL.
+  std::vector<Dwo_file*> dwo_files_;
+  // The index of the next file to read.
+  size_t next_read_;
+  // The index of the next file to add to the output file.
+  size_t next_add_;
+  // Whether some thread is adding a file to the output file.
+  bool adding_;
+  // Controls access to the fields above.
+  Lock lock_;
+  // Signalled when a file has been read or added.
+  Condvar condvar_;
 };
 
 // Return the name of a DWARF .dwo section.
@@ -784,6 +931,17 @@ Sized_relobj_dwo<size, big_endian>::setup()
   const unsigned int shnum = this->elf_file_.shnum();
   this->set_shnum(shnum);
   this->section_offsets().resize(shnum);
+  this->decompressed_sections_.resize(shnum,
+				      Decompressed_section(NULL, 0));
+}
+
+// Free the decompressed sections.
+
+template <int size, bool big_endian>
+Sized_relobj_dwo<size, big_endian>::~Sized_relobj_dwo()
+{
+  for (unsigned int i = 0; i < this->decompressed_sections_.size(); ++i)
+    delete[] this->decompressed_sections_[i].first;
 }
 
 // Return a view of the contents of a section.
@@ -806,8 +964,8 @@ Sized_relobj_dwo<size, big_endian>::do_section_contents(
 }
 
 // Return a view of the uncompressed contents of a section.  Set *PLEN
-// to the size.  Set *IS_NEW to true if the contents need to be deleted
-// by the caller.
+// to the size.  *IS_NEW is always set to false, because we keep the
+// decompressed contents until the object is deleted.
 
 template <int size, bool big_endian>
 const unsigned char*
@@ -816,6 +974,15 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
     section_size_type* plen,
     bool* is_new)
 {
+  *is_new = false;
+  gold_assert(shndx < this->decompressed_sections_.size());
+  Decompressed_section& ds(this->decompressed_sections_[shndx]);
+  if (ds.first != NULL)
+    {
+      *plen = ds.second;
+      return ds.first;
+    }
+
   section_size_type buffer_size;
   const unsigned char* buffer = this->do_section_contents(shndx, &buffer_size,
 							  false);
@@ -824,7 +991,6 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
   if (!is_prefix_of(".zdebug_", sect_name.c_str()))
     {
       *plen = buffer_size;
-      *is_new = false;
       return buffer;
     }
 
@@ -837,8 +1003,9 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
 				uncompressed_size))
     this->error(_("could not decompress section %s"),
 		this->section_name(shndx).c_str());
+  ds.first = uncompressed_data;
+  ds.second = uncompressed_size;
   *plen = uncompressed_size;
-  *is_new = true;
   return uncompressed_data;
 }
 
@@ -858,7 +1025,7 @@ Dwo_file::~Dwo_file()
 void
 Dwo_file::read_executable(File_list* files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -898,26 +1065,18 @@ Dwo_file::read_executable(File_list* files)
     }
 }
 
-// Read the input file and send its contents to OUTPUT_FILE.
+// Read the input file and do the work which does not depend on the
+// other input files.
 
 void
-Dwo_file::read(Dwp_output_file* output_file)
+Dwo_file::read_input()
 {
-  this->obj_ = this->make_object(output_file);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
   this->sect_offsets_.resize(shnum);
 
-  typedef std::vector<unsigned int> Types_list;
-  Types_list debug_types;
-  unsigned int debug_shndx[elfcpp::DW_SECT_MAX + 1];
-  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
-    debug_shndx[i] = 0;
-  unsigned int debug_str = 0;
-  unsigned int debug_cu_index = 0;
-  unsigned int debug_tu_index = 0;
-
   // Scan the section table and collect debug sections.
   // (Section index 0 is a dummy section; skip it.)
   for (unsigned int i = 1; i < shnum; i++)
@@ -936,60 +1095,119 @@ Dwo_file::read(Dwp_output_file* output_file)
       else
 	continue;
       if (strcmp(suffix, "info.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_INFO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_INFO] = i;
       else if (strcmp(suffix, "types.dwo") == 0)
-	debug_types.push_back(i);
+	this->debug_types_.push_back(i);
       else if (strcmp(suffix, "abbrev.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_ABBREV] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_ABBREV] = i;
       else if (strcmp(suffix, "line.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_LINE] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_LINE] = i;
       else if (strcmp(suffix, "loc.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_LOC] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_LOC] = i;
       else if (strcmp(suffix, "str.dwo") == 0)
-	debug_str = i;
+	this->debug_str_ = i;
       else if (strcmp(suffix, "str_offsets.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_STR_OFFSETS] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_STR_OFFSETS] = i;
       else if (strcmp(suffix, "macinfo.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_MACINFO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_MACINFO] = i;
       else if (strcmp(suffix, "macro.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_MACRO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_MACRO] = i;
       else if (strcmp(suffix, "cu_index") == 0)
-	debug_cu_index = i;
+	this->debug_cu_index_ = i;
       else if (strcmp(suffix, "tu_index") == 0)
-	debug_tu_index = i;
+	this->debug_tu_index_ = i;
+    }
+
+  // Read the input string table.
+  this->read_strings(this->debug_str_);
+
+  // Read the other sections now, so that any compressed sections are
+  // decompressed here rather than while adding them to the output.
+  section_size_type len;
+  bool is_new;
+  for (int i = elfcpp::DW_SECT_INFO; i <= elfcpp::DW_SECT_MAX; ++i)
+    if (this->debug_shndx_[i] > 0)
+      this->section_contents(this->debug_shndx_[i], &len, &is_new);
+  for (std::vector<unsigned int>::const_iterator tp =
+	 this->debug_types_.begin();
+       tp != this->debug_types_.end();
+       ++tp)
+    this->section_contents(*tp, &len, &is_new);
+
+  // A .dwp file is processed using its index sections when it is
+  // added to the output.
+  if (this->debug_cu_index_ > 0 || this->debug_tu_index_ > 0)
+    return;
+
+  // If we found no index sections, this is a .dwo file.  Find the
+  // compilation and type units.
+  if (this->debug_shndx_[elfcpp::DW_SECT_INFO] == 0
+      && this->debug_types_.empty())
+    return;
+
+  if (this->debug_shndx_[elfcpp::DW_SECT_ABBREV] == 0)
+    gold_fatal(_("%s: no .debug_abbrev.dwo section found"), this->name_);
+
+  if (this->debug_shndx_[elfcpp::DW_SECT_INFO] > 0)
+    {
+      Unit_reader reader(false, this->obj_,
+			 this->debug_shndx_[elfcpp::DW_SECT_INFO]);
+      reader.get_units(this->debug_shndx_[elfcpp::DW_SECT_ABBREV],
+		       &this->info_units_);
+    }
+
+  this->types_units_.resize(this->debug_types_.size());
+  for (unsigned int i = 0; i < this->debug_types_.size(); ++i)
+    {
+      Unit_reader reader(true, this->obj_, this->debug_types_[i]);
+      reader.get_units(this->debug_shndx_[elfcpp::DW_SECT_ABBREV],
+		       &this->types_units_[i]);
     }
+}
+
+// Send the contents of the input file to OUTPUT_FILE.
+
+void
+Dwo_file::add_to_output(Dwp_output_file* output_file)
+{
+  output_file->record_target_info(this->name_, this->machine_, this->size_,
+				  this->big_endian_, this->osabi_,
+				  this->abiversion_);
 
   // Merge the input string table into the output string table.
-  this->add_strings(output_file, debug_str);
+  this->add_strings(output_file);
+
+  unsigned int* debug_shndx = this->debug_shndx_;
 
   // If we found any .dwp index sections, read those and add the section
   // sets to the output file.
-  if (debug_cu_index > 0 || debug_tu_index > 0)
+  if (this->debug_cu_index_ > 0 || this->debug_tu_index_ > 0)
     {
-      if (debug_cu_index > 0)
-	this->read_unit_index(debug_cu_index, debug_shndx, output_file, false);
-      if (debug_tu_index > 0)
+      if (this->debug_cu_index_ > 0)
+	this->read_unit_index(this->debug_cu_index_, debug_shndx, output_file,
+			      false);
+      if (this->debug_tu_index_ > 0)
         {
-	  if (debug_types.size() != 1)
+	  if (this->debug_types_.size() != 1)
 	    gold_fatal(_("%s: .dwp file must have exactly one "
 			 ".debug_types.dwo section"), this->name_);
-	  debug_shndx[elfcpp::DW_SECT_TYPES] = debug_types[0];
-	  this->read_unit_index(debug_tu_index, debug_shndx, output_file, true);
+	  debug_shndx[elfcpp::DW_SECT_TYPES] = this->debug_types_[0];
+	  this->read_unit_index(this->debug_tu_index_, debug_shndx,
+				output_file, true);
 	}
       return;
     }
 
   // If we found no index sections, this is a .dwo file.
   if (debug_shndx[elfcpp::DW_SECT_INFO] > 0)
-    this->add_unit_set(output_file, debug_shndx, false);
+    this->add_unit_set(output_file, debug_shndx, false, this->info_units_);
 
   debug_shndx[elfcpp::DW_SECT_INFO] = 0;
-  for (Types_list::const_iterator tp = debug_types.begin();
-       tp != debug_types.end();
-       ++tp)
+  for (unsigned int i = 0; i < this->debug_types_.size(); ++i)
     {
-      debug_shndx[elfcpp::DW_SECT_TYPES] = *tp;
-      this->add_unit_set(output_file, debug_shndx, true);
+      debug_shndx[elfcpp::DW_SECT_TYPES] = this->debug_types_[i];
+      this->add_unit_set(output_file, debug_shndx, true,
+			 this->types_units_[i]);
     }
 }
 
@@ -1000,7 +1218,7 @@ Dwo_file::read(Dwp_output_file* output_file)
 bool
 Dwo_file::verify(const File_list& files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -1036,10 +1254,10 @@ Dwo_file::verify(const File_list& files)
 }
 
 // Create a Sized_relobj_dwo of the given size and endianness,
-// and record the target info.
+// and save the target info.
 
 Relobj*
-Dwo_file::make_object(Dwp_output_file* output_file)
+Dwo_file::make_object()
 {
   // Open the input file.
   Input_file* input_file = new Input_file(this->name_);
@@ -1060,8 +1278,8 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     gold_fatal(_("%s: not an ELF object file"), this->name_);
   
   // Get the size, endianness, machine, etc. info from the header,
-  // make an appropriately-sized Relobj, and pass the target info
-  // to the output object.
+  // make an appropriately-sized Relobj, and save the target info
+  // for the output object.
   int size;
   bool big_endian;
   std::string error;
@@ -1073,15 +1291,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_32_BIG
-	return this->sized_make_object<32, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<32, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_32_LITTLE
-	return this->sized_make_object<32, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<32, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1090,15 +1306,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_64_BIG
-	return this->sized_make_object<64, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<64, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_64_LITTLE
-	return this->sized_make_object<64, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<64, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1107,23 +1321,22 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     gold_unreachable();
 }
 
-// Function template to create a Sized_relobj_dwo and record the target info.
+// Function template to create a Sized_relobj_dwo and save the target info.
 // P is a pointer to the ELF header in memory.
 
 template <int size, bool big_endian>
 Relobj*
-Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file,
-			    Dwp_output_file* output_file)
+Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file)
 {
   elfcpp::Ehdr<size, big_endian> ehdr(p);
   Sized_relobj_dwo<size, big_endian>* obj =
       new Sized_relobj_dwo<size, big_endian>(this->name_, input_file, ehdr);
   obj->setup();
-  if (output_file != NULL)
-    output_file->record_target_info(
-	this->name_, ehdr.get_e_machine(), size, big_endian,
-	ehdr.get_e_ident()[elfcpp::EI_OSABI],
-	ehdr.get_e_ident()[elfcpp::EI_ABIVERSION]);
+  this->machine_ = ehdr.get_e_machine();
+  this->size_ = size;
+  this->big_endian_ = big_endian;
+  this->osabi_ = ehdr.get_e_ident()[elfcpp::EI_OSABI];
+  this->abiversion_ = ehdr.get_e_ident()[elfcpp::EI_ABIVERSION];
   return obj;
 }
 
@@ -1249,15 +1462,6 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 	      info_contents + unit_set->sections[info_sect].offset;
 	  section_size_type unit_length = unit_set->sections[info_sect].size;
 
-	  // Dwp_output_file::add_contribution writes the .debug_info.dwo
-	  // section directly to the output file, so we only need to
-	  // duplicate contributions for .debug_types.dwo section.
-	  if (is_tu_index)
-	    {
-	      unsigned char *copy = new unsigned char[unit_length];
-	      memcpy(copy, unit_start, unit_length);
-	      unit_start = copy;
-	    }
 	  section_offset_type off =
 	      output_file->add_contribution(info_sect, unit_start,
 					    unit_length, 1);
@@ -1373,46 +1577,66 @@ Dwo_file::sized_verify_dwo_list(unsigned int shndx, const File_list& files)
   return nmissing == 0;
 }
 
-// Merge the input string table section into the output file.
+// Read the input string table section and compute the hash code of
+// each string, so that the strings can be added to the output string
+// table quickly.
 
 void
-Dwo_file::add_strings(Dwp_output_file* output_file, unsigned int debug_str)
+Dwo_file::read_strings(unsigned int debug_str)
 {
+  if (debug_str == 0)
+    return;
+
   section_size_type len;
   bool is_new;
   const unsigned char* pdata = this->section_contents(debug_str, &len, &is_new);
+  gold_assert(!is_new);
   const char* p = reinterpret_cast<const char*>(pdata);
   const char* pend = p + len;
 
   // Check that the last string is null terminated.
-  if (pend[-1] != '\0')
+  if (len == 0 || pend[-1] != '\0')
     gold_fatal(_("%s: last entry in string section '%s' "
 		 "is not null terminated"),
 	       this->name_,
 	       this->section_name(debug_str).c_str());
 
-  // Count the number of strings in the section, and size the map.
+  // Count the number of strings in the section, and size the list.
   size_t count = 0;
   for (const char* pt = p; pt < pend; pt += strlen(pt) + 1)
     ++count;
-  this->str_offset_map_.reserve(count + 1);
+  this->strings_.reserve(count);
+
+  while (p < pend)
+    {
+      size_t len = strlen(p);
+      this->strings_.push_back(Input_string(p, len,
+					    Stringpool::string_hash(p, len)));
+      p += len + 1;
+    }
+}
+
+// Merge the input string table section into the output file.
+
+void
+Dwo_file::add_strings(Dwp_output_file* output_file)
+{
+  this->str_offset_map_.reserve(this->strings_.size() + 1);
 
   // Add the strings to the output string table, and record the new offsets
   // in the map.
   section_offset_type i = 0;
   section_offset_type new_offset;
-  while (p < pend)
+  for (Input_strings::const_iterator p = this->strings_.begin();
+       p != this->strings_.end();
+       ++p)
     {
-      size_t len = strlen(p);
-      new_offset = output_file->add_string(p, len);
+      new_offset = output_file->add_string(p->str, p->len, p->hash_code);
       this->str_offset_map_.push_back(std::make_pair(i, new_offset));
-      p += len + 1;
-      i += len + 1;
+      i += p->len + 1;
     }
   new_offset = 0;
   this->str_offset_map_.push_back(std::make_pair(i, new_offset));
-  if (is_new)
-    delete[] pdata;
 }
 
 // Copy a section from the input file to the output file.
@@ -1429,32 +1653,25 @@ Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
   if (this->sect_offsets_[shndx].size > 0)
     return this->sect_offsets_[shndx];
 
-  // Get the section contents. Upon return, if IS_NEW is true, the memory
-  // has been allocated via new; if false, the memory is part of the mapped
-  // input file, and we will need to duplicate it so that it will persist
-  // after we close the input file.
+  // Get the section contents.  The output file writes out the
+  // contents before add_contribution returns, so we need not copy them.
   section_size_type len;
   bool is_new;
   const unsigned char* contents = this->section_contents(shndx, &len, &is_new);
+  gold_assert(!is_new);
 
+  const unsigned char* remapped = NULL;
   if (section_id == elfcpp::DW_SECT_STR_OFFSETS)
     {
-      const unsigned char* remapped = this->remap_str_offsets(contents, len);
-      if (is_new)
-	delete[] contents;
+      remapped = this->remap_str_offsets(contents, len);
       contents = remapped;
     }
-  else if (!is_new)
-    {
-      unsigned char* copy = new unsigned char[len];
-      memcpy(copy, contents, len);
-      contents = copy;
-    }
 
   // Add the contents of the input section to the output section.
-  // The output file takes ownership of the memory pointed to by CONTENTS.
   section_offset_type off = output_file->add_contribution(section_id, contents,
 							  len, 1);
+  if (remapped != NULL)
+    delete[] remapped;
 
   // Store the output section bounds.
   Section_bounds bounds(off, len);
@@ -1520,22 +1737,20 @@ Dwo_file::remap_str_offset(section_offset_type val)
   return p->second + (val - p->first);
 }
 
-// Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-// to OUTPUT_FILE.
+// Add the units in UNITS, from a .debug_info.dwo or .debug_types.dwo
+// section, and the related sections to OUTPUT_FILE.
 
 void
 Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-		       bool is_debug_types)
+		       bool is_debug_types, const Unit_list& units)
 {
-  unsigned int shndx = (is_debug_types
-			? debug_shndx[elfcpp::DW_SECT_TYPES]
-			: debug_shndx[elfcpp::DW_SECT_INFO]);
+  elfcpp::DW_SECT info_sect = (is_debug_types
+			       ? elfcpp::DW_SECT_TYPES
+			       : elfcpp::DW_SECT_INFO);
+  unsigned int shndx = debug_shndx[info_sect];
 
   gold_assert(shndx != 0);
 
-  if (debug_shndx[elfcpp::DW_SECT_ABBREV] == 0)
-    gold_fatal(_("%s: no .debug_abbrev.dwo section found"), this->name_);
-
   // Copy the related sections and track the section offsets and sizes.
   Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
   for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
@@ -1545,11 +1760,32 @@ Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
 					 static_cast<elfcpp::DW_SECT>(i));
     }
 
-  // Parse the .debug_info or .debug_types section and add each compilation
-  // or type unit to the output file, along with the contributions to the
-  // related sections.
-  Unit_reader reader(is_debug_types, this->obj_, shndx);
-  reader.add_units(output_file, debug_shndx[elfcpp::DW_SECT_ABBREV], sections);
+  section_size_type len;
+  bool is_new;
+  const unsigned char* contents = this->section_contents(shndx, &len, &is_new);
+  gold_assert(!is_new);
+
+  // Add each compilation or type unit to the output file, along with
+  // the contributions to the related sections.
+  for (Unit_list::const_iterator p = units.begin(); p != units.end(); ++p)
+    {
+      if (is_debug_types && output_file->lookup_tu(p->signature))
+	continue;
+
+      Unit_set* unit_set = new Unit_set();
+      unit_set->signature = p->signature;
+      for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+	unit_set->sections[i] = sections[i];
+
+      section_offset_type off =
+	  output_file->add_contribution(info_sect, contents + p->offset,
+					p->length, 1);
+      unit_set->sections[info_sect] = Section_bounds(off, p->length);
+      if (is_debug_types)
+	output_file->add_tu_set(unit_set);
+      else
+	output_file->add_cu_set(unit_set);
+    }
 }
 
 // Class Dwp_output_file.
@@ -1595,10 +1831,10 @@ Dwp_output_file::record_target_info(const char*, int machine,
 // Add a string to the debug strings section.
 
 section_offset_type
-Dwp_output_file::add_string(const char* str, size_t len)
+Dwp_output_file::add_string(const char* str, size_t len, size_t hash_code)
 {
   Stringpool::Key key;
-  this->stringpool_.add_with_length(str, len, true, &key);
+  this->stringpool_.add_with_length_and_hash(str, len, hash_code, &key);
   this->have_strings_ = true;
   // We aren't supposed to call get_offset() until after
   // calling set_string_offsets(), but the offsets will
@@ -1627,9 +1863,10 @@ Dwp_output_file::add_output_section(const char* section_name, int align)
 // Add a contribution to a section in the output file, and return the offset
 // of the contribution within the output section.  The .debug_info.dwo section
 // is expected to be the largest one, so we will write the contents of this
-// section directly to the output file as we receive contributions, allowing
-// us to free that memory as soon as possible. We will save the remaining
-// contributions until we finalize the layout of the output file.
+// section directly to the output file as we receive contributions.  We will
+// write the remaining contributions to temporary files, and copy them to the
+// output file when we finalize its layout.  Either way the caller may free
+// CONTENTS as soon as we return.
 
 section_offset_type
 Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
@@ -1681,20 +1918,47 @@ Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
       section_offset = file_offset - section.offset;
       section.size = file_offset + len - section.offset;
 
-      ::fseek(this->fd_, file_offset, SEEK_SET);
+      this->seek(file_offset);
       if (::fwrite(contents, 1, len, this->fd_) < len)
 	gold_fatal(_("%s: error writing section '%s'"), this->name_,
 		   section_name);
       this->next_file_offset_ = file_offset + len;
     }
+  else if (this->spill_contributions_)
+    {
+      // Write the contribution to the temporary file, and keep track
+      // of the total size.
+      if (section.temp_fd == NULL)
+	{
+	  section.temp_fd = ::tmpfile();
+	  if (section.temp_fd == NULL)
+	    gold_fatal(_("%s: cannot create temporary file for section '%s': "
+			 "%s"),
+		       this->name_, section_name, strerror(errno));
+	}
+      if (align > section.align)
+	section.align = align;
+      section_offset = align_offset(section.size, align);
+      section.size = section_offset + len;
+      if (::fseek(section.temp_fd, section_offset, SEEK_SET) != 0)
+	gold_fatal(_("%s: error seeking temporary file for section '%s': %s"),
+		   this->name_, section_name, strerror(errno));
+      if (::fwrite(contents, 1, len, section.temp_fd) < len)
+	gold_fatal(_("%s: error writing temporary file for section '%s': %s"),
+		   this->name_, section_name, strerror(errno));
+    }
   else
     {
       // Collect the contributions and keep track of the total size.
+      // The input file may be closed before we write the contents,
+      // so we keep a copy.
       if (align > section.align)
 	section.align = align;
       section_offset = align_offset(section.size, align);
       section.size = section_offset + len;
-      Contribution contrib = { section_offset, len, contents };
+      unsigned char* copy = new unsigned char[len];
+      memcpy(copy, contents, len);
+      Contribution contrib = { section_offset, len, copy };
       section.contributions.push_back(contrib);
     }
 
@@ -1861,7 +2125,7 @@ Dwp_output_file::finalize()
       off_t file_offset = this->next_file_offset_;
       file_offset = align_offset(file_offset, sect.align);
       sect.offset = file_offset;
-      this->write_contributions(sect);
+      this->write_contributions(&sect);
       this->next_file_offset_ = file_offset + sect.size;
     }
 
@@ -1900,7 +2164,7 @@ Dwp_output_file::finalize()
   buf = new unsigned char[shstrtab_len];
   this->shstrtab_.write_to_buffer(buf, shstrtab_len);
   off_t shstrtab_off = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
+  this->seek(file_offset);
   if (::fwrite(buf, 1, shstrtab_len, this->fd_) < shstrtab_len)
     gold_fatal(_("%s: error writing section '.shstrtab'"), this->name_);
   delete[] buf;
@@ -1911,7 +2175,7 @@ Dwp_output_file::finalize()
   // .shstrtab section header.
   file_offset = align_offset(file_offset, this->size_ == 32 ? 4 : 8);
   this->shoff_ = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
+  this->seek(file_offset);
   section_size_type sh0_size = 0;
   unsigned int sh0_link = 0;
   if (this->shnum_ >= elfcpp::SHN_LORESERVE)
@@ -1940,19 +2204,58 @@ Dwp_output_file::finalize()
   this->fd_ = NULL;
 }
 
-// Write the contributions to an output section.
+// Seek to OFFSET in the output file.
 
 void
-Dwp_output_file::write_contributions(const Section& sect)
+Dwp_output_file::seek(off_t offset)
 {
-  for (unsigned int i = 0; i < sect.contributions.size(); ++i)
+  if (::fseek(this->fd_, offset, SEEK_SET) != 0)
+    gold_fatal(_("%s: error seeking output file: %s"), this->name_,
+	       strerror(errno));
+}
+
+// Write the contributions to an output section.  They are either in
+// memory or in a temporary file.
+
+void
+Dwp_output_file::write_contributions(Section* sect)
+{
+  if (sect->temp_fd == NULL)
     {
-      const Contribution& c = sect.contributions[i];
-      ::fseek(this->fd_, sect.offset + c.output_offset, SEEK_SET);
-      if (::fwrite(c.contents, 1, c.size, this->fd_) < c.size)
-	gold_fatal(_("%s: error writing section '%s'"), this->name_, sect.name);
-      delete[] c.contents;
+      for (unsigned int i = 0; i < sect->contributions.size(); ++i)
+	{
+	  const Contribution& c = sect->contributions[i];
+	  this->seek(sect->offset + c.output_offset);
+	  if (::fwrite(c.contents, 1, c.size, this->fd_) < c.size)
+	    gold_fatal(_("%s: error writing section '%s'"), this->name_,
+		       sect->name);
+	  delete[] c.contents;
+	}
+      sect->contributions.clear();
+      return;
     }
+
+  if (::fseek(sect->temp_fd, 0, SEEK_SET) != 0)
+    gold_fatal(_("%s: error seeking temporary file for section '%s': %s"),
+	       this->name_, sect->name, strerror(errno));
+  this->seek(sect->offset);
+
+  unsigned char buf[65536];
+  section_size_type remaining = sect->size;
+  while (remaining > 0)
+    {
+      size_t len = remaining < sizeof buf ? remaining : sizeof buf;
+      if (::fread(buf, 1, len, sect->temp_fd) < len)
+	gold_fatal(_("%s: error reading temporary file for section '%s': %s"),
+		   this->name_, sect->name, strerror(errno));
+      if (::fwrite(buf, 1, len, this->fd_) < len)
+	gold_fatal(_("%s: error writing section '%s'"), this->name_,
+		   sect->name);
+      remaining -= len;
+    }
+
+  ::fclose(sect->temp_fd);
+  sect->temp_fd = NULL;
 }
 
 // Write a new section to the output file.
@@ -1971,7 +2274,7 @@ Dwp_output_file::write_new_section(const char* section_name,
   file_offset = align_offset(file_offset, align);
   section.offset = file_offset;
   section.size = len;
-  ::fseek(this->fd_, file_offset, SEEK_SET);
+  this->seek(file_offset);
   if (::fwrite(contents, 1, len, this->fd_) < len)
     gold_fatal(_("%s: error writing section '%s'"), this->name_, section_name);
   this->next_file_offset_ = file_offset + len;
@@ -2150,7 +2453,7 @@ Dwp_output_file::sized_write_ehdr()
 		      ? this->shstrndx_
 		      : static_cast<unsigned int>(elfcpp::SHN_XINDEX));
 
-  ::fseek(this->fd_, 0, 0);
+  this->seek(0);
   if (::fwrite(buf, 1, ehdr_size, this->fd_) < ehdr_size)
     gold_fatal(_("%s: error writing ELF header"), this->name_);
 }
@@ -2233,15 +2536,12 @@ Dwo_name_info_reader::visit_compilation_unit(off_t, off_t, Dwarf_die* die)
 
 // Class Unit_reader.
 
-// Read the CUs or TUs and add them to the output file.
+// Read the CUs or TUs and add them to UNITS.
 
 void
-Unit_reader::add_units(Dwp_output_file* output_file,
-		       unsigned int debug_abbrev,
-		       Section_bounds* sections)
+Unit_reader::get_units(unsigned int debug_abbrev, Unit_list* units)
 {
-  this->output_file_ = output_file;
-  this->sections_ = sections;
+  this->units_ = units;
   this->set_abbrev_shndx(debug_abbrev);
   this->parse();
 }
@@ -2249,52 +2549,73 @@ Unit_reader::add_units(Dwp_output_file* output_file,
 // Visit a compilation unit.
 
 void
-Unit_reader::visit_compilation_unit(off_t, off_t cu_length, Dwarf_die* die)
+Unit_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
+				    Dwarf_die* die)
 {
   if (cu_length == 0)
     return;
 
-  Unit_set* unit_set = new Unit_set();
-  unit_set->signature = die->uint_attribute(elfcpp::DW_AT_GNU_dwo_id);
-  for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    unit_set->sections[i] = this->sections_[i];
-
-  // Dwp_output_file::add_contribution writes the .debug_info.dwo section
-  // directly to the output file, so we do not need to duplicate the
-  // section contents, and add_contribution does not need to free the memory.
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_INFO,
-					   this->buffer_at_offset(0),
-					   cu_length, 1);
-  Section_bounds bounds(off, cu_length);
-  unit_set->sections[elfcpp::DW_SECT_INFO] = bounds;
-  this->output_file_->add_cu_set(unit_set);
+  uint64_t dwo_id = die->uint_attribute(elfcpp::DW_AT_GNU_dwo_id);
+  this->units_->push_back(Unit_entry(dwo_id, cu_offset, cu_length));
 }
 
 // Visit a type unit.
 
 void
-Unit_reader::visit_type_unit(off_t, off_t tu_length, off_t,
+Unit_reader::visit_type_unit(off_t tu_offset, off_t tu_length, off_t,
 			     uint64_t signature, Dwarf_die*)
 {
   if (tu_length == 0)
     return;
-  if (this->output_file_->lookup_tu(signature))
-    return;
 
-  Unit_set* unit_set = new Unit_set();
-  unit_set->signature = signature;
-  for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    unit_set->sections[i] = this->sections_[i];
-
-  unsigned char* contents = new unsigned char[tu_length];
-  memcpy(contents, this->buffer_at_offset(0), tu_length);
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_TYPES, contents,
-					   tu_length, 1);
-  Section_bounds bounds(off, tu_length);
-  unit_set->sections[elfcpp::DW_SECT_TYPES] = bounds;
-  this->output_file_->add_tu_set(unit_set);
+  this->units_->push_back(Unit_entry(signature, tu_offset, tu_length));
+}
+
+// Class Dwo_read_job.
+
+void
+Dwo_read_job::run_piece(unsigned int)
+{
+  this->lock_.acquire();
+  while (this->next_add_ < this->files_.size())
+    {
+      size_t i;
+      if (!this->adding_ && this->dwo_files_[this->next_add_] != NULL)
+	{
+	  i = this->next_add_;
+	  Dwo_file* dwo_file = this->dwo_files_[i];
+	  this->dwo_files_[i] = NULL;
+	  this->adding_ = true;
+	  this->lock_.release();
+
+	  if (this->verbose_)
+	    fprintf(stderr, "%s\n", this->files_[i].dwo_name.c_str());
+	  dwo_file->add_to_output(this->output_file_);
+	  delete dwo_file;
+
+	  this->lock_.acquire();
+	  ++this->next_add_;
+	  this->adding_ = false;
+	  this->condvar_.broadcast();
+	}
+      else if (this->next_read_ < this->files_.size()
+	       && this->next_read_ < this->next_add_ + this->read_ahead_)
+	{
+	  i = this->next_read_;
+	  ++this->next_read_;
+	  this->lock_.release();
+
+	  Dwo_file* dwo_file = new Dwo_file(this->files_[i].dwo_name.c_str());
+	  dwo_file->read_input();
+
+	  this->lock_.acquire();
+	  this->dwo_files_[i] = dwo_file;
+	  this->condvar_.broadcast();
+	}
+      else
+	this->condvar_.wait();
+    }
+  this->lock_.release();
 }
 
 }; // End namespace gold
@@ -2305,6 +2626,9 @@ using namespace gold;
 
 enum Dwp_options {
   VERIFY_ONLY = 0x101,
+  THREADS,
+  NO_THREADS,
+  THREAD_COUNT,
 };
 
 struct option dwp_options[] =
@@ -2312,6 +2636,9 @@ struct option dwp_options[] =
     { "exec", required_argument, NULL, 'e' },
     { "help", no_argument, NULL, 'h' },
     { "output", required_argument, NULL, 'o' },
+    { "threads", no_argument, NULL, THREADS },
+    { "no-threads", no_argument, NULL, NO_THREADS },
+    { "thread-count", required_argument, NULL, THREAD_COUNT },
     { "verbose", no_argument, NULL, 'v' },
     { "verify-only", no_argument, NULL, VERIFY_ONLY },
     { "version", no_argument, NULL, 'V' },
@@ -2328,6 +2655,11 @@ usage(FILE* fd, int exit_status)
   fprintf(fd, _("  -e EXE, --exec EXE       Get list of dwo files from EXE"
 					   " (defaults output to EXE.dwp)\n"));
   fprintf(fd, _("  -o FILE, --output FILE   Set output dwp file name\n"));
+  fprintf(fd, _("  --threads                Read input files in parallel\n"));
+  fprintf(fd, _("  --no-threads             Read input files one at a time"
+					   " (default)\n"));
+  fprintf(fd, _("  --thread-count COUNT     Number of threads to use"
+					   " (implies --threads)\n"));
   fprintf(fd, _("  -v, --verbose            Verbose output\n"));
   fprintf(fd, _("  --verify-only            Verify output file against"
 					   " exec file\n"));
@@ -2391,6 +2723,8 @@ main(int argc, char** argv)
   const char* exe_filename = NULL;
   bool verbose = false;
   bool verify_only = false;
+  bool threads = false;
+  int thread_count = 0;
   int c;
   while ((c = getopt_long(argc, argv, "e:ho:vV", dwp_options, NULL)) != -1)
     {
@@ -2410,6 +2744,21 @@ main(int argc, char** argv)
 	  case VERIFY_ONLY:
 	    verify_only = true;
 	    break;
+	  case THREADS:
+	    threads = true;
+	    break;
+	  case NO_THREADS:
+	    threads = false;
+	    break;
+	  case THREAD_COUNT:
+	    {
+	      char* endptr;
+	      thread_count = strtol(optarg, &endptr, 0);
+	      if (*endptr != '\0' || thread_count <= 0)
+		gold_fatal(_("invalid thread count: %s"), optarg);
+	      threads = true;
+	    }
+	    break;
 	  case 'V':
 	    print_version();
 	  case '?':
@@ -2418,6 +2767,17 @@ main(int argc, char** argv)
 	}
     }
 
+  if (threads)
+    {
+#ifdef ENABLE_THREADS
+      options.set_thread_options(true, thread_count);
+#else
+      gold_warning(_("ignoring --threads: "
+		     "%s was compiled without thread support"),
+		   program_name);
+#endif
+    }
+
   if (output_filename.empty())
     {
       if (exe_filename == NULL)
@@ -2451,13 +2811,10 @@ main(int argc, char** argv)
 
   // Process each file, adding its contents to the output file.
   Dwp_output_file output_file(output_filename.c_str());
-  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
-    {
-      if (verbose)
-	fprintf(stderr, "%s\n", f->dwo_name.c_str());
-      Dwo_file dwo_file(f->dwo_name.c_str());
-      dwo_file.read(&output_file);
-    }
+  unsigned int thread_count_used = parallel_thread_count();
+  output_file.set_spill_contributions(thread_count_used > 1);
+  Dwo_read_job read_job(files, &output_file, 4 * thread_count_used, verbose);
+  run_in_parallel(&read_job, thread_count_used);
   output_file.finalize();
 
   return EXIT_SUCCESS;
@@ -27,6 +27,7 @@
 
 #include "elfcpp.h"
 #include "dwarf.h"
+#include "gold-threads.h"
 #include "symtab.h"
 #include "reloc.h"
 #include "ehframe.h"
@@ -188,8 +189,11 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
 						&fde_addresses);
 
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
+      // A large program has hundreds of thousands of FDEs, so sort
+      // them in parallel when we can.  No two FDEs have the same
+      // address, so the result does not depend on the thread count.
+      parallel_sort(fde_addresses.begin(), fde_addresses.end(),
+		    Fde_address_compare<size>());
 
       typename elfcpp::Elf_types<size>::Elf_Addr output_address;
       output_address = this->address();
@@ -552,6 +556,19 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
   return false;
 }
 
+// Class Parsed_eh_frame.
+
+Parsed_eh_frame::~Parsed_eh_frame()
+{
+  for (std::vector<Entry>::iterator p = this->entries_.begin();
+       p != this->entries_.end();
+       ++p)
+    {
+      delete p->cie;
+      delete p->fde;
+    }
+}
+
 // Add input section SHNDX in OBJECT to an exception frame section.
 // SYMBOLS is the contents of the symbol table section (size
 // SYMBOLS_SIZE), SYMBOL_NAMES is the symbol names section (size
@@ -561,7 +578,8 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
 // SHT_REL or SHT_RELA.  We try to parse the input exception frame
 // data into our data structures.  If we can't do it, we return false
 // to mean that the section should be handled as a normal input
-// section.
+// section.  If the section was already parsed while reading symbols,
+// we use that result.
 
 template<int size, bool big_endian>
 bool
@@ -575,60 +593,67 @@ Eh_frame::add_ehframe_input_section(
     unsigned int reloc_shndx,
     unsigned int reloc_type)
 {
+  Parsed_eh_frame* parsed = object->release_parsed_eh_frame(shndx);
+  if (parsed == NULL)
+    parsed = parse_ehframe_input_section(object, symbols, symbols_size,
+					 symbol_names, symbol_names_size,
+					 shndx, reloc_shndx, reloc_type);
+  bool ret = this->add_parsed_ehframe_input_section(object, parsed);
+  delete parsed;
+  return ret;
+}
+
+// Parse input section SHNDX in OBJECT.  This does not look at
+// anything outside OBJECT, and does not change the Eh_frame.
+
+template<int size, bool big_endian>
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type)
+{
+  Parsed_eh_frame* parsed = new Parsed_eh_frame(shndx);
+
   // Get the section contents.
   section_size_type contents_len;
   const unsigned char* pcontents = object->section_contents(shndx,
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return false;
+    return parsed;
 
   // If this is the marker section for the end of the data, then
-  // return false to force it to be handled as an ordinary input
-  // section.  If we don't do this, we won't correctly handle the case
-  // of unrecognized .eh_frame sections.
+  // leave it to be handled as an ordinary input section.  If we don't
+  // do this, we won't correctly handle the case of unrecognized
+  // .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return false;
-
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
-    {
-      if (this->eh_frame_hdr_ != NULL)
-	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
-
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
+    return parsed;
 
-      return false;
-    }
-
-  // Now that we know we are using this section, record any new CIEs
-  // that we found.
-  for (New_cies::const_iterator p = new_cies.begin();
-       p != new_cies.end();
-       ++p)
+  if (!do_parse_ehframe_input_section(object, symbols, symbols_size,
+				      symbol_names, symbol_names_size,
+				      shndx, reloc_shndx, reloc_type,
+				      pcontents, contents_len, parsed))
     {
-      if (p->second)
-	this->cie_offsets_.insert(p->first);
-      else
-	this->unmergeable_cie_offsets_.push_back(p->first);
+      parsed->status_ = Parsed_eh_frame::PARSE_FAILED;
+      return parsed;
     }
 
-  return true;
+  parsed->status_ = Parsed_eh_frame::PARSE_OK;
+  return parsed;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of parse_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_parse_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
@@ -639,7 +664,7 @@ Eh_frame::do_add_ehframe_input_section(
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Parsed_eh_frame* parsed)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -691,17 +716,16 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!read_cie(object, shndx, symbols, symbols_size,
+			symbol_names, symbol_names_size,
+			pcontents, p, pentend, &relocs, &cies, parsed))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!read_fde(object, shndx, symbols, symbols_size,
+			pcontents, id, p, pentend, &relocs, &cies, parsed))
 	    return false;
 	}
 
@@ -711,6 +735,103 @@ Eh_frame::do_add_ehframe_input_section(
   return true;
 }
 
+// Merge the CIEs and FDEs which we found in an input section of
+// OBJECT into the output section, in the order in which they appear
+// in the input.  This is where duplicate CIEs are discarded, and
+// where FDEs for discarded sections are dropped.  Return false if the
+// section should be handled as a normal input section.
+
+bool
+Eh_frame::add_parsed_ehframe_input_section(Relobj* object,
+					   Parsed_eh_frame* parsed)
+{
+  if (parsed->status_ == Parsed_eh_frame::PARSE_IGNORE)
+    return false;
+
+  if (parsed->status_ == Parsed_eh_frame::PARSE_FAILED)
+    {
+      if (this->eh_frame_hdr_ != NULL)
+	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+      return false;
+    }
+
+  const unsigned int shndx = parsed->shndx_;
+  std::vector<Parsed_eh_frame::Entry>& entries(parsed->entries_);
+
+  // The CIE which each CIE entry turned into.
+  std::vector<Cie*> entry_cies(entries.size());
+
+  New_cies new_cies;
+  for (size_t i = 0; i < entries.size(); ++i)
+    {
+      Parsed_eh_frame::Entry* pe = &entries[i];
+
+      if (pe->cie != NULL)
+	{
+	  Cie* cie_pointer = NULL;
+	  if (pe->mergeable)
+	    {
+	      Cie_offsets::iterator find_cie = this->cie_offsets_.find(pe->cie);
+	      if (find_cie != this->cie_offsets_.end())
+		cie_pointer = *find_cie;
+	      else if (pe->cie_index != -1U)
+		{
+		  // We already saw this CIE in this object file.
+		  cie_pointer = entry_cies[pe->cie_index];
+		}
+	    }
+
+	  if (cie_pointer == NULL)
+	    {
+	      cie_pointer = pe->cie;
+	      new_cies.push_back(std::make_pair(cie_pointer, pe->mergeable));
+	    }
+	  else
+	    {
+	      // We are deleting this CIE.  Record that in our mapping
+	      // from input sections to the output section.
+	      this->merge_map_.add_mapping(object, shndx, pe->input_offset,
+					   pe->length, -1);
+	      delete pe->cie;
+	    }
+	  pe->cie = NULL;
+	  entry_cies[i] = cie_pointer;
+	}
+      else
+	{
+	  gold_assert(pe->fde != NULL);
+	  if (pe->is_ordinary
+	      && pe->fde_shndx != elfcpp::SHN_UNDEF
+	      && pe->fde_shndx < object->shnum()
+	      && !object->is_section_included(pe->fde_shndx))
+	    {
+	      // This FDE applies to a section which we are discarding.
+	      // We can discard this FDE.
+	      this->merge_map_.add_mapping(object, shndx, pe->input_offset,
+					   pe->length, -1);
+	      delete pe->fde;
+	    }
+	  else
+	    entry_cies[pe->cie_index]->add_fde(pe->fde);
+	  pe->fde = NULL;
+	}
+    }
+
+  // Now that we know we are using this section, record any new CIEs
+  // that we found.
+  for (New_cies::const_iterator p = new_cies.begin();
+       p != new_cies.end();
+       ++p)
+    {
+      if (p->second)
+	this->cie_offsets_.insert(p->first);
+      else
+	this->unmergeable_cie_offsets_.push_back(p->first);
+    }
+
+  return true;
+}
+
 // Read a CIE.  Return false if we can't parse the information.
 
 template<int size, bool big_endian>
@@ -726,7 +847,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Parsed_eh_frame* parsed)
 {
   bool mergeable = true;
 
@@ -919,48 +1040,29 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
+  std::vector<Parsed_eh_frame::Entry>& entries(parsed->entries_);
+  Parsed_eh_frame::Entry entry((pcie - 8) - pcontents, pcieend - (pcie - 8));
+  entry.cie = new Cie(object, shndx, (pcie - 8) - pcontents, fde_encoding,
+		      personality_name, pcie, pcieend - pcie);
+  entry.mergeable = mergeable;
   if (mergeable)
     {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
+      // See if we already saw this CIE in this object file.  Whether
+      // it matches a CIE in some other object file is not decided
+      // until the section is merged.
+      for (size_t i = 0; i < entries.size(); ++i)
 	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
+	  if (entries[i].cie != NULL && *entries[i].cie == *entry.cie)
 	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
+	      entry.cie_index = i;
+	      break;
 	    }
 	}
     }
 
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
-  else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      this->merge_map_.add_mapping(object, shndx, (pcie - 8) - pcontents,
-				   pcieend - (pcie - 8), -1);
-    }
-
   // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  cies->insert(std::make_pair(pcie - pcontents, entries.size()));
+  entries.push_back(entry);
 
   return true;
 }
@@ -978,7 +1080,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   Offsets_to_cie* cies,
+		   Parsed_eh_frame* parsed)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -987,7 +1090,6 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
 
   // The FDE should start with a reloc to the start of the code which
   // it describes.
@@ -1016,20 +1118,15 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
 				       &is_ordinary);
 
-  if (is_ordinary
-      && fde_shndx != elfcpp::SHN_UNDEF
-      && fde_shndx < object->shnum()
-      && !object->is_section_included(fde_shndx))
-    {
-      // This FDE applies to a section which we are discarding.  We
-      // can discard this FDE.
-      this->merge_map_.add_mapping(object, shndx, (pfde - 8) - pcontents,
-				   pfdeend - (pfde - 8), -1);
-      return true;
-    }
-
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  // We can't tell yet whether FDE_SHNDX is being discarded; that is
+  // checked when the section is merged.
+  Parsed_eh_frame::Entry entry((pfde - 8) - pcontents, pfdeend - (pfde - 8));
+  entry.fde = new Fde(object, shndx, (pfde - 8) - pcontents,
+		      pfde, pfdeend - pfde);
+  entry.cie_index = pcie->second;
+  entry.fde_shndx = fde_shndx;
+  entry.is_ordinary = is_ordinary;
+  parsed->entries_.push_back(entry);
 
   return true;
 }
@@ -1216,6 +1313,18 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1230,6 +1339,18 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1244,6 +1365,18 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1258,6 +1391,18 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 } // End namespace gold.
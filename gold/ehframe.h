@@ -124,14 +124,19 @@ class Eh_frame_hdr : public Output_section_data
     Fde_address_list fde_addresses_;
   };
 
-  // Compare Fde_address objects.
+  // Compare Fde_address objects.  FDEs for the same PC are ordered by
+  // address, so that the sorted table does not depend on the sort.
   template<int size>
   struct Fde_address_compare
   {
     bool
     operator()(const typename Fde_addresses<size>::Fde_address& f1,
 	       const typename Fde_addresses<size>::Fde_address& f2) const
-    { return f1.first < f2.first; }
+    {
+      if (f1.first != f2.first)
+	return f1.first < f2.first;
+      return f1.second < f2.second;
+    }
   };
 
   // Return the PC to which an FDE refers.
@@ -351,6 +356,86 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+// The CIEs and FDEs found in a single input .eh_frame section.  The
+// section is parsed without looking at any other input file, so this
+// may be done while reading symbols, in parallel with other objects.
+// Eh_frame::add_ehframe_input_section later merges the result into
+// the output .eh_frame section in input order, which keeps the output
+// the same as when each section is parsed as it is laid out.
+
+class Parsed_eh_frame
+{
+ public:
+  // The result of parsing the section.
+  enum Status
+  {
+    // The section is empty or is the zero terminator.  It should be
+    // handled as an ordinary input section.
+    PARSE_IGNORE,
+    // We could not parse the section.  It should be handled as an
+    // ordinary input section, and we can not build .eh_frame_hdr.
+    PARSE_FAILED,
+    // We parsed the section.
+    PARSE_OK
+  };
+
+  Parsed_eh_frame(unsigned int shndx)
+    : shndx_(shndx), status_(PARSE_IGNORE), entries_()
+  { }
+
+  ~Parsed_eh_frame();
+
+  // The index of the input section.
+  unsigned int
+  shndx() const
+  { return this->shndx_; }
+
+ private:
+  friend class Eh_frame;
+
+  // One CIE or FDE, in the order in which they appear in the input
+  // section.
+  struct Entry
+  {
+    Entry(section_offset_type offset, section_size_type len)
+      : input_offset(offset), length(len), cie(NULL), fde(NULL),
+	mergeable(false), cie_index(-1U), fde_shndx(0), is_ordinary(false)
+    { }
+
+    // The offset of the entry in the input section.
+    section_offset_type input_offset;
+    // The length of the entry, including the length word.
+    section_size_type length;
+    // For a CIE, the CIE; for an FDE, NULL.  Cleared once the CIE has
+    // been handed over to the Eh_frame.
+    Cie* cie;
+    // For an FDE, the FDE; for a CIE, NULL.  Cleared once the FDE has
+    // been handed over to the Eh_frame.
+    Fde* fde;
+    // For a CIE, whether it may be merged with other identical CIEs.
+    bool mergeable;
+    // For a mergeable CIE, the index in entries_ of an earlier
+    // identical CIE in this section, or -1U.  For an FDE, the index
+    // in entries_ of its CIE.
+    unsigned int cie_index;
+    // For an FDE, the section index of the code it describes.
+    unsigned int fde_shndx;
+    // For an FDE, whether FDE_SHNDX is an ordinary section index.
+    bool is_ordinary;
+  };
+
+  // The class is not copyable.
+  Parsed_eh_frame(const Parsed_eh_frame&);
+  Parsed_eh_frame& operator=(const Parsed_eh_frame&);
+
+  // Input section index.
+  unsigned int shndx_;
+  // The result of parsing.
+  Status status_;
+  // The CIEs and FDEs.
+  std::vector<Entry> entries_;
+};
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -381,6 +466,19 @@ class Eh_frame : public Output_section_data
 			    unsigned int shndx, unsigned int reloc_shndx,
 			    unsigned int reloc_type);
 
+  // Parse the input section SHNDX in OBJECT, with the same arguments
+  // as add_ehframe_input_section.  This only looks at OBJECT, so it
+  // may be called from any thread.  The caller owns the result.
+  template<int size, bool big_endian>
+  static Parsed_eh_frame*
+  parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+			      const unsigned char* symbols,
+			      section_size_type symbols_size,
+			      const unsigned char* symbol_names,
+			      section_size_type symbol_names_size,
+			      unsigned int shndx, unsigned int reloc_shndx,
+			      unsigned int reloc_type);
+
   // Add a CIE and an FDE for a PLT section, to permit unwinding
   // through a PLT.  The FDE data should start with 8 bytes of zero,
   // which will be replaced by a 4 byte PC relative reference to the
@@ -433,9 +531,9 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
+  // A mapping from offsets to the index of the CIE in the entries of
+  // a Parsed_eh_frame.  This is used while reading an input section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // A list of CIEs, and a bool indicating whether the CIE is
   // mergeable.
@@ -445,24 +543,24 @@ class Eh_frame : public Output_section_data
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The bulk of the implementation of parse_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+				 const unsigned char* symbols,
+				 section_size_type symbols_size,
+				 const unsigned char* symbol_names,
+				 section_size_type symbol_names_size,
+				 unsigned int shndx,
+				 unsigned int reloc_shndx,
+				 unsigned int reloc_type,
+				 const unsigned char* pcontents,
+				 section_size_type contents_len,
+				 Parsed_eh_frame*);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -474,11 +572,11 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Parsed_eh_frame* parsed);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj_file<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -488,7 +586,12 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   Offsets_to_cie* cies,
+	   Parsed_eh_frame* parsed);
+
+  // Merge the CIEs and FDEs parsed from an input section of OBJECT.
+  bool
+  add_parsed_ehframe_input_section(Relobj* object, Parsed_eh_frame*);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -0,0 +1,191 @@
+// fast-hash.cc -- a fast non-cryptographic 128-bit hash
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cstring>
+
+#include "elfcpp.h"
+#include "fast-hash.h"
+
+// The hash is built the same way as the 64-bit xxHash: the input is
+// consumed in 32-byte stripes by four independent 64-bit lanes, so a
+// compiler can keep the lanes in registers (or vector registers) and
+// overlap the multiplications.  The lanes are then folded twice, in a
+// different order and with different rotations, to produce the two
+// halves of the 128-bit digest, and the tail of the input is mixed
+// into both halves.  All input words are read as little endian.
+
+namespace
+{
+
+const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t prime3 = 0x165667B19E3779F9ULL;
+const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t
+rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+// Read little endian words which need not be aligned.  The memcpy
+// compiles to a single load.
+
+inline uint64_t
+read64(const unsigned char* p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof v);
+  return elfcpp::Convert<64, false>::convert_host(v);
+}
+
+inline uint64_t
+read32(const unsigned char* p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof v);
+  return elfcpp::Convert<32, false>::convert_host(v);
+}
+
+// Mix the input word INPUT into the lane ACC.
+
+inline uint64_t
+lane_round(uint64_t acc, uint64_t input)
+{
+  acc += input * prime2;
+  acc = rotl(acc, 31);
+  return acc * prime1;
+}
+
+// Fold the lane V into the hash H.
+
+inline uint64_t
+merge_round(uint64_t h, uint64_t v)
+{
+  h ^= lane_round(0, v);
+  return h * prime1 + prime4;
+}
+
+// Make every bit of H depend on every other bit.
+
+inline uint64_t
+avalanche(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+} // End anonymous namespace.
+
+namespace gold
+{
+
+void
+fast_hash128(const unsigned char* data, size_t len, unsigned char* digest)
+{
+  const unsigned char* p = data;
+  const unsigned char* const end = data + len;
+  uint64_t lo;
+  uint64_t hi;
+
+  if (len >= 32)
+    {
+      uint64_t v1 = prime1 + prime2;
+      uint64_t v2 = prime2;
+      uint64_t v3 = 0;
+      uint64_t v4 = -prime1;
+      const unsigned char* const limit = end - 32;
+      do
+	{
+	  v1 = lane_round(v1, read64(p));
+	  v2 = lane_round(v2, read64(p + 8));
+	  v3 = lane_round(v3, read64(p + 16));
+	  v4 = lane_round(v4, read64(p + 24));
+	  p += 32;
+	}
+      while (p <= limit);
+
+      lo = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+      lo = merge_round(lo, v1);
+      lo = merge_round(lo, v2);
+      lo = merge_round(lo, v3);
+      lo = merge_round(lo, v4);
+
+      hi = rotl(v1, 3) + rotl(v2, 17) + rotl(v3, 23) + rotl(v4, 41);
+      hi = merge_round(hi, v4);
+      hi = merge_round(hi, v3);
+      hi = merge_round(hi, v2);
+      hi = merge_round(hi, v1);
+    }
+  else
+    {
+      lo = prime5;
+      hi = prime4;
+    }
+
+  lo += static_cast<uint64_t>(len);
+  hi ^= static_cast<uint64_t>(len) * prime3;
+
+  while (p + 8 <= end)
+    {
+      uint64_t k = lane_round(0, read64(p));
+      lo ^= k;
+      lo = rotl(lo, 27) * prime1 + prime4;
+      hi += k;
+      hi = rotl(hi, 31) * prime2 + prime5;
+      p += 8;
+    }
+
+  if (p + 4 <= end)
+    {
+      uint64_t k = read32(p) * prime1;
+      lo ^= k;
+      lo = rotl(lo, 23) * prime2 + prime3;
+      hi ^= rotl(k, 19);
+      hi = rotl(hi, 29) * prime1 + prime3;
+      p += 4;
+    }
+
+  while (p < end)
+    {
+      uint64_t k = *p * prime5;
+      lo ^= k;
+      lo = rotl(lo, 11) * prime1;
+      hi += k;
+      hi = rotl(hi, 17) * prime3;
+      ++p;
+    }
+
+  lo = avalanche(lo + hi);
+  hi = avalanche(hi ^ rotl(lo, 29));
+
+  elfcpp::Swap_unaligned<64, false>::writeval(digest, lo);
+  elfcpp::Swap_unaligned<64, false>::writeval(digest + 8, hi);
+}
+
+} // End namespace gold.
@@ -0,0 +1,42 @@
+// fast-hash.h -- a fast non-cryptographic 128-bit hash  -*- C++ -*-
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_FAST_HASH_H
+#define GOLD_FAST_HASH_H
+
+namespace gold
+{
+
+// The size in bytes of the digest computed by fast_hash128.
+const size_t fast_hash128_size = 16;
+
+// Compute a 128-bit hash of the LEN bytes at DATA, and store it in
+// the fast_hash128_size bytes at DIGEST.  This is used for
+// --build-id=fast.  It is not a cryptographic hash, but it is much
+// faster than MD5 or SHA-1.  The digest does not depend on the byte
+// order of the host.
+
+extern void
+fast_hash128(const unsigned char* data, size_t len, unsigned char* digest);
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_FAST_HASH_H)
@@ -288,6 +288,25 @@ File_read::release()
   this->released_ = true;
 }
 
+// Permit access from several threads.
+
+void
+File_read::begin_parallel_access()
+{
+  gold_assert(this->is_locked() && this->parallel_lock_ == NULL);
+  this->parallel_lock_ = new Lock();
+}
+
+// Return to access from a single thread.
+
+void
+File_read::end_parallel_access()
+{
+  gold_assert(this->parallel_lock_ != NULL);
+  delete this->parallel_lock_;
+  this->parallel_lock_ = NULL;
+}
+
 // Lock the file.
 
 void
@@ -424,6 +443,7 @@ File_read::do_read(off_t start, section_size_type size, void* p)
 void
 File_read::read(off_t start, section_size_type size, void* p)
 {
+  Hold_optional_lock hl(this->parallel_lock_);
   const File_read::View* pv = this->find_view(start, size, -1U, NULL);
   if (pv != NULL)
     {
@@ -614,6 +634,7 @@ const unsigned char*
 File_read::get_view(off_t offset, off_t start, section_size_type size,
 		    bool aligned, bool cache)
 {
+  Hold_optional_lock hl(this->parallel_lock_);
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   return pv->data() + (offset + start - pv->start() + pv->byteshift());
@@ -623,6 +644,7 @@ File_view*
 File_read::get_lasting_view(off_t offset, off_t start, section_size_type size,
 			    bool aligned, bool cache)
 {
+  Hold_optional_lock hl(this->parallel_lock_);
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   pv->lock();
@@ -732,6 +754,7 @@ File_read::read_multiple(off_t base, const Read_multiple& rm)
 	this->read(base + i_off, i_entry.size, i_entry.buffer);
       else
 	{
+	  Hold_optional_lock hl(this->parallel_lock_);
 	  File_read::View* view = this->find_view(base + i_off,
 						  end_off - i_off,
 						  -1U, NULL);
@@ -862,6 +885,7 @@ File_read::print_stats()
 File_view::~File_view()
 {
   gold_assert(this->file_.is_locked());
+  Hold_optional_lock hl(this->file_.parallel_lock_);
   this->view_->unlock();
 }
 
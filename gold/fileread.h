@@ -30,6 +30,7 @@
 #include <string>
 #include <vector>
 
+#include "gold-threads.h"
 #include "token.h"
 
 namespace gold
@@ -72,7 +73,7 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      released_(true), whole_file_view_(NULL), parallel_lock_(NULL)
   { }
 
   ~File_read();
@@ -96,12 +97,29 @@ class File_read
   // Add an object associated with a file.
   void
   add_object()
-  { ++this->object_count_; }
+  {
+    Hold_optional_lock hl(this->parallel_lock_);
+    ++this->object_count_;
+  }
 
   // Remove an object associated with a file.
   void
   remove_object()
-  { --this->object_count_; }
+  {
+    Hold_optional_lock hl(this->parallel_lock_);
+    --this->object_count_;
+  }
+
+  // Permit several threads to create objects for the file and to get
+  // views of it, on behalf of the Task which has locked it, until
+  // end_parallel_access is called.  This is used to read archive
+  // members in parallel.
+  void
+  begin_parallel_access();
+
+  // Return to access by a single thread.
+  void
+  end_parallel_access();
 
   // Lock the file for exclusive access within a particular Task::run
   // execution.  This routine may only be called when the workqueue
@@ -442,6 +460,9 @@ class File_read
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
   View* whole_file_view_;
+  // While several threads may use the file, a lock which controls
+  // access to the views; NULL otherwise.
+  Lock* parallel_lock_;
 };
 
 // A view of file data that persists even when the file is unlocked.
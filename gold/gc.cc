@@ -22,52 +22,164 @@
 
 
 #include "gold.h"
+
+#include <cstdio>
+
+#include "options.h"
 #include "object.h"
 #include "gc.h"
 #include "symtab.h"
+#include "gold-threads.h"
 
 namespace gold
 {
 
-// Garbage collection uses a worklist style algorithm to determine the 
-// transitive closure of all referenced sections.
-void 
+// A job which finds the sections referenced by the sections in one
+// part of FRONTIER, the sections newly marked by the previous pass.
+// The pieces only read the Garbage_collection data, so they may run
+// on several threads.  Each piece collects the referenced sections
+// which are not yet marked in its own vector of FOUND.
+
+class Garbage_collection::Mark_job : public Parallel_job
+{
+ public:
+  Mark_job(Garbage_collection* gc, const std::vector<Section_id>& frontier,
+	   unsigned int pieces, std::vector<std::vector<Section_id> >* found,
+	   std::vector<size_t>* references)
+    : gc_(gc), frontier_(frontier), pieces_(pieces), found_(found),
+      references_(references)
+  { }
+
+  void
+  run_piece(unsigned int);
+
+ private:
+  Garbage_collection* gc_;
+  const std::vector<Section_id>& frontier_;
+  unsigned int pieces_;
+  std::vector<std::vector<Section_id> >* found_;
+  std::vector<size_t>* references_;
+};
+
+void
+Garbage_collection::Mark_job::run_piece(unsigned int i)
+{
+  const Section_ref& section_reloc_map(this->gc_->section_reloc_map_);
+  const Sections_reachable& referenced_list(this->gc_->referenced_list_);
+  std::vector<Section_id>& found((*this->found_)[i]);
+  size_t references = 0;
+
+  size_t size = this->frontier_.size();
+  size_t begin = size * i / this->pieces_;
+  size_t end = size * (i + 1) / this->pieces_;
+  for (size_t j = begin; j < end; ++j)
+    {
+      Section_ref::const_iterator p = section_reloc_map.find(this->frontier_[j]);
+      if (p == section_reloc_map.end())
+	continue;
+      references += p->second.size();
+      for (Sections_reachable::const_iterator q = p->second.begin();
+	   q != p->second.end();
+	   ++q)
+	{
+	  // Do not add already processed sections to the list.
+	  if (referenced_list.find(*q) == referenced_list.end())
+	    found.push_back(*q);
+	}
+    }
+
+  (*this->references_)[i] = references;
+}
+
+// Garbage collection uses a worklist style algorithm to determine the
+// transitive closure of all referenced sections.  We process the
+// worklist in passes: each pass finds, on several threads, the
+// sections referenced by the sections marked in the previous pass,
+// and then marks the new ones.  The set of marked sections does not
+// depend on the order in which we find them, so this keeps exactly
+// the sections which a simple walk of the worklist would keep.
+
+void
 Garbage_collection::do_transitive_closure()
 {
+  Timer timer;
+  if (parameters->options().stats())
+    timer.start();
+
+  std::vector<Section_id> frontier;
   while (!this->worklist().empty())
     {
-      // Add elements from the work list to the referenced list
-      // one by one.
       Section_id entry = this->worklist().front();
       this->worklist().pop();
-      if (this->referenced_list().find(entry)
-          == this->referenced_list().end()) 
-        {
-          this->referenced_list().insert(entry);
-        }
+      if (this->referenced_list().insert(entry).second)
+	frontier.push_back(entry);
+    }
+  this->num_roots_ = frontier.size();
+
+  // Split each pass into pieces of at least this many sections, so
+  // that short passes are not spread over threads.
+  const size_t min_piece_size = 64;
+
+  std::vector<std::vector<Section_id> > found;
+  std::vector<size_t> references;
+  while (!frontier.empty())
+    {
+      ++this->num_passes_;
+
+      unsigned int pieces = parallel_thread_count();
+      if (frontier.size() / min_piece_size < pieces)
+	pieces = frontier.size() / min_piece_size;
+      if (pieces == 0)
+	pieces = 1;
+
+      found.clear();
+      found.resize(pieces);
+      references.assign(pieces, 0);
+      Mark_job job(this, frontier, pieces, &found, &references);
+      if (pieces == 1)
+	job.run_piece(0);
       else
-        {
-          continue;
-        }
-      Garbage_collection::Section_ref::iterator find_it = 
-                this->section_reloc_map().find(entry);
-      if (find_it == this->section_reloc_map().end()) 
-          continue;
-      Garbage_collection::Sections_reachable v = find_it->second;
-      // Scan the vector of references for each work_list entry. 
-      for (Garbage_collection::Sections_reachable::iterator it_v = v.begin();
-           it_v != v.end();
-           ++it_v)
-        {
-          // Do not add already processed sections to the work_list. 
-          if (this->referenced_list().find(*it_v)
-              == this->referenced_list().end())
-            {
-              this->worklist().push(*it_v);   
-            }
-        }
+	run_in_parallel(&job, pieces);
+
+      // Mark the sections we found, in a fixed order, and make the
+      // new ones the frontier for the next pass.
+      std::vector<Section_id> next;
+      for (unsigned int i = 0; i < pieces; ++i)
+	{
+	  this->num_references_ += references[i];
+	  for (std::vector<Section_id>::const_iterator p = found[i].begin();
+	       p != found[i].end();
+	       ++p)
+	    if (this->referenced_list().insert(*p).second)
+	      next.push_back(*p);
+	}
+      frontier.swap(next);
     }
+
   this->worklist_ready();
+
+  if (parameters->options().stats())
+    this->elapsed_ = timer.get_elapsed_time();
+}
+
+// Print statistics about garbage collection to stderr.
+
+void
+Garbage_collection::print_stats()
+{
+  fprintf(stderr, _("%s: GC root sections: %zu\n"),
+	  program_name, this->num_roots_);
+  fprintf(stderr, _("%s: GC sections kept: %zu\n"),
+	  program_name, this->referenced_list().size());
+  fprintf(stderr, _("%s: GC mark passes: %u; references scanned: %zu\n"),
+	  program_name, this->num_passes_, this->num_references_);
+  fprintf(stderr,
+	  _("%s: GC mark time: "
+	    "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+	  program_name,
+	  this->elapsed_.user / 1000, (this->elapsed_.user % 1000) * 1000,
+	  this->elapsed_.sys / 1000, (this->elapsed_.sys % 1000) * 1000,
+	  this->elapsed_.wall / 1000, (this->elapsed_.wall % 1000) * 1000);
 }
 
 } // End namespace gold.
@@ -30,6 +30,7 @@
 #include "symtab.h"
 #include "object.h"
 #include "icf.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -59,7 +60,8 @@ class Garbage_collection
   typedef std::map<std::string, Sections_reachable> Cident_section_map;
 
   Garbage_collection()
-  : is_worklist_ready_(false)
+  : is_worklist_ready_(false), num_roots_(0), num_passes_(0),
+    num_references_(0), elapsed_()
   { }
 
   // Accessor methods for the private members.
@@ -87,6 +89,10 @@ class Garbage_collection
   void
   do_transitive_closure();
 
+  // Print statistics to stderr.
+  void
+  print_stats();
+
   bool
   is_section_garbage(Object* obj, unsigned int shndx)
   { return (this->referenced_list().find(Section_id(obj, shndx))
@@ -118,11 +124,22 @@ class Garbage_collection
 
  private:
 
+  // A job which finds the sections referenced by part of the
+  // sections marked in the previous pass of do_transitive_closure.
+  class Mark_job;
+
   Worklist_type work_list_;
   bool is_worklist_ready_;
   Section_ref section_reloc_map_;
   Sections_reachable referenced_list_;
   Cident_section_map cident_sections_;
+  // Statistics for --stats: the number of distinct sections on the
+  // initial worklist, the number of passes over the newly marked
+  // sections, the number of references scanned, and the time taken.
+  size_t num_roots_;
+  unsigned int num_passes_;
+  size_t num_references_;
+  Timer::TimeStats elapsed_;
 };
 
 // Data to pass between successive invocations of do_layout
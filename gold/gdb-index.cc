@@ -27,12 +27,17 @@
 #include "dwarf.h"
 #include "object.h"
 #include "output.h"
+#include "workqueue.h"
 #include "demangle.h"
+#include "gdb/gdb-index.h"
 
 namespace gold
 {
 
-const int gdb_index_version = 5;
+// Version 7 added the symbol kind and static flag to the CU vector
+// entries, and version 8 made symbols defined in a type unit refer to
+// the type unit rather than to the compilation unit.
+const int gdb_index_version = 8;
 
 // Sizes of various records in the .gdb_index section.
 const int gdb_index_offset_size = 4;
@@ -171,6 +176,230 @@ mapped_index_string_hash(const unsigned char* str)
   return r;
 }
 
+class Gdb_index_info_reader;
+
+// The results of scanning the .debug_info and .debug_types sections
+// of one input object.  The scan records the CUs, TUs, address ranges
+// and symbols it finds, numbering the CUs and TUs from zero within the
+// object.  Gdb_index::add_scans adds them to the index afterward.
+
+class Gdb_index_scan
+{
+ public:
+  Gdb_index_scan(Relobj* object, const unsigned char* symbols,
+		 off_t symbols_size);
+
+  ~Gdb_index_scan();
+
+  // Return the object being scanned.
+  Relobj*
+  object() const
+  { return this->object_; }
+
+  // Add a .debug_info or .debug_types section to be scanned.
+  void
+  add_section(bool is_type_unit, unsigned int shndx,
+	      unsigned int reloc_shndx, unsigned int reloc_type)
+  {
+    this->sections_.push_back(Section(is_type_unit, shndx, reloc_shndx,
+				      reloc_type));
+  }
+
+  // Scan the sections.  The object must be locked by the caller.
+  void
+  scan();
+
+  // Return whether the sections have been scanned.
+  bool
+  is_scanned() const
+  { return this->is_scanned_; }
+
+  // Add the results of the scan to GDB_INDEX.
+  void
+  add_to_index(Gdb_index* gdb_index);
+
+  // The remaining functions are called by Gdb_index_info_reader.
+
+  // Add a compilation unit, returning its index within the object.
+  int
+  add_comp_unit(off_t cu_offset, off_t cu_length)
+  {
+    this->comp_units_.push_back(std::make_pair(cu_offset, cu_length));
+    return this->comp_units_.size() - 1;
+  }
+
+  // Add a type unit, returning its index within the object.
+  int
+  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
+  {
+    this->type_units_.push_back(Type_unit(tu_offset, type_offset, signature));
+    return this->type_units_.size() - 1;
+  }
+
+  // Add an address range.
+  void
+  add_address_range_list(int cu_index, Dwarf_range_list* ranges)
+  { this->ranges_.push_back(std::make_pair(cu_index, ranges)); }
+
+  // Add a symbol.
+  void
+  add_symbol(int cu_index, const char* sym_name, unsigned int attributes)
+  {
+    this->symbols_list_.push_back(Symbol(this->names_.size(), cu_index,
+					 attributes));
+    this->names_.append(sym_name, strlen(sym_name) + 1);
+  }
+
+  // Return the offset into the pubnames table for the cu at the given
+  // offset.
+  off_t
+  find_pubname_offset(off_t cu_offset);
+
+  // Return the offset into the pubtypes table for the cu at the
+  // given offset.
+  off_t
+  find_pubtype_offset(off_t cu_offset);
+
+  // Return TRUE if we have already processed the pubnames and types
+  // set of the CUs and TUS associated with the statement list at
+  // OFFSET.
+  bool
+  pubnames_read(off_t offset) const
+  { return this->stmt_list_offset_ == offset; }
+
+  // Record that we have already read the pubnames associated with
+  // OFFSET.
+  void
+  set_pubnames_read(off_t offset)
+  { this->stmt_list_offset_ = offset; }
+
+  // Return a pointer to the given table.
+  Dwarf_pubnames_table*
+  pubnames_table()
+  { return this->pubnames_table_; }
+
+  Dwarf_pubnames_table*
+  pubtypes_table()
+  { return this->pubtypes_table_; }
+
+  // Count a compilation unit or type unit, and whether its names were
+  // found in the pubnames and pubtypes tables.
+  void
+  count_unit(bool is_type_unit, bool has_pubnames)
+  {
+    if (is_type_unit)
+      {
+	++this->tu_count_;
+	if (!has_pubnames)
+	  ++this->tu_nopubnames_count_;
+      }
+    else
+      {
+	++this->cu_count_;
+	if (!has_pubnames)
+	  ++this->cu_nopubnames_count_;
+      }
+  }
+
+  // Print usage statistics.
+  static void
+  print_stats();
+
+ private:
+  // A section to scan.
+  struct Section
+  {
+    Section(bool is_tu, unsigned int sec_shndx, unsigned int rel_shndx,
+	    unsigned int rel_type)
+      : is_type_unit(is_tu), shndx(sec_shndx), reloc_shndx(rel_shndx),
+	reloc_type(rel_type)
+    { }
+    bool is_type_unit;
+    unsigned int shndx;
+    unsigned int reloc_shndx;
+    unsigned int reloc_type;
+  };
+
+  // A type unit.
+  struct Type_unit
+  {
+    Type_unit(off_t off, off_t toff, uint64_t sig)
+      : tu_offset(off), type_offset(toff), type_signature(sig)
+    { }
+    off_t tu_offset;
+    off_t type_offset;
+    uint64_t type_signature;
+  };
+
+  // A symbol.  The name is at NAME_OFFSET in NAMES_.  CU_INDEX is
+  // negative for a TU.
+  struct Symbol
+  {
+    Symbol(size_t offset, int index, unsigned int attrs)
+      : name_offset(offset), cu_index(index), attributes(attrs)
+    { }
+    size_t name_offset;
+    int cu_index;
+    unsigned int attributes;
+  };
+
+  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
+
+  // Create a map from dies to pubnames.
+  Dwarf_pubnames_table*
+  map_pubtable_to_dies(unsigned int attr, Gdb_index_info_reader* dwinfo);
+
+  // Wrapper for map_pubtable_to_dies
+  void
+  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo);
+
+  // The object being scanned.
+  Relobj* object_;
+  // A copy of the symbol table of the object, used to apply the
+  // relocations to the debug info.
+  unsigned char* symbols_;
+  off_t symbols_size_;
+  // The sections to scan.
+  std::vector<Section> sections_;
+  // Whether the sections have been scanned.
+  bool is_scanned_;
+  // The compilation units, as (offset, length) pairs.
+  std::vector<std::pair<off_t, off_t> > comp_units_;
+  // The type units.
+  std::vector<Type_unit> type_units_;
+  // The address ranges, as (CU index, range list) pairs.
+  std::vector<std::pair<int, Dwarf_range_list*> > ranges_;
+  // The symbols, and the buffer holding their names.
+  std::vector<Symbol> symbols_list_;
+  std::string names_;
+  // Maps from a CU offset to its set in the pubnames and pubtypes
+  // tables.
+  Pubname_offset_map cu_pubname_map_;
+  Pubname_offset_map cu_pubtype_map_;
+  // The pubnames and pubtypes tables of the object.
+  Dwarf_pubnames_table* pubnames_table_;
+  Dwarf_pubnames_table* pubtypes_table_;
+  // The stmt list offset of the CUs and TUs associated with the last
+  // read pubnames and pubtypes sets.
+  off_t stmt_list_offset_;
+  // Statistics for this object.
+  unsigned int cu_count_;
+  unsigned int cu_nopubnames_count_;
+  unsigned int tu_count_;
+  unsigned int tu_nopubnames_count_;
+
+  // Statistics for all objects, updated as the scans are added to the
+  // index.
+  // Total number of DWARF compilation units processed.
+  static unsigned int dwarf_cu_count;
+  // Number of DWARF compilation units without pubnames/pubtypes.
+  static unsigned int dwarf_cu_nopubnames_count;
+  // Total number of DWARF type units processed.
+  static unsigned int dwarf_tu_count;
+  // Number of DWARF type units without pubnames/pubtypes.
+  static unsigned int dwarf_tu_nopubnames_count;
+};
+
 // A specialization of Dwarf_info_reader, for building the .gdb_index.
 
 class Gdb_index_info_reader : public Dwarf_info_reader
@@ -183,19 +412,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 			unsigned int shndx,
 			unsigned int reloc_shndx,
 			unsigned int reloc_type,
-			Gdb_index* gdb_index)
+			Gdb_index_scan* scan)
     : Dwarf_info_reader(is_type_unit, object, symbols, symbols_size, shndx,
 			reloc_shndx, reloc_type),
-      gdb_index_(gdb_index), cu_index_(0), cu_language_(0)
+      scan_(scan), cu_index_(0), cu_language_(0)
   { }
 
   ~Gdb_index_info_reader()
   { this->clear_declarations(); }
 
-  // Print usage statistics.
-  static void
-  print_stats();
-
  protected:
   // Visit a compilation unit.
   virtual void
@@ -217,14 +442,17 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   // have to manage them, but when we have a fully-qualified name
   // computed, we put it in the table, and set PARENT_OFFSET_ to -1
   // indicate a string that we are managing.
+  // IS_EXTERNAL_ records whether a function or variable declaration
+  // has the DW_AT_external attribute.
   struct Declaration_pair
   {
-    Declaration_pair(off_t parent_offset, const char* name)
-      : parent_offset_(parent_offset), name_(name)
+    Declaration_pair(off_t parent_offset, const char* name, bool is_external)
+      : parent_offset_(parent_offset), name_(name), is_external_(is_external)
     { }
 
     off_t parent_offset_;
     const char* name_; 
+    bool is_external_;
   };
   typedef Unordered_map<off_t, Declaration_pair> Declaration_map;
 
@@ -269,6 +497,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   std::string
   get_qualified_name(Dwarf_die* die, Dwarf_die* context);
 
+  // Return whether DIE, or the declaration it completes, is external.
+  bool
+  is_external(Dwarf_die* die);
+
+  // Return the symbol kind and static flag for the symbol defined by
+  // DIE, as they appear in a CU vector entry.
+  unsigned int
+  symbol_attributes(Dwarf_die* die);
+
   // Record the address ranges for a compilation unit.
   void
   record_cu_ranges(Dwarf_die* die);
@@ -285,8 +522,8 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   void
   clear_declarations();
 
-  // The Gdb_index section.
-  Gdb_index* gdb_index_;
+  // The scan of the object.
+  Gdb_index_scan* scan_;
   // The current CU index (negative for a TU).
   int cu_index_;
   // The language of the current CU or TU.
@@ -294,35 +531,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   // Map from DIE offset to (parent offset, name) pair,
   // for DW_AT_specification.
   Declaration_map declarations_;
-
-  // Statistics.
-  // Total number of DWARF compilation units processed.
-  static unsigned int dwarf_cu_count;
-  // Number of DWARF compilation units with pubnames/pubtypes.
-  static unsigned int dwarf_cu_nopubnames_count;
-  // Total number of DWARF type units processed.
-  static unsigned int dwarf_tu_count;
-  // Number of DWARF type units with pubnames/pubtypes.
-  static unsigned int dwarf_tu_nopubnames_count;
 };
 
-// Total number of DWARF compilation units processed.
-unsigned int Gdb_index_info_reader::dwarf_cu_count = 0;
-// Number of DWARF compilation units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_cu_nopubnames_count = 0;
-// Total number of DWARF type units processed.
-unsigned int Gdb_index_info_reader::dwarf_tu_count = 0;
-// Number of DWARF type units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_tu_nopubnames_count = 0;
-
 // Process a compilation unit and parse its child DIE.
 
 void
 Gdb_index_info_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
 					      Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_cu_count;
-  this->cu_index_ = this->gdb_index_->add_comp_unit(cu_offset, cu_length);
+  this->cu_index_ = this->scan_->add_comp_unit(cu_offset, cu_length);
   this->visit_top_die(root_die);
 }
 
@@ -333,10 +550,9 @@ Gdb_index_info_reader::visit_type_unit(off_t tu_offset, off_t,
 				       off_t type_offset, uint64_t signature,
 				       Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_tu_count;
   // Use a negative index to flag this as a TU instead of a CU.
-  this->cu_index_ = -1 - this->gdb_index_->add_type_unit(tu_offset, type_offset,
-							 signature);
+  this->cu_index_ = -1 - this->scan_->add_type_unit(tu_offset, type_offset,
+						    signature);
   this->visit_top_die(root_die);
 }
 
@@ -376,12 +592,13 @@ Gdb_index_info_reader::visit_top_die(Dwarf_die* die)
 	// If there is a pubnames and/or pubtypes section for this
 	// compilation unit, use those; otherwise, parse the DWARF
 	// info to extract the names.
-	if (!this->read_pubnames_and_pubtypes(die))
+	if (this->read_pubnames_and_pubtypes(die))
+	  this->scan_->count_unit(die->tag() == elfcpp::DW_TAG_type_unit,
+				  true);
+	else
 	  {
-	    if (die->tag() == elfcpp::DW_TAG_compile_unit)
-	      ++Gdb_index_info_reader::dwarf_cu_nopubnames_count;
-	    else
-	      ++Gdb_index_info_reader::dwarf_tu_nopubnames_count;
+	    this->scan_->count_unit(die->tag() == elfcpp::DW_TAG_type_unit,
+				    false);
 	    this->visit_children(die, NULL);
 	  }
 	break;
@@ -436,7 +653,8 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	    // If the DIE is not a declaration, add it to the index.
 	    std::string full_name = this->get_qualified_name(die, context);
 	    if (!full_name.empty())
-	      this->gdb_index_->add_symbol(this->cu_index_, full_name.c_str());
+	      this->scan_->add_symbol(this->cu_index_, full_name.c_str(),
+				      this->symbol_attributes(die));
 	  }
 	break;
       case elfcpp::DW_TAG_typedef:
@@ -475,8 +693,8 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	      if (full_name.empty())
 		full_name = this->get_qualified_name(die, context);
 	      if (!full_name.empty())
-		this->gdb_index_->add_symbol(this->cu_index_,
-					     full_name.c_str());
+		this->scan_->add_symbol(this->cu_index_, full_name.c_str(),
+					this->symbol_attributes(die));
 	    }
 
 	  // We're interested in the children only for namespaces and
@@ -690,6 +908,7 @@ Gdb_index_info_reader::add_declaration(Dwarf_die* die, Dwarf_die* context)
   const char* name = die->name();
 
   off_t parent_offset = context != NULL ? context->offset() : 0;
+  bool is_external = die->flag_attribute(elfcpp::DW_AT_external);
 
   // If this DIE has a DW_AT_specification or DW_AT_abstract_origin
   // attribute, use the parent and name from the earlier declaration.
@@ -703,6 +922,7 @@ Gdb_index_info_reader::add_declaration(Dwarf_die* die, Dwarf_die* context)
         {
 	  parent_offset = it->second.parent_offset_;
 	  name = it->second.name_;
+	  is_external = is_external || it->second.is_external_;
         }
     }
 
@@ -716,7 +936,7 @@ Gdb_index_info_reader::add_declaration(Dwarf_die* die, Dwarf_die* context)
         name = "(unknown)";
     }
 
-  Declaration_pair decl(parent_offset, name);
+  Declaration_pair decl(parent_offset, name, is_external);
   this->declarations_.insert(std::make_pair(die->offset(), decl));
 }
 
@@ -736,7 +956,7 @@ Gdb_index_info_reader::add_declaration_with_full_name(
   memcpy(copy, full_name, len + 1);
 
   // Flag that we now manage the memory this points to.
-  Declaration_pair decl(-1, copy);
+  Declaration_pair decl(-1, copy, false);
   this->declarations_.insert(std::make_pair(die->offset(), decl));
 }
 
@@ -810,6 +1030,80 @@ Gdb_index_info_reader::get_qualified_name(Dwarf_die* die, Dwarf_die* context)
   return full_name;
 }
 
+// Return whether DIE, or the declaration it completes, has the
+// DW_AT_external attribute.
+
+bool
+Gdb_index_info_reader::is_external(Dwarf_die* die)
+{
+  if (die->flag_attribute(elfcpp::DW_AT_external))
+    return true;
+
+  off_t spec = die->specification();
+  if (spec == 0)
+    spec = die->abstract_origin();
+  if (spec > 0)
+    {
+      Declaration_map::iterator it = this->declarations_.find(spec);
+      if (it != this->declarations_.end())
+	return it->second.is_external_;
+    }
+  return false;
+}
+
+// Return the symbol kind and static flag for the symbol defined by
+// DIE.  As in gdb, which puts each partial symbol in either the global
+// or the static block, functions and variables are global when they
+// are external, and types and enumerators are global only in C++.
+
+unsigned int
+Gdb_index_info_reader::symbol_attributes(Dwarf_die* die)
+{
+  bool is_cplus = (this->cu_language_ == elfcpp::DW_LANG_C_plus_plus
+		   || this->cu_language_ == elfcpp::DW_LANG_ObjC_plus_plus);
+  gdb_index_symbol_kind kind;
+  bool is_static;
+
+  switch (die->tag())
+    {
+      case elfcpp::DW_TAG_subprogram:
+	kind = GDB_INDEX_SYMBOL_KIND_FUNCTION;
+	is_static = !this->is_external(die);
+	break;
+      case elfcpp::DW_TAG_constant:
+      case elfcpp::DW_TAG_variable:
+	kind = GDB_INDEX_SYMBOL_KIND_VARIABLE;
+	is_static = !this->is_external(die);
+	break;
+      case elfcpp::DW_TAG_enumerator:
+	kind = GDB_INDEX_SYMBOL_KIND_VARIABLE;
+	is_static = !is_cplus;
+	break;
+      case elfcpp::DW_TAG_namespace:
+	kind = GDB_INDEX_SYMBOL_KIND_TYPE;
+	is_static = false;
+	break;
+      case elfcpp::DW_TAG_union_type:
+      case elfcpp::DW_TAG_class_type:
+      case elfcpp::DW_TAG_interface_type:
+      case elfcpp::DW_TAG_structure_type:
+      case elfcpp::DW_TAG_enumeration_type:
+	kind = GDB_INDEX_SYMBOL_KIND_TYPE;
+	is_static = !is_cplus;
+	break;
+      default:
+	// DW_TAG_base_type, DW_TAG_typedef and DW_TAG_subrange_type.
+	kind = GDB_INDEX_SYMBOL_KIND_TYPE;
+	is_static = true;
+	break;
+    }
+
+  unsigned int attributes = 0;
+  GDB_INDEX_SYMBOL_KIND_SET_VALUE(attributes, kind);
+  GDB_INDEX_SYMBOL_STATIC_SET_VALUE(attributes, is_static ? 1U : 0U);
+  return attributes;
+}
+
 // Record the address ranges for a compilation unit.
 
 void
@@ -823,8 +1117,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
     {
       Dwarf_range_list* ranges = this->read_range_list(shndx, ranges_offset);
       if (ranges != NULL)
-	this->gdb_index_->add_address_range_list(this->object(),
-						 this->cu_index_, ranges);
+	this->scan_->add_address_range_list(this->cu_index_, ranges);
       return;
     }
 
@@ -849,8 +1142,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
         {
 	  Dwarf_range_list* ranges = new Dwarf_range_list();
 	  ranges->add(shndx, low_pc, high_pc);
-	  this->gdb_index_->add_address_range_list(this->object(),
-						   this->cu_index_, ranges);
+	  this->scan_->add_address_range_list(this->cu_index_, ranges);
         }
     }
 }
@@ -870,11 +1162,16 @@ Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
     return false;
   while (true)
     {
-      const char* name = table->next_name();
+      // The flag byte of a GNU-style table holds the symbol kind and
+      // static flag, in the top byte of a CU vector entry.
+      uint8_t flag_byte;
+      const char* name = table->next_name(&flag_byte);
       if (name == NULL)
         break;
 
-      this->gdb_index_->add_symbol(this->cu_index_, name);
+      this->scan_->add_symbol(this->cu_index_, name,
+			      (static_cast<unsigned int>(flag_byte)
+			       << GDB_INDEX_CU_BITSIZE));
     }
   return true;
 }
@@ -898,29 +1195,19 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   unsigned int flag = die->uint_attribute(elfcpp::DW_AT_GNU_pubnames);
   if (offset == -1 && flag == 0)
     {
-      // Didn't find the attribute.
-      if (die->tag() == elfcpp::DW_TAG_type_unit)
-        {
-          // If die is a TU, then it might correspond to a CU which we
-          // have read. If it does, then no need to read the pubnames.
-          // If it doesn't, then the caller will have to parse the
-          // dies manually to find the names.
-          return this->gdb_index_->pubnames_read(this->object(),
-                                                 stmt_list_off);
-        }
-      else
-        {
-          // No attribute on the CU means that no pubnames were read.
-          return false;
-        }
+      // Didn't find the attribute.  The pubtypes set of the CU that
+      // uses a TU may list the types it defines, but the index must
+      // attribute those names to the TU itself, so the caller will
+      // have to parse the dies of a TU manually as well.
+      return false;
     }
 
   // We found the attribute, so we can check if the corresponding
   // pubnames have been read.
-  if (this->gdb_index_->pubnames_read(this->object(), stmt_list_off))
+  if (this->scan_->pubnames_read(stmt_list_off))
     return true;
 
-  this->gdb_index_->set_pubnames_read(this->object(), stmt_list_off);
+  this->scan_->set_pubnames_read(stmt_list_off);
 
   // We have an attribute, and the pubnames haven't been read, so read
   // them.
@@ -928,12 +1215,12 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   // In some of the cases, we could rely on the previous value of
   // offset here, but sorting out which cases complicates the logic
   // enough that it isn't worth it. So just look up the offset again.
-  offset = this->gdb_index_->find_pubname_offset(this->cu_offset());
-  names = this->read_pubtable(this->gdb_index_->pubnames_table(), offset);
+  offset = this->scan_->find_pubname_offset(this->cu_offset());
+  names = this->read_pubtable(this->scan_->pubnames_table(), offset);
 
   bool types = false;
-  offset = this->gdb_index_->find_pubtype_offset(this->cu_offset());
-  types = this->read_pubtable(this->gdb_index_->pubtypes_table(), offset);
+  offset = this->scan_->find_pubtype_offset(this->cu_offset());
+  types = this->read_pubtable(this->scan_->pubtypes_table(), offset);
   return names || types;
 }
 
@@ -953,67 +1240,48 @@ Gdb_index_info_reader::clear_declarations()
   this->declarations_.clear();
 }
 
-// Print usage statistics.
-void
-Gdb_index_info_reader::print_stats()
-{
-  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_count);
-  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_nopubnames_count);
-  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_count);
-  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_nopubnames_count);
-}
+// Class Gdb_index_scan.
 
-// Class Gdb_index.
-
-// Construct the .gdb_index section.
-
-Gdb_index::Gdb_index(Output_section* gdb_index_section)
-  : Output_section_data(4),
-    pubnames_table_(NULL),
-    pubtypes_table_(NULL),
-    gdb_index_section_(gdb_index_section),
-    comp_units_(),
-    type_units_(),
-    ranges_(),
-    cu_vector_list_(),
-    cu_vector_offsets_(NULL),
-    stringpool_(),
-    tu_offset_(0),
-    addr_offset_(0),
-    symtab_offset_(0),
-    cu_pool_offset_(0),
-    stringpool_offset_(0),
-    pubnames_object_(NULL),
-    stmt_list_offset_(-1)
+// Total number of DWARF compilation units processed.
+unsigned int Gdb_index_scan::dwarf_cu_count = 0;
+// Number of DWARF compilation units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_cu_nopubnames_count = 0;
+// Total number of DWARF type units processed.
+unsigned int Gdb_index_scan::dwarf_tu_count = 0;
+// Number of DWARF type units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_tu_nopubnames_count = 0;
+
+// The symbol table of the object is discarded after the object has
+// been laid out, so we keep a copy of it until the scan has run.
+
+Gdb_index_scan::Gdb_index_scan(Relobj* object,
+			       const unsigned char* symbols,
+			       off_t symbols_size)
+  : object_(object), symbols_(new unsigned char[symbols_size]),
+    symbols_size_(symbols_size), sections_(), is_scanned_(false),
+    comp_units_(), type_units_(), ranges_(), symbols_list_(), names_(),
+    cu_pubname_map_(), cu_pubtype_map_(), pubnames_table_(NULL),
+    pubtypes_table_(NULL), stmt_list_offset_(-1), cu_count_(0),
+    cu_nopubnames_count_(0), tu_count_(0), tu_nopubnames_count_(0)
 {
-  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+  memcpy(this->symbols_, symbols, symbols_size);
 }
 
-Gdb_index::~Gdb_index()
+Gdb_index_scan::~Gdb_index_scan()
 {
-  // Free the memory used by the symbol table.
-  delete this->gdb_symtab_;
-  // Free the memory used by the CU vectors.
-  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
-    delete this->cu_vector_list_[i];
+  delete[] this->symbols_;
+  delete this->pubnames_table_;
+  delete this->pubtypes_table_;
 }
 
-
 // Scan the pubnames and pubtypes sections and build a map of the
 // various cus and tus they refer to, so we can process the entries
 // when we encounter the die for that cu or tu.
 // Return the just-read table so it can be cached.
 
 Dwarf_pubnames_table*
-Gdb_index::map_pubtable_to_dies(unsigned int attr,
-                                Gdb_index_info_reader* dwinfo,
-                                Relobj* object,
-                                const unsigned char* symbols,
-                                off_t symbols_size)
+Gdb_index_scan::map_pubtable_to_dies(unsigned int attr,
+				     Gdb_index_info_reader* dwinfo)
 {
   uint64_t section_offset = 0;
   Dwarf_pubnames_table* table;
@@ -1031,8 +1299,12 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
     }
 
   map->clear();
-  if (!table->read_section(object, symbols, symbols_size))
-    return NULL;
+  if (!table->read_section(this->object_, this->symbols_,
+			   this->symbols_size_))
+    {
+      delete table;
+      return NULL;
+    }
 
   while (table->read_header(section_offset))
     {
@@ -1046,30 +1318,19 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
 // Wrapper for map_pubtable_to_dies
 
 void
-Gdb_index::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                          Relobj* object,
-                                          const unsigned char* symbols,
-                                          off_t symbols_size)
+Gdb_index_scan::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo)
 {
-  // This is a new object, so reset the relevant variables.
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = -1;
-
-  delete this->pubnames_table_;
   this->pubnames_table_
-      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo,
-                                   object, symbols, symbols_size);
-  delete this->pubtypes_table_;
+      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo);
   this->pubtypes_table_
-      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo,
-                                   object, symbols, symbols_size);
+      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo);
 }
 
 // Given a cu_offset, find the associated section of the pubnames
 // table.
 
 off_t
-Gdb_index::find_pubname_offset(off_t cu_offset)
+Gdb_index_scan::find_pubname_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubname_map_.find(cu_offset);
   if (it != this->cu_pubname_map_.end())
@@ -1081,7 +1342,7 @@ Gdb_index::find_pubname_offset(off_t cu_offset)
 // table.
 
 off_t
-Gdb_index::find_pubtype_offset(off_t cu_offset)
+Gdb_index_scan::find_pubtype_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubtype_map_.find(cu_offset);
   if (it != this->cu_pubtype_map_.end())
@@ -1089,7 +1350,199 @@ Gdb_index::find_pubtype_offset(off_t cu_offset)
   return -1;
 }
 
-// Scan a .debug_info or .debug_types input section.
+// Scan the .debug_info and .debug_types sections of the object.
+
+void
+Gdb_index_scan::scan()
+{
+  gold_assert(!this->is_scanned_ && !this->sections_.empty());
+
+  // The pubnames tables are shared by all the sections of the object,
+  // so they are read using a reader which lives as long as they do.
+  const Section& first = this->sections_.front();
+  Gdb_index_info_reader pubnames_reader(first.is_type_unit, this->object_,
+					this->symbols_, this->symbols_size_,
+					first.shndx, first.reloc_shndx,
+					first.reloc_type, this);
+  this->map_pubnames_and_types_to_dies(&pubnames_reader);
+
+  for (size_t i = 0; i < this->sections_.size(); ++i)
+    {
+      const Section& sec = this->sections_[i];
+      Gdb_index_info_reader dwinfo(sec.is_type_unit, this->object_,
+				   this->symbols_, this->symbols_size_,
+				   sec.shndx, sec.reloc_shndx,
+				   sec.reloc_type, this);
+      dwinfo.parse();
+    }
+
+  // We no longer need the symbols or the pubnames tables.
+  delete this->pubnames_table_;
+  this->pubnames_table_ = NULL;
+  delete this->pubtypes_table_;
+  this->pubtypes_table_ = NULL;
+  this->cu_pubname_map_.clear();
+  this->cu_pubtype_map_.clear();
+  delete[] this->symbols_;
+  this->symbols_ = NULL;
+
+  this->is_scanned_ = true;
+}
+
+// Add the results of the scan to GDB_INDEX.  The CUs and TUs of this
+// object follow those of the objects already added, so we translate
+// the indexes as we go.
+
+void
+Gdb_index_scan::add_to_index(Gdb_index* gdb_index)
+{
+  gold_assert(this->is_scanned_);
+
+  int cu_base = 0;
+  for (size_t i = 0; i < this->comp_units_.size(); ++i)
+    cu_base = (gdb_index->add_comp_unit(this->comp_units_[i].first,
+					this->comp_units_[i].second)
+	       - static_cast<int>(i));
+
+  int tu_base = 0;
+  for (size_t i = 0; i < this->type_units_.size(); ++i)
+    {
+      const Type_unit& tu = this->type_units_[i];
+      tu_base = (gdb_index->add_type_unit(tu.tu_offset, tu.type_offset,
+					  tu.type_signature)
+		 - static_cast<int>(i));
+    }
+
+  for (size_t i = 0; i < this->ranges_.size(); ++i)
+    {
+      int cu_index = this->ranges_[i].first;
+      gold_assert(cu_index >= 0);
+      gdb_index->add_address_range_list(this->object_, cu_base + cu_index,
+					this->ranges_[i].second);
+    }
+
+  for (size_t i = 0; i < this->symbols_list_.size(); ++i)
+    {
+      const Symbol& sym = this->symbols_list_[i];
+      int cu_index = sym.cu_index;
+      if (cu_index >= 0)
+	cu_index += cu_base;
+      else
+	cu_index = -1 - (tu_base + (-1 - cu_index));
+      gdb_index->add_symbol(cu_index, this->names_.data() + sym.name_offset,
+			    sym.attributes);
+    }
+
+  Gdb_index_scan::dwarf_cu_count += this->cu_count_;
+  Gdb_index_scan::dwarf_cu_nopubnames_count += this->cu_nopubnames_count_;
+  Gdb_index_scan::dwarf_tu_count += this->tu_count_;
+  Gdb_index_scan::dwarf_tu_nopubnames_count += this->tu_nopubnames_count_;
+
+  // The range lists now belong to GDB_INDEX.
+  this->comp_units_.clear();
+  this->type_units_.clear();
+  this->ranges_.clear();
+  this->symbols_list_.clear();
+  this->names_.clear();
+}
+
+// Print usage statistics.
+void
+Gdb_index_scan::print_stats()
+{
+  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_count);
+  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_nopubnames_count);
+  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_count);
+  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_nopubnames_count);
+}
+
+// A task to scan the debug info of one object for the .gdb_index
+// section.  It is queued once the object has been laid out, and
+// holds BLOCKER until it has run.
+
+class Gdb_index_scan_task : public Task
+{
+ public:
+  Gdb_index_scan_task(Gdb_index_scan* scan, Task_token* blocker)
+    : scan_(scan), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    Relobj* object = this->scan_->object();
+    return object->is_locked() ? object->token() : NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->scan_->object()->token());
+    tl->add(this, this->blocker_);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->scan_->scan();
+    this->scan_->object()->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_scan_task " + this->scan_->object()->name(); }
+
+ private:
+  Gdb_index_scan* scan_;
+  Task_token* blocker_;
+};
+
+// Class Gdb_index.
+
+// Construct the .gdb_index section.
+
+Gdb_index::Gdb_index(Output_section* gdb_index_section)
+  : Output_section_data(4),
+    gdb_index_section_(gdb_index_section),
+    comp_units_(),
+    type_units_(),
+    ranges_(),
+    cu_vector_list_(),
+    cu_vector_offsets_(NULL),
+    stringpool_(),
+    tu_offset_(0),
+    addr_offset_(0),
+    symtab_offset_(0),
+    cu_pool_offset_(0),
+    stringpool_offset_(0),
+    scans_(),
+    scans_queued_(0),
+    scan_blocker_(new Task_token(true))
+{
+  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+}
+
+Gdb_index::~Gdb_index()
+{
+  // Free the memory used by the symbol table.
+  delete this->gdb_symtab_;
+  // Free the memory used by the CU vectors.
+  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
+    delete this->cu_vector_list_[i];
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    delete this->scans_[i];
+  delete this->scan_blocker_;
+}
+
+// Record a .debug_info or .debug_types input section to be scanned.
+// All the sections of an object are recorded together, as the object
+// is laid out, and are scanned by a single task.
 
 void
 Gdb_index::scan_debug_info(bool is_type_unit,
@@ -1100,19 +1553,60 @@ Gdb_index::scan_debug_info(bool is_type_unit,
 			   unsigned int reloc_shndx,
 			   unsigned int reloc_type)
 {
-  Gdb_index_info_reader dwinfo(is_type_unit, object,
-			       symbols, symbols_size,
-			       shndx, reloc_shndx,
-			       reloc_type, this);
-  if (object != this->pubnames_object_)
-    map_pubnames_and_types_to_dies(&dwinfo, object, symbols, symbols_size);
-  dwinfo.parse();
+  if (this->scans_.size() == this->scans_queued_
+      || this->scans_.back()->object() != object)
+    this->scans_.push_back(new Gdb_index_scan(object, symbols, symbols_size));
+  this->scans_.back()->add_section(is_type_unit, shndx, reloc_shndx,
+				   reloc_type);
+}
+
+// Queue a task to scan the sections of each object recorded since the
+// last call.
+
+void
+Gdb_index::queue_scan_tasks(Workqueue* workqueue)
+{
+  gold_assert(this->scan_blocker_ != NULL);
+  for (; this->scans_queued_ < this->scans_.size(); ++this->scans_queued_)
+    {
+      workqueue->add_blocker(this->scan_blocker_);
+      workqueue->queue(new Gdb_index_scan_task(this->scans_[this->scans_queued_],
+					       this->scan_blocker_));
+    }
+}
+
+// Return the blocker held by the scan tasks, and give up ownership of
+// it.
+
+Task_token*
+Gdb_index::release_scan_blocker()
+{
+  Task_token* blocker = this->scan_blocker_;
+  this->scan_blocker_ = NULL;
+  return blocker;
+}
+
+// Add the results of the scans to the index.  We do this in input
+// order, so that the index is the same as if the objects had been
+// scanned one after the other.
+
+void
+Gdb_index::add_scans()
+{
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    {
+      this->scans_[i]->add_to_index(this);
+      delete this->scans_[i];
+    }
+  this->scans_.clear();
+  this->scans_queued_ = 0;
 }
 
 // Add a symbol.
 
 void
-Gdb_index::add_symbol(int cu_index, const char* sym_name)
+Gdb_index::add_symbol(int cu_index, const char* sym_name,
+		      unsigned int attributes)
 {
   unsigned int hash = mapped_index_string_hash(
       reinterpret_cast<const unsigned char*>(sym_name));
@@ -1135,33 +1629,13 @@ Gdb_index::add_symbol(int cu_index, const char* sym_name)
       delete sym;
     }
 
-  // Add the CU index to the vector list for this symbol,
-  // if it's not already on the list.  We only need to
+  // Add the CU index and attributes to the vector list for this
+  // symbol, if they're not already on the list.  We only need to
   // check the last added entry.
   Cu_vector* cu_vec = this->cu_vector_list_[found->cu_vector_index];
-  if (cu_vec->size() == 0 || cu_vec->back() != cu_index)
-    cu_vec->push_back(cu_index);
-}
-
-// Return TRUE if we have already processed the pubnames associated
-// with the statement list at the given OFFSET.
-
-bool
-Gdb_index::pubnames_read(const Relobj* object, off_t offset)
-{
-  bool ret = (this->pubnames_object_ == object
-	      && this->stmt_list_offset_ == offset);
-  return ret;
-}
-
-// Record that we have processed the pubnames associated with the
-// statement list for OBJECT at the given OFFSET.
-
-void
-Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
-{
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = offset;
+  std::pair<int, unsigned int> entry(cu_index, attributes);
+  if (cu_vec->size() == 0 || cu_vec->back() != entry)
+    cu_vec->push_back(entry);
 }
 
 // Set the size of the .gdb_index section.
@@ -1169,6 +1643,9 @@ Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
 void
 Gdb_index::set_final_data_size()
 {
+  // All the scan tasks have run by now.
+  this->add_scans();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
@@ -1317,10 +1794,11 @@ Gdb_index::do_write(Output_file* of)
       pov += 4;
       for (unsigned int j = 0; j < cu_vec->size(); ++j)
 	{
-	  int cu_index = (*cu_vec)[j];
+	  int cu_index = (*cu_vec)[j].first;
 	  if (cu_index < 0)
 	    cu_index = comp_units_count + (-1 - cu_index);
-	  elfcpp::Swap<32, false>::writeval(pov, cu_index);
+	  elfcpp::Swap<32, false>::writeval(pov, (cu_index
+						  | (*cu_vec)[j].second));
 	  pov += 4;
 	}
     }
@@ -1338,7 +1816,7 @@ void
 Gdb_index::print_stats()
 {
   if (parameters->options().gdb_index())
-    Gdb_index_info_reader::print_stats();
+    Gdb_index_scan::print_stats();
 }
 
 } // End namespace gold.
@@ -42,13 +42,20 @@ class Sized_relobj;
 class Dwarf_range_list;
 template <typename T>
 class Gdb_hashtab;
-class Gdb_index_info_reader;
-class Dwarf_pubnames_table;
+class Gdb_index_scan;
+class Task_token;
+class Workqueue;
 
 // This class manages the .gdb_index section, which is a fast
 // lookup table for DWARF information used by the gdb debugger.
 // The format of this section is described in gdb/doc/gdb.texinfo.
 
+// The .debug_info and .debug_types sections of each input object are
+// scanned by a separate task, which may run as soon as the object has
+// been laid out.  The results are added to the index in input order
+// when the section size is set, so that the index does not depend on
+// the order in which the tasks ran.
+
 class Gdb_index : public Output_section_data
 {
  public:
@@ -56,7 +63,7 @@ class Gdb_index : public Output_section_data
 
   ~Gdb_index();
 
-  // Scan a .debug_info or .debug_types input section.
+  // Record a .debug_info or .debug_types input section to be scanned.
   void scan_debug_info(bool is_type_unit,
 		       Relobj* object,
 		       const unsigned char* symbols,
@@ -65,6 +72,17 @@ class Gdb_index : public Output_section_data
 		       unsigned int reloc_shndx,
 		       unsigned int reloc_type);
 
+  // Queue a task to scan the sections of each object recorded since
+  // the last call.
+  void
+  queue_scan_tasks(Workqueue*);
+
+  // Return a blocker which is unblocked when all the queued scan
+  // tasks have run.  The caller takes ownership of the blocker, and
+  // no more tasks may be queued after this is called.
+  Task_token*
+  release_scan_blocker();
+
   // Add a compilation unit.
   int
   add_comp_unit(off_t cu_offset, off_t cu_length)
@@ -89,39 +107,10 @@ class Gdb_index : public Output_section_data
     this->ranges_.push_back(Per_cu_range_list(object, cu_index, ranges));
   }
 
-  // Add a symbol.
+  // Add a symbol.  ATTRIBUTES holds the symbol kind and static flag,
+  // in the bits of a CU vector entry above the CU index.
   void
-  add_symbol(int cu_index, const char* sym_name);
-
-  // Return the offset into the pubnames table for the cu at the given
-  // offset.
-  off_t
-  find_pubname_offset(off_t cu_offset);
-
-  // Return the offset into the pubtypes table for the cu at the
-  // given offset.
-  off_t
-  find_pubtype_offset(off_t cu_offset);
-
-  // Return TRUE if we have already processed the pubnames and types
-  // set for OBJECT of the CUs and TUS associated with the statement
-  // list at OFFSET.
-  bool
-  pubnames_read(const Relobj* object, off_t offset);
-
-  // Record that we have already read the pubnames associated with
-  // OBJECT and OFFSET.
-  void
-  set_pubnames_read(const Relobj* object, off_t offset);
-
-  // Return a pointer to the given table.
-  Dwarf_pubnames_table*
-  pubnames_table()
-  { return pubnames_table_; }
-
-  Dwarf_pubnames_table*
-  pubtypes_table()
-  { return pubtypes_table_; }
+  add_symbol(int cu_index, const char* sym_name, unsigned int attributes);
 
   // Print usage statistics.
   static void
@@ -147,22 +136,11 @@ class Gdb_index : public Output_section_data
   do_print_to_mapfile(Mapfile* mapfile) const
   { mapfile->print_output_data(this, _("** gdb_index")); }
 
-  // Create a map from dies to pubnames.
-  Dwarf_pubnames_table*
-  map_pubtable_to_dies(unsigned int attr,
-                       Gdb_index_info_reader* dwinfo,
-                       Relobj* object,
-                       const unsigned char* symbols,
-                       off_t symbols_size);
-
-  // Wrapper for map_pubtable_to_dies
+ private:
+  // Add the results of the scan tasks to the index, in input order.
   void
-  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                 Relobj* object,
-                                 const unsigned char* symbols,
-                                 off_t symbols_size);
+  add_scans();
 
- private:
   // An entry in the compilation unit list.
   struct Comp_unit
   {
@@ -213,22 +191,9 @@ class Gdb_index : public Output_section_data
     { return this->name_key == symbol->name_key; }
   };
 
-  typedef std::vector<int> Cu_vector;
-
-  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
-  Pubname_offset_map cu_pubname_map_;
-  Pubname_offset_map cu_pubtype_map_;
-
-  // Scan the given pubtable and build a map of the various dies it
-  // refers to, so we can process the entries when we encounter the
-  // die.
-  void
-  map_pubtable_to_dies(Dwarf_pubnames_table* table,
-                       Pubname_offset_map* map);
-
-  // Tables to store the pubnames section of the current object.
-  Dwarf_pubnames_table* pubnames_table_;
-  Dwarf_pubnames_table* pubtypes_table_;
+  // A CU vector holds a (CU index, attributes) pair for each CU or TU
+  // which defines a symbol.
+  typedef std::vector<std::pair<int, unsigned int> > Cu_vector;
 
   // The .gdb_index section.
   Output_section* gdb_index_section_;
@@ -252,10 +217,12 @@ class Gdb_index : public Output_section_data
   off_t symtab_offset_;
   off_t cu_pool_offset_;
   off_t stringpool_offset_;
-  // Object, stmt list offset of the CUs and TUs associated with the
-  // last read pubnames and pubtypes sections.
-  const Relobj* pubnames_object_;
-  off_t stmt_list_offset_;
+  // The scans of the input objects, in input order.
+  std::vector<Gdb_index_scan*> scans_;
+  // The number of scans for which a task has been queued.
+  size_t scans_queued_;
+  // The blocker held by the scan tasks.
+  Task_token* scan_blocker_;
 };
 
 } // End namespace gold.
@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include <cstring>
+#include <unistd.h>
 
 #ifdef ENABLE_THREADS
 #include <pthread.h>
@@ -447,4 +448,149 @@ Initialize_lock::do_run_once(void*)
   *this->pplock_ = new Lock();
 }
 
+// Functions for Parallel_job.
+
+// The state shared by the threads running a Parallel_job.
+
+struct Parallel_job_state
+{
+  Parallel_job_state(Parallel_job* j, unsigned int c)
+    : job(j), count(c), next(0), lock()
+  { }
+
+  // Run pieces until there are none left.
+  void
+  run_pieces();
+
+  // The job being run.
+  Parallel_job* job;
+  // The number of pieces.
+  unsigned int count;
+  // The next piece to run.
+  unsigned int next;
+  // Controls access to NEXT.
+  Lock lock;
+};
+
+void
+Parallel_job_state::run_pieces()
+{
+  while (true)
+    {
+      unsigned int i;
+      {
+	Hold_lock hl(this->lock);
+	if (this->next >= this->count)
+	  return;
+	i = this->next;
+	++this->next;
+      }
+      this->job->run_piece(i);
+    }
+}
+
+#ifdef ENABLE_THREADS
+
+// Passed to pthread_create.
+
+extern "C"
+{
+
+static void*
+parallel_job_thread(void* arg)
+{
+  static_cast<Parallel_job_state*>(arg)->run_pieces();
+  return NULL;
+}
+
+}
+
+#endif // defined(ENABLE_THREADS)
+
+// The pool of threads which helps run Parallel_jobs, if any.
+
+static Parallel_job_runner* parallel_job_runner;
+
+// Set the pool of threads which helps run Parallel_jobs.
+
+void
+set_parallel_job_runner(Parallel_job_runner* runner)
+{
+  parallel_job_runner = runner;
+}
+
+// Run pieces of the job in STATE on behalf of a Parallel_job_runner.
+
+void
+run_parallel_job_pieces(Parallel_job_state* state)
+{
+  state->run_pieces();
+}
+
+// Return the number of threads to use for a Parallel_job.
+
+unsigned int
+parallel_thread_count()
+{
+  if (!parameters->options_valid() || !parameters->options().threads())
+    return 1;
+  unsigned int count = parameters->options().thread_count();
+  if (count == 0)
+    {
+      long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+      count = cpus > 0 ? cpus : 1;
+    }
+  return count;
+}
+
+// Run the pieces of JOB.
+
+void
+run_in_parallel(Parallel_job* job, unsigned int count)
+{
+  unsigned int thread_count = std::min(parallel_thread_count(), count);
+  if (thread_count <= 1)
+    {
+      for (unsigned int i = 0; i < count; ++i)
+	job->run_piece(i);
+      return;
+    }
+
+#ifdef ENABLE_THREADS
+  Parallel_job_state state(job, count);
+
+  // If the workqueue threads are running, let the idle ones help
+  // rather than starting more threads.  The calling thread runs
+  // pieces too, so the job finishes even if no thread is idle.
+  if (parallel_job_runner != NULL)
+    {
+      parallel_job_runner->offer_parallel_job(&state);
+      state.run_pieces();
+      parallel_job_runner->withdraw_parallel_job(&state);
+      return;
+    }
+
+  // The calling thread is one of the threads.
+  std::vector<pthread_t> threads(thread_count - 1);
+  for (unsigned int i = 0; i < threads.size(); ++i)
+    {
+      int err = pthread_create(&threads[i], NULL, parallel_job_thread,
+			       static_cast<void*>(&state));
+      if (err != 0)
+	gold_fatal(_("pthread_create failed: %s"), strerror(err));
+    }
+
+  state.run_pieces();
+
+  for (unsigned int i = 0; i < threads.size(); ++i)
+    {
+      int err = pthread_join(threads[i], NULL);
+      if (err != 0)
+	gold_fatal(_("pthread_join failed: %s"), strerror(err));
+    }
+#else
+  gold_unreachable();
+#endif
+}
+
 } // End namespace gold.
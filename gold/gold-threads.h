@@ -31,6 +31,9 @@
 #ifndef GOLD_THREADS_H
 #define GOLD_THREADS_H
 
+#include <algorithm>
+#include <vector>
+
 namespace gold
 {
 
@@ -262,6 +265,156 @@ class Initialize_lock : public Once
   Lock** const pplock_;
 };
 
+// An interface for a job which can be split into a number of
+// independent pieces.  This is used for work done inside a single
+// Task which is large enough to be worth spreading over several
+// threads, such as sorting a big vector.  Work which can be expressed
+// as separate Tasks should use the Workqueue instead.
+
+class Parallel_job
+{
+ public:
+  virtual
+  ~Parallel_job()
+  { }
+
+  // Run piece number I of the job.  This may be called on any
+  // thread, so it must not touch state shared with the other pieces
+  // without locking it.
+  virtual void
+  run_piece(unsigned int i) = 0;
+};
+
+// Return the number of threads which run_in_parallel will use.  This
+// is 1 unless we are running with --threads.
+
+extern unsigned int
+parallel_thread_count();
+
+// Run pieces 0 through COUNT - 1 of JOB, and return when they have
+// all completed.  The calling thread runs pieces too.  When we are
+// not running with --threads, the pieces are simply run in order.
+
+extern void
+run_in_parallel(Parallel_job* job, unsigned int count);
+
+// The state of a call to run_in_parallel.  This is only defined in
+// gold-threads.cc.
+
+struct Parallel_job_state;
+
+// An interface for a pool of threads which can help run the pieces of
+// a Parallel_job.  When one has been registered, run_in_parallel uses
+// its idle threads rather than starting new ones, so that we do not
+// run more threads than were asked for.
+
+class Parallel_job_runner
+{
+ public:
+  virtual
+  ~Parallel_job_runner()
+  { }
+
+  // Let idle threads run pieces of STATE, by calling
+  // run_parallel_job_pieces.
+  virtual void
+  offer_parallel_job(Parallel_job_state* state) = 0;
+
+  // Stop offering STATE to idle threads, and wait until no thread is
+  // running a piece of it.
+  virtual void
+  withdraw_parallel_job(Parallel_job_state* state) = 0;
+};
+
+// Set the pool of threads used by run_in_parallel.  RUNNER may be
+// NULL, in which case run_in_parallel starts its own threads.
+
+extern void
+set_parallel_job_runner(Parallel_job_runner* runner);
+
+// Run pieces of the job in STATE until there are none left to start.
+// This is called by the threads of a Parallel_job_runner.
+
+extern void
+run_parallel_job_pieces(Parallel_job_state* state);
+
+// The job used by parallel_sort.
+
+template<typename Iterator, typename Compare>
+class Parallel_sort_job : public Parallel_job
+{
+ public:
+  // Each piece sorts, or merges, the elements in one group of
+  // adjacent runs.  BOUNDS holds the start of each run, followed by
+  // LAST.  WIDTH is the number of runs in each group; if it is 1 the
+  // runs are sorted, otherwise two groups of WIDTH / 2 runs are
+  // merged.
+  Parallel_sort_job(Iterator first, const std::vector<size_t>& bounds,
+		    unsigned int width, Compare comp)
+    : first_(first), bounds_(bounds), width_(width), comp_(comp)
+  { }
+
+  void
+  run_piece(unsigned int i)
+  {
+    unsigned int runs = this->bounds_.size() - 1;
+    unsigned int begin = i * this->width_;
+    unsigned int end = std::min(begin + this->width_, runs);
+    if (this->width_ == 1)
+      std::sort(this->first_ + this->bounds_[begin],
+		this->first_ + this->bounds_[end], this->comp_);
+    else
+      {
+	unsigned int middle = begin + this->width_ / 2;
+	if (middle < end)
+	  std::inplace_merge(this->first_ + this->bounds_[begin],
+			     this->first_ + this->bounds_[middle],
+			     this->first_ + this->bounds_[end], this->comp_);
+      }
+  }
+
+ private:
+  Iterator first_;
+  const std::vector<size_t>& bounds_;
+  unsigned int width_;
+  Compare comp_;
+};
+
+// Sort the elements between FIRST and LAST using COMP.  The range is
+// split into runs which are sorted in parallel and then merged.  The
+// result is the same as std::sort as long as no two elements compare
+// equal.
+
+template<typename Iterator, typename Compare>
+void
+parallel_sort(Iterator first, Iterator last, Compare comp)
+{
+  // Below this size it is not worth starting threads.
+  const size_t min_run_size = 16384;
+
+  size_t size = last - first;
+  unsigned int runs = parallel_thread_count();
+  if (size / min_run_size < runs)
+    runs = size / min_run_size;
+  if (runs <= 1)
+    {
+      std::sort(first, last, comp);
+      return;
+    }
+
+  std::vector<size_t> bounds;
+  bounds.reserve(runs + 1);
+  for (unsigned int i = 0; i < runs; ++i)
+    bounds.push_back(size / runs * i);
+  bounds.push_back(size);
+
+  for (unsigned int width = 1; width / 2 < runs; width *= 2)
+    {
+      Parallel_sort_job<Iterator, Compare> job(first, bounds, width, comp);
+      run_in_parallel(&job, (runs + width - 1) / width);
+    }
+}
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_THREADS_H)
@@ -36,6 +36,7 @@
 #include "workqueue.h"
 #include "dirsearch.h"
 #include "readsyms.h"
+#include "archive.h"
 #include "symtab.h"
 #include "common.h"
 #include "object.h"
@@ -45,6 +46,7 @@
 #include "plugin.h"
 #include "gc.h"
 #include "icf.h"
+#include "call-graph.h"
 #include "incremental.h"
 #include "timer.h"
 
@@ -60,6 +62,11 @@ process_incremental_input(Incremental_binary*, unsigned int, Input_objects*,
 			  Symbol_table*, Layout*, Dirsearch*, Mapfile*,
 			  Task_token*, Task_token*);
 
+static void
+queue_middle_layout_tasks(const General_options&, const Task*,
+			  const Input_objects*, Symbol_table*, Layout*,
+			  Workqueue*, Mapfile*);
+
 void
 gold_exit(Exit_status status)
 {
@@ -135,6 +142,64 @@ Middle_runner::run(Workqueue* workqueue, const Task* task)
 		     this->layout_, workqueue, this->mapfile_);
 }
 
+// This class arranges to run the rest of the middle of the link after
+// identical code folding has run.
+
+class Middle_layout_runner : public Task_function_runner
+{
+ public:
+  Middle_layout_runner(const General_options& options,
+		       const Input_objects* input_objects,
+		       Symbol_table* symtab,
+		       Layout* layout, Mapfile* mapfile)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+};
+
+void
+Middle_layout_runner::run(Workqueue* workqueue, const Task* task)
+{
+  queue_middle_layout_tasks(this->options_, task, this->input_objects_,
+			    this->symtab_, this->layout_, workqueue,
+			    this->mapfile_);
+}
+
+// This class queues the layout task to wait for the tasks which scan
+// the debug info for the .gdb_index section, once the tasks which
+// read the relocs have run.  It is just a closure.
+
+class Gdb_index_wait_runner : public Task_function_runner
+{
+ public:
+  Gdb_index_wait_runner(Task_function_runner* layout_runner,
+			Task_token* gdb_index_blocker)
+    : layout_runner_(layout_runner), gdb_index_blocker_(gdb_index_blocker)
+  { }
+
+  void
+  run(Workqueue* workqueue, const Task*)
+  {
+    workqueue->queue(new Task_function(this->layout_runner_,
+				       this->gdb_index_blocker_,
+				       "Task_function Layout_task_runner"));
+  }
+
+ private:
+  Task_function_runner* layout_runner_;
+  Task_token* gdb_index_blocker_;
+};
+
 // This class arranges the tasks to process the relocs for garbage collection.
 
 class Gc_runner : public Task_function_runner
@@ -215,6 +280,16 @@ queue_initial_tasks(const General_options& options,
 	      of->close();
 	    }
 	}
+
+      // A child of the --incremental-server gets this far before the
+      // request for its link arrives.  The script files were checked
+      // before then, so check them again.
+      if (options.user_set_incremental_server()
+	  && incremental_server_start_link(mapfile)
+	  && ibase != NULL
+	  && !ibase->check_inputs(cmdline, layout->incremental_inputs()))
+	incremental_server_restart();
+
       if (ibase == NULL)
 	{
 	  if (set_parameters_incremental_full())
@@ -224,6 +299,9 @@ queue_initial_tasks(const General_options& options,
 	}
     }
 
+  if (options.user_set_input_cache())
+    Input_cache::initialize();
+
   // Read the input files.  We have to add the symbols to the symbol
   // table in order.  We do this by creating a separate blocker for
   // each input file.  We associate the blocker with the following
@@ -520,12 +598,40 @@ queue_middle_tasks(const General_options& options,
 
   // If identical code folding (--icf) is chosen it makes sense to do it
   // only after garbage collection (--gc-sections) as we do not want to
-  // be folding sections that will be garbage.
+  // be folding sections that will be garbage.  ICF hashes the sections
+  // in separate tasks, so the rest of the middle of the link runs once
+  // those have finished.
   if (parameters->options().icf_enabled())
     {
-      symtab->icf()->find_identical_sections(input_objects, symtab);
-    }
+      Task_token* icf_blocker =
+	symtab->icf()->find_identical_sections(input_objects, symtab,
+					       workqueue);
+      workqueue->queue(new Task_function(new Middle_layout_runner(options,
+								  input_objects,
+								  symtab,
+								  layout,
+								  mapfile),
+					 icf_blocker,
+					 "Task_function Middle_layout_runner"));
+      return;
+    }
+
+  queue_middle_layout_tasks(options, task, input_objects, symtab, layout,
+			    workqueue, mapfile);
+}
+
+// Queue up the rest of the middle set of tasks, after garbage
+// collection and identical code folding.
 
+static void
+queue_middle_layout_tasks(const General_options& options,
+			  const Task* task,
+			  const Input_objects* input_objects,
+			  Symbol_table* symtab,
+			  Layout* layout,
+			  Workqueue* workqueue,
+			  Mapfile* mapfile)
+{
   // Call Object::layout for the second time to determine the
   // output_sections for all referenced input sections.  When
   // --gc-sections or --icf is turned on, or when certain input
@@ -553,6 +659,9 @@ queue_middle_tasks(const General_options& options,
       plugins->layout_deferred_objects();
     }
 
+  // Scan the debug info of any objects laid out above.
+  layout->queue_gdb_index_tasks(workqueue);
+
   /* If plugins have specified a section order, re-arrange input sections
      according to a specified section order.  If --section-ordering-file is
      also specified, do not do anything here.  */
@@ -567,6 +676,18 @@ queue_middle_tasks(const General_options& options,
 	(*p)->update_section_layout(layout->get_section_order_map());
     }
 
+  // Order the functions named in the call graph profile.
+  if (parameters->options().call_graph_profile())
+    {
+      Call_graph_sort call_graph_sort;
+      call_graph_sort.read_profile(parameters->options().call_graph_profile(),
+				   task, symtab);
+      call_graph_sort.compute_order();
+      call_graph_sort.apply_order(layout);
+      if (parameters->options().print_order())
+	call_graph_sort.print_order();
+    }
+
   if (parameters->options().gc_sections()
       || parameters->options().icf_enabled())
     {
@@ -770,15 +891,25 @@ queue_middle_tasks(const General_options& options,
     }
 
   // When all those tasks are complete, we can start laying out the
-  // output file.
-  workqueue->queue(new Task_function(new Layout_task_runner(options,
-							    input_objects,
-							    symtab,
-							    target,
-							    layout,
-							    mapfile),
-				     this_blocker,
-				     "Task_function Layout_task_runner"));
+  // output file.  The layout task sets the size of the .gdb_index
+  // section, so it must also wait for the tasks which scan the debug
+  // info.
+  Task_function_runner* layout_runner = new Layout_task_runner(options,
+							       input_objects,
+							       symtab,
+							       target,
+							       layout,
+							       mapfile);
+  Task_token* gdb_index_blocker = layout->release_gdb_index_blocker();
+  if (gdb_index_blocker == NULL)
+    workqueue->queue(new Task_function(layout_runner, this_blocker,
+				       "Task_function Layout_task_runner"));
+  else
+    workqueue->queue(new Task_function(
+			 new Gdb_index_wait_runner(layout_runner,
+						   gdb_index_blocker),
+			 this_blocker,
+			 "Task_function Gdb_index_wait_runner"));
 }
 
 // Queue up the final set of tasks.  This is called at the end of
@@ -130,6 +130,18 @@
 // folded causing unpredictable run-time behaviour if the pointers were used
 // in comparisons.
 //
+// Parallel hashing :
+// ----------------
+//
+// The text of each candidate section, and its relocs to sections that
+// cannot be folded, do not change from one iteration to the next.  They
+// are gathered and checksummed once, by one task per input object, so
+// this work is spread over the workqueue threads.  The iterations then
+// only extend those checksums over the relocs to foldable sections.
+// That is done serially, in section order, because a section's relocs
+// refer to the kept sections chosen earlier in the same iteration; this
+// keeps the folding identical to a single-threaded link.
+//
 //
 //
 // How to run  : --icf=[safe|all|none]
@@ -142,6 +154,7 @@
 #include "object.h"
 #include "gc.h"
 #include "icf.h"
+#include "workqueue.h"
 #include "symtab.h"
 #include "libiberty.h"
 #include "demangle.h"
@@ -155,52 +168,28 @@ namespace gold
 // sections has unique contents.  Such unique sections or groups can be
 // declared final and need not be processed any further.
 // Parameters :
-// ID_SECTION : Vector mapping a section index to a Section_id pair.
+// SECTION_CKSUM : Vector mapping a section index to the checksum of
+//                 the section's contents.  Before the first iteration
+//                 of icf this is the checksum of the raw section
+//                 contents, afterwards it is the checksum of the text
+//                 and relocs to sections that cannot be folded.
 // IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
 //                            sections is already known to be unique.
-// SECTION_CONTENTS : Contains the section's text and relocs to sections
-//                    that cannot be folded.   SECTION_CONTENTS are NULL
-//                    implies that this function is being called for the
-//                    first time before the first iteration of icf.
 
 static void
-preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
-                               std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+preprocess_for_unique_sections(const std::vector<uint32_t>& section_cksum,
+                               std::vector<bool>* is_secn_or_group_unique)
 {
   Unordered_map<uint32_t, unsigned int> uniq_map;
   std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < section_cksum.size(); i++)
     {
       if ((*is_secn_or_group_unique)[i])
         continue;
 
-      uint32_t cksum;
-      Section_id secn = id_section[i];
-      section_size_type plen;
-      if (section_contents == NULL)
-        {
-          // Lock the object so we can read from it.  This is only called
-          // single-threaded from queue_middle_tasks, so it is OK to lock.
-          // Unfortunately we have no way to pass in a Task token.
-          const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-          Task_lock_obj<Object> tl(dummy_task, secn.first);
-          const unsigned char* contents;
-          contents = secn.first->section_contents(secn.second,
-                                                  &plen,
-                                                  false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
-        }
-      else
-        {
-          const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
-                         0xffffffff);
-        }
-      uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
+      uniq_map_insert = uniq_map.insert(std::make_pair(section_cksum[i], i));
       if (uniq_map_insert.second)
         {
           (*is_secn_or_group_unique)[i] = true;
@@ -213,43 +202,53 @@ preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
     }
 }
 
-// This returns the buffer containing the section's contents, both
-// text and relocs.  Relocs are differentiated as those pointing to
-// sections that could be folded and those that cannot.  Only relocs
-// pointing to sections that could be folded are recomputed on
-// subsequent invocations of this function.
+// This computes the section's contents, both text and relocs.  Relocs
+// are differentiated as those pointing to sections that could be
+// folded and those that cannot.  The text and the relocs pointing to
+// sections that cannot be folded do not change between iterations, so
+// they are computed once, by the hashing tasks, and stored in
+// STATIC_CONTENTS.  Relocs pointing to sections that could be folded
+// are recomputed on every iteration and stored in ICF_RELOC_CONTENTS.
+// The full contents of the section are STATIC_CONTENTS followed by
+// ICF_RELOC_CONTENTS.
 // Parameters  :
 // FIRST_ITERATION    : true if it is the first invocation.
 // SECN               : Section for which contents are desired.
-// SECTION_NUM        : Unique section number of this section.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
+// NUM_TRACKED_RELOCS : Pointer to store the number of relocs to ICF
 //                      sections.
+// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
+//                      Only needed if ICF_RELOC_CONTENTS is not NULL.
+// LOCK               : Lock to hold while reading from input objects.
+// STATIC_CONTENTS    : If not NULL, store the section's text and relocs
+//                      to non-ICF sections.  FIRST_ITERATION must be
+//                      true, and the object of SECN must be locked by
+//                      the calling task.
+// ICF_RELOC_CONTENTS : If not NULL, store the relocs to ICF sections.
 
-static std::string
+static void
 get_section_contents(bool first_iteration,
                      const Section_id& secn,
-                     unsigned int section_num,
                      unsigned int* num_tracked_relocs,
                      Symbol_table* symtab,
-                     const std::vector<unsigned int>& kept_section_id,
-                     std::vector<std::string>* section_contents)
+                     const std::vector<unsigned int>* kept_section_id,
+                     Lock* lock,
+                     std::string* static_contents,
+                     std::string* icf_reloc_contents)
 {
-  // Lock the object so we can read from it.  This is only called
-  // single-threaded from queue_middle_tasks, so it is OK to lock.
-  // Unfortunately we have no way to pass in a Task token.
-  const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-  Task_lock_obj<Object> tl(dummy_task, secn.first);
+  gold_assert(static_contents == NULL || first_iteration);
+  gold_assert(icf_reloc_contents == NULL || kept_section_id != NULL);
 
   section_size_type plen;
   const unsigned char* contents = NULL;
-  if (first_iteration)
-    contents = secn.first->section_contents(secn.second, &plen, false);
+  if (static_contents != NULL)
+    {
+      // The view remains valid until the object is released.
+      Hold_optional_lock hl(lock);
+      contents = secn.first->section_contents(secn.second, &plen, false);
+    }
 
-  // The buffer to hold all the contents including relocs.  A checksum
-  // is then computed on this buffer.
+  // The buffers to hold the contents including relocs.  A checksum
+  // is then computed on their concatenation.
   std::string buffer;
   std::string icf_reloc_buffer;
 
@@ -325,7 +324,7 @@ get_section_contents(bool first_iteration,
 	  // object is NULL.
 	  if (it_v->first == NULL)
             {
-	      if (first_iteration)
+	      if (static_contents != NULL)
                 {
 		  // If the symbol name is available, use it.
                   if ((*it_s) != NULL)
@@ -344,7 +343,7 @@ get_section_contents(bool first_iteration,
           if (reloc_secn.first == secn.first
               && reloc_secn.second == secn.second)
             {
-              if (first_iteration)
+              if (static_contents != NULL)
                 {
                   buffer.append("R");
                   buffer.append(addend_str);
@@ -367,27 +366,34 @@ get_section_contents(bool first_iteration,
               if (num_tracked_relocs)
                 (*num_tracked_relocs)++;
 
-              char kept_section_str[10];
-              unsigned int secn_id = section_id_map_it->second;
-              snprintf(kept_section_str, sizeof(kept_section_str), "%u",
-                       kept_section_id[secn_id]);
-              if (first_iteration)
+              if (static_contents != NULL)
                 {
                   buffer.append("ICF_R");
                   buffer.append(addend_str);
                 }
-              icf_reloc_buffer.append(kept_section_str);
-              // Append the addend.
-              icf_reloc_buffer.append(addend_str);
-              icf_reloc_buffer.append("@");
+              if (icf_reloc_contents != NULL)
+                {
+                  char kept_section_str[10];
+                  unsigned int secn_id = section_id_map_it->second;
+                  snprintf(kept_section_str, sizeof(kept_section_str), "%u",
+                           (*kept_section_id)[secn_id]);
+                  icf_reloc_buffer.append(kept_section_str);
+                  // Append the addend.
+                  icf_reloc_buffer.append(addend_str);
+                  icf_reloc_buffer.append("@");
+                }
             }
           else
             {
               // This is a reloc to a section that cannot be folded.
               // Process it only in the first iteration.
-              if (!first_iteration)
+              if (static_contents == NULL)
                 continue;
 
+              // The target section may belong to an object which is
+              // being hashed by another task.
+              Hold_optional_lock hl(lock);
+
               uint64_t secn_flags = (it_v->first)->section_flags(it_v->second);
               // This reloc points to a merge section.  Hash the
               // contents of this section.
@@ -520,23 +526,37 @@ get_section_contents(bool first_iteration,
         }
     }
 
-  if (first_iteration)
+  if (static_contents != NULL)
     {
       buffer.append("Contents = ");
       buffer.append(reinterpret_cast<const char*>(contents), plen);
       // Store the section contents that dont change to avoid recomputing
       // during the next call to this function.
-      (*section_contents)[section_num] = buffer;
+      static_contents->swap(buffer);
     }
   else
-    {
-      gold_assert(buffer.empty());
-      // Reuse the contents computed in the previous iteration.
-      buffer.append((*section_contents)[section_num]);
-    }
+    gold_assert(buffer.empty());
+
+  if (icf_reloc_contents != NULL)
+    icf_reloc_contents->swap(icf_reloc_buffer);
+}
 
-  buffer.append(icf_reloc_buffer);
-  return buffer;
+// Return whether the concatenation of A1 and A2 is the same string as
+// the concatenation of B1 and B2.
+
+static bool
+concatenations_equal(const std::string& a1, const std::string& a2,
+                     const std::string& b1, const std::string& b2)
+{
+  if (a1.length() + a2.length() != b1.length() + b2.length())
+    return false;
+  if (a1.length() > b1.length())
+    return concatenations_equal(b1, b2, a1, a2);
+  size_t n = a1.length();
+  size_t m = b1.length() - n;
+  return (b1.compare(0, n, a1) == 0
+          && a2.compare(0, m, b1, n, m) == 0
+          && a2.compare(m, std::string::npos, b2) == 0);
 }
 
 // This function computes a checksum on each section to detect and form
@@ -552,88 +572,74 @@ get_section_contents(bool first_iteration,
 // identical sections.  A section is added to a group only after its
 // contents are explicitly compared with the kept section of the group.
 //
+// The checksum and contents of the parts of each section which do not
+// change between iterations were computed by the hashing tasks.  Here
+// the checksum is extended over the relocs to ICF sections.  This is
+// done serially, in section order, because the relocs of a section
+// refer to the kept sections chosen earlier in the same iteration.
+//
 // Parameters  :
 // ITERATION_NUM           : Invocation instance of this function.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// ID_SECTION         : Vector mapping a section to an unique integer.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sections is already known to be unique.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
 
-static bool
-match_sections(unsigned int iteration_num,
-               Symbol_table* symtab,
-               std::vector<unsigned int>* num_tracked_relocs,
-               std::vector<unsigned int>* kept_section_id,
-               const std::vector<Section_id>& id_section,
-               std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
+bool
+Icf::match_sections(unsigned int iteration_num)
 {
   Unordered_multimap<uint32_t, unsigned int> section_cksum;
   std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
             Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
   bool converged = true;
 
-  if (iteration_num == 1)
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   NULL);
-  else
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   section_contents);
+  // The sections with unique raw contents were found before the
+  // second hashing pass.
+  if (iteration_num > 1)
+    preprocess_for_unique_sections(this->section_cksum_,
+                                   &this->is_secn_or_group_unique_);
 
-  std::vector<std::string> full_section_contents;
+  // For the kept section of each group, the relocs to ICF sections.
+  std::vector<std::string> full_section_contents(this->id_section_.size());
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < this->id_section_.size(); i++)
     {
-      full_section_contents.push_back("");
-      if ((*is_secn_or_group_unique)[i])
+      if (this->is_secn_or_group_unique_[i])
         continue;
 
-      Section_id secn = id_section[i];
+      Section_id secn = this->id_section_[i];
       std::string this_secn_contents;
       uint32_t cksum;
       if (iteration_num == 1)
-        {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, secn, i, &num_relocs,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
+        get_section_contents(true, secn, NULL, this->symtab_,
+                             &this->kept_section_id_, NULL, NULL,
+                             &this_secn_contents);
       else
         {
-          if ((*kept_section_id)[i] != i)
+          if (this->kept_section_id_[i] != i)
             {
               // This section is already folded into something.  See
               // if it should point to a different kept section.
-              unsigned int kept_section = (*kept_section_id)[i];
-              if (kept_section != (*kept_section_id)[kept_section])
+              unsigned int kept_section = this->kept_section_id_[i];
+              if (kept_section != this->kept_section_id_[kept_section])
                 {
-                  (*kept_section_id)[i] = (*kept_section_id)[kept_section];
+                  this->kept_section_id_[i] =
+                    this->kept_section_id_[kept_section];
                 }
               continue;
             }
-          this_secn_contents = get_section_contents(false, secn, i, NULL,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
+          get_section_contents(false, secn, NULL, this->symtab_,
+                               &this->kept_section_id_, NULL, NULL,
+                               &this_secn_contents);
         }
 
       const unsigned char* this_secn_contents_array =
             reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
       cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
+                     this->section_cksum_[i]);
       size_t count = section_cksum.count(cksum);
 
       if (count == 0)
         {
           // Start a group with this cksum.
           section_cksum.insert(std::make_pair(cksum, i));
-          full_section_contents[i] = this_secn_contents;
+          full_section_contents[i].swap(this_secn_contents);
         }
       else
         {
@@ -643,14 +649,12 @@ match_sections(unsigned int iteration_num,
           for (it = key_range.first; it != key_range.second; ++it)
             {
               unsigned int kept_section = it->second;
-              if (full_section_contents[kept_section].length()
-                  != this_secn_contents.length())
-                  continue;
-              if (memcmp(full_section_contents[kept_section].c_str(),
-                         this_secn_contents.c_str(),
-                         this_secn_contents.length()) != 0)
+              if (!concatenations_equal(this->section_contents_[kept_section],
+                                        full_section_contents[kept_section],
+                                        this->section_contents_[i],
+                                        this_secn_contents))
                   continue;
-              (*kept_section_id)[i] = kept_section;
+              this->kept_section_id_[i] = kept_section;
               converged = false;
               break;
             }
@@ -658,18 +662,204 @@ match_sections(unsigned int iteration_num,
             {
               // Create a new group for this cksum.
               section_cksum.insert(std::make_pair(cksum, i));
-              full_section_contents[i] = this_secn_contents;
+              full_section_contents[i].swap(this_secn_contents);
             }
         }
       // If there are no relocs to foldable sections do not process
       // this section any further.
-      if (iteration_num == 1 && (*num_tracked_relocs)[i] == 0)
-        (*is_secn_or_group_unique)[i] = true;
+      if (iteration_num == 1 && this->num_tracked_relocs_[i] == 0)
+        this->is_secn_or_group_unique_[i] = true;
     }
 
   return converged;
 }
 
+// An Icf_hash_task hashes the candidate sections of one object.
+
+class Icf_hash_task : public Task
+{
+ public:
+  Icf_hash_task(Icf* icf, Object* object, bool first_pass,
+                unsigned int begin, unsigned int end,
+                Task_token* next_blocker)
+    : icf_(icf), object_(object), first_pass_(first_pass),
+      begin_(begin), end_(end), next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return this->object_->is_locked() ? this->object_->token() : NULL; }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->object_->token());
+    tl->add(this, this->next_blocker_);
+  }
+
+  void
+  run(Workqueue*)
+  { this->icf_->hash_sections(this->first_pass_, this->begin_, this->end_); }
+
+  std::string
+  get_name() const
+  { return "Icf_hash_task " + this->object_->name(); }
+
+ private:
+  Icf* icf_;
+  Object* object_;
+  bool first_pass_;
+  unsigned int begin_;
+  unsigned int end_;
+  Task_token* next_blocker_;
+};
+
+// An Icf_match_task runs after each hashing pass.  After the first
+// pass it queues the second pass, and after the second pass it forms
+// the groups of identical sections.  It holds ICF_BLOCKER until ICF
+// has completed.
+
+class Icf_match_task : public Task
+{
+ public:
+  Icf_match_task(Icf* icf, bool first_pass, Task_token* this_blocker,
+                 Task_token* icf_blocker)
+    : icf_(icf), first_pass_(first_pass), this_blocker_(this_blocker),
+      icf_blocker_(icf_blocker)
+  { }
+
+  ~Icf_match_task()
+  { delete this->this_blocker_; }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->icf_blocker_); }
+
+  void
+  run(Workqueue* workqueue)
+  {
+    if (this->first_pass_)
+      this->icf_->queue_second_pass(workqueue, this->icf_blocker_);
+    else
+      this->icf_->match_all_sections();
+  }
+
+  std::string
+  get_name() const
+  { return "Icf_match_task"; }
+
+ private:
+  Icf* icf_;
+  bool first_pass_;
+  Task_token* this_blocker_;
+  Task_token* icf_blocker_;
+};
+
+// Queue an Icf_hash_task for each object with candidate sections.  In
+// the second pass, skip the objects whose sections are all known to be
+// unique.  Return a blocker which is unblocked when all the tasks have
+// run.
+
+Task_token*
+Icf::queue_hash_tasks(Workqueue* workqueue, bool first_pass)
+{
+  // The candidate sections of each object are numbered consecutively.
+  std::vector<std::pair<unsigned int, unsigned int> > ranges;
+  unsigned int begin = 0;
+  bool any_to_hash = false;
+  for (unsigned int i = 0; i < this->id_section_.size(); ++i)
+    {
+      if (first_pass || !this->is_secn_or_group_unique_[i])
+        any_to_hash = true;
+      if (i + 1 == this->id_section_.size()
+          || this->id_section_[i + 1].first != this->id_section_[i].first)
+        {
+          if (any_to_hash)
+            ranges.push_back(std::make_pair(begin, i + 1));
+          begin = i + 1;
+          any_to_hash = false;
+        }
+    }
+
+  Task_token* blocker = new Task_token(true);
+  blocker->add_blockers(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i)
+    workqueue->queue(new Icf_hash_task(this,
+                                       this->id_section_[ranges[i].first].first,
+                                       first_pass, ranges[i].first,
+                                       ranges[i].second, blocker));
+  return blocker;
+}
+
+// Hash the candidate sections numbered [BEGIN, END).  These all
+// belong to one object, which is locked by the calling task.  Other
+// tasks may read from this object to hash relocs to its merge
+// sections, so all access to the input files is done while holding
+// lock_.
+
+void
+Icf::hash_sections(bool first_pass, unsigned int begin, unsigned int end)
+{
+  for (unsigned int i = begin; i < end; ++i)
+    {
+      Section_id secn = this->id_section_[i];
+      if (first_pass)
+        {
+          section_size_type plen;
+          const unsigned char* contents;
+          {
+            Hold_optional_lock hl(this->lock_);
+            contents = secn.first->section_contents(secn.second, &plen,
+                                                    false);
+          }
+          this->section_cksum_[i] = xcrc32(contents, plen, 0xffffffff);
+        }
+      else
+        {
+          if (this->is_secn_or_group_unique_[i])
+            continue;
+          std::string* contents = &this->section_contents_[i];
+          get_section_contents(true, secn, &this->num_tracked_relocs_[i],
+                               this->symtab_, NULL, this->lock_, contents,
+                               NULL);
+          this->section_cksum_[i] =
+            xcrc32(reinterpret_cast<const unsigned char*>(contents->c_str()),
+                   contents->length(), 0xffffffff);
+        }
+    }
+
+  Hold_optional_lock hl(this->lock_);
+  this->id_section_[begin].first->release();
+}
+
+// Called after the first hashing pass.  Mark the sections whose raw
+// contents are unique and queue the second hashing pass, which
+// computes the contents of the remaining sections.  ICF_BLOCKER is
+// held until the groups have been formed.
+
+void
+Icf::queue_second_pass(Workqueue* workqueue, Task_token* icf_blocker)
+{
+  preprocess_for_unique_sections(this->section_cksum_,
+                                 &this->is_secn_or_group_unique_);
+
+  Task_token* blocker = this->queue_hash_tasks(workqueue, false);
+  workqueue->add_blocker(icf_blocker);
+  workqueue->queue(new Icf_match_task(this, false, blocker, icf_blocker));
+}
+
 // During safe icf (--icf=safe), only fold functions that are ctors or dtors.
 // This function returns true if the section name is that of a ctor or a dtor.
 
@@ -689,19 +879,24 @@ is_function_ctor_or_dtor(const std::string& section_name)
 }
 
 // This is the main ICF function called in gold.cc.  This does the
-// initialization and calls match_sections repeatedly (twice by default)
-// which computes the crc checksums and detects identical functions.
+// initialization and queues the tasks which hash the candidate
+// sections.  When they have run, match_all_sections calls
+// match_sections repeatedly (twice by default) to detect identical
+// functions.  Return a blocker which is unblocked when that is done.
 
-void
+Task_token*
 Icf::find_identical_sections(const Input_objects* input_objects,
-                             Symbol_table* symtab)
+                             Symbol_table* symtab,
+                             Workqueue* workqueue)
 {
   unsigned int section_num = 0;
-  std::vector<unsigned int> num_tracked_relocs;
-  std::vector<bool> is_secn_or_group_unique;
-  std::vector<std::string> section_contents;
   const Target& target = parameters->target();
 
+  if (parameters->options().stats())
+    this->timer_.start();
+  this->initialize_lock_.initialize();
+  this->symtab_ = symtab;
+
   // Decide which sections are possible candidates first.
 
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
@@ -737,29 +932,41 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           this->id_section_.push_back(Section_id(*p, i));
           this->section_id_[Section_id(*p, i)] = section_num;
           this->kept_section_id_.push_back(section_num);
-          num_tracked_relocs.push_back(0);
-          is_secn_or_group_unique.push_back(false);
-          section_contents.push_back("");
           section_num++;
         }
     }
 
-  unsigned int num_iterations = 0;
+  this->num_tracked_relocs_.resize(section_num, 0);
+  this->is_secn_or_group_unique_.resize(section_num, false);
+  this->section_contents_.resize(section_num);
+  this->section_cksum_.resize(section_num, 0);
+
+  Task_token* icf_blocker = new Task_token(true);
+  icf_blocker->add_blocker();
+  Task_token* blocker = this->queue_hash_tasks(workqueue, true);
+  workqueue->queue(new Icf_match_task(this, true, blocker, icf_blocker));
+  return icf_blocker;
+}
 
+// Called after the hashing tasks have run.  Run match_sections until
+// the groups of identical sections converge or the iteration limit is
+// reached.
+
+void
+Icf::match_all_sections()
+{
   // Default number of iterations to run ICF is 2.
   unsigned int max_iterations = (parameters->options().icf_iterations() > 0)
                             ? parameters->options().icf_iterations()
                             : 2;
 
   bool converged = false;
+  unsigned int num_iterations = 0;
 
   while (!converged && (num_iterations < max_iterations))
     {
       num_iterations++;
-      converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
-                                 this->id_section_, &is_secn_or_group_unique,
-                                 &section_contents);
+      converged = this->match_sections(num_iterations);
     }
 
   if (parameters->options().print_icf_sections())
@@ -772,6 +979,17 @@ Icf::find_identical_sections(const Input_objects* input_objects,
                   program_name, num_iterations);
     }
 
+  this->num_iterations_ = num_iterations;
+  this->converged_ = converged;
+
+  // The per-section contents are no longer needed.
+  std::vector<unsigned int>().swap(this->num_tracked_relocs_);
+  std::vector<bool>().swap(this->is_secn_or_group_unique_);
+  std::vector<std::string>().swap(this->section_contents_);
+  std::vector<uint32_t>().swap(this->section_cksum_);
+
+  Symbol_table* symtab = this->symtab_;
+
   // Unfold --keep-unique symbols.
   for (options::String_set::const_iterator p =
 	 parameters->options().keep_unique_begin();
@@ -799,6 +1017,33 @@ Icf::find_identical_sections(const Input_objects* input_objects,
     }
 
   this->icf_ready();
+
+  if (parameters->options().stats())
+    this->elapsed_ = this->timer_.get_elapsed_time();
+}
+
+// Print statistics about ICF to stderr.
+
+void
+Icf::print_stats() const
+{
+  unsigned int folded = 0;
+  for (unsigned int i = 0; i < this->kept_section_id_.size(); ++i)
+    if (this->kept_section_id_[i] != i)
+      ++folded;
+  fprintf(stderr, _("%s: ICF candidate sections: %zu\n"),
+          program_name, this->id_section_.size());
+  fprintf(stderr, _("%s: ICF folded sections: %u\n"), program_name, folded);
+  fprintf(stderr, _("%s: ICF iterations: %u (%s)\n"), program_name,
+          this->num_iterations_,
+          this->converged_ ? _("converged") : _("not converged"));
+  fprintf(stderr,
+          _("%s: ICF run time: "
+            "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+          program_name,
+          this->elapsed_.user / 1000, (this->elapsed_.user % 1000) * 1000,
+          this->elapsed_.sys / 1000, (this->elapsed_.sys % 1000) * 1000,
+          this->elapsed_.wall / 1000, (this->elapsed_.wall % 1000) * 1000);
 }
 
 // Unfolds the section denoted by OBJ and SHNDX if folded.
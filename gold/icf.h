@@ -28,13 +28,18 @@
 #include "elfcpp.h"
 #include "symtab.h"
 #include "object.h"
+#include "gold-threads.h"
+#include "timer.h"
 
 namespace gold
 {
 
 class Object;
+class Relobj;
 class Input_objects;
 class Symbol_table;
+class Workqueue;
+class Task_token;
 
 class Icf
 {
@@ -68,7 +73,10 @@ class Icf
   : id_section_(), section_id_(), kept_section_id_(),
     fptr_section_id_(),
     icf_ready_(false),
-    reloc_info_list_()
+    reloc_info_list_(), symtab_(NULL), num_tracked_relocs_(),
+    is_secn_or_group_unique_(), section_contents_(), section_cksum_(),
+    num_iterations_(0), converged_(false), lock_(NULL),
+    initialize_lock_(&this->lock_), timer_(), elapsed_()
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -77,10 +85,36 @@ class Icf
   get_folded_section(Object* dup_obj, unsigned int dup_shndx);
 
   // Forms groups of identical sections where the first member
-  // of each group is the kept section during folding.
-  void
+  // of each group is the kept section during folding.  The section
+  // contents are hashed by tasks queued on WORKQUEUE.  This returns a
+  // blocker which is unblocked when the groups have been formed.
+  Task_token*
   find_identical_sections(const Input_objects* input_objects,
-                          Symbol_table* symtab);
+                          Symbol_table* symtab,
+                          Workqueue* workqueue);
+
+  // Hash the candidate sections numbered [BEGIN, END), which all
+  // belong to one object.  This is called by an Icf_task.  If
+  // FIRST_PASS is true, checksum the raw section contents; otherwise
+  // compute the contents which do not change from one iteration to the
+  // next for the sections which are not already known to be unique.
+  void
+  hash_sections(bool first_pass, unsigned int begin, unsigned int end);
+
+  // Called after the first hashing pass.  Mark the sections whose
+  // raw contents are unique and queue the second hashing pass.
+  // ICF_BLOCKER is the blocker returned by find_identical_sections.
+  void
+  queue_second_pass(Workqueue* workqueue, Task_token* icf_blocker);
+
+  // Called after the second hashing pass.  Iterate until the groups of
+  // identical sections converge.
+  void
+  match_all_sections();
+
+  // Print statistics to stderr.
+  void
+  print_stats() const;
 
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
@@ -160,6 +194,42 @@ class Icf
   bool icf_ready_;
   // This list is populated by gc_process_relocs in gc.h.
   Reloc_info_list reloc_info_list_;
+
+  // Queue an Icf_task for each object with candidate sections.
+  Task_token*
+  queue_hash_tasks(Workqueue* workqueue, bool first_pass);
+
+  // Compute the checksums and form the groups for one iteration.
+  bool
+  match_sections(unsigned int iteration_num);
+
+  // The symbol table, set while ICF is running.
+  Symbol_table* symtab_;
+  // For each section, the number of relocs to sections which could
+  // be folded.
+  std::vector<unsigned int> num_tracked_relocs_;
+  // For each section, whether the section or its group of identical
+  // sections is already known to be unique.
+  std::vector<bool> is_secn_or_group_unique_;
+  // For each section, the text and the relocs to sections which can
+  // not be folded.  These do not change between iterations.
+  std::vector<std::string> section_contents_;
+  // For each section, after the first hashing pass the checksum of its
+  // raw contents, and after the second the checksum of
+  // section_contents_.
+  std::vector<uint32_t> section_cksum_;
+  // The number of iterations run so far.
+  unsigned int num_iterations_;
+  // Whether the groups have converged.
+  bool converged_;
+  // Lock which serializes access to the input files while the
+  // hashing tasks run.
+  Lock* lock_;
+  // Used to initialize lock_.
+  Initialize_lock initialize_lock_;
+  // Time taken by ICF, for --stats.
+  Timer timer_;
+  Timer::TimeStats elapsed_;
 };
 
 // This function returns true if this section corresponds to a function that
@@ -23,7 +23,15 @@
 #include "gold.h"
 
 #include <set>
+#include <cerrno>
+#include <csignal>
 #include <cstdarg>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "libiberty.h"
 
 #include "elfcpp.h"
@@ -37,6 +45,8 @@
 #include "target-select.h"
 #include "target.h"
 #include "fileread.h"
+#include "mapfile.h"
+#include "timer.h"
 #include "script.h"
 
 namespace gold {
@@ -432,8 +442,9 @@ Sized_incremental_binary<size, big_endian>::do_check_inputs(
 
   // Walk the list of input files given on the command line, and build
   // a direct map of argument serial numbers to the corresponding input
-  // arguments.
-  this->input_args_map_.resize(cmdline.number_of_input_files());
+  // arguments.  The --incremental-server may call this again for the
+  // same link, so start from an empty map.
+  this->input_args_map_.assign(cmdline.number_of_input_files(), NULL);
   check_input_args(this->input_args_map_, cmdline.begin(), cmdline.end());
 
   // Walk the list of input files to check for conditions that prevent
@@ -497,6 +508,13 @@ Sized_incremental_binary<size, big_endian>::do_file_has_changed(
     return disp == INCREMENTAL_CHANGED;
 
   const char* filename = input_file.filename();
+
+  // A request to the --incremental-server may name files which changed
+  // too recently for their timestamps to show it.  We still check the
+  // timestamps of the files it does not name.
+  if (incremental_server_file_has_changed(filename))
+    return true;
+
   Timespec old_mtime = input_file.get_mtime();
   Timespec new_mtime;
   if (!get_mtime(filename, &new_mtime))
@@ -949,6 +967,380 @@ open_incremental_binary(Output_file* file)
   return result;
 }
 
+// The state of a process started by --incremental-server.
+
+enum Incremental_server_state
+{
+  // Not started by the server.
+  INCREMENTAL_SERVER_NONE,
+  // Started before the link request arrived, to set up the link ahead
+  // of time.
+  INCREMENTAL_SERVER_WARM,
+  // Started after the link request arrived.
+  INCREMENTAL_SERVER_COLD
+};
+
+static Incremental_server_state incremental_server_state;
+
+// In a warm process, the end of the socket pair on which the server
+// passes along the link request.
+
+static int incremental_server_channel = -1;
+
+// The output file as it was when the server started the warm process,
+// so that the warm process can tell whether something else changed it
+// before the request arrived.
+
+static bool incremental_server_output_exists;
+static struct stat incremental_server_output_stat;
+
+// The exit status with which a warm process asks the server to do the
+// link in a cold process instead.
+
+static const int incremental_server_restart_status = 125;
+
+// The files named by the link request which this process is serving.
+
+static std::set<std::string> incremental_server_changed_files;
+
+// Read all the data on descriptor FD until the other side shuts down
+// its side of the connection, and append it to *DATA.
+
+static void
+read_incremental_server_data(int fd, std::string* data)
+{
+  char buf[4096];
+  while (true)
+    {
+      ssize_t len = ::read(fd, buf, sizeof buf);
+      if (len < 0 && errno == EINTR)
+	continue;
+      if (len <= 0)
+	break;
+      data->append(buf, len);
+    }
+}
+
+// Record the link request REQUEST.  A request is a list of the input
+// files which changed, one per line.
+
+static void
+set_incremental_server_request(const std::string& request)
+{
+  size_t pos = 0;
+  while (pos < request.length())
+    {
+      size_t end = request.find('\n', pos);
+      if (end == std::string::npos)
+	end = request.length();
+      if (end > pos)
+	incremental_server_changed_files.insert(request.substr(pos,
+							       end - pos));
+      pos = end + 1;
+    }
+}
+
+// Pass the client connection C and the link REQUEST to the warm
+// process on descriptor CHANNEL.  Return false if the warm process has
+// gone away.
+
+static bool
+send_incremental_server_request(int channel, int c,
+				const std::string& request)
+{
+  // The connection goes along with the first byte.
+  char byte = 'R';
+  struct iovec iov;
+  iov.iov_base = &byte;
+  iov.iov_len = 1;
+  char control[CMSG_SPACE(sizeof(int))];
+  memset(control, 0, sizeof control);
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof control;
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &c, sizeof(int));
+
+  ssize_t len;
+  do
+    len = ::sendmsg(channel, &msg, 0);
+  while (len < 0 && errno == EINTR);
+  if (len != 1)
+    return false;
+
+  const char* p = request.data();
+  size_t left = request.length();
+  while (left > 0)
+    {
+      len = ::write(channel, p, left);
+      if (len < 0 && errno == EINTR)
+	continue;
+      if (len <= 0)
+	return false;
+      p += len;
+      left -= len;
+    }
+  return true;
+}
+
+// In a warm process, wait for the server to pass along a link request,
+// and return the client connection.  If the server went away first,
+// exit.
+
+static int
+receive_incremental_server_request()
+{
+  char byte;
+  struct iovec iov;
+  iov.iov_base = &byte;
+  iov.iov_len = 1;
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof control;
+
+  ssize_t len;
+  do
+    len = ::recvmsg(incremental_server_channel, &msg, 0);
+  while (len < 0 && errno == EINTR);
+  struct cmsghdr* cmsg = len == 1 ? CMSG_FIRSTHDR(&msg) : NULL;
+  if (cmsg == NULL
+      || cmsg->cmsg_level != SOL_SOCKET
+      || cmsg->cmsg_type != SCM_RIGHTS)
+    _exit(0);
+  int c;
+  memcpy(&c, CMSG_DATA(cmsg), sizeof(int));
+
+  std::string request;
+  read_incremental_server_data(incremental_server_channel, &request);
+  ::close(incremental_server_channel);
+  incremental_server_channel = -1;
+  set_incremental_server_request(request);
+  return c;
+}
+
+// Record the state of the output file, for
+// incremental_server_output_changed.
+
+static void
+record_incremental_server_output()
+{
+  const char* output_file_name = parameters->options().output_file_name();
+  incremental_server_output_exists =
+    ::stat(output_file_name, &incremental_server_output_stat) == 0;
+}
+
+// Return whether the output file changed since
+// record_incremental_server_output was called.
+
+static bool
+incremental_server_output_changed()
+{
+  const char* output_file_name = parameters->options().output_file_name();
+  struct stat st;
+  bool exists = ::stat(output_file_name, &st) == 0;
+  if (exists != incremental_server_output_exists)
+    return true;
+  if (!exists)
+    return false;
+  const struct stat& old_st(incremental_server_output_stat);
+  return (st.st_dev != old_st.st_dev
+	  || st.st_ino != old_st.st_ino
+	  || st.st_size != old_st.st_size
+	  || st.st_mtime != old_st.st_mtime
+	  || st.st_ctime != old_st.st_ctime);
+}
+
+// Wait for the process PID to exit, and return its exit status.
+
+static int
+wait_for_incremental_server_child(pid_t pid)
+{
+  int status;
+  while (::waitpid(pid, &status, 0) < 0)
+    {
+      if (errno != EINTR)
+	gold_fatal(_("waitpid: %s"), strerror(errno));
+    }
+  if (WIFEXITED(status))
+    return WEXITSTATUS(status);
+  return 128 + WTERMSIG(status);
+}
+
+// Fork a process to do a link.
+
+static pid_t
+fork_incremental_server_child()
+{
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = ::fork();
+  if (pid < 0)
+    gold_fatal(_("fork: %s"), strerror(errno));
+  return pid;
+}
+
+// Serve link requests for --incremental-server.
+
+void
+run_incremental_server()
+{
+  const char* socket_name = parameters->options().incremental_server();
+
+  struct sockaddr_un addr;
+  if (strlen(socket_name) >= sizeof addr.sun_path)
+    gold_fatal(_("%s: socket name too long"), socket_name);
+  memset(&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_name);
+
+  int s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (s < 0)
+    gold_fatal(_("%s: socket: %s"), socket_name, strerror(errno));
+
+  // Remove a socket left behind by an earlier server.
+  struct stat st;
+  if (::lstat(socket_name, &st) == 0 && S_ISSOCK(st.st_mode))
+    ::unlink(socket_name);
+
+  if (::bind(s, reinterpret_cast<struct sockaddr*>(&addr), sizeof addr) < 0)
+    gold_fatal(_("%s: bind: %s"), socket_name, strerror(errno));
+  if (::listen(s, 8) < 0)
+    gold_fatal(_("%s: listen: %s"), socket_name, strerror(errno));
+
+  // A client which goes away should not kill the server, or a link
+  // which is writing to it.
+  ::signal(SIGPIPE, SIG_IGN);
+
+  while (true)
+    {
+      // Start the process for the next link before the request
+      // arrives.  It reads the incremental information from the
+      // output file and lays out the output file as the last link
+      // left it, and then waits in incremental_server_start_link.
+      int channel[2];
+      if (::socketpair(AF_UNIX, SOCK_STREAM, 0, channel) < 0)
+	gold_fatal(_("socketpair: %s"), strerror(errno));
+      record_incremental_server_output();
+      pid_t pid = fork_incremental_server_child();
+      if (pid == 0)
+	{
+	  ::close(s);
+	  ::close(channel[0]);
+	  incremental_server_channel = channel[1];
+	  incremental_server_state = INCREMENTAL_SERVER_WARM;
+	  return;
+	}
+      ::close(channel[1]);
+
+      int c;
+      do
+	c = ::accept(s, NULL, NULL);
+      while (c < 0 && errno == EINTR);
+      if (c < 0)
+	gold_fatal(_("%s: accept: %s"), socket_name, strerror(errno));
+
+      std::string request;
+      read_incremental_server_data(c, &request);
+
+      // If the warm process has gone away, closing the channel does
+      // no harm; otherwise it tells the process the request is
+      // complete.
+      bool sent = send_incremental_server_request(channel[0], c, request);
+      ::close(channel[0]);
+      int exit_status = wait_for_incremental_server_child(pid);
+
+      // If the warm process could not be used, do the link from the
+      // start in a new process.
+      if (!sent || exit_status == incremental_server_restart_status)
+	{
+	  pid = fork_incremental_server_child();
+	  if (pid == 0)
+	    {
+	      ::close(s);
+	      ::dup2(c, 1);
+	      ::dup2(c, 2);
+	      ::close(c);
+	      set_incremental_server_request(request);
+	      incremental_server_state = INCREMENTAL_SERVER_COLD;
+	      return;
+	    }
+	  exit_status = wait_for_incremental_server_child(pid);
+	}
+
+      // Links are done one at a time, since each one updates the
+      // output of the last.  When the link is done, tell the client
+      // how it went.
+      char reply[32];
+      snprintf(reply, sizeof reply, "exit status %d\n", exit_status);
+      if (::write(c, reply, strlen(reply)) < 0)
+	gold_info(_("%s: write: %s"), socket_name, strerror(errno));
+      ::close(c);
+    }
+}
+
+// Start the link in a process started by --incremental-server.
+
+bool
+incremental_server_start_link(Mapfile* mapfile)
+{
+  bool warm = incremental_server_state == INCREMENTAL_SERVER_WARM;
+  if (warm)
+    {
+      int c = receive_incremental_server_request();
+
+      // The link was set up from the output file as it was when this
+      // process started.  If it has changed since, start over.
+      if (incremental_server_output_changed())
+	incremental_server_restart();
+
+      // Anything the link prints goes to the client.
+      fflush(stdout);
+      fflush(stderr);
+      ::dup2(c, 1);
+      ::dup2(c, 2);
+      ::close(c);
+    }
+
+  // Each link writes its own map file.
+  if (mapfile != NULL && !mapfile->open(parameters->options().Map()))
+    gold_exit(GOLD_ERR);
+
+  // Only time the link itself.
+  if (parameters->timer() != NULL)
+    parameters->timer()->start();
+
+  return warm;
+}
+
+// Ask the server to do this link in a new process.
+
+void
+incremental_server_restart()
+{
+  gold_assert(incremental_server_state == INCREMENTAL_SERVER_WARM);
+  _exit(incremental_server_restart_status);
+}
+
+// Return whether the link request which this process is serving named
+// FILENAME as changed.
+
+bool
+incremental_server_file_has_changed(const char* filename)
+{
+  return (incremental_server_changed_files.find(filename)
+	  != incremental_server_changed_files.end());
+}
+
 // Class Incremental_inputs.
 
 // Add the command line to the string table, setting
@@ -975,10 +1367,12 @@ Incremental_inputs::report_command_line(int argc, const char* const* argv)
 	  || strcmp(argv[i], "--incremental-startup-unchanged") == 0
 	  || is_prefix_of("--incremental-base=", argv[i])
 	  || is_prefix_of("--incremental-patch=", argv[i])
+	  || is_prefix_of("--incremental-server=", argv[i])
 	  || is_prefix_of("--debug=", argv[i]))
 	continue;
       if (strcmp(argv[i], "--incremental-base") == 0
 	  || strcmp(argv[i], "--incremental-patch") == 0
+	  || strcmp(argv[i], "--incremental-server") == 0
 	  || strcmp(argv[i], "--debug") == 0)
 	{
 	  // When these options are used without the '=', skip the
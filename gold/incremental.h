@@ -46,6 +46,7 @@ class Incremental_inputs;
 class Incremental_binary;
 class Incremental_library;
 class Object;
+class Mapfile;
 
 // Incremental input type as stored in .gnu_incremental_inputs.
 
@@ -92,6 +93,41 @@ can_incremental_update(unsigned int sh_type);
 Incremental_binary*
 open_incremental_binary(Output_file* file);
 
+// Serve link requests for --incremental-server.  The server listens on
+// the named socket, and forks a child process to do each link, so
+// that every link starts from the state set up before this was
+// called.  The child for the next link is forked before its request
+// arrives, and sets up as much of the link as it can from the output
+// file; it then waits in incremental_server_start_link.  The server
+// process never returns from this function.  In each child, it
+// returns and the child goes on to do the link.
+
+void
+run_incremental_server();
+
+// Called in a child of the --incremental-server when the link has been
+// set up as far as it can be before the request arrives.  Wait for the
+// request, send the standard output and error to the client, and open
+// MAPFILE if it is not NULL.  Return true if the link was set up before
+// the request arrived, in which case anything checked while setting it
+// up must be checked again.
+
+bool
+incremental_server_start_link(Mapfile* mapfile);
+
+// Called in a child of the --incremental-server which set up the link
+// before the request arrived, when the setup turns out to be out of
+// date.  Exit, and have the server do the link in a new child.
+
+void
+incremental_server_restart() ATTRIBUTE_NORETURN;
+
+// Return whether the --incremental-server request for this link named
+// FILENAME as a file which changed.
+
+bool
+incremental_server_file_has_changed(const char* filename);
+
 // Base class for recording each input file.
 
 class Incremental_input_entry
@@ -47,6 +47,7 @@
 #include "ehframe.h"
 #include "gdb-index.h"
 #include "compressed_output.h"
+#include "fast-hash.h"
 #include "reduced_debug_output.h"
 #include "object.h"
 #include "reloc.h"
@@ -236,25 +237,37 @@ Free_list::print_stats()
 	  program_name, Free_list::num_allocate_visits);
 }
 
-// A Hash_task computes the MD5 checksum of an array of char.
-// It has a blocker on either side (i.e., the task cannot run until
-// the first is unblocked, and it unblocks the second after running).
+// A Hash_task computes the MD5 checksum, or for --build-id=fast the
+// fast_hash128 digest, of a chunk of the output file.  It has a
+// blocker on either side (i.e., the task cannot run until the first
+// is unblocked, and it unblocks the second after running).
 
 class Hash_task : public Task
 {
  public:
-  Hash_task(const unsigned char* src,
+  Hash_task(Output_file* of,
+	    off_t offset,
 	    size_t size,
 	    unsigned char* dst,
+	    bool is_fast,
 	    Task_token* build_id_blocker,
 	    Task_token* final_blocker)
-    : src_(src), size_(size), dst_(dst), build_id_blocker_(build_id_blocker),
-      final_blocker_(final_blocker)
+    : of_(of), offset_(offset), size_(size), dst_(dst), is_fast_(is_fast),
+      build_id_blocker_(build_id_blocker), final_blocker_(final_blocker)
   { }
 
   void
   run(Workqueue*)
-  { md5_buffer(reinterpret_cast<const char*>(src_), size_, dst_); }
+  {
+    const unsigned char* src = this->of_->get_input_view(this->offset_,
+							 this->size_);
+    if (this->is_fast_)
+      fast_hash128(src, this->size_, this->dst_);
+    else
+      md5_buffer(reinterpret_cast<const char*>(src), this->size_,
+		 this->dst_);
+    this->of_->free_input_view(this->offset_, this->size_, src);
+  }
 
   Task_token*
   is_runnable();
@@ -269,9 +282,11 @@ class Hash_task : public Task
   { return "Hash_task"; }
 
  private:
-  const unsigned char* const src_;
+  Output_file* const of_;
+  const off_t offset_;
   const size_t size_;
   unsigned char* const dst_;
+  const bool is_fast_;
   Task_token* const build_id_blocker_;
   Task_token* const final_blocker_;
 };
@@ -452,7 +467,6 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     build_id_note_(NULL),
     array_of_hashes_(NULL),
     size_of_array_of_hashes_(0),
-    input_view_(NULL),
     debug_abbrev_(NULL),
     debug_info_(NULL),
     group_signatures_(),
@@ -565,6 +579,8 @@ static const char* gdb_fast_lookup_sections[] =
   "aranges",
   "pubnames",
   "pubtypes",
+  "gnu_pubnames",
+  "gnu_pubtypes",
 };
 
 // Returns whether the given debug section is in the list of
@@ -1566,6 +1582,26 @@ Layout::add_to_gdb_index(bool is_type_unit,
 					 reloc_type);
 }
 
+// Queue the tasks which scan the sections added to the .gdb_index
+// section.  This is called after each object is laid out.
+
+void
+Layout::queue_gdb_index_tasks(Workqueue* workqueue)
+{
+  if (this->gdb_index_data_ != NULL)
+    this->gdb_index_data_->queue_scan_tasks(workqueue);
+}
+
+// Return the blocker for the .gdb_index scan tasks.
+
+Task_token*
+Layout::release_gdb_index_blocker()
+{
+  if (this->gdb_index_data_ == NULL)
+    return NULL;
+  return this->gdb_index_data_->release_scan_blocker();
+}
+
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
 // the output section.
 
@@ -2721,6 +2757,9 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   if (this->script_options_->saw_sections_clause())
     this->place_orphan_sections_in_script();
 
+  if (parameters->options().hugepage_text())
+    this->align_hot_text_to_hugepages();
+
   Output_segment* load_seg;
   off_t off;
   unsigned int shndx;
@@ -2813,6 +2852,42 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   return off;
 }
 
+// For --hugepage-text, ask each executable output section whose input
+// sections are ordered by --section-ordering-file, --call-graph-profile
+// or a plugin to place its ordered sections, which are the hot text,
+// on huge page boundaries.  This must be done before we set the
+// segment offsets, since the segments which hold the hot text are
+// laid out using the huge page size.
+
+void
+Layout::align_hot_text_to_hugepages()
+{
+  const uint64_t hugepage_size = parameters->options().hugepage_size();
+  if (parameters->options().nmagic() || parameters->options().omagic())
+    {
+      gold_warning(_("ignoring --hugepage-text with -n or -N"));
+      return;
+    }
+
+  bool found = false;
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    {
+      if (((*p)->flags() & elfcpp::SHF_ALLOC) == 0
+	  || ((*p)->flags() & elfcpp::SHF_EXECINSTR) == 0
+	  || !(*p)->input_section_order_specified())
+	continue;
+      (*p)->set_hugepage_size(hugepage_size);
+      found = true;
+    }
+  if (!found
+      && (this->is_section_ordering_specified()
+	  || parameters->options().call_graph_profile()))
+    gold_warning(_("--hugepage-text: no executable input sections are "
+		   "ordered"));
+}
+
 // Create a note header following the format defined in the ELF ABI.
 // NAME is the name, NOTE_TYPE is the type, SECTION_NAME is the name
 // of the section to create, DESCSZ is the size of the descriptor.
@@ -3008,7 +3083,7 @@ Layout::create_build_id()
   // set DESC to the note descriptor contents.
   size_t descsz;
   std::string desc;
-  if (strcmp(style, "md5") == 0)
+  if (strcmp(style, "md5") == 0 || strcmp(style, "fast") == 0)
     descsz = 128 / 8;
   else if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
     descsz = 160 / 8;
@@ -3489,6 +3564,13 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
 	  uint64_t abi_pagesize = target->abi_pagesize();
 	  uint64_t common_pagesize = target->common_pagesize();
 
+	  // For --hugepage-text, lay out a segment holding hot text as
+	  // though the page size were the huge page size, so that its
+	  // addresses and file offsets are congruent modulo the huge
+	  // page size.
+	  if ((*p)->hugepage_size() > abi_pagesize)
+	    abi_pagesize = (*p)->hugepage_size();
+
 	  if (!parameters->options().nmagic()
 	      && !parameters->options().omagic())
 	    (*p)->set_minimum_p_align(abi_pagesize);
@@ -5342,6 +5424,13 @@ Layout::write_sections_after_input_sections(Output_file* of)
 // or as a "tree" where each chunk of the string is hashed and then those
 // hashes are put into a (much smaller) string which is hashed with sha1.
 // We compute a checksum over the entire file because that is simplest.
+//
+// --build-id=fast is always computed as a tree, using fast_hash128 for
+// both levels.  Its chunk size is fixed, so that the build ID does not
+// depend on any options, or on whether we use threads.
+
+// The chunk size for --build-id=fast.
+static const size_t fast_build_id_chunk_size = 1024 * 1024;
 
 Task_token*
 Layout::queue_build_id_tasks(Workqueue* workqueue, Task_token* build_id_blocker,
@@ -5349,37 +5438,51 @@ Layout::queue_build_id_tasks(Workqueue* workqueue, Task_token* build_id_blocker,
 {
   const size_t filesize = (this->output_file_size() <= 0 ? 0
 			   : static_cast<size_t>(this->output_file_size()));
-  if (this->build_id_note_ != NULL
-      && strcmp(parameters->options().build_id(), "tree") == 0
-      && parameters->options().build_id_chunk_size_for_treehash() > 0
-      && filesize > 0
-      && (filesize >=
-	  parameters->options().build_id_min_file_size_for_treehash()))
+  if (this->build_id_note_ == NULL || filesize == 0)
+    return build_id_blocker;
+
+  const char* style = parameters->options().build_id();
+  size_t chunk_size;
+  size_t hash_size;
+  bool is_fast;
+  if (strcmp(style, "fast") == 0)
+    {
+      chunk_size = fast_build_id_chunk_size;
+      hash_size = fast_hash128_size;
+      is_fast = true;
+    }
+  else if (strcmp(style, "tree") == 0
+	   && parameters->options().build_id_chunk_size_for_treehash() > 0
+	   && (filesize >=
+	       parameters->options().build_id_min_file_size_for_treehash()))
     {
       static const size_t MD5_OUTPUT_SIZE_IN_BYTES = 16;
-      const size_t chunk_size =
-	  parameters->options().build_id_chunk_size_for_treehash();
-      const size_t num_hashes = ((filesize - 1) / chunk_size) + 1;
-      Task_token* post_hash_tasks_blocker = new Task_token(true);
-      post_hash_tasks_blocker->add_blockers(num_hashes);
-      this->size_of_array_of_hashes_ = num_hashes * MD5_OUTPUT_SIZE_IN_BYTES;
-      const unsigned char* src = of->get_input_view(0, filesize);
-      this->input_view_ = src;
-      unsigned char *dst = new unsigned char[this->size_of_array_of_hashes_];
-      this->array_of_hashes_ = dst;
-      for (size_t i = 0, src_offset = 0; i < num_hashes;
-	   i++, dst += MD5_OUTPUT_SIZE_IN_BYTES, src_offset += chunk_size)
-	{
-	  size_t size = std::min(chunk_size, filesize - src_offset);
-	  workqueue->queue(new Hash_task(src + src_offset,
-					 size,
-					 dst,
-					 build_id_blocker,
-					 post_hash_tasks_blocker));
-	}
-      return post_hash_tasks_blocker;
+      chunk_size = parameters->options().build_id_chunk_size_for_treehash();
+      hash_size = MD5_OUTPUT_SIZE_IN_BYTES;
+      is_fast = false;
     }
-  return build_id_blocker;
+  else
+    return build_id_blocker;
+
+  const size_t num_hashes = ((filesize - 1) / chunk_size) + 1;
+  Task_token* post_hash_tasks_blocker = new Task_token(true);
+  post_hash_tasks_blocker->add_blockers(num_hashes);
+  this->size_of_array_of_hashes_ = num_hashes * hash_size;
+  unsigned char *dst = new unsigned char[this->size_of_array_of_hashes_];
+  this->array_of_hashes_ = dst;
+  for (size_t i = 0, src_offset = 0; i < num_hashes;
+       i++, dst += hash_size, src_offset += chunk_size)
+    {
+      size_t size = std::min(chunk_size, filesize - src_offset);
+      workqueue->queue(new Hash_task(of,
+				     src_offset,
+				     size,
+				     dst,
+				     is_fast,
+				     build_id_blocker,
+				     post_hash_tasks_blocker));
+    }
+  return post_hash_tasks_blocker;
 }
 
 // If a tree-style build ID was requested, the parallel part of that computation
@@ -5397,29 +5500,55 @@ Layout::write_build_id(Output_file* of) const
 
   if (this->array_of_hashes_ == NULL)
     {
-      const size_t output_file_size = this->output_file_size();
-      const unsigned char* iv = of->get_input_view(0, output_file_size);
+      const off_t output_file_size = this->output_file_size();
       const char* style = parameters->options().build_id();
 
       // If we get here with style == "tree" then the output must be
       // too small for chunking, and we use SHA-1 in that case.
+      bool is_sha1;
       if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
-	sha1_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
+	is_sha1 = true;
       else if (strcmp(style, "md5") == 0)
-	md5_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
+	is_sha1 = false;
       else
 	gold_unreachable();
 
-      of->free_input_view(0, output_file_size, iv);
+      // Read the file in blocks, so that with --stream-output we do
+      // not have to hold all of it in memory.
+      const off_t block_size = 1024 * 1024;
+      sha1_ctx sha1;
+      md5_ctx md5;
+      if (is_sha1)
+	sha1_init_ctx(&sha1);
+      else
+	md5_init_ctx(&md5);
+      for (off_t off = 0; off < output_file_size; off += block_size)
+	{
+	  size_t len = std::min(block_size, output_file_size - off);
+	  const unsigned char* iv = of->get_input_view(off, len);
+	  if (is_sha1)
+	    sha1_process_bytes(iv, len, &sha1);
+	  else
+	    md5_process_bytes(iv, len, &md5);
+	  of->free_input_view(off, len, iv);
+	}
+      if (is_sha1)
+	sha1_finish_ctx(&sha1, ov);
+      else
+	md5_finish_ctx(&md5, ov);
     }
   else
     {
       // Non-overlapping substrings of the output file have been hashed.
-      // Compute SHA-1 hash of the hashes.
-      sha1_buffer(reinterpret_cast<const char*>(this->array_of_hashes_),
-		  this->size_of_array_of_hashes_, ov);
+      // Compute SHA-1 hash of the hashes, or for --build-id=fast
+      // their fast_hash128 digest.
+      if (strcmp(parameters->options().build_id(), "fast") == 0)
+	fast_hash128(this->array_of_hashes_, this->size_of_array_of_hashes_,
+		     ov);
+      else
+	sha1_buffer(reinterpret_cast<const char*>(this->array_of_hashes_),
+		    this->size_of_array_of_hashes_, ov);
       delete[] this->array_of_hashes_;
-      of->free_input_view(0, this->output_file_size(), this->input_view_);
     }
 
   of->write_output_view(this->build_id_note_->offset(),
@@ -5499,7 +5628,10 @@ Layout::print_stats() const
   for (Section_list::const_iterator p = this->section_list_.begin();
        p != this->section_list_.end();
        ++p)
-    (*p)->print_merge_stats();
+    {
+      (*p)->print_merge_stats();
+      (*p)->print_hugepage_stats();
+    }
 }
 
 // Write_sections_task methods.
@@ -656,6 +656,17 @@ class Layout
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // Queue the tasks which scan the .debug_info and .debug_types
+  // sections added by add_to_gdb_index since the last call.
+  void
+  queue_gdb_index_tasks(Workqueue*);
+
+  // Return a blocker which is unblocked when all the tasks queued by
+  // queue_gdb_index_tasks have run, or NULL if we are not building a
+  // .gdb_index section.  The caller takes ownership of the blocker.
+  Task_token*
+  release_gdb_index_blocker();
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -1203,6 +1214,10 @@ class Layout
   void
   place_orphan_sections_in_script();
 
+  // Align the hot text to huge pages, for --hugepage-text.
+  void
+  align_hot_text_to_hugepages();
+
   // Return whether SEG1 comes before SEG2 in the output file.
   bool
   segment_precedes(const Output_segment* seg1, const Output_segment* seg2);
@@ -1379,8 +1394,6 @@ class Layout
   unsigned char* array_of_hashes_;
   // Size of array_of_hashes_ (in bytes).
   size_t size_of_array_of_hashes_;
-  // Input view for computing tree hash of build ID.  Freed in write_build_id().
-  const unsigned char* input_view_;
   // The output section containing dwarf abbreviations
   Output_reduced_debug_abbrev_section* debug_abbrev_;
   // The output section containing the dwarf debug info tree
@@ -178,12 +178,14 @@ main(int argc, char** argv)
   write_debug_script(command_line.options().output_file_name(),
                      program_name, args.c_str());
 
-  // If the user asked for a map file, open it.
+  // If the user asked for a map file, open it.  With
+  // --incremental-server, each link opens its own.
   Mapfile* mapfile = NULL;
   if (command_line.options().user_set_Map())
     {
       mapfile = new Mapfile();
-      if (!mapfile->open(command_line.options().Map()))
+      if (!command_line.options().user_set_incremental_server()
+	  && !mapfile->open(command_line.options().Map()))
 	{
 	  delete mapfile;
 	  mapfile = NULL;
@@ -239,6 +241,11 @@ main(int argc, char** argv)
   if (command_line.options().has_plugins())
     command_line.options().plugins()->load_plugins(&layout);
 
+  // With --incremental-server, we only get past this point in a child
+  // process forked to do one link.
+  if (command_line.options().user_set_incremental_server())
+    run_incremental_server();
+
   // Get the search path from the -L options.
   Dirsearch search_path;
   search_path.initialize(&workqueue, &command_line.options().library_path());
@@ -251,6 +258,9 @@ main(int argc, char** argv)
   // Run the main task processing loop.
   workqueue.process(0);
 
+  if (command_line.options().user_set_trace_tasks())
+    workqueue.write_trace(command_line.options().trace_tasks());
+
   if (command_line.options().print_output_format())
     print_output_format();
 
@@ -298,12 +308,21 @@ main(int argc, char** argv)
       File_read::print_stats();
       Archive::print_stats();
       Lib_group::print_stats();
+      if (command_line.options().has_plugins())
+	command_line.options().plugins()->print_stats();
       fprintf(stderr, _("%s: output file size: %lld bytes\n"),
 	      program_name, static_cast<long long>(layout.output_file_size()));
+      Output_file::print_stats();
       symtab.print_stats();
+      if (symtab.gc() != NULL && symtab.gc()->is_worklist_ready())
+	symtab.gc()->print_stats();
+      if (symtab.icf() != NULL && symtab.icf()->is_icf_ready())
+	symtab.icf()->print_stats();
       layout.print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
+      if (command_line.options().threads())
+	workqueue.print_stats();
     }
 
   // Issue defined symbol report.
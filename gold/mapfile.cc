@@ -347,6 +347,12 @@ Mapfile::print_discarded_sections(const Input_objects* input_objects)
        ++p)
     {
       Relobj* relobj = *p;
+
+      // An unchanged input to an incremental update is not read, so
+      // we do not know which of its sections were discarded.
+      if (relobj->is_incremental())
+	continue;
+
       // Lock the object so we can read from it.  This is only called
       // single-threaded from Layout_task_runner, so it is OK to lock.
       // Unfortunately we have no way to pass in a Task token.
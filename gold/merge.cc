@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <algorithm>
 
+#include "gold-threads.h"
 #include "merge.h"
 #include "compressed_output.h"
 
@@ -540,14 +541,27 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   this->merged_strings_lists_.push_back(merged_strings_list);
   Merged_strings& merged_strings = merged_strings_list->merged_strings;
 
-  // Count the number of non-null strings in the section and size the list.
+  // We assume here that the beginning of the section is correctly
+  // aligned, so each string within the section must retain the same
+  // modulo.
+  uintptr_t init_align_modulo = (reinterpret_cast<uintptr_t>(pdata)
+				 & (this->addralign() - 1));
+  bool has_misaligned_strings = false;
+
+  // Count the number of non-null strings in the section and size the
+  // list.  Within merge input section each string must be aligned.
   size_t count = 0;
   const Char_type* pt = p;
   while (pt < pend0)
     {
       size_t len = string_length(pt);
       if (len != 0)
-	++count;
+	{
+	  ++count;
+	  if ((reinterpret_cast<uintptr_t>(pt) & (this->addralign() - 1))
+	      != init_align_modulo)
+	    has_misaligned_strings = true;
+	}
       pt += len + 1;
     }
   if (pend0 < pend)
@@ -557,46 +571,49 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   // The index I is in bytes, not characters.
   section_size_type i = 0;
 
-  // We assume here that the beginning of the section is correctly
-  // aligned, so each string within the section must retain the same
-  // modulo.
-  uintptr_t init_align_modulo = (reinterpret_cast<uintptr_t>(pdata)
-				 & (this->addralign() - 1));
-  bool has_misaligned_strings = false;
-
-  while (p < pend0)
+  if (parallel_thread_count() > 1)
     {
-      size_t len = string_length(p);
+      // Save the strings to be hashed by add_saved_strings.
+      merged_strings_list->contents_length = pend - p;
+      merged_strings_list->terminated_length = pend0 - p;
+      merged_strings_list->contents = new Char_type[pend - p];
+      memcpy(merged_strings_list->contents, p,
+	     (pend - p) * sizeof(Char_type));
+
+      i = (pend0 - p) * sizeof(Char_type);
+      if (pend0 < pend)
+	i += (pend - pend0 + 1) * sizeof(Char_type);
+    }
+  else
+    {
+      while (p < pend0)
+	{
+	  size_t len = string_length(p);
 
-      // Within merge input section each string must be aligned.
-      if (len != 0
-	  && ((reinterpret_cast<uintptr_t>(p) & (this->addralign() - 1))
-	      != init_align_modulo))
-	  has_misaligned_strings = true;
+	  Stringpool::Key key;
+	  this->stringpool_.add_with_length(p, len, true, &key);
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+	  merged_strings.push_back(Merged_string(i, key));
+	  p += len + 1;
+	  i += (len + 1) * sizeof(Char_type);
+	}
+      if (p < pend)
+	{
+	  size_t len = pend - p;
 
-      merged_strings.push_back(Merged_string(i, key));
-      p += len + 1;
-      i += (len + 1) * sizeof(Char_type);
-    }
-  if (p < pend)
-    {
-      size_t len = pend - p;
+	  Stringpool::Key key;
+	  this->stringpool_.add_with_length(p, len, true, &key);
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+	  merged_strings.push_back(Merged_string(i, key));
 
-      merged_strings.push_back(Merged_string(i, key));
+	  i += (len + 1) * sizeof(Char_type);
+	}
 
-      i += (len + 1) * sizeof(Char_type);
+      // Record the last offset in the input section so that we can
+      // compute the length of the last string.
+      merged_strings.push_back(Merged_string(i, 0));
     }
 
-  // Record the last offset in the input section so that we can
-  // compute the length of the last string.
-  merged_strings.push_back(Merged_string(i, 0));
-
   this->input_count_ += count;
   this->input_size_ += i;
 
@@ -616,6 +633,181 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   return true;
 }
 
+// A job which splits the saved contents of each input section into
+// strings and computes their hash codes.  Each piece handles one
+// input section.  The strings are also grouped into partitions by
+// hash code, for Find_first_strings_job.
+
+template<typename Char_type>
+class Output_merge_string<Char_type>::Hash_strings_job : public Parallel_job
+{
+ public:
+  Hash_strings_job(Merged_strings_lists* lists, unsigned int shard_count)
+    : lists_(lists), shard_count_(shard_count)
+  { }
+
+  void
+  run_piece(unsigned int);
+
+ private:
+  Merged_strings_lists* lists_;
+  unsigned int shard_count_;
+};
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::Hash_strings_job::run_piece(unsigned int i)
+{
+  Merged_strings_list* l = (*this->lists_)[i];
+  Saved_strings& saved_strings(l->saved_strings);
+  saved_strings.reserve(l->merged_strings.capacity());
+
+  const Char_type* p = l->contents;
+  const Char_type* pend0 = p + l->terminated_length;
+  const Char_type* pend = p + l->contents_length;
+  section_size_type offset = 0;
+  while (p < pend)
+    {
+      size_t len = p < pend0 ? string_length(p) : pend - p;
+      Saved_string ss;
+      ss.string = p;
+      ss.length = len;
+      ss.hash_code = string_hash<Char_type>(p, len);
+      ss.offset = offset;
+      ss.first = NULL;
+      ss.stringpool_key = 0;
+      ss.shard_next = -1U;
+      saved_strings.push_back(ss);
+      p += len + 1;
+      offset += (len + 1) * sizeof(Char_type);
+    }
+
+  // Chain the strings of each partition together, in input order.
+  // Walking backward lets us add each string at the head.
+  const unsigned int shard_count = this->shard_count_;
+  std::vector<unsigned int>& shard_head(l->shard_head);
+  shard_head.assign(shard_count, -1U);
+  for (unsigned int j = saved_strings.size(); j > 0; --j)
+    {
+      Saved_string& ss(saved_strings[j - 1]);
+      unsigned int shard = ss.hash_code % shard_count;
+      ss.shard_next = shard_head[shard];
+      shard_head[shard] = j - 1;
+    }
+}
+
+// A job which finds the first instance of each saved string.  Each
+// piece handles the strings in one partition, looking at the input
+// sections in order, so the result does not depend on which thread
+// runs which partition.
+
+template<typename Char_type>
+class Output_merge_string<Char_type>::Find_first_strings_job
+  : public Parallel_job
+{
+ public:
+  Find_first_strings_job(Merged_strings_lists* lists)
+    : lists_(lists)
+  { }
+
+  void
+  run_piece(unsigned int);
+
+ private:
+  Merged_strings_lists* lists_;
+};
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::Find_first_strings_job::run_piece(
+    unsigned int shard)
+{
+  typedef Unordered_set<const Saved_string*, Saved_string_hash,
+			Saved_string_eq> First_strings;
+  First_strings first_strings;
+
+  for (typename Merged_strings_lists::const_iterator l =
+	 this->lists_->begin();
+       l != this->lists_->end();
+       ++l)
+    {
+      Saved_strings& saved_strings((*l)->saved_strings);
+      for (unsigned int j = (*l)->shard_head[shard];
+	   j != -1U;
+	   j = saved_strings[j].shard_next)
+	{
+	  Saved_string* ss = &saved_strings[j];
+	  ss->first = *first_strings.insert(ss).first;
+	}
+    }
+}
+
+// Add the strings saved by do_add_input_section to the Stringpool.
+// The expensive parts, hashing the strings and finding the
+// duplicates, are done on several threads.  The unique strings are
+// then added to the Stringpool in the order in which they appear in
+// the input sections, so the Stringpool is the same as if they had
+// been added in do_add_input_section.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_saved_strings()
+{
+  if (this->merged_strings_lists_.empty()
+      || this->merged_strings_lists_.front()->contents == NULL)
+    return;
+
+  const unsigned int shard_count = parallel_thread_count() * 4;
+
+  Hash_strings_job hash_job(&this->merged_strings_lists_, shard_count);
+  run_in_parallel(&hash_job, this->merged_strings_lists_.size());
+
+  Find_first_strings_job find_job(&this->merged_strings_lists_);
+  run_in_parallel(&find_job, shard_count);
+
+  for (typename Merged_strings_lists::const_iterator l =
+	 this->merged_strings_lists_.begin();
+       l != this->merged_strings_lists_.end();
+       ++l)
+    {
+      Merged_strings& merged_strings((*l)->merged_strings);
+      Saved_strings& saved_strings((*l)->saved_strings);
+      for (typename Saved_strings::iterator p = saved_strings.begin();
+	   p != saved_strings.end();
+	   ++p)
+	{
+	  if (p->first == &*p)
+	    this->stringpool_.add_with_length_and_hash(p->string, p->length,
+						       p->hash_code,
+						       &p->stringpool_key);
+	  merged_strings.push_back(Merged_string(p->offset,
+						 p->first->stringpool_key));
+	}
+
+      // Record the last offset in the input section so that we can
+      // compute the length of the last string.
+      section_size_type i = (*l)->terminated_length * sizeof(Char_type);
+      if ((*l)->terminated_length < (*l)->contents_length)
+	i += ((*l)->contents_length - (*l)->terminated_length + 1)
+	      * sizeof(Char_type);
+      merged_strings.push_back(Merged_string(i, 0));
+    }
+
+  // The Stringpool has copied the strings.  The saved strings of an
+  // input section may be referred to by later input sections, so we
+  // can only free them all at the end.
+  for (typename Merged_strings_lists::const_iterator l =
+	 this->merged_strings_lists_.begin();
+       l != this->merged_strings_lists_.end();
+       ++l)
+    {
+      delete[] (*l)->contents;
+      (*l)->contents = NULL;
+      Saved_strings().swap((*l)->saved_strings);
+      std::vector<unsigned int>().swap((*l)->shard_head);
+    }
+}
+
 // Finalize the mappings from the input sections to the output
 // section, and return the final data size.
 
@@ -623,6 +815,7 @@ template<typename Char_type>
 section_size_type
 Output_merge_string<Char_type>::finalize_merged_data()
 {
+  this->add_saved_strings();
   this->stringpool_.set_string_offsets();
 
   for (typename Merged_strings_lists::const_iterator l =
@@ -542,6 +542,31 @@ class Output_merge_string : public Output_merge_base
 
   typedef std::vector<Merged_string> Merged_strings;
 
+  // When running with threads, the strings are not added to the
+  // Stringpool as the input sections are seen.  Instead a copy of
+  // each input section is saved, and finalize_merged_data splits the
+  // sections into strings and hashes them on several threads.  This
+  // is one of those strings.
+  struct Saved_string
+  {
+    // The string, in the saved copy of the input section.
+    const Char_type* string;
+    // The length of the string in characters.
+    size_t length;
+    // The hash code of the string.
+    size_t hash_code;
+    // The offset of the string in the input section.
+    section_offset_type offset;
+    // The first instance of the same string in any input section.
+    const Saved_string* first;
+    // If FIRST is this string, the key in the Stringpool.
+    Stringpool::Key stringpool_key;
+    // The index of the next string in the same partition, or -1U.
+    unsigned int shard_next;
+  };
+
+  typedef std::vector<Saved_string> Saved_strings;
+
   struct Merged_strings_list
   {
     // The input object where the strings were found.
@@ -550,14 +575,58 @@ class Output_merge_string : public Output_merge_base
     unsigned int shndx;
     // The list of merged strings.
     Merged_strings merged_strings;
+    // If the strings are hashed in finalize_merged_data, a copy of
+    // the section contents, the number of characters in the copy, and
+    // the number of characters up to the end of the last null
+    // terminated string.  Otherwise CONTENTS is NULL.
+    Char_type* contents;
+    size_t contents_length;
+    size_t terminated_length;
+    // The strings found in CONTENTS.
+    Saved_strings saved_strings;
+    // The index in SAVED_STRINGS of the first string in each
+    // partition, or -1U.  The rest of the partition is chained
+    // through Saved_string::shard_next, in input order.
+    std::vector<unsigned int> shard_head;
 
     Merged_strings_list(Relobj* objecta, unsigned int shndxa)
-      : object(objecta), shndx(shndxa), merged_strings()
+      : object(objecta), shndx(shndxa), merged_strings(), contents(NULL),
+	contents_length(0), terminated_length(0), saved_strings(),
+	shard_head()
     { }
+
+    ~Merged_strings_list()
+    { delete[] this->contents; }
   };
 
   typedef std::vector<Merged_strings_list*> Merged_strings_lists;
 
+  // Hash and equality functions for a table of Saved_string pointers.
+  struct Saved_string_hash
+  {
+    size_t
+    operator()(const Saved_string* ss) const
+    { return ss->hash_code; }
+  };
+
+  struct Saved_string_eq
+  {
+    bool
+    operator()(const Saved_string* ss1, const Saved_string* ss2) const
+    {
+      return (ss1->length == ss2->length
+	      && memcmp(ss1->string, ss2->string,
+			ss1->length * sizeof(Char_type)) == 0);
+    }
+  };
+
+  class Hash_strings_job;
+  class Find_first_strings_job;
+
+  // Add the strings saved by do_add_input_section to the Stringpool.
+  void
+  add_saved_strings();
+
   // As we see the strings, we add them to a Stringpool.
   Stringpool_template<Char_type> stringpool_;
   // Map from a location in an input object to an entry in the
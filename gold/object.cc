@@ -42,6 +42,7 @@
 #include "plugin.h"
 #include "compressed_output.h"
 #include "incremental.h"
+#include "ehframe.h"
 
 namespace gold
 {
@@ -429,6 +430,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     kept_comdat_sections_(),
     has_eh_frame_(false),
     discarded_eh_frame_shndx_(-1U),
+    parsed_eh_frame_(NULL),
     deferred_layout_(),
     deferred_layout_relocs_(),
     compressed_sections_()
@@ -439,6 +441,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
 template<int size, bool big_endian>
 Sized_relobj_file<size, big_endian>::~Sized_relobj_file()
 {
+  delete this->parsed_eh_frame_;
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -837,6 +840,99 @@ Sized_relobj_file<size, big_endian>::do_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+  if (this->has_eh_frame_)
+    this->parse_eh_frame_section(pshdrs, sd);
+}
+
+// Parse the .eh_frame section.  Doing this here, rather than when the
+// section is laid out, moves the work from the single Add_symbols
+// task chain into the Read_symbols tasks, which run in parallel.  The
+// result is merged into the output .eh_frame section by
+// layout_eh_frame_section.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::parse_eh_frame_section(
+    const unsigned char* pshdrs,
+    Read_symbols_data* sd)
+{
+  // There is nothing to gain when not using threads.  We are called
+  // again by do_layout_deferred_sections, after the section has been
+  // parsed.
+  if (!parameters->options().threads()
+      || parameters->options().relocatable()
+      || parameters->incremental()
+      || this->parsed_eh_frame_ != NULL
+      || !this->output_sections().empty())
+    return;
+
+  // Only handle the usual case of a single .eh_frame section.
+  const char* names =
+    reinterpret_cast<const char*>(sd->section_names->data());
+  const unsigned char* s = NULL;
+  unsigned int shndx = 0;
+  while (true)
+    {
+      s = this->template find_shdr<size, big_endian>(pshdrs, ".eh_frame",
+						     names,
+						     sd->section_names_size,
+						     s);
+      if (s == NULL)
+	break;
+      typename This::Shdr shdr(s);
+      if (!this->check_eh_frame_flags(&shdr))
+	continue;
+      if (shndx != 0)
+	return;
+      shndx = (s - pshdrs) / This::shdr_size;
+    }
+  if (shndx == 0)
+    return;
+
+  // Find the reloc section, as do_layout does.
+  const unsigned int shnum = this->shnum();
+  unsigned int reloc_shndx = 0;
+  unsigned int reloc_type = elfcpp::SHT_NULL;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if ((sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	  && this->adjust_shndx(shdr.get_sh_info()) == shndx)
+	{
+	  if (reloc_shndx != 0)
+	    reloc_shndx = -1U;
+	  else
+	    {
+	      reloc_shndx = i;
+	      reloc_type = sh_type;
+	    }
+	}
+    }
+
+  this->parsed_eh_frame_ =
+    Eh_frame::parse_ehframe_input_section(this,
+					  sd->symbols->data(),
+					  sd->symbols_size,
+					  sd->symbol_names->data(),
+					  sd->symbol_names_size,
+					  shndx, reloc_shndx, reloc_type);
+}
+
+// Return the parsed .eh_frame section SHNDX, if there is one.
+
+template<int size, bool big_endian>
+Parsed_eh_frame*
+Sized_relobj_file<size, big_endian>::release_parsed_eh_frame(
+    unsigned int shndx)
+{
+  Parsed_eh_frame* ret = this->parsed_eh_frame_;
+  if (ret == NULL || ret->shndx() != shndx)
+    return NULL;
+  this->parsed_eh_frame_ = NULL;
+  return ret;
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1220,6 +1316,11 @@ Sized_relobj_file<size, big_endian>::layout_eh_frame_section(
 					       reloc_shndx,
 					       reloc_type,
 					       &offset);
+
+  // If the section was parsed early but not merged, because it is
+  // being discarded, free the result now.
+  delete this->release_parsed_eh_frame(shndx);
+
   this->output_sections()[shndx] = os;
   if (os == NULL || offset == -1)
     {
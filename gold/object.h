@@ -48,6 +48,7 @@ class Pluginobj;
 class Dynobj;
 class Object_merge_map;
 class Relocatable_relocs;
+class Parsed_eh_frame;
 struct Symbols_data;
 
 template<typename Stringpool_char>
@@ -112,7 +113,11 @@ struct Symbol_location_info
 struct Section_relocs
 {
   Section_relocs()
-    : contents(NULL)
+    : reloc_shndx(0), data_shndx(0), contents(NULL), sh_type(0),
+      reloc_count(0), output_section(NULL),
+      needs_special_offset_handling(false),
+      is_data_section_allocated(false), is_prescanned(false),
+      deferred_relocs(), deferred_reloc_count(0)
   { }
 
   ~Section_relocs()
@@ -134,6 +139,14 @@ struct Section_relocs
   bool needs_special_offset_handling;
   // Whether the data section is allocated (has the SHF_ALLOC flag set).
   bool is_data_section_allocated;
+  // Whether the relocs were prescanned.  If this is true, CONTENTS
+  // has been released, and scan_relocs only needs to see the relocs
+  // in DEFERRED_RELOCS.
+  bool is_prescanned;
+  // The relocs which survived the prescan, in their original order.
+  std::vector<unsigned char> deferred_relocs;
+  // Number of reloc entries in DEFERRED_RELOCS.
+  size_t deferred_reloc_count;
 };
 
 // Relocations in an object file.  This is read in read_relocs and
@@ -1058,6 +1071,13 @@ class Relobj : public Object
   read_relocs(Read_relocs_data* rd)
   { return this->do_read_relocs(rd); }
 
+  // Drop the relocs which scan_relocs does not need to see.  This
+  // runs in parallel for different objects, before any of them are
+  // scanned.
+  void
+  prescan_relocs(Read_relocs_data* rd)
+  { this->do_prescan_relocs(rd); }
+
   // Process the relocs, during garbage collection only.
   void
   gc_process_relocs(Symbol_table* symtab, Layout* layout, Read_relocs_data* rd)
@@ -1266,6 +1286,12 @@ class Relobj : public Object
   virtual void
   do_read_relocs(Read_relocs_data*) = 0;
 
+  // Prescan the relocs--may be implemented by child class.  By
+  // default scan_relocs sees all the relocs.
+  virtual void
+  do_prescan_relocs(Read_relocs_data*)
+  { }
+
   // Process the relocs--implemented by child class.
   virtual void
   do_gc_process_relocs(Symbol_table*, Layout*, Read_relocs_data*) = 0;
@@ -2187,6 +2213,12 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   Address
   map_to_kept_section(unsigned int shndx, bool* found) const;
 
+  // If the .eh_frame section SHNDX was parsed while reading symbols,
+  // return the result and give up ownership of it.  Otherwise return
+  // NULL.
+  Parsed_eh_frame*
+  release_parsed_eh_frame(unsigned int shndx);
+
   // Compute final local symbol value.  R_SYM is the local symbol index.
   // LV_IN points to a local symbol value containing the input value.
   // LV_OUT points to a local symbol value storing the final output value,
@@ -2274,6 +2306,10 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_read_relocs(Read_relocs_data*);
 
+  // Drop the relocs which the target does not need to scan.
+  void
+  do_prescan_relocs(Read_relocs_data*);
+
   // Process the relocs to find list of referenced sections. Used only
   // during garbage collection.
   void
@@ -2531,6 +2567,10 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
                  const typename This::Shdr& shdr, unsigned int reloc_shndx,
                  unsigned int reloc_type);
 
+  // Parse the .eh_frame section while reading symbols.
+  void
+  parse_eh_frame_section(const unsigned char* pshdrs, Read_symbols_data*);
+
   // Layout an input .eh_frame section.
   void
   layout_eh_frame_section(Layout* layout, const unsigned char* symbols_data,
@@ -2736,6 +2776,9 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   // If this object has a GNU style .eh_frame section that is discarded in
   // output, record the index here.  Otherwise it is -1U.
   unsigned int discarded_eh_frame_shndx_;
+  // The .eh_frame section, if it was parsed while reading symbols and
+  // has not been laid out yet.
+  Parsed_eh_frame* parsed_eh_frame_;
   // The list of sections whose layout was deferred.
   std::vector<Deferred_layout> deferred_layout_;
   // The list of relocation sections whose layout was deferred.
@@ -1242,6 +1242,33 @@ General_options::finalize()
     gold_fatal(_("Options --incremental-changed, --incremental-unchanged, "
 		 "--incremental-unknown require the use of --incremental"));
 
+  if (this->user_set_incremental_server()
+      && this->incremental_mode_ != INCREMENTAL_AUTO
+      && this->incremental_mode_ != INCREMENTAL_UPDATE)
+    gold_fatal(_("Option --incremental-server requires the use of "
+		 "--incremental or --incremental-update"));
+
+  if (this->user_set_call_graph_profile()
+      && this->user_set_section_ordering_file())
+    gold_fatal(_("--call-graph-profile may not be used with "
+		 "--section-ordering-file"));
+  if (this->print_order() && !this->user_set_call_graph_profile())
+    gold_fatal(_("--print-order requires --call-graph-profile"));
+
+  if (this->hugepage_text())
+    {
+      if (this->hugepage_size() == 0
+	  || (this->hugepage_size() & (this->hugepage_size() - 1)) != 0)
+	gold_fatal(_("--hugepage-size must be a power of 2"));
+      if (this->relocatable())
+	gold_fatal(_("--hugepage-text may not be used with -r"));
+      if (!this->user_set_section_ordering_file()
+	  && !this->user_set_call_graph_profile()
+	  && !this->has_plugins())
+	gold_warning(_("--hugepage-text has no effect without "
+		       "--section-ordering-file or --call-graph-profile"));
+    }
+
   // Check for options that are not compatible with incremental linking.
   // Where an option can be disabled without seriously changing the semantics
   // of the link, we turn the option off; otherwise, we issue a fatal error.
@@ -1265,6 +1292,29 @@ General_options::finalize()
 	  gold_warning(_("ignoring --icf for an incremental link"));
 	  this->set_icf_status(ICF_NONE);
 	}
+      if (this->user_set_call_graph_profile())
+	{
+	  gold_warning(_("ignoring --call-graph-profile for an "
+			 "incremental link"));
+	  this->set_call_graph_profile(NULL);
+	  this->set_print_order(false);
+	}
+      if (this->hugepage_text())
+	{
+	  gold_warning(_("ignoring --hugepage-text for an incremental link"));
+	  this->set_hugepage_text(false);
+	}
+      if (this->stream_output())
+	{
+	  gold_warning(_("ignoring --stream-output for an incremental link"));
+	  this->set_stream_output(false);
+	}
+      if (this->pack_relative_relocs())
+	{
+	  gold_warning(_("ignoring -z pack-relative-relocs for an "
+			 "incremental link"));
+	  this->set_pack_relative_relocs(false);
+	}
       if (strcmp(this->compress_debug_sections(), "none") != 0)
 	{
 	  gold_warning(_("ignoring --compress-debug-sections for an "
@@ -707,6 +707,12 @@ class General_options
 	      N_("[none]"),
 	      {"none"});
 #endif
+  DEFINE_uint64(compress_debug_sections_chunk_size, options::TWO_DASHES,
+		'\0', 0,
+		N_("Compress sections in independent pieces of SIZE bytes, "
+		   "which may be compressed in parallel (default 0, "
+		   "for a single piece)"),
+		N_("SIZE"));
 
   DEFINE_bool(copy_dt_needed_entries, options::TWO_DASHES, '\0', false,
 	      N_("Not supported"),
@@ -852,6 +858,16 @@ class General_options
   DEFINE_string(dynamic_linker, options::TWO_DASHES, 'I', NULL,
 		N_("Set dynamic linker path"), N_("PROGRAM"));
 
+  DEFINE_bool(hugepage_text, options::TWO_DASHES, '\0', false,
+	      N_("Align the hot executable input sections named by "
+		 "--section-ordering-file or --call-graph-profile to huge "
+		 "pages"),
+	      N_("Do not align hot text to huge pages (default)"));
+  DEFINE_uint64(hugepage_size, options::TWO_DASHES, '\0', 0x200000,
+		N_("Set the huge page size for --hugepage-text "
+		   "(default 0x200000)"),
+		N_("SIZE"));
+
   DEFINE_special(incremental, options::TWO_DASHES, '\0',
 		 N_("Do an incremental link if possible; "
 		    "otherwise, do a full link and prepare output "
@@ -889,9 +905,19 @@ class General_options
 		 N_("Amount of extra space to allocate for patches"),
 		 N_("PERCENT"));
 
+  DEFINE_string(incremental_server, options::TWO_DASHES, '\0', NULL,
+		N_("Wait for link requests on local socket FILE, and "
+		   "relink incrementally for each one"),
+		N_("FILE"));
+
   DEFINE_string(init, options::ONE_DASH, '\0', "_init",
 		N_("Call SYMBOL at load-time"), N_("SYMBOL"));
 
+  DEFINE_string(input_cache, options::TWO_DASHES, '\0', NULL,
+		N_("Cache the symbols defined by --start-lib objects in DIR "
+		   "(created if needed; old entries are never removed)"),
+		N_("DIR"));
+
   DEFINE_special(just_symbols, options::TWO_DASHES, '\0',
 		 N_("Read only symbol values from FILE"), N_("FILE"));
 
@@ -938,6 +964,16 @@ class General_options
 	      N_("Map the output file for writing (default)."),
 	      N_("Do not map the output file for writing."));
 
+  DEFINE_bool(stream_output, options::TWO_DASHES, '\0', false,
+	      N_("Write the output file through bounded buffers rather "
+		 "than mapping all of it"),
+	      N_("Map the output file, or buffer all of it (default)"));
+  DEFINE_uint64(stream_output_buffer_size, options::TWO_DASHES, '\0',
+		64 * 1024 * 1024,
+		N_("Write out the buffers queued by --stream-output when they "
+		   "exceed SIZE bytes (default 64MiB)"),
+		N_("SIZE"));
+
   DEFINE_bool(print_map, options::TWO_DASHES, 'M', false,
 	      N_("Write map file on standard output"), NULL);
   DEFINE_string(Map, options::ONE_DASH, '\0', NULL, N_("Write map file"),
@@ -1048,6 +1084,10 @@ class General_options
   DEFINE_string(section_ordering_file, options::TWO_DASHES, '\0', NULL,
 		N_("Layout sections in the order specified."),
 		N_("FILENAME"));
+  DEFINE_string(call_graph_profile, options::TWO_DASHES, '\0', NULL,
+		N_("Order functions to place callers near their callees, "
+		   "using the call counts in FILENAME"),
+		N_("FILENAME"));
 
   DEFINE_special(section_start, options::TWO_DASHES, '\0',
 		 N_("Set address of section"), N_("SECTION=ADDRESS"));
@@ -1128,6 +1168,9 @@ class General_options
   DEFINE_bool(print_gc_sections, options::TWO_DASHES, '\0', false,
 	      N_("List removed unused sections on stderr"),
 	      N_("Do not list removed unused sections"));
+  DEFINE_bool(print_order, options::TWO_DASHES, '\0', false,
+	      N_("List the order chosen from --call-graph-profile on stderr"),
+	      N_("Do not list the order chosen from --call-graph-profile"));
 
   DEFINE_bool(stats, options::TWO_DASHES, '\0', false,
 	      N_("Print resource usage statistics"), NULL);
@@ -1137,6 +1180,10 @@ class General_options
 
   DEFINE_bool(trace, options::TWO_DASHES, 't', false,
 	      N_("Print the name of each input file"), NULL);
+  DEFINE_string(trace_tasks, options::TWO_DASHES, '\0', NULL,
+		N_("Write a trace of the tasks run to FILE, in the "
+		   "Chrome trace event format"),
+		N_("FILE"));
 
   DEFINE_special(script, options::TWO_DASHES, 'T',
 		 N_("Read linker script"), N_("FILE"));
@@ -1313,6 +1360,9 @@ class General_options
   DEFINE_bool(origin, options::DASH_Z, '\0', false,
 	      N_("Mark DSO to indicate that needs immediate $ORIGIN "
 		 "processing at runtime"), NULL);
+  DEFINE_bool(pack_relative_relocs, options::DASH_Z, '\0', false,
+	      N_("Pack relative relocations into a DT_RELR section"),
+	      N_("Do not pack relative relocations (default)"));
   DEFINE_bool(relro, options::DASH_Z, '\0', false,
 	      N_("Where possible mark variables read-only after relocation"),
 	      N_("Don't mark variables read-only after relocation"));
@@ -1389,6 +1439,15 @@ class General_options
   bool
   is_in_system_directory(const std::string& name) const;
 
+  // Set --threads and --thread-count.  This is for programs other
+  // than the linker which use libgold, such as dwp.
+  void
+  set_thread_options(bool threads, int thread_count)
+  {
+    this->set_threads(threads);
+    this->set_thread_count(thread_count);
+  }
+
   // RETURN whether SYMBOL_NAME should be kept, according to symbols_to_retain_.
   bool
   should_retain_symbol(const char* symbol_name) const
@@ -1288,6 +1288,152 @@ Output_data_reloc_base<sh_type, dynamic, size, big_endian>::do_write(
   this->relocs_.clear();
 }
 
+// Class Output_data_relr.
+
+// Return the output address of a relocated word.
+
+template<int size, bool big_endian>
+typename Output_data_relr<size, big_endian>::Address
+Output_data_relr<size, big_endian>::Relr_reloc::output_address() const
+{
+  if (this->relobj == NULL)
+    return this->od->address() + this->address;
+
+  Output_section* os = this->relobj->output_section(this->shndx);
+  gold_assert(os != NULL);
+  Address off = this->relobj->get_output_section_offset(this->shndx);
+  if (off != invalid_address)
+    return os->address() + off + this->address;
+
+  Sized_relobj_file<size, big_endian>* relobj =
+    this->relobj->sized_relobj();
+  gold_assert(relobj != NULL);
+  Address ret = os->output_address(relobj, this->shndx, this->address);
+  gold_assert(ret != invalid_address);
+  return ret;
+}
+
+// Encode the relocations into WORDS, using the current addresses.
+// If REPORT_ERRORS is true, report words which can not be encoded.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::encode(std::vector<Address>* words,
+					   bool report_errors) const
+{
+  std::vector<Address> addresses;
+  addresses.reserve(this->relocs_.size());
+  for (typename Relocs::const_iterator p = this->relocs_.begin();
+       p != this->relocs_.end();
+       ++p)
+    addresses.push_back(p->output_address());
+  std::sort(addresses.begin(), addresses.end());
+  addresses.erase(std::unique(addresses.begin(), addresses.end()),
+		  addresses.end());
+
+  // Each bitmap covers SIZE - 1 words.
+  const Address bitmap_span = (size - 1) * word_size;
+
+  words->clear();
+  typename std::vector<Address>::const_iterator p = addresses.begin();
+  while (p != addresses.end())
+    {
+      // We only pack relocs for words at even offsets in sections
+      // which are at least 2-byte aligned, so this can only happen
+      // if the layout is broken.
+      if ((*p & 1) != 0)
+	{
+	  if (report_errors)
+	    gold_error(_("can not pack relative reloc at odd address %#llx"),
+		       static_cast<unsigned long long>(*p));
+	  ++p;
+	  continue;
+	}
+
+      words->push_back(*p);
+      Address base = *p + word_size;
+      ++p;
+
+      while (true)
+	{
+	  Address bitmap = 0;
+	  while (p != addresses.end()
+		 && *p >= base
+		 && *p < base + bitmap_span
+		 && (*p - base) % word_size == 0)
+	    {
+	      bitmap |= static_cast<Address>(1) << ((*p - base) / word_size);
+	      ++p;
+	    }
+	  if (bitmap == 0)
+	    break;
+	  words->push_back((bitmap << 1) | 1);
+	  base += bitmap_span;
+	}
+    }
+}
+
+// Encode the relocations and grow the section if necessary.  Return
+// true if the size changed.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::update_packed_size()
+{
+  std::vector<Address> words;
+  this->encode(&words, false);
+  off_t new_size = words.size() * word_size;
+  if (new_size <= this->current_data_size())
+    return false;
+
+  this->reset_address_and_file_offset();
+  this->set_current_data_size(new_size);
+  this->finalize_data_size();
+  this->output_section()->set_section_offsets_need_adjustment();
+  return true;
+}
+
+// Set the entry size of the output section.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_adjust_output_section(
+    Output_section* os)
+{
+  os->set_entsize(word_size);
+}
+
+// Write out the packed relocations.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_write(Output_file* of)
+{
+  const off_t off = this->offset();
+  const section_size_type oview_size =
+    convert_to_section_size_type(this->data_size());
+  unsigned char* const oview = of->get_output_view(off, oview_size);
+
+  std::vector<Address> words;
+  this->encode(&words, true);
+  gold_assert(words.size() * word_size <= oview_size);
+
+  // Fill any space left over from an earlier, larger encoding with
+  // empty bitmaps, which the dynamic linker skips.
+  unsigned char* pov = oview;
+  for (typename std::vector<Address>::const_iterator p = words.begin();
+       p != words.end();
+       ++p, pov += word_size)
+    elfcpp::Swap<size, big_endian>::writeval(pov, *p);
+  for (; pov < oview + oview_size; pov += word_size)
+    elfcpp::Swap<size, big_endian>::writeval(pov, 1);
+
+  of->write_output_view(off, oview_size, oview);
+
+  // We no longer need the relocations.
+  this->relocs_.clear();
+}
+
 // Class Output_relocatable_relocs.
 
 template<int sh_type, int size, bool big_endian>
@@ -2314,7 +2460,10 @@ Output_section::Output_section(const char* name, elfcpp::Elf_Word type,
     lookup_maps_(new Output_section_lookup_maps),
     free_list_(),
     free_space_fill_(NULL),
-    patch_space_(0)
+    patch_space_(0),
+    hugepage_size_(0),
+    hot_text_start_(0),
+    hot_text_end_(0)
 {
   // An unallocated section has no address.  Forcing this means that
   // we don't need special treatment for symbols defined in debug
@@ -2450,7 +2599,8 @@ Output_section::add_input_section(Layout* layout,
       && (sh_flags & elfcpp::SHF_EXECINSTR) != 0
       && parameters->target().has_code_fill()
       && (parameters->target().may_relax()
-	  || layout->is_section_ordering_specified()))
+	  || layout->is_section_ordering_specified()
+	  || parameters->options().call_graph_profile()))
     {
       gold_assert(this->fills_.empty());
       this->generate_code_fills_at_write_ = true;
@@ -2480,8 +2630,8 @@ Output_section::add_input_section(Layout* layout,
   // track of sections, or if we are relaxing.  Also, if this is a
   // section which requires sorting, or which may require sorting in
   // the future, we keep track of the sections.  If the
-  // --section-ordering-file option is used to specify the order of
-  // sections, we need to keep track of sections.
+  // --section-ordering-file or --call-graph-profile option is used to
+  // specify the order of sections, we need to keep track of sections.
   if (this->always_keeps_input_sections_
       || have_sections_script
       || !this->input_sections_.empty()
@@ -2489,7 +2639,8 @@ Output_section::add_input_section(Layout* layout,
       || this->must_sort_attached_input_sections()
       || parameters->options().user_set_Map()
       || parameters->target().may_relax()
-      || layout->is_section_ordering_specified())
+      || layout->is_section_ordering_specified()
+      || parameters->options().call_graph_profile())
     {
       Input_section isecn(object, shndx, input_section_size, addralign);
       /* If section ordering is requested by specifying a ordering file,
@@ -3105,6 +3256,36 @@ Output_section::set_final_data_size()
 	  || this->input_section_order_specified())
 	this->sort_attached_input_sections();
 
+      // For --hugepage-text, start the hot input sections, and the
+      // input section which follows them, on a huge page boundary.
+      // Doing this through the alignment of the input sections means
+      // that the gaps get code fill when we write the section.
+      Input_section_list::iterator first_hot = this->input_sections_.end();
+      Input_section_list::iterator last_hot = this->input_sections_.end();
+      if (this->hugepage_size_ != 0)
+	{
+	  for (Input_section_list::iterator p = this->input_sections_.begin();
+	       p != this->input_sections_.end();
+	       ++p)
+	    {
+	      if (p->section_order_index() == 0)
+		continue;
+	      if (first_hot == this->input_sections_.end())
+		first_hot = p;
+	      last_hot = p;
+	    }
+	  if (first_hot != this->input_sections_.end())
+	    {
+	      if (first_hot->addralign() < this->hugepage_size_)
+		first_hot->set_addralign(this->hugepage_size_);
+	      Input_section_list::iterator next = last_hot;
+	      ++next;
+	      if (next != this->input_sections_.end()
+		  && next->addralign() < this->hugepage_size_)
+		next->set_addralign(this->hugepage_size_);
+	    }
+	}
+
       uint64_t address = this->address();
       off_t startoff = this->offset();
       off_t off = startoff + this->first_input_offset_;
@@ -3115,7 +3296,22 @@ Output_section::set_final_data_size()
 	  off = align_address(off, p->addralign());
 	  p->set_address_and_file_offset(address + (off - startoff), off,
 					 startoff);
+	  if (p == first_hot)
+	    this->hot_text_start_ = off - startoff;
 	  off += p->data_size();
+	  if (p == last_hot)
+	    this->hot_text_end_ = off - startoff;
+	}
+
+      // If the hot input sections come last, pad the section out to
+      // a huge page boundary, so that the hot text does not share a
+      // huge page with the following output section.
+      if (last_hot != this->input_sections_.end())
+	{
+	  Input_section_list::iterator next = last_hot;
+	  ++next;
+	  if (next == this->input_sections_.end())
+	    off = align_address(off, this->hugepage_size_);
 	}
       data_size = off - startoff;
     }
@@ -3492,7 +3688,9 @@ Output_section::Input_section_sort_section_order_index_compare::operator()(
 
 // Return true if S1 should come before S2.  This is the sort comparison
 // function for .text to sort sections with prefixes
-// .text.{unlikely,exit,startup,hot} before other sections.
+// .text.{unlikely,exit,startup,hot} before other sections.  Within
+// each group, sections are ordered by their section order index, as
+// set by --call-graph-profile.
 
 bool
 Output_section::Input_section_sort_section_prefix_special_ordering_compare
@@ -3523,6 +3721,11 @@ Output_section::Input_section_sort_section_prefix_special_ordering_compare
 	return o1 < o2;
     }
 
+  unsigned int s1_secn_index = s1.input_section().section_order_index();
+  unsigned int s2_secn_index = s2.input_section().section_order_index();
+  if (s1_secn_index != s2_secn_index)
+    return s1_secn_index < s2_secn_index;
+
   // Keep input order otherwise.
   return s1.index() < s2.index();
 }
@@ -3738,6 +3941,17 @@ Output_section::do_write(Output_file* of)
       off = aligned_off + p->data_size();
     }
 
+  // Fill the padding which --hugepage-text added after the last
+  // input section.
+  off_t end = this->offset() + this->data_size();
+  if (this->hugepage_size_ != 0
+      && this->generate_code_fills_at_write_
+      && off < end)
+    {
+      std::string fill_data(parameters->target().code_fill(end - off));
+      of->write(off, fill_data.data(), fill_data.size());
+    }
+
   // For incremental links, fill in unused chunks in debug sections
   // with dummy compilation unit headers.
   if (this->free_space_fill_ != NULL)
@@ -4055,6 +4269,36 @@ Output_section::print_merge_stats()
     p->print_merge_stats(this->name_);
 }
 
+// Print the placement of the hot text for --hugepage-text to stderr.
+
+void
+Output_section::print_hugepage_stats() const
+{
+  if (this->hugepage_size_ == 0)
+    return;
+
+  if (this->hot_text_end_ <= this->hot_text_start_)
+    {
+      fprintf(stderr, _("%s: %s: no hot text to align to huge pages\n"),
+	      program_name, this->name_);
+      return;
+    }
+
+  uint64_t start = this->address() + this->hot_text_start_;
+  uint64_t end = this->address() + this->hot_text_end_;
+  uint64_t pages = ((align_address(end, this->hugepage_size_)
+		     - (start & ~(this->hugepage_size_ - 1)))
+		    / this->hugepage_size_);
+  fprintf(stderr, _("%s: %s: hot text 0x%llx-0x%llx (%llu bytes) spans "
+		    "%llu huge pages of %llu bytes\n"),
+	  program_name, this->name_,
+	  static_cast<unsigned long long>(start),
+	  static_cast<unsigned long long>(end),
+	  static_cast<unsigned long long>(end - start),
+	  static_cast<unsigned long long>(pages),
+	  static_cast<unsigned long long>(this->hugepage_size_));
+}
+
 // Set a fixed layout for the section.  Used for incremental update links.
 
 void
@@ -4206,6 +4450,28 @@ Output_segment::has_any_data_sections() const
   return false;
 }
 
+// Return the largest huge page size of the output sections in this
+// segment for --hugepage-text, or zero if there is none.
+
+uint64_t
+Output_segment::hugepage_size() const
+{
+  uint64_t ret = 0;
+  for (int i = 0; i < static_cast<int>(ORDER_MAX); ++i)
+    {
+      const Output_data_list* pdl = &this->output_lists_[i];
+      for (Output_data_list::const_iterator p = pdl->begin();
+	   p != pdl->end();
+	   ++p)
+	{
+	  if ((*p)->is_section()
+	      && (*p)->output_section()->hugepage_size() > ret)
+	    ret = (*p)->output_section()->hugepage_size();
+	}
+    }
+  return ret;
+}
+
 // Return whether the first data section (not counting TLS sections)
 // is a relro section.
 
@@ -4939,7 +5205,13 @@ Output_file::Output_file(const char* name)
     base_(NULL),
     map_is_anonymous_(false),
     map_is_allocated_(false),
-    is_temporary_(false)
+    is_temporary_(false),
+    is_streaming_(false),
+    stream_buffers_(),
+    stream_buffered_size_(0),
+    stream_buffer_limit_(0),
+    stream_lock_(NULL),
+    stream_flush_lock_(NULL)
 {
 }
 
@@ -5089,6 +5361,11 @@ Output_file::open(off_t file_size)
 	}
     }
 
+  if (parameters->options().stream_output()
+      && !this->is_temporary_
+      && this->open_for_streaming())
+    return;
+
   this->map();
 }
 
@@ -5097,6 +5374,22 @@ Output_file::open(off_t file_size)
 void
 Output_file::resize(off_t file_size)
 {
+  if (this->is_streaming_)
+    {
+      this->stream_flush();
+      if (::ftruncate(this->o_, file_size) < 0)
+	gold_fatal(_("%s: ftruncate: %s"), this->name_, strerror(errno));
+      if (file_size > this->file_size_)
+	{
+	  int err = gold_fallocate(this->o_, this->file_size_,
+				   file_size - this->file_size_);
+	  if (err != 0)
+	    gold_fatal(_("%s: %s"), this->name_, strerror(err));
+	}
+      this->file_size_ = file_size;
+      return;
+    }
+
   // If the mmap is mapping an anonymous memory buffer, this is easy:
   // just mremap to the new size.  If it's mapping to a file, we want
   // to unmap to flush to the file, then remap after growing the file.
@@ -5224,6 +5517,217 @@ Output_file::map()
 	     strerror(errno));
 }
 
+// Statistics for --stream-output.
+
+unsigned long long Output_file::stream_flushes;
+unsigned long long Output_file::stream_written_bytes;
+unsigned long long Output_file::maximum_stream_buffered_bytes;
+
+// Set up the output file to be written with pwrite rather than
+// mapped, for --stream-output.  This only works for a regular file.
+
+bool
+Output_file::open_for_streaming()
+{
+  const int o = this->o_;
+  struct stat statbuf;
+  if (o == STDOUT_FILENO || o == STDERR_FILENO
+      || ::fstat(o, &statbuf) != 0
+      || !S_ISREG(statbuf.st_mode))
+    return false;
+
+  // Reserve the disk space now, as map_no_anonymous does.
+  int err = gold_fallocate(o, 0, this->file_size_);
+  if (err != 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(err));
+
+  this->is_streaming_ = true;
+  this->stream_buffer_limit_ =
+    parameters->options().stream_output_buffer_size();
+  this->stream_lock_ = new Lock();
+  this->stream_flush_lock_ = new Lock();
+  return true;
+}
+
+// Copy LEN bytes of DATA into a buffer queued to be written at
+// OFFSET.
+
+void
+Output_file::stream_write(off_t offset, const void* data, size_t len)
+{
+  gold_assert(offset >= 0
+	      && offset + static_cast<off_t>(len) <= this->file_size_);
+  if (len == 0)
+    return;
+  unsigned char* buf = new unsigned char[len];
+  memcpy(buf, data, len);
+  this->stream_queue(offset, len, buf);
+}
+
+// Return a buffer for an output view.  The buffer is cleared, since
+// the code which writes a view may skip bytes which should be zero,
+// as they would be in a newly created file.
+
+unsigned char*
+Output_file::stream_get_output_view(size_t size)
+{
+  unsigned char* buf = new unsigned char[size];
+  memset(buf, 0, size);
+  return buf;
+}
+
+// Return a buffer holding SIZE bytes read from the file at START.  We
+// first write out any queued buffers, so that we read what has been
+// written so far.  If FOR_OUTPUT is true, this is an input/output
+// view, and we keep a copy of the original contents after the
+// buffer.  Two tasks may modify different parts of the same range
+// through input/output views at the same time; by writing back only
+// the bytes which changed, neither task overwrites the changes made
+// by the other.
+
+unsigned char*
+Output_file::stream_get_input_view(off_t start, size_t size, bool for_output)
+{
+  gold_assert(start >= 0
+	      && start + static_cast<off_t>(size) <= this->file_size_);
+  this->stream_flush();
+
+  unsigned char* buf = new unsigned char[for_output ? size * 2 : size];
+  size_t done = 0;
+  while (done < size)
+    {
+      ssize_t bytes = ::pread(this->o_, buf + done, size - done,
+			      start + done);
+      if (bytes < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  gold_fatal(_("%s: pread: %s"), this->name_, strerror(errno));
+	}
+      if (bytes == 0)
+	{
+	  // The file is allocated to its full size, so this can only
+	  // happen if it was truncated behind our back.
+	  memset(buf + done, 0, size - done);
+	  break;
+	}
+      done += bytes;
+    }
+
+  if (for_output)
+    memcpy(buf + size, buf, size);
+  return buf;
+}
+
+// Queue the bytes of an input/output view which differ from the
+// original contents saved by stream_get_input_view to be written, and
+// free the view.
+
+void
+Output_file::stream_write_input_output_view(off_t start, size_t size,
+					    unsigned char* view)
+{
+  const unsigned char* orig = view + size;
+  size_t i = 0;
+  while (i < size)
+    {
+      if (view[i] == orig[i])
+	{
+	  ++i;
+	  continue;
+	}
+      size_t j = i + 1;
+      while (j < size && view[j] != orig[j])
+	++j;
+      this->stream_write(start + i, view + i, j - i);
+      i = j;
+    }
+  delete[] view;
+}
+
+// Queue SIZE bytes in BUF to be written at START, taking ownership of
+// BUF.  If that takes us over the buffer limit, write out everything
+// which is queued.
+
+void
+Output_file::stream_queue(off_t start, size_t size, unsigned char* buf)
+{
+  bool flush;
+  {
+    Hold_lock hl(*this->stream_lock_);
+    this->stream_buffers_.push_back(Stream_buffer(start, size, buf));
+    this->stream_buffered_size_ += size;
+    if (this->stream_buffered_size_ > Output_file::maximum_stream_buffered_bytes)
+      Output_file::maximum_stream_buffered_bytes = this->stream_buffered_size_;
+    flush = this->stream_buffered_size_ > this->stream_buffer_limit_;
+  }
+  if (flush)
+    this->stream_flush();
+}
+
+// Write all the queued buffers to the file, in file offset order.  We
+// hold stream_flush_lock_ while writing, so that if several threads
+// flush at once, the buffers are written in the order in which they
+// were queued.
+
+void
+Output_file::stream_flush()
+{
+  Hold_lock hlf(*this->stream_flush_lock_);
+
+  Stream_buffers buffers;
+  {
+    Hold_lock hl(*this->stream_lock_);
+    buffers.swap(this->stream_buffers_);
+    this->stream_buffered_size_ = 0;
+  }
+  if (buffers.empty())
+    return;
+  ++Output_file::stream_flushes;
+
+  // A stable sort keeps a later write to the same offset after an
+  // earlier one.
+  std::stable_sort(buffers.begin(), buffers.end(), Stream_buffer_compare());
+
+  for (Stream_buffers::iterator p = buffers.begin();
+       p != buffers.end();
+       ++p)
+    {
+      size_t done = 0;
+      while (done < p->size)
+	{
+	  ssize_t bytes = ::pwrite(this->o_, p->data + done, p->size - done,
+				   p->offset + done);
+	  if (bytes < 0)
+	    {
+	      if (errno == EINTR)
+		continue;
+	      gold_fatal(_("%s: pwrite: %s"), this->name_, strerror(errno));
+	    }
+	  if (bytes == 0)
+	    gold_fatal(_("%s: pwrite: unexpected 0 return-value"), this->name_);
+	  done += bytes;
+	}
+      Output_file::stream_written_bytes += p->size;
+      delete[] p->data;
+    }
+}
+
+// Print statistics about --stream-output to stderr.
+
+void
+Output_file::print_stats()
+{
+  if (Output_file::stream_flushes == 0)
+    return;
+  fprintf(stderr, _("%s: output bytes written by --stream-output: %llu\n"),
+	  program_name, Output_file::stream_written_bytes);
+  fprintf(stderr, _("%s: output buffer flushes: %llu\n"),
+	  program_name, Output_file::stream_flushes);
+  fprintf(stderr, _("%s: maximum bytes queued for output: %llu\n"),
+	  program_name, Output_file::maximum_stream_buffered_bytes);
+}
+
 // Unmap the file from memory.
 
 void
@@ -5247,6 +5751,20 @@ Output_file::unmap()
 void
 Output_file::close()
 {
+  if (this->is_streaming_)
+    {
+      this->stream_flush();
+      delete this->stream_lock_;
+      delete this->stream_flush_lock_;
+      this->stream_lock_ = NULL;
+      this->stream_flush_lock_ = NULL;
+      this->is_streaming_ = false;
+      if (::close(this->o_) < 0)
+	gold_error(_("%s: close: %s"), this->name_, strerror(errno));
+      this->o_ = -1;
+      return;
+    }
+
   // If the map isn't file-backed, we need to write it now.
   if (this->map_is_anonymous_ && !this->is_temporary_)
     {
@@ -5493,6 +6011,26 @@ template
 class Output_data_reloc<elfcpp::SHT_RELA, true, 64, true>;
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+class Output_data_relr<32, false>;
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+class Output_data_relr<32, true>;
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+class Output_data_relr<64, false>;
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+class Output_data_relr<64, true>;
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 class Output_relocatable_relocs<elfcpp::SHT_REL, 32, false>;
@@ -2187,6 +2187,114 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   }
 };
 
+// Output_data_relr holds the relative relocations which we pack into
+// a SHT_RELR section for -z pack-relative-relocs.  The section is a
+// sequence of words.  A word with the low bit clear is the address of
+// a word to relocate.  A word with the low bit set is a bitmap of the
+// SIZE - 1 words which follow the words covered by the previous entry:
+// if bit N is set, the word N - 1 words past the start of that range
+// is to be relocated.  The dynamic linker adds the load address to
+// each word, so this may only be used for a word which holds its
+// link-time value.
+
+// The size of the section depends on the addresses of the relocated
+// words, so the target must call update_packed_size after the sections
+// have been laid out, and lay them out again if the size changed.
+
+template<int size, bool big_endian>
+class Output_data_relr : public Output_section_data_build
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+  static const Address invalid_address = static_cast<Address>(0) - 1;
+  static const int word_size = size / 8;
+
+  Output_data_relr()
+    : Output_section_data_build(Output_data::default_alignment_for_size(size)),
+      relocs_()
+  { }
+
+  // Add a relative relocation for the word at offset ADDRESS within
+  // OD.
+  void
+  add_relative(Output_data* od, Address address)
+  { this->add(od, Relr_reloc(od, NULL, 0, address)); }
+
+  // Add a relative relocation for the word at offset ADDRESS within
+  // section SHNDX of RELOBJ.  OD is the associated output section.
+  void
+  add_relative(Output_data* od, Sized_relobj<size, big_endian>* relobj,
+	       unsigned int shndx, Address address)
+  { this->add(od, Relr_reloc(NULL, relobj, shndx, address)); }
+
+  // Return the number of relocations.
+  size_t
+  reloc_count() const
+  { return this->relocs_.size(); }
+
+  // Encode the relocations using the current addresses, and grow the
+  // section if the encoding does not fit.  We never shrink the
+  // section, so that repeated layouts converge; unused words are
+  // written as empty bitmaps.  Return true if the size changed.
+  bool
+  update_packed_size();
+
+ protected:
+  // Write out the data.
+  void
+  do_write(Output_file*);
+
+  // Set the entry size.
+  void
+  do_adjust_output_section(Output_section* os);
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** packed dynamic relocs")); }
+
+ private:
+  // A relocated word.  If RELOBJ is not NULL, the word is at offset
+  // ADDRESS within section SHNDX of RELOBJ.  Otherwise it is at offset
+  // ADDRESS within OD.
+  struct Relr_reloc
+  {
+    Relr_reloc(Output_data* a_od, Sized_relobj<size, big_endian>* a_relobj,
+	       unsigned int a_shndx, Address a_address)
+      : od(a_od), relobj(a_relobj), shndx(a_shndx), address(a_address)
+    { }
+
+    // Return the output address of the word.
+    Address
+    output_address() const;
+
+    Output_data* od;
+    Sized_relobj<size, big_endian>* relobj;
+    unsigned int shndx;
+    Address address;
+  };
+
+  typedef std::vector<Relr_reloc> Relocs;
+
+  // Add a relocation.
+  void
+  add(Output_data* od, const Relr_reloc& reloc)
+  {
+    gold_assert((reloc.address & 1) == 0);
+    this->relocs_.push_back(reloc);
+    if (this->relocs_.size() == 1)
+      this->set_current_data_size(word_size);
+    od->add_dynamic_reloc();
+  }
+
+  // Encode the relocations into WORDS.
+  void
+  encode(std::vector<Address>* words, bool report_errors) const;
+
+  // The relocations.
+  Relocs relocs_;
+};
+
 // Output_relocatable_relocs represents a relocation section in a
 // relocatable link.  The actual data is written out in the target
 // hook relocate_relocs.  This just saves space for it.
@@ -3441,6 +3549,22 @@ class Output_section : public Output_data
   set_segment_alignment(uint64_t align)
   { this->segment_alignment_ = align; }
 
+  // Return the huge page size for --hugepage-text, or zero if the
+  // hot text of this section is not aligned to huge pages.
+  uint64_t
+  hugepage_size() const
+  { return this->hugepage_size_; }
+
+  // Set the huge page size for --hugepage-text.  The input sections
+  // with a section order index are aligned to a multiple of SIZE, and
+  // the following input section starts at the next multiple of SIZE.
+  void
+  set_hugepage_size(uint64_t size)
+  {
+    gold_assert(size != 0 && (size & (size - 1)) == 0);
+    this->hugepage_size_ = size;
+  }
+
   // If a section requires postprocessing, return the buffer to use.
   unsigned char*
   postprocessing_buffer() const
@@ -3907,6 +4031,11 @@ class Output_section : public Output_data
   void
   print_merge_stats();
 
+  // Print the placement of the hot text for --hugepage-text to
+  // stderr.
+  void
+  print_hugepage_stats() const;
+
   // Set a fixed layout for the section.  Used for incremental update links.
   void
   set_fixed_layout(uint64_t sh_addr, off_t sh_offset, off_t sh_size,
@@ -4440,6 +4569,13 @@ class Output_section : public Output_data
   Output_fill* free_space_fill_;
   // Amount added as patch space for incremental linking.
   off_t patch_space_;
+  // The huge page size for --hugepage-text, or zero.
+  uint64_t hugepage_size_;
+  // For --hugepage-text, the offsets within this section of the start
+  // and end of the hot input sections.  These are equal if there are
+  // no hot input sections.
+  off_t hot_text_start_;
+  off_t hot_text_end_;
 };
 
 // An output segment.  PT_LOAD segments are built from collections of
@@ -4518,6 +4654,11 @@ class Output_segment
   uint64_t
   maximum_alignment();
 
+  // Return the largest huge page size of the output sections in this
+  // segment for --hugepage-text, or zero if there is none.
+  uint64_t
+  hugepage_size() const;
+
   // Add the Output_section OS to this PT_LOAD segment.  SEG_FLAGS is
   // the segment flags to use.
   void
@@ -4781,13 +4922,24 @@ class Output_file
   filename()
   { return this->name_; }
 
-  // We currently always use mmap which makes the view handling quite
-  // simple.  In the future we may support other approaches.
+  // Normally we map the whole file, or an anonymous buffer of the
+  // same size, and a view is simply a pointer into the map.  With
+  // --stream-output we do not map the file.  Each view is then a
+  // separate buffer, which is read from the file with pread if
+  // needed, and which is queued to be written with pwrite when it is
+  // released.  The queued buffers are written in file offset order
+  // whenever their total size goes over --stream-output-buffer-size,
+  // and before anything is read back from the file.
 
   // Write data to the output file.
   void
   write(off_t offset, const void* data, size_t len)
-  { memcpy(this->base_ + offset, data, len); }
+  {
+    if (this->is_streaming_)
+      this->stream_write(offset, data, len);
+    else
+      memcpy(this->base_ + offset, data, len);
+  }
 
   // Get a buffer to use to write to the file, given the offset into
   // the file and the size.
@@ -4796,38 +4948,118 @@ class Output_file
   {
     gold_assert(start >= 0
 		&& start + static_cast<off_t>(size) <= this->file_size_);
+    if (this->is_streaming_)
+      return this->stream_get_output_view(size);
     return this->base_ + start;
   }
 
   // VIEW must have been returned by get_output_view.  Write the
   // buffer to the file, passing in the offset and the size.
   void
-  write_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_output_view(off_t start, size_t size, unsigned char* view)
+  {
+    if (this->is_streaming_)
+      this->stream_queue(start, size, view);
+  }
 
   // Get a read/write buffer.  This is used when we want to write part
   // of the file, read it in, and write it again.
   unsigned char*
   get_input_output_view(off_t start, size_t size)
-  { return this->get_output_view(start, size); }
+  {
+    if (this->is_streaming_)
+      return this->stream_get_input_view(start, size, true);
+    return this->get_output_view(start, size);
+  }
 
   // Write a read/write buffer back to the file.
   void
-  write_input_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_input_output_view(off_t start, size_t size, unsigned char* view)
+  {
+    if (this->is_streaming_)
+      this->stream_write_input_output_view(start, size, view);
+  }
 
   // Get a read buffer.  This is used when we just want to read part
   // of the file back it in.
   const unsigned char*
   get_input_view(off_t start, size_t size)
-  { return this->get_output_view(start, size); }
+  {
+    if (this->is_streaming_)
+      return this->stream_get_input_view(start, size, false);
+    return this->get_output_view(start, size);
+  }
 
   // Release a read bfufer.
   void
-  free_input_view(off_t, size_t, const unsigned char*)
-  { }
+  free_input_view(off_t, size_t, const unsigned char* view)
+  {
+    if (this->is_streaming_)
+      delete[] view;
+  }
+
+  // Print statistics about --stream-output to stderr.
+  static void
+  print_stats();
 
  private:
+  // A buffer queued to be written with --stream-output.
+  struct Stream_buffer
+  {
+    Stream_buffer(off_t off, size_t len, unsigned char* buf)
+      : offset(off), size(len), data(buf)
+    { }
+
+    off_t offset;
+    size_t size;
+    unsigned char* data;
+  };
+
+  // Sort Stream_buffers by file offset.
+  struct Stream_buffer_compare
+  {
+    bool
+    operator()(const Stream_buffer& a, const Stream_buffer& b) const
+    { return a.offset < b.offset; }
+  };
+
+  typedef std::vector<Stream_buffer> Stream_buffers;
+
+  // Set up the file for --stream-output.  Return false if the file
+  // can not be written with pwrite.
+  bool
+  open_for_streaming();
+
+  // Copy LEN bytes of DATA into a buffer queued to be written at
+  // OFFSET.
+  void
+  stream_write(off_t offset, const void* data, size_t len);
+
+  // Return a new buffer of SIZE bytes for an output view.
+  unsigned char*
+  stream_get_output_view(size_t size);
+
+  // Return a buffer holding SIZE bytes read from the file at START.
+  // If FOR_OUTPUT is true, keep a copy of the original contents after
+  // the buffer, so that we can write back just the bytes which
+  // changed.
+  unsigned char*
+  stream_get_input_view(off_t start, size_t size, bool for_output);
+
+  // Queue the changed bytes of an input/output view to be written.
+  void
+  stream_write_input_output_view(off_t start, size_t size,
+				 unsigned char* view);
+
+  // Queue SIZE bytes in BUF to be written at START.  This takes
+  // ownership of BUF, which must have been allocated with new[].
+  void
+  stream_queue(off_t start, size_t size, unsigned char* buf);
+
+  // Write all the queued buffers to the file.
+  void
+  stream_flush();
+
   // Map the file into memory or, if that fails, allocate anonymous
   // memory.
   void
@@ -4859,6 +5091,27 @@ class Output_file
   bool map_is_allocated_;
   // True if this is a temporary file which should not be output.
   bool is_temporary_;
+  // True if we are writing the file with pwrite, for --stream-output.
+  bool is_streaming_;
+  // The buffers queued to be written, for --stream-output.
+  Stream_buffers stream_buffers_;
+  // The total size of stream_buffers_.
+  size_t stream_buffered_size_;
+  // The limit on stream_buffered_size_.
+  size_t stream_buffer_limit_;
+  // Lock controlling access to stream_buffers_.
+  Lock* stream_lock_;
+  // Lock held while writing buffers to the file, so that buffers
+  // queued later are written later.
+  Lock* stream_flush_lock_;
+
+  // Statistics for --stream-output.
+  // The number of times we wrote out the queued buffers.
+  static unsigned long long stream_flushes;
+  // The total number of bytes written.
+  static unsigned long long stream_written_bytes;
+  // The largest total size of the queued buffers.
+  static unsigned long long maximum_stream_buffered_bytes;
 };
 
 } // End namespace gold.
@@ -72,6 +72,8 @@ dlerror(void)
 #include "readsyms.h"
 #include "symtab.h"
 #include "descriptors.h"
+#include "gold-threads.h"
+#include "timer.h"
 #include "elfcpp.h"
 
 namespace gold
@@ -427,6 +429,7 @@ Plugin_manager::~Plugin_manager()
        ++obj)
     delete *obj;
   this->objects_.clear();
+  delete this->claim_lock_;
 }
 
 // Load all plugin libraries.
@@ -435,6 +438,7 @@ void
 Plugin_manager::load_plugins(Layout* layout)
 {
   this->layout_ = layout;
+  this->claim_lock_ = new Lock();
   for (this->current_ = this->plugins_.begin();
        this->current_ != this->plugins_.end();
        ++this->current_)
@@ -447,9 +451,20 @@ Pluginobj*
 Plugin_manager::claim_file(Input_file* input_file, off_t offset,
                            off_t filesize, Object* elf_object)
 {
+  const bool stats = parameters->options().stats();
+  Timer timer;
+  if (stats)
+    timer.start();
+
+  // Only the handlers run under the lock.  Other Read_symbols tasks
+  // go on opening and reading their input files meanwhile.
+  Hold_lock hl(*this->claim_lock_);
+
   if (this->in_replacement_phase_)
     return NULL;
 
+  long locked = stats ? timer.get_elapsed_time().wall : 0;
+
   unsigned int handle = this->objects_.size();
   this->input_file_ = input_file;
   this->plugin_input_file_.name = input_file->filename().c_str();
@@ -461,6 +476,7 @@ Plugin_manager::claim_file(Input_file* input_file, off_t offset,
     this->objects_.push_back(elf_object);
   this->in_claim_file_handler_ = true;
 
+  Pluginobj* obj = NULL;
   for (this->current_ = this->plugins_.begin();
        this->current_ != this->plugins_.end();
        ++this->current_)
@@ -468,21 +484,33 @@ Plugin_manager::claim_file(Input_file* input_file, off_t offset,
       if ((*this->current_)->claim_file(&this->plugin_input_file_))
         {
 	  this->any_claimed_ = true;
-	  this->in_claim_file_handler_ = false;
 
           if (this->objects_.size() > handle
               && this->objects_[handle]->pluginobj() != NULL)
-            return this->objects_[handle]->pluginobj();
-
-          // If the plugin claimed the file but did not call the
-          // add_symbols callback, we need to create the Pluginobj now.
-          Pluginobj* obj = this->make_plugin_object(handle);
-          return obj;
+            obj = this->objects_[handle]->pluginobj();
+	  else
+	    {
+	      // If the plugin claimed the file but did not call the
+	      // add_symbols callback, we need to create the Pluginobj
+	      // now.
+	      obj = this->make_plugin_object(handle);
+	    }
+	  break;
         }
     }
 
   this->in_claim_file_handler_ = false;
-  return NULL;
+
+  if (stats)
+    {
+      ++this->files_offered_;
+      if (obj != NULL)
+	++this->files_claimed_;
+      this->claim_wait_time_ += locked;
+      this->claim_time_ += timer.get_elapsed_time().wall - locked;
+    }
+
+  return obj;
 }
 
 // Save an archive.  This is used so that a plugin can add a file
@@ -528,11 +556,18 @@ Plugin_manager::all_symbols_read(Workqueue* workqueue, Task* task,
   this->mapfile_ = mapfile;
   this->this_blocker_ = NULL;
 
+  Timer timer;
+  if (parameters->options().stats())
+    timer.start();
+
   for (this->current_ = this->plugins_.begin();
        this->current_ != this->plugins_.end();
        ++this->current_)
     (*this->current_)->all_symbols_read();
 
+  if (parameters->options().stats())
+    this->all_symbols_read_time_ += timer.get_elapsed_time().wall;
+
   if (this->any_added_)
     {
       Task_token* next_blocker = new Task_token(true);
@@ -555,6 +590,30 @@ Plugin_manager::new_undefined_symbol(Symbol* sym)
     this->undefined_symbols_.push_back(sym);
 }
 
+// Print statistics to stderr.  This is used for --stats.
+
+void
+Plugin_manager::print_stats() const
+{
+  fprintf(stderr, _("%s: plugin input files claimed: %u of %u\n"),
+	  program_name, this->files_claimed_, this->files_offered_);
+  fprintf(stderr,
+	  _("%s: plugin claim-file handlers: %ld.%06ld seconds, "
+	    "%ld.%06ld seconds waiting for other files\n"),
+	  program_name, this->claim_time_ / 1000,
+	  (this->claim_time_ % 1000) * 1000, this->claim_wait_time_ / 1000,
+	  (this->claim_wait_time_ % 1000) * 1000);
+  fprintf(stderr,
+	  _("%s: plugin symbols added: %u in %ld.%06ld seconds\n"),
+	  program_name, this->symbols_added_,
+	  this->add_symbols_time_ / 1000,
+	  (this->add_symbols_time_ % 1000) * 1000);
+  fprintf(stderr,
+	  _("%s: plugin all-symbols-read handlers: %ld.%06ld seconds\n"),
+	  program_name, this->all_symbols_read_time_ / 1000,
+	  (this->all_symbols_read_time_ % 1000) * 1000);
+}
+
 // Rescan archives as needed.  This handles the case where a new
 // object file added by a plugin has an undefined reference to some
 // symbol defined in an archive.
@@ -872,10 +931,29 @@ Plugin_manager::add_input_file(const char* pathname, bool is_lib)
 Pluginobj::Pluginobj(const std::string& name, Input_file* input_file,
                      off_t offset, off_t filesize)
   : Object(name, input_file, false, offset),
-    nsyms_(0), syms_(NULL), symbols_(), filesize_(filesize), comdat_map_()
+    nsyms_(0), syms_(NULL), symbols_(), name_lengths_(), name_hash_codes_(),
+    filesize_(filesize), comdat_map_()
 {
 }
 
+// Compute the lengths and hash codes of the symbol names.
+
+void
+Pluginobj::hash_symbol_names()
+{
+  this->name_lengths_.resize(this->nsyms_);
+  this->name_hash_codes_.resize(this->nsyms_);
+  for (int i = 0; i < this->nsyms_; ++i)
+    {
+      const char* name = this->syms_[i].name;
+      if (name == NULL)
+	continue;
+      size_t len = strlen(name);
+      this->name_lengths_[i] = len;
+      this->name_hash_codes_[i] = Stringpool::string_hash(name, len);
+    }
+}
+
 // Return TRUE if a defined symbol is referenced from outside the
 // universe of claimed objects.  Only references from relocatable,
 // non-IR (unclaimed) objects count as a reference.  References from
@@ -1055,7 +1133,12 @@ Sized_pluginobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
 
   typedef typename elfcpp::Elf_types<size>::Elf_WXword Elf_size_type;
 
+  Timer timer;
+  if (parameters->options().stats())
+    timer.start();
+
   this->symbols_.resize(this->nsyms_);
+  const bool have_hash_codes = !this->name_hash_codes_.empty();
 
   for (int i = 0; i < this->nsyms_; ++i)
     {
@@ -1130,9 +1213,32 @@ Sized_pluginobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
       osym.put_st_other(vis, 0);
       osym.put_st_shndx(shndx);
 
+      size_t name_length;
+      size_t name_hash_code;
+      if (have_hash_codes)
+	{
+	  name_length = this->name_lengths_[i];
+	  name_hash_code = this->name_hash_codes_[i];
+	}
+      else
+	{
+	  name_length = strlen(name);
+	  name_hash_code = Stringpool::string_hash(name, name_length);
+	}
+
       this->symbols_[i] =
-        symtab->add_from_pluginobj<size, big_endian>(this, name, ver, &sym);
+        symtab->add_from_pluginobj<size, big_endian>(this, name, name_length,
+						     name_hash_code, ver,
+						     &sym);
     }
+
+  // We are done with the hash codes.
+  std::vector<size_t>().swap(this->name_lengths_);
+  std::vector<size_t>().swap(this->name_hash_codes_);
+
+  if (parameters->options().stats())
+    parameters->options().plugins()->record_add_symbols(
+	this->nsyms_, timer.get_elapsed_time().wall);
 }
 
 template<int size, bool big_endian>
@@ -45,6 +45,7 @@ class Dirsearch;
 class Mapfile;
 class Task;
 class Task_token;
+class Lock;
 class Pluginobj;
 class Plugin_rescan;
 
@@ -131,10 +132,12 @@ class Plugin_manager
     : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
       plugin_input_file_(), rescannable_(), undefined_symbols_(),
       any_claimed_(false), in_replacement_phase_(false), any_added_(false),
-      in_claim_file_handler_(false),
+      in_claim_file_handler_(false), claim_lock_(NULL),
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
-      this_blocker_(NULL), extra_search_path_()
+      this_blocker_(NULL), extra_search_path_(), files_offered_(0),
+      files_claimed_(0), claim_time_(0), claim_wait_time_(0),
+      symbols_added_(0), add_symbols_time_(0), all_symbols_read_time_(0)
   { this->current_ = plugins_.end(); }
 
   ~Plugin_manager();
@@ -156,7 +159,9 @@ class Plugin_manager
   void
   load_plugins(Layout* layout);
 
-  // Call the plugin claim-file handlers in turn to see if any claim the file.
+  // Call the plugin claim-file handlers in turn to see if any claim
+  // the file.  This may be called from several Read_symbols tasks at
+  // once; the handlers are called for one file at a time.
   Pluginobj*
   claim_file(Input_file* input_file, off_t offset, off_t filesize,
              Object* elf_object);
@@ -285,6 +290,19 @@ class Plugin_manager
   layout()
   { return this->layout_; }
 
+  // Record that NSYMS symbols from a claimed file were added to the
+  // symbol table in TIME milliseconds.  This is used for --stats.
+  void
+  record_add_symbols(int nsyms, long time)
+  {
+    this->symbols_added_ += nsyms;
+    this->add_symbols_time_ += time;
+  }
+
+  // Print statistics to stderr.  This is used for --stats.
+  void
+  print_stats() const;
+
  private:
   Plugin_manager(const Plugin_manager&);
   Plugin_manager& operator=(const Plugin_manager&);
@@ -362,6 +380,10 @@ class Plugin_manager
 
   // Set to true when the claim_file handler of a plugin is called.
   bool in_claim_file_handler_;
+  // Held while the claim_file handlers look at an input file.  The
+  // plugin API does not permit calling them on several threads at
+  // once, and the fields above describe the file being claimed.
+  Lock* claim_lock_;
 
   const General_options& options_;
   Workqueue* workqueue_;
@@ -376,6 +398,23 @@ class Plugin_manager
   // An extra directory to seach for the libraries passed by
   // add_input_library.
   std::string extra_search_path_;
+
+  // Statistics for --stats.  Times are wall clock times in
+  // milliseconds, as returned by Timer.
+  // The number of input files offered to the claim_file handlers.
+  unsigned int files_offered_;
+  // The number of input files claimed.
+  unsigned int files_claimed_;
+  // The time spent in the claim_file handlers.
+  long claim_time_;
+  // The time spent waiting for claim_lock_.
+  long claim_wait_time_;
+  // The number of symbols from claimed files added to the symbol table.
+  unsigned int symbols_added_;
+  // The time spent adding them.
+  long add_symbols_time_;
+  // The time spent in the all_symbols_read handlers.
+  long all_symbols_read_time_;
 };
 
 
@@ -405,6 +444,13 @@ class Pluginobj : public Object
     this->syms_ = syms;
   }
 
+  // Compute the lengths and hash codes of the symbol names, so that
+  // adding the symbols to the symbol table, which has to be done in
+  // order, does less work.  This is called by the Read_symbols task
+  // which claimed the file, and may run in parallel with other tasks.
+  void
+  hash_symbol_names();
+
   // Return TRUE if the comdat group with key COMDAT_KEY from this object
   // should be kept.
   bool
@@ -440,6 +486,14 @@ class Pluginobj : public Object
   // The entries in the symbol table for the external symbols.
   Symbols symbols_;
 
+  // The length of each symbol name, set by hash_symbol_names.  If
+  // this is empty, the names have not been hashed.
+  std::vector<size_t> name_lengths_;
+
+  // The Stringpool hash code of each symbol name, set by
+  // hash_symbol_names.
+  std::vector<size_t> name_hash_codes_;
+
  private:
   // Size of the file (or archive member).
   off_t filesize_;
@@ -276,6 +276,27 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
   if (!input_file->open(*this->dirpath_, this, &this->dirindex_))
     return false;
 
+  // For a lib group member which we have seen before, the
+  // --input-cache tells us which symbols it defines, so we need not
+  // read it unless it is included in the link.
+  bool use_input_cache = (this->member_ != NULL
+			  && Input_cache::is_enabled()
+			  && !parameters->options().has_plugins());
+  if (use_input_cache)
+    {
+      std::vector<std::string>* names = new std::vector<std::string>;
+      if (Input_cache::lookup(input_file, names))
+	{
+	  input_file->file().unlock(this);
+	  this->member_->input_file_ = input_file;
+	  this->member_->cached_symbols_ = names;
+	  this->member_->arg_serial_ =
+	      this->input_argument_->file().arg_serial();
+	  return true;
+	}
+      delete names;
+    }
+
   // Read enough of the file to pick up the entire ELF header.
 
   off_t filesize = input_file->file().filesize();
@@ -350,7 +371,10 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
 	    delete elf_obj;
 
           // The input file was claimed by a plugin, and its symbols
-          // have been provided by the plugin.
+          // have been provided by the plugin.  Hash their names now,
+          // while other input files are being read, rather than in
+          // the Add_symbols task.
+          obj->hash_symbol_names();
 
           // We are done with the file at this point, so unlock it.
           obj->unlock(this);
@@ -400,6 +424,11 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
       Read_symbols_data* sd = new Read_symbols_data;
       elf_obj->read_symbols(sd);
 
+      if (use_input_cache
+	  && !elf_obj->is_dynamic()
+	  && sd->symbol_names != NULL)
+	Input_cache::record(input_file, elf_obj, sd);
+
       // Opening the file locked it, so now we need to unlock it.  We
       // need to unlock it before queuing the Add_symbols task,
       // because the workqueue doesn't know about our lock on the
@@ -591,7 +620,7 @@ Add_symbols::locks(Task_locker* tl)
 // Add the symbols in the object to the symbol table.
 
 void
-Add_symbols::run(Workqueue*)
+Add_symbols::run(Workqueue* workqueue)
 {
   Pluginobj* pluginobj = this->object_->pluginobj();
   if (pluginobj != NULL)
@@ -637,6 +666,10 @@ Add_symbols::run(Workqueue*)
       delete this->sd_;
       this->sd_ = NULL;
       this->object_->release();
+
+      // When building a .gdb_index section, scan the debug info of
+      // the object while we read the remaining input files.
+      this->layout_->queue_gdb_index_tasks(workqueue);
     }
 }
 
@@ -85,6 +85,20 @@ Read_relocs::run(Workqueue* workqueue)
     }
   else
     {
+      // The Scan_relocs tasks run one at a time, because they change
+      // the symbol table and the target's GOT and PLT sections.  When
+      // using threads, we drop the relocs which can not change those
+      // here, where we can still run in parallel, so that the
+      // Scan_relocs tasks only see the rest, in the same order.  We
+      // do not reserve GOT or PLT entries or dynamic relocs here:
+      // their offsets, and the global symbols they depend on, are
+      // assigned in input order by Scan_relocs, which keeps the
+      // output independent of the number of threads.
+      if (parameters->options().threads()
+	  && !parameters->options().relocatable()
+	  && !parameters->options().emit_relocs()
+	  && !parameters->incremental())
+	this->object_->prescan_relocs(rd);
       workqueue->queue_next(new Scan_relocs(this->symtab_, this->layout_,
 					    this->object_, rd,
                                             this->this_blocker_,
@@ -377,6 +391,48 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
     }
 }
 
+// Drop the relocs which the target does not need to scan, keeping
+// the others in RD.  Since the relocs are never used again after they
+// are scanned, we release them here.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_prescan_relocs(Read_relocs_data* rd)
+{
+  Sized_target<size, big_endian>* target =
+    parameters->sized_target<size, big_endian>();
+
+  const unsigned char* local_symbols;
+  if (rd->local_symbols == NULL)
+    local_symbols = NULL;
+  else
+    local_symbols = rd->local_symbols->data();
+
+  for (Read_relocs_data::Relocs_list::iterator p = rd->relocs.begin();
+       p != rd->relocs.end();
+       ++p)
+    {
+      if (!p->is_data_section_allocated)
+	continue;
+
+      if (!target->prescan_relocs(this, p->sh_type, p->contents->data(),
+				  p->reloc_count, this->local_symbol_count_,
+				  local_symbols, &p->deferred_relocs))
+	continue;
+
+      unsigned int reloc_size;
+      if (p->sh_type == elfcpp::SHT_REL)
+	reloc_size = elfcpp::Elf_sizes<size>::rel_size;
+      else
+	reloc_size = elfcpp::Elf_sizes<size>::rela_size;
+      p->deferred_reloc_count = p->deferred_relocs.size() / reloc_size;
+      p->is_prescanned = true;
+
+      delete p->contents;
+      p->contents = NULL;
+    }
+}
+
 // Process the relocs to generate mappings from source sections to referenced
 // sections.  This is used during garbage collection to determine garbage
 // sections.
@@ -458,7 +514,18 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  // As noted above, when not generating an object file, we
 	  // only scan allocated sections.  We may see a non-allocated
 	  // section here if we are emitting relocs.
-	  if (p->is_data_section_allocated)
+	  if (p->is_prescanned)
+	    {
+	      if (p->deferred_reloc_count > 0)
+		target->scan_relocs(symtab, layout, this, p->data_shndx,
+				    p->sh_type, &p->deferred_relocs[0],
+				    p->deferred_reloc_count,
+				    p->output_section,
+				    p->needs_special_offset_handling,
+				    this->local_symbol_count_,
+				    local_symbols);
+	    }
+	  else if (p->is_data_section_allocated)
 	    target->scan_relocs(symtab, layout, this, p->data_shndx,
 				p->sh_type, p->contents->data(),
 				p->reloc_count, p->output_section,
@@ -1626,6 +1693,30 @@ void
 Sized_relobj_file<64, true>::do_read_relocs(Read_relocs_data* rd);
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+void
+Sized_relobj_file<32, false>::do_prescan_relocs(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+void
+Sized_relobj_file<32, true>::do_prescan_relocs(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+void
+Sized_relobj_file<64, false>::do_prescan_relocs(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+void
+Sized_relobj_file<64, true>::do_prescan_relocs(Read_relocs_data* rd);
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 void
@@ -28,6 +28,7 @@
 
 #include "output.h"
 #include "parameters.h"
+#include "gold-threads.h"
 #include "stringpool.h"
 
 namespace gold
@@ -270,12 +271,29 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
       return p->first.string;
     }
 
+  return this->add_with_length_and_hash(s, length,
+					string_hash(s, length), pkey);
+}
+
+template<typename Stringpool_char>
+const Stringpool_char*
+Stringpool_template<Stringpool_char>::add_with_length_and_hash(
+    const Stringpool_char* s,
+    size_t length,
+    size_t hash_code,
+    Key* pkey)
+{
+  typedef std::pair<typename String_set_type::iterator, bool> Insert_type;
+
+  // We add 1 so that 0 is always invalid.
+  const Key k = this->key_to_offset_.size() + 1;
+
   // When we have to copy the string, we look it up twice in the hash
   // table.  The problem is that we can't insert S before we
   // canonicalize it by copying it into the canonical list. The hash
   // code will only be computed once.
 
-  Hashkey hk(s, length);
+  Hashkey hk(s, length, hash_code);
   typename String_set_type::const_iterator p = this->string_set_.find(hk);
   if (p != this->string_set_.end())
     {
@@ -387,6 +405,10 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
   // the strtab size, and gives a relatively small benefit (it's
   // typically rare for a symbol to be a suffix of another), we only
   // take the time to sort when the user asks for heavy optimization.
+  // When running with --threads the sort is spread over several
+  // threads.  The strings in the pool are all different, so the
+  // sorted order, and therefore the output, does not depend on the
+  // number of threads.
   if (!this->optimize_)
     {
       // If we are not optimizing, the offsets are already assigned.
@@ -404,7 +426,7 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
            ++p)
         v.push_back(Stringpool_sort_info(p));
 
-      std::sort(v.begin(), v.end(), Stringpool_sort_comparison());
+      parallel_sort(v.begin(), v.end(), Stringpool_sort_comparison());
 
       section_offset_type last_offset = -1;
       for (typename std::vector<Stringpool_sort_info>::iterator last = v.end(),
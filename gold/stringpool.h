@@ -229,6 +229,18 @@ class Stringpool_template
   const Stringpool_char*
   add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey);
 
+  // Compute a hash code for a string.  LENGTH is the length of the
+  // string in characters.
+  static size_t
+  string_hash(const Stringpool_char*, size_t length);
+
+  // Add string S of length LEN characters to the pool, copying it.
+  // HASH_CODE must be string_hash(S, LEN).  This is for callers which
+  // have already computed the hash code, perhaps on another thread.
+  const Stringpool_char*
+  add_with_length_and_hash(const Stringpool_char* s, size_t len,
+			   size_t hash_code, Key* pkey);
+
   // If the string S is present in the pool, return the canonical
   // string pointer.  Otherwise, return NULL.  If PKEY is not NULL,
   // set *PKEY to the key.
@@ -297,11 +309,6 @@ class Stringpool_template
   static bool
   string_equal(const Stringpool_char*, const Stringpool_char*);
 
-  // Compute a hash code for a string.  LENGTH is the length of the
-  // string in characters.
-  static size_t
-  string_hash(const Stringpool_char*, size_t length);
-
   // We store the actual data in a list of these buffers.
   struct Stringdata
   {
@@ -353,6 +360,10 @@ class Stringpool_template
     Hashkey(const Stringpool_char* s, size_t len)
       : string(s), length(len), hash_code(string_hash(s, len))
     { }
+
+    Hashkey(const Stringpool_char* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
   };
 
   // Hash function.  This is trivial, since we have already computed
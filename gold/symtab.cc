@@ -1275,6 +1275,8 @@ Symbol*
 Symbol_table::add_from_pluginobj(
     Sized_pluginobj<size, big_endian>* obj,
     const char* name,
+    size_t name_length,
+    size_t name_hash_code,
     const char* ver,
     elfcpp::Sym<size, big_endian>* sym)
 {
@@ -1319,7 +1321,8 @@ Symbol_table::add_from_pluginobj(
     }
 
   Stringpool::Key name_key;
-  name = this->namepool_.add(name, true, &name_key);
+  name = this->namepool_.add_with_length_and_hash(name, name_length,
+						  name_hash_code, &name_key);
 
   Sized_symbol<size>* res;
   res = this->add_from_object(obj, name, name_key, ver, ver_key,
@@ -3466,6 +3469,8 @@ Symbol*
 Symbol_table::add_from_pluginobj<32, false>(
     Sized_pluginobj<32, false>* obj,
     const char* name,
+    size_t name_length,
+    size_t name_hash_code,
     const char* ver,
     elfcpp::Sym<32, false>* sym);
 #endif
@@ -3476,6 +3481,8 @@ Symbol*
 Symbol_table::add_from_pluginobj<32, true>(
     Sized_pluginobj<32, true>* obj,
     const char* name,
+    size_t name_length,
+    size_t name_hash_code,
     const char* ver,
     elfcpp::Sym<32, true>* sym);
 #endif
@@ -3486,6 +3493,8 @@ Symbol*
 Symbol_table::add_from_pluginobj<64, false>(
     Sized_pluginobj<64, false>* obj,
     const char* name,
+    size_t name_length,
+    size_t name_hash_code,
     const char* ver,
     elfcpp::Sym<64, false>* sym);
 #endif
@@ -3496,6 +3505,8 @@ Symbol*
 Symbol_table::add_from_pluginobj<64, true>(
     Sized_pluginobj<64, true>* obj,
     const char* name,
+    size_t name_length,
+    size_t name_hash_code,
     const char* ver,
     elfcpp::Sym<64, true>* sym);
 #endif
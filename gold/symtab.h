@@ -1370,11 +1370,14 @@ class Symbol_table
 		  size_t* defined);
 
   // Add one external symbol from the plugin object OBJ to the symbol table.
-  // Returns a pointer to the resolved symbol in the symbol table.
+  // NAME_LENGTH is the length of NAME and NAME_HASH_CODE is its
+  // Stringpool hash code.  Returns a pointer to the resolved symbol
+  // in the symbol table.
   template<int size, bool big_endian>
   Symbol*
   add_from_pluginobj(Sized_pluginobj<size, big_endian>* obj,
-                     const char* name, const char* ver,
+                     const char* name, size_t name_length,
+                     size_t name_hash_code, const char* ver,
                      elfcpp::Sym<size, big_endian>* sym);
 
   // Add COUNT dynamic symbols from the dynamic object DYNOBJ to the
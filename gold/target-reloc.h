@@ -115,6 +115,49 @@ scan_relocs(
     }
 }
 
+// This function implements the generic part of prescanning the
+// relocations for Sized_target::prescan_relocs.  It copies to
+// DEFERRED each reloc which the Scan class may need to see, in the
+// original order.  The Scan class must have a static
+// local_reloc_needs_scan method, which is called for a reloc against
+// a local symbol.  Relocs against global symbols are always kept,
+// since the global symbols may change while other objects are being
+// scanned.
+
+template<int size, bool big_endian, int sh_type, typename Scan>
+inline void
+prescan_relocs(
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    size_t local_count,
+    const unsigned char* plocal_syms,
+    std::vector<unsigned char>* deferred)
+{
+  typedef typename Reloc_types<sh_type, size, big_endian>::Reloc Reltype;
+  const int reloc_size = Reloc_types<sh_type, size, big_endian>::reloc_size;
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+
+  for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
+    {
+      Reltype reloc(prelocs);
+
+      typename elfcpp::Elf_types<size>::Elf_WXword r_info = reloc.get_r_info();
+      unsigned int r_sym = elfcpp::elf_r_sym<size>(r_info);
+      unsigned int r_type = elfcpp::elf_r_type<size>(r_info);
+
+      if (r_sym < local_count)
+	{
+	  gold_assert(plocal_syms != NULL);
+	  typename elfcpp::Sym<size, big_endian> lsym(plocal_syms
+						      + r_sym * sym_size);
+	  if (!Scan::local_reloc_needs_scan(r_type, lsym))
+	    continue;
+	}
+
+      deferred->insert(deferred->end(), prelocs, prelocs + reloc_size);
+    }
+}
+
 // Behavior for relocations to discarded comdat sections.
 
 enum Comdat_behavior
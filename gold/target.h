@@ -817,6 +817,24 @@ class Sized_target : public Target
 	      size_t local_symbol_count,
 	      const unsigned char* plocal_symbols) = 0;
 
+  // Copy to DEFERRED those relocs for a section which scan_relocs
+  // must see, dropping those which can not create GOT or PLT entries,
+  // dynamic relocations or COPY relocations.  The parameters are like
+  // scan_relocs.  This is called for different objects in parallel,
+  // before any relocs are scanned, so it may only look at the relocs
+  // and the local symbols, not at the global symbols or the target.
+  // Returns false if the target does not support this, in which case
+  // scan_relocs is called for all the relocs.
+  virtual bool
+  prescan_relocs(Sized_relobj_file<size, big_endian>*,
+		 unsigned int /* sh_type */,
+		 const unsigned char* /* prelocs */,
+		 size_t /* reloc_count */,
+		 size_t /* local_symbol_count */,
+		 const unsigned char* /* plocal_symbols */,
+		 std::vector<unsigned char>* /* deferred */)
+  { return false; }
+
   // Relocate section data.  SH_TYPE is the type of the relocation
   // section, SHT_REL or SHT_RELA.  PRELOCS points to the relocation
   // information.  RELOC_COUNT is the number of relocs.
@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# archive_parallel_test.sh -- test reading archive members in parallel.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# archive_parallel_test_1 was linked with --no-threads, and
+# archive_parallel_test_2 with several threads, which reads the
+# archive members which are needed in parallel.  The same members
+# must be included in the same order, so the two links must produce
+# the same output.
+
+if ! cmp -s archive_parallel_test_1 archive_parallel_test_2; then
+  echo "output linked with --threads differs from --no-threads output"
+  exit 1
+fi
+
+exit 0
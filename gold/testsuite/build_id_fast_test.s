@@ -0,0 +1,18 @@
+# build_id_fast_test.s: x86_64 test case for --build-id=fast.
+
+# The data section makes the output span several of the 1M chunks
+# which are hashed in parallel.
+
+	.text
+	.global	_start
+	.type	_start,@function
+_start:
+	retq
+	.size	_start,. - _start
+
+	.data
+	.global	data
+data:
+	.fill	1000000,1,0x5a
+	.fill	1000000,1,0xa5
+	.fill	1000000,1,0x3c
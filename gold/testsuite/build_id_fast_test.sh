@@ -0,0 +1,61 @@
+#!/bin/sh
+
+# build_id_fast_test.sh -- test --build-id=fast for x86_64
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# build_id_fast_test_1 is linked with --no-threads,
+# build_id_fast_test_2 with four threads and build_id_fast_test_3 with
+# --stream-output.  The chunks of the output are hashed in parallel,
+# but the build ID must not depend on that: all three must have the
+# same 16 byte build ID.  build_id_fast_test_4 only has a different
+# entry point, and must have a different build ID.
+
+build_id()
+{
+    id=`awk '/Build ID:/ { print $3 }' $1`
+    if test -z "$id"; then
+	echo "no build ID in $1"
+	cat $1
+	exit 1
+    fi
+    if test `expr length "$id"` -ne 32; then
+	echo "build ID $id in $1 is not 16 bytes"
+	exit 1
+    fi
+    echo $id
+}
+
+id1=`build_id build_id_fast_test_1.stdout` || { echo "$id1"; exit 1; }
+id2=`build_id build_id_fast_test_2.stdout` || { echo "$id2"; exit 1; }
+id3=`build_id build_id_fast_test_3.stdout` || { echo "$id3"; exit 1; }
+id4=`build_id build_id_fast_test_4.stdout` || { echo "$id4"; exit 1; }
+
+if test "$id1" != "$id2" || test "$id1" != "$id3"; then
+    echo "build IDs differ: $id1 $id2 $id3"
+    exit 1
+fi
+
+if test "$id1" = "$id4"; then
+    echo "build ID $id1 does not depend on the contents"
+    exit 1
+fi
+
+exit 0
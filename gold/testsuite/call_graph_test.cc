@@ -0,0 +1,71 @@
+// call_graph_test.cc -- a test case for gold --call-graph-profile
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+
+// The --call-graph-profile option places busy_caller after main and
+// busy_callee after busy_caller, using the call counts in
+// call_graph_test.prof.  By default the functions are placed in the
+// order in which they are defined here.  unlikely_function is not
+// in the profile, and is still placed ahead of the other functions
+// with the rest of .text.unlikely.  The other names must not start
+// with "hot", since .text.hot* sections are grouped too.
+
+extern "C"
+{
+
+int __attribute__ ((noinline))
+busy_callee(int i)
+{
+  return i + 1;
+}
+
+int __attribute__ ((noinline))
+cold_function(int i)
+{
+  return i - 1;
+}
+
+int __attribute__ ((noinline, section (".text.unlikely.unlikely_function")))
+unlikely_function(int i)
+{
+  return i - 2;
+}
+
+int __attribute__ ((noinline))
+busy_caller(int i)
+{
+  return busy_callee(i) * 2;
+}
+
+}
+
+int
+main()
+{
+  int r = 0;
+  for (int i = 0; i < 10; ++i)
+    r += busy_caller(i);
+  if (r < 0)
+    r = cold_function(r);
+  if (r > 1000)
+    r = unlikely_function(r);
+  return r == 110 ? 0 : 1;
+}
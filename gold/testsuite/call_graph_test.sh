@@ -0,0 +1,75 @@
+#!/bin/sh
+
+# call_graph_test.sh -- test --call-graph-profile.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --call-graph-profile
+# places the functions which call each other often next to each
+# other, without disturbing the default ordering of .text.unlikely
+# ahead of the other .text sections.  File call_graph_test.cc is in
+# this test, and call_graph_test.prof is its profile.
+
+set -e
+
+check()
+{
+    awk "
+BEGIN { saw1 = 0; saw2 = 0; err = 0; }
+/ T $2\$/ { saw1 = 1; next; }
+/ T / {
+     if (saw1 && !saw2)
+       {
+	  if (\$3 != \"$3\")
+	    {
+	      printf \"$3 does not follow $2\\n\";
+	      err = 1;
+	      exit 1;
+	    }
+	  saw2 = 1;
+       }
+    }
+END {
+      if (!saw2 && !err)
+	{
+	  printf \"did not see $2 followed by $3\\n\";
+	  exit 1;
+	}
+    }" $1
+}
+
+check call_graph_test.stdout "main" "busy_caller"
+check call_graph_test.stdout "busy_caller" "busy_callee"
+
+# unlikely_function is in .text.unlikely, so it comes before main.
+if ! awk '/ T unlikely_function$/ { found = 1 } / T main$/ { exit !found }' \
+    call_graph_test.stdout; then
+  echo "unlikely_function does not precede main:"
+  cat call_graph_test.stdout
+  exit 1
+fi
+
+if ! grep -q "call graph order 1: section '.text.main'" call_graph_test.err; then
+  echo "--print-order output does not start with main:"
+  cat call_graph_test.err
+  exit 1
+fi
+
+exit 0
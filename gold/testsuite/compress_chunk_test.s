@@ -0,0 +1,20 @@
+# compress_chunk_test.s: x86_64 test case for compressing debug
+# sections in chunks.
+
+# The .debug_str section is about 6K, so with a chunk size of 1K it
+# is compressed in several pieces.
+
+	.text
+	.globl	_start
+	.type	_start, @function
+_start:
+	ret
+	.size	_start, .-_start
+
+	.section	.debug_str,"MS",@progbits,1
+	.irp	x,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49
+	.string	"compress_chunk_test_first_string_\x\()_with_some_padding_text"
+	.endr
+	.irp	x,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49
+	.string	"compress_chunk_test_second_string_\x\()_with_some_padding_text"
+	.endr
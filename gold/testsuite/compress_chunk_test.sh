@@ -0,0 +1,54 @@
+#!/bin/sh
+
+# compress_chunk_test.sh -- test compressing debug sections in chunks
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --compress-debug-sections-chunk-size the .debug_str section is
+# compressed in several independent chunks, which are joined into one
+# zlib stream.  Decompressing it must give the same contents as
+# linking without compression.
+
+if ! grep -q '\.zdebug_str' compress_chunk_test_2.sections
+then
+    echo "no .zdebug_str section in compress_chunk_test_2"
+    cat compress_chunk_test_2.sections
+    exit 1
+fi
+
+# The heading names the section, which differs.
+grep -v '^Contents of' compress_chunk_test_1.stdout > compress_chunk_test_1.cmp
+grep -v '^Contents of' compress_chunk_test_2.stdout > compress_chunk_test_2.cmp
+if ! cmp -s compress_chunk_test_1.cmp compress_chunk_test_2.cmp
+then
+    echo "decompressed .debug_str differs from uncompressed section"
+    diff compress_chunk_test_1.cmp compress_chunk_test_2.cmp
+    exit 1
+fi
+
+# The section is about 6K, so the dump must reach at least 0x1700.
+if ! grep -q '^  0x000017' compress_chunk_test_2.stdout
+then
+    echo "decompressed .debug_str is too short"
+    cat compress_chunk_test_2.stdout
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,40 @@
+#!/bin/sh
+
+# dwp_test_3.sh -- Test that dwp --threads gives the same output.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# dwp_test_3a.dwp and dwp_test_3b.dwp are built like dwp_test_1.dwp
+# and dwp_test_2.dwp, but reading the input files on several threads.
+# The files must be identical.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$2 differs from $1"
+	exit 1
+    fi
+}
+
+check_same dwp_test_1.dwp dwp_test_3a.dwp
+check_same dwp_test_2.dwp dwp_test_3b.dwp
+
+exit 0
@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# eh_frame_threads_test.sh -- test parsing .eh_frame in parallel
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the .eh_frame sections are parsed while reading
+# symbols, and merged in input order when they are laid out.  The
+# output must be the same as with --no-threads: one CIE, and one FDE
+# each for _start, f1, f2 and the kept copy of dup.
+
+if ! cmp -s eh_frame_threads_test_1.stdout eh_frame_threads_test_2.stdout
+then
+    echo "output differs with --threads"
+    diff eh_frame_threads_test_1.stdout eh_frame_threads_test_2.stdout
+    exit 1
+fi
+
+cies=`grep -c ' CIE' eh_frame_threads_test_2.stdout`
+fdes=`grep -c ' FDE ' eh_frame_threads_test_2.stdout`
+if test "$cies" != "1" || test "$fdes" != "4"; then
+    echo "found $cies CIEs and $fdes FDEs, expected 1 and 4"
+    cat eh_frame_threads_test_2.stdout
+    exit 1
+fi
+
+exit 0
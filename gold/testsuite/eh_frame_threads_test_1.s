@@ -0,0 +1,37 @@
+# eh_frame_threads_test_1.s: x86_64 test case for parsing .eh_frame
+# sections in parallel.
+
+# The FDE for dup is kept from this file and discarded from
+# eh_frame_threads_test_2.s, and the CIEs of both files are merged.
+
+	.text
+	.globl	_start
+	.type	_start, @function
+_start:
+	.cfi_startproc
+	call	f1
+	call	f2
+	call	dup
+	.cfi_endproc
+	.size	_start, .-_start
+
+	.globl	f1
+	.type	f1, @function
+f1:
+	.cfi_startproc
+	pushq	%rbp
+	.cfi_def_cfa_offset 16
+	popq	%rbp
+	.cfi_def_cfa_offset 8
+	ret
+	.cfi_endproc
+	.size	f1, .-f1
+
+	.section	.text.dup,"axG",@progbits,dup,comdat
+	.weak	dup
+	.type	dup, @function
+dup:
+	.cfi_startproc
+	ret
+	.cfi_endproc
+	.size	dup, .-dup
@@ -0,0 +1,23 @@
+# eh_frame_threads_test_2.s: second file for eh_frame_threads_test.
+
+	.text
+	.globl	f2
+	.type	f2, @function
+f2:
+	.cfi_startproc
+	pushq	%rbx
+	.cfi_def_cfa_offset 16
+	popq	%rbx
+	.cfi_def_cfa_offset 8
+	ret
+	.cfi_endproc
+	.size	f2, .-f2
+
+	.section	.text.dup,"axG",@progbits,dup,comdat
+	.weak	dup
+	.type	dup, @function
+dup:
+	.cfi_startproc
+	ret
+	.cfi_endproc
+	.size	dup, .-dup
@@ -0,0 +1,100 @@
+// fast_hash_unittest.cc -- test fast_hash128
+
+// Copyright 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cstring>
+
+#include "fast-hash.h"
+
+#include "test.h"
+
+namespace gold_testsuite
+{
+
+using namespace gold;
+
+// The digests are part of the --build-id=fast output format, so they
+// must never change.
+
+struct Fast_hash_vector
+{
+  size_t len;
+  unsigned char digest[fast_hash128_size];
+};
+
+static const Fast_hash_vector fast_hash_vectors[] =
+{
+  { 0, { 0x13, 0xfc, 0xad, 0x37, 0x6a, 0x85, 0xb0, 0x9f,
+	 0xa1, 0xed, 0xab, 0x05, 0x88, 0x44, 0xc8, 0xbc } },
+  { 1, { 0x9b, 0x56, 0xb6, 0x55, 0x51, 0x94, 0x48, 0x0a,
+	 0x52, 0x15, 0x56, 0xec, 0xa1, 0xe1, 0xca, 0xc9 } },
+  { 7, { 0x43, 0x8b, 0x5a, 0xd5, 0x11, 0xb0, 0x03, 0x51,
+	 0x26, 0xd2, 0x5a, 0xd0, 0xb9, 0x7a, 0x80, 0x07 } },
+  { 8, { 0xf1, 0xc8, 0xdf, 0x55, 0x15, 0x71, 0xd5, 0x95,
+	 0x2a, 0xed, 0x06, 0xb5, 0xf7, 0x96, 0x35, 0x9c } },
+  { 31, { 0x66, 0x05, 0xcf, 0xdc, 0x90, 0x0e, 0x98, 0x7f,
+	  0x47, 0x8e, 0x11, 0x39, 0x64, 0xf9, 0xcc, 0x7a } },
+  { 32, { 0x21, 0x77, 0xc5, 0x9d, 0xa5, 0x7b, 0xda, 0x34,
+	  0x81, 0xd5, 0x21, 0x2f, 0x01, 0x18, 0x3a, 0x1d } },
+  { 33, { 0xb1, 0x3d, 0x16, 0x7e, 0x22, 0xf2, 0xab, 0x14,
+	  0xcc, 0xa7, 0xde, 0x2c, 0x30, 0x26, 0xe4, 0x22 } },
+  { 1000, { 0xef, 0x91, 0x47, 0x55, 0x78, 0x91, 0xa0, 0xab,
+	    0x8d, 0xe5, 0xe9, 0x22, 0xef, 0xb9, 0x6c, 0x99 } },
+};
+
+bool
+Fast_hash_test(Test_report*)
+{
+  unsigned char buf[1001];
+  for (int i = 0; i < 1000; ++i)
+    buf[i] = static_cast<unsigned char>(i * 7 + 3);
+
+  const size_t count = sizeof fast_hash_vectors / sizeof fast_hash_vectors[0];
+  for (size_t i = 0; i < count; ++i)
+    {
+      const Fast_hash_vector& v(fast_hash_vectors[i]);
+      unsigned char digest[fast_hash128_size];
+      fast_hash128(buf, v.len, digest);
+      CHECK(memcmp(digest, v.digest, fast_hash128_size) == 0);
+
+      // The alignment of the input must not matter.
+      memmove(buf + 1, buf, 1000);
+      fast_hash128(buf + 1, v.len, digest);
+      CHECK(memcmp(digest, v.digest, fast_hash128_size) == 0);
+      memmove(buf, buf + 1, 1000);
+    }
+
+  // Changing a single bit must change both halves of the digest.
+  unsigned char d1[fast_hash128_size];
+  unsigned char d2[fast_hash128_size];
+  fast_hash128(buf, 1000, d1);
+  buf[500] ^= 0x10;
+  fast_hash128(buf, 1000, d2);
+  CHECK(memcmp(d1, d2, 8) != 0);
+  CHECK(memcmp(d1 + 8, d2 + 8, 8) != 0);
+
+  return true;
+}
+
+Register_test fast_hash_register("Fast_hash", Fast_hash_test);
+
+} // End namespace gold_testsuite.
@@ -0,0 +1,45 @@
+# gc_threads_test.s: x86_64 test case for --gc-sections on several
+# threads.
+
+# _start calls 300 functions, each in its own section, and each of
+# those refers to a data section of its own, so the sections marked
+# in each pass are enough to be split over several threads.  Another
+# 300 functions, and the data they refer to, are not referenced from
+# _start and must be removed.
+
+	.macro	define_kept
+	.pushsection .text.kept_\@,"ax",@progbits
+kept_\@:
+	movq	kept_data_\@(%rip), %rax
+	retq
+	.section .data.kept_data_\@,"aw",@progbits
+kept_data_\@:
+	.quad	kept_\@
+	.popsection
+	callq	kept_\@
+	.endm
+
+	.macro	define_removed
+	.section .text.removed_\@,"ax",@progbits
+removed_\@:
+	movq	removed_data_\@(%rip), %rax
+	callq	_start
+	retq
+	.section .data.removed_data_\@,"aw",@progbits
+removed_data_\@:
+	.quad	removed_\@
+	.endm
+
+	.text
+	.globl	_start
+	.type	_start,@function
+_start:
+	.rept	300
+	define_kept
+	.endr
+	retq
+	.size	_start,. - _start
+
+	.rept	300
+	define_removed
+	.endr
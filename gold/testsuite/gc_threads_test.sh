@@ -0,0 +1,53 @@
+#!/bin/sh
+
+# gc_threads_test.sh -- test --gc-sections with --threads
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the strings of SHF_MERGE sections are hashed and
+# With --threads the sections referenced by the sections marked in
+# each pass are found on several threads.  The sections kept, and so
+# the output, must be the same as with --no-threads.
+
+if ! cmp -s gc_threads_test_1 gc_threads_test_2
+then
+    echo "output differs with --threads"
+    diff gc_threads_test_1.stdout gc_threads_test_2.stdout
+    exit 1
+fi
+
+check_count()
+{
+    count=`grep -c "$2" $1`
+    if test "$count" != "$3"
+    then
+	echo "found $count matches for \"$2\" in $1, expected $3"
+	exit 1
+    fi
+}
+
+check_count gc_threads_test_2.stdout " kept_[0-9]*\$" 300
+check_count gc_threads_test_2.stdout " kept_data_[0-9]*\$" 300
+check_count gc_threads_test_2.stdout "removed" 0
+
+check_count gc_threads_test_2.err "GC sections kept: 601\$" 1
+check_count gc_threads_test_2.err "GC mark passes: 3;" 1
+
+exit 0
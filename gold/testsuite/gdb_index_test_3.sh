@@ -37,7 +37,7 @@ check()
 
 STDOUT=gdb_index_test_3.stdout
 
-check $STDOUT "^Version [45]"
+check $STDOUT "^Version 8"
 
 # Look for the symbols we know should be in the symbol table.
 
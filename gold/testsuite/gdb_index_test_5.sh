@@ -0,0 +1,53 @@
+#!/bin/sh
+
+# gdb_index_test_5.sh -- a test case for the --gdb-index option with
+# DWARF 4 type units.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output:"
+	echo "   $2"
+	echo ""
+	echo "Actual error output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+STDOUT=gdb_index_test_5.stdout
+
+# The common checks apply to type units as well.
+
+${srcdir}/gdb_index_test_comm.sh $STDOUT || exit 1
+
+# Types defined in a type unit should refer to the type unit, and each
+# entry should carry the symbol kind and whether it is static.
+
+check $STDOUT "^\[ *[0-9]*\] one::c1: T[0-9]* \[global, type\]"
+check $STDOUT "^\[ *[0-9]*\] one::G_A: T[0-9]* \[global, variable\]"
+check $STDOUT "^\[ *[0-9]*\] main: [0-9]* \[global, function\]"
+check $STDOUT "^\[ *[0-9]*\] (anonymous namespace)::c1_count: [0-9]* \[static, variable\]"
+check $STDOUT "^\[ *[0-9]*\] inline_func_1: [0-9]* \[static, function\]"
+
+exit 0
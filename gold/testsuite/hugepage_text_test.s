@@ -0,0 +1,54 @@
+# hugepage_text_test.s: x86_64 test case for --hugepage-text.
+
+# The hot functions are named in hugepage_text_test.order.  The cold
+# functions are placed before them, and the read-only data after
+# them, so the test can check that both are kept off the huge pages
+# which hold the hot text.
+
+	.section .text.cold1,"ax",@progbits
+	.global	cold1
+	.type	cold1,@function
+cold1:
+	.fill	300,1,0x90
+	retq
+	.size	cold1,. - cold1
+
+	.section .text.hot1,"ax",@progbits
+	.global	hot1
+	.type	hot1,@function
+hot1:
+	callq	hot2
+	retq
+	.size	hot1,. - hot1
+
+	.section .text.cold2,"ax",@progbits
+	.global	cold2
+	.type	cold2,@function
+cold2:
+	.fill	200,1,0x90
+	retq
+	.size	cold2,. - cold2
+
+	.section .text.hot2,"ax",@progbits
+	.global	hot2
+	.type	hot2,@function
+hot2:
+	callq	cold2
+	retq
+	.size	hot2,. - hot2
+
+	.text
+	.global	_start
+	.type	_start,@function
+_start:
+	callq	hot1
+	callq	cold1
+	retq
+	.size	_start,. - _start
+
+	.section .rodata,"a",@progbits
+	.global	ro_data
+	.type	ro_data,@object
+ro_data:
+	.long	1
+	.size	ro_data,. - ro_data
@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# hugepage_text_test.sh -- test --hugepage-text for x86_64
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# hugepage_text_test is linked with --hugepage-text and a huge page
+# size of 64K.  The hot functions named in the section ordering file
+# must start on a huge page boundary, the read-only data which
+# follows them must start on the next one, and the text segment must
+# be aligned to the huge page size.  The --stats output must report
+# that the hot text spans one huge page.
+
+check_aligned()
+{
+    addr=`awk "/ $2\\$/ { print \\$1 }" $1`
+    if test -z "$addr"; then
+	echo "symbol $2 not found in $1"
+	exit 1
+    fi
+    case $addr in
+    *0000) ;;
+    *)
+	echo "$2 at 0x$addr is not aligned to the huge page size"
+	cat $1
+	exit 1
+	;;
+    esac
+}
+
+check_aligned hugepage_text_test.stdout hot1
+check_aligned hugepage_text_test.stdout ro_data
+
+if ! grep -q "LOAD .* R E 0x10000$" hugepage_text_test.phdrs; then
+    echo "text segment is not aligned to the huge page size"
+    cat hugepage_text_test.phdrs
+    exit 1
+fi
+
+if ! grep -q "\.text: hot text .* spans 1 huge pages of 65536 bytes" \
+	hugepage_text_test.err; then
+    echo "--stats does not report the hot text"
+    cat hugepage_text_test.err
+    exit 1
+fi
+
+exit 0
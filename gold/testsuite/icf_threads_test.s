@@ -0,0 +1,52 @@
+# icf_threads_test.s: x86_64 test case for --icf on several threads.
+
+# This file is assembled four times, with N set to 1, 2, 3 and 4, so
+# that the candidate sections are spread over several input objects,
+# which are hashed by different tasks.  The same_N functions are
+# identical and are folded.  The call_same_N functions only become
+# identical once the same_N functions are folded, which takes a second
+# iteration.  The differ_N functions all differ.
+
+	.altmacro
+
+	.macro	define_functions n
+	.section .text.same_\n,"ax",@progbits
+	.globl	same_\n
+	.type	same_\n,@function
+same_\n:
+	movl	$42, %eax
+	retq
+	.size	same_\n,. - same_\n
+
+	.section .text.call_same_\n,"ax",@progbits
+	.globl	call_same_\n
+	.type	call_same_\n,@function
+call_same_\n:
+	callq	same_\n
+	addl	$1, %eax
+	retq
+	.size	call_same_\n,. - call_same_\n
+
+	.section .text.differ_\n,"ax",@progbits
+	.globl	differ_\n
+	.type	differ_\n,@function
+differ_\n:
+	movl	$\n, %eax
+	retq
+	.size	differ_\n,. - differ_\n
+	.endm
+
+	define_functions %N
+
+	.if	N == 1
+	.text
+	.globl	_start
+	.type	_start,@function
+_start:
+	.irp	i, 1, 2, 3, 4
+	callq	call_same_\i
+	callq	differ_\i
+	.endr
+	retq
+	.size	_start,. - _start
+	.endif
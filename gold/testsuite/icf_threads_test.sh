@@ -0,0 +1,58 @@
+#!/bin/sh
+
+# icf_threads_test.sh -- test --icf with --threads
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the strings of SHF_MERGE sections are hashed and
+# With --threads the candidate sections of each input object are
+# hashed by a separate task.  The sections folded, and so the output,
+# must be the same as with --no-threads.
+
+if ! cmp -s icf_threads_test_1 icf_threads_test_2
+then
+    echo "output differs with --threads"
+    diff icf_threads_test_1.stdout icf_threads_test_2.stdout
+    exit 1
+fi
+
+# Print the number of different addresses of the symbols matching $1.
+addresses()
+{
+    grep " T $1_[1-4]\$" icf_threads_test_2.stdout \
+      | awk '{ print $1 }' | sort -u | wc -l
+}
+
+check()
+{
+    count=`addresses $1`
+    if test "$count" -ne "$2"
+    then
+	echo "$1 functions are at $count addresses, expected $2"
+	cat icf_threads_test_2.stdout
+	exit 1
+    fi
+}
+
+check same 1
+check call_same 1
+check differ 4
+
+exit 0
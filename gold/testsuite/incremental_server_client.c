@@ -0,0 +1,89 @@
+/* incremental_server_client.c -- send a request to --incremental-server
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   Usage: incremental_server_client SOCKET [FILE...]
+
+   Connect to the gold --incremental-server listening on SOCKET, ask
+   for a link in which the FILEs changed, and copy everything the
+   server sends back to the standard output.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static void
+write_all (int fd, const char *p, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = write (fd, p, len);
+      if (n <= 0)
+	{
+	  perror ("write");
+	  exit (1);
+	}
+      p += n;
+      len -= n;
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  struct sockaddr_un addr;
+  char buf[4096];
+  ssize_t len;
+  int s;
+  int i;
+
+  if (argc < 2 || strlen (argv[1]) >= sizeof addr.sun_path)
+    {
+      fprintf (stderr, "usage: %s SOCKET [FILE...]\n", argv[0]);
+      return 1;
+    }
+
+  memset (&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, argv[1]);
+
+  s = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (s < 0 || connect (s, (struct sockaddr *) &addr, sizeof addr) < 0)
+    {
+      perror (argv[1]);
+      return 1;
+    }
+
+  for (i = 2; i < argc; ++i)
+    {
+      write_all (s, argv[i], strlen (argv[i]));
+      write_all (s, "\n", 1);
+    }
+  shutdown (s, SHUT_WR);
+
+  while ((len = read (s, buf, sizeof buf)) > 0)
+    write_all (1, buf, len);
+
+  close (s);
+  return 0;
+}
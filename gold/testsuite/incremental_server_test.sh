@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# incremental_server_test.sh -- test --incremental-server
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The server is started after an initial incremental link, and is sent
+# two requests.  Before each one, incremental_server_test_1_tmp.o is
+# replaced by a new version.  The first request names no files, and
+# the second names only the file which did not change, so in both
+# cases the server must find the change from the timestamp.  Each link
+# must write a complete map file of its own.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_map()
+{
+    check "$1" "^\.data "
+    count=`grep -c "^Memory map" "$1"`
+    if test "$count" != "1"; then
+	echo "$1 has $count memory maps instead of 1"
+	exit 1
+    fi
+}
+
+check incremental_server_test_1.stdout "^exit status 0$"
+check incremental_server_test_2.stdout "^exit status 0$"
+
+# The little-endian values 0x5a5a0002 and 0x5a5a0003.
+check incremental_server_test_1.data " 02005a5a"
+check incremental_server_test_2.data " 03005a5a"
+
+check_map incremental_server_test_1.map
+check_map incremental_server_test_2.map
+
+exit 0
@@ -0,0 +1,9 @@
+# incremental_server_test_1_v3.s: x86_64 test case for --incremental-server.
+# Version 3 of the input file which changes between links.
+
+	.data
+	.globl	incremental_server_test_value
+	.type	incremental_server_test_value, @object
+	.size	incremental_server_test_value, 4
+incremental_server_test_value:
+	.long	0x5a5a0003
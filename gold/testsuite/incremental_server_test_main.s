@@ -0,0 +1,11 @@
+# incremental_server_test_main.s: x86_64 test case for
+# --incremental-server.  This input does not change between links.
+
+	.text
+	.globl	_start
+	.type	_start, @function
+_start:
+	movl	incremental_server_test_value(%rip), %edi
+	movl	$60, %eax
+	syscall
+	.size	_start, .-_start
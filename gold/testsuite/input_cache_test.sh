@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# input_cache_test.sh -- test --input-cache.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The first link created input_cache_test.dir and filled it with an
+# entry for each of the --start-lib objects which defines global
+# symbols, which leaves out start_lib_test_3.o, and the second link
+# used those entries.  The two links must produce the same output.
+
+check()
+{
+  if ! grep -q "$2" "$1"
+  then
+    echo "Did not find expected output in $1:"
+    echo "   $2"
+    echo ""
+    echo "Actual output below:"
+    cat "$1"
+    exit 1
+  fi
+}
+
+entries=`wc -l < input_cache_test.entries`
+if test "$entries" -ne 1; then
+  echo "expected 1 entry in input_cache_test.dir, found $entries"
+  exit 1
+fi
+
+check input_cache_test_1.err "lib groups members found in input cache: 0$"
+check input_cache_test_2.err "lib groups members found in input cache: 1$"
+check input_cache_test_2.err "loaded lib groups members from input cache: 1$"
+
+if ! cmp -s input_cache_test_1 input_cache_test_2; then
+  echo "output using the input cache differs"
+  exit 1
+fi
+
+rm -rf input_cache_test.dir
+
+exit 0
@@ -0,0 +1,78 @@
+#!/bin/sh
+
+# merge_string_benchmark.sh -- time merging of SHF_MERGE string sections.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This is not run by "make check".  Run "make merge_string_benchmark"
+# to see how the merging of .debug_str style sections scales with the
+# number of threads.  We generate a number of objects whose string
+# sections share most of their strings, as the .debug_str sections
+# of a large C++ program do, link them with different thread counts,
+# and check that the output does not depend on the thread count.
+
+# Usage: merge_string_benchmark.sh LD AS [OBJECTS [STRINGS]]
+
+LD=$1
+AS=$2
+OBJECTS=${3:-16}
+STRINGS=${4:-200000}
+
+dir=merge_string_benchmark.dir
+rm -rf $dir
+mkdir $dir || exit 1
+
+i=0
+while test $i -lt $OBJECTS; do
+  awk -v obj=$i -v count=$STRINGS 'BEGIN {
+    if (obj == 0)
+      printf "\t.text\n\t.globl _start\n_start:\n\tret\n";
+    printf "\t.section .debug_str,\"MS\",@progbits,1\n";
+    for (j = 0; j < count; j++)
+      {
+        # Three quarters of the strings are common to all objects.
+        if (j % 4 == 0)
+          printf "\t.string \"local_%d_name_%d\"\n", obj, j;
+        else
+          printf "\t.string \"std::vector<type_%d>::shared_name_%d\"\n", j % 1000, j;
+      }
+  }' > $dir/s$i.s
+  $AS -o $dir/s$i.o $dir/s$i.s || exit 1
+  i=`expr $i + 1`
+done
+
+status=0
+for threads in 0 1 2 4 8; do
+  if test $threads -eq 0; then
+    opts="--no-threads"
+  else
+    opts="--threads --thread-count=$threads"
+  fi
+  start=`date +%s%N`
+  $LD $opts -o $dir/out$threads $dir/*.o || exit 1
+  end=`date +%s%N`
+  echo "$opts: `expr \( $end - $start \) / 1000000` ms"
+  if ! cmp -s $dir/out0 $dir/out$threads; then
+    echo "output with $opts differs from --no-threads output"
+    status=1
+  fi
+done
+
+exit $status
@@ -0,0 +1,51 @@
+#!/bin/sh
+
+# merge_threads_test.sh -- test merging strings in parallel
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the strings of SHF_MERGE sections are hashed and
+# deduplicated on several threads.  The output must be the same as
+# with --no-threads, and each string must appear only once.
+
+if ! cmp -s merge_threads_test_1 merge_threads_test_2
+then
+    echo "output differs with --threads"
+    diff merge_threads_test_1.stdout merge_threads_test_2.stdout
+    exit 1
+fi
+
+if ! cmp -s merge_threads_test_1.stdout merge_threads_test_2.stdout
+then
+    echo "section dumps differ with --threads"
+    diff merge_threads_test_1.stdout merge_threads_test_2.stdout
+    exit 1
+fi
+
+for s in "shared string one" "shared string two" "unsigned int" "char"; do
+    count=`grep -c "\] *$s\$" merge_threads_test_2.stdout`
+    if test "$count" != "1"; then
+	echo "found \"$s\" $count times, expected 1"
+	cat merge_threads_test_2.stdout
+	exit 1
+    fi
+done
+
+exit 0
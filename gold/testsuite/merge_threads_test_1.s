@@ -0,0 +1,49 @@
+# merge_threads_test_1.s: x86_64 test case for merging SHF_MERGE
+# string sections on several threads.
+
+# Some strings appear twice in this file and again in
+# merge_threads_test_2.s.  The data section refers to strings by
+# offset, so the mapping from input offsets to output offsets is
+# checked too.
+
+	.text
+	.globl	_start
+	.type	_start, @function
+_start:
+	ret
+	.size	_start, .-_start
+
+	.section	.rodata.str1.1,"aMS",@progbits,1
+.LC0:
+	.string	"shared string one"
+.LC1:
+	.string	"only in the first file"
+.LC2:
+	.string	"shared string two"
+	.string	"shared string one"
+.LC3:
+	.string	"string one"
+
+	.section	.rodata.str2.2,"aMS",@progbits,2
+	.align	2
+.LW0:
+	.short	'w', 'i', 'd', 'e', 0
+.LW1:
+	.short	'f', 'i', 'r', 's', 't', 0
+	.short	'w', 'i', 'd', 'e', 0
+
+	.section	.debug_str,"MS",@progbits,1
+	.string	"unsigned int"
+	.string	"first_file_name"
+	.string	"char"
+	.string	"unsigned int"
+
+	.data
+	.globl	first_strings
+first_strings:
+	.quad	.LC0
+	.quad	.LC1
+	.quad	.LC2
+	.quad	.LC3
+	.quad	.LW0
+	.quad	.LW1
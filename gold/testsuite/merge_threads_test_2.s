@@ -0,0 +1,31 @@
+# merge_threads_test_2.s: x86_64 test case for merging SHF_MERGE
+# string sections on several threads.
+
+	.section	.rodata.str1.1,"aMS",@progbits,1
+.LC0:
+	.string	"only in the second file"
+.LC1:
+	.string	"shared string two"
+.LC2:
+	.string	"shared string one"
+
+	.section	.rodata.str2.2,"aMS",@progbits,2
+	.align	2
+.LW0:
+	.short	's', 'e', 'c', 'o', 'n', 'd', 0
+.LW1:
+	.short	'w', 'i', 'd', 'e', 0
+
+	.section	.debug_str,"MS",@progbits,1
+	.string	"char"
+	.string	"second_file_name"
+	.string	"unsigned int"
+
+	.data
+	.globl	second_strings
+second_strings:
+	.quad	.LC0
+	.quad	.LC1
+	.quad	.LC2
+	.quad	.LW0
+	.quad	.LW1
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# plugin_test_10.sh -- a test case for the plugin statistics.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with plugin_test_10.err, the output of an -r link with
+# --stats that runs the claim-file hooks from several threads.  Check
+# that the claims were counted and the plugin times were reported.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check plugin_test_10.err "plugin input files claimed: 2 of 4"
+check plugin_test_10.err "plugin claim-file handlers: .* seconds waiting for other files"
+check plugin_test_10.err "plugin symbols added: [0-9]* in .* seconds"
+check plugin_test_10.err "plugin all-symbols-read handlers: .* seconds"
+
+exit 0
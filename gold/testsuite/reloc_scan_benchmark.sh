@@ -0,0 +1,96 @@
+#!/bin/sh
+
+# reloc_scan_benchmark.sh -- time scanning of relocations.
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This is not run by "make check".  Run "make reloc_scan_benchmark"
+# on x86_64 to see how the scanning of relocations scales with the
+# number of threads.  We generate a number of objects which look like
+# code compiled with -ffunction-sections: calls between functions in
+# the same object, references to read-only data and unwind info, all
+# through local symbols, plus calls and GOT references to functions
+# defined in other objects.  We link them with different thread
+# counts and check that the output, in particular the order of the
+# GOT entries, does not depend on the thread count.
+
+# Usage: reloc_scan_benchmark.sh LD AS [OBJECTS [FUNCTIONS]]
+
+LD=$1
+AS=$2
+OBJECTS=${3:-16}
+FUNCTIONS=${4:-20000}
+
+dir=reloc_scan_benchmark.dir
+rm -rf $dir
+mkdir $dir || exit 1
+
+i=0
+while test $i -lt $OBJECTS; do
+  awk -v obj=$i -v objects=$OBJECTS -v count=$FUNCTIONS 'BEGIN {
+    if (obj == 0)
+      printf "\t.text\n\t.globl _start\n_start:\n\tret\n";
+    next_obj = (obj + 1) % objects;
+    for (j = 0; j < count; j++)
+      {
+        printf "\t.section .text.f%d_%d,\"ax\",@progbits\n", obj, j;
+        printf "\t.globl f%d_%d\n", obj, j;
+        printf "f%d_%d:\n", obj, j;
+        printf "\t.cfi_startproc\n";
+        printf "\tleaq .LC%d(%%rip), %%rax\n", j;
+        if (j > 0)
+          printf "\tcall l%d_%d\n", obj, j - 1;
+        if (j % 8 == 0)
+          printf "\tcall f%d_%d\n", next_obj, j;
+        if (j % 64 == 0)
+          printf "\tmovq f%d_%d@GOTPCREL(%%rip), %%rax\n", next_obj, j;
+        printf "\tret\n";
+        printf "\t.cfi_endproc\n";
+        printf "\t.section .text.l%d_%d,\"ax\",@progbits\n", obj, j;
+        printf "l%d_%d:\n", obj, j;
+        printf "\tret\n";
+        printf "\t.section .rodata.str,\"aMS\",@progbits,1\n";
+        printf ".LC%d:\n\t.string \"f%d_%d\"\n", j, obj, j;
+        printf "\t.section .data.rel.local,\"aw\",@progbits\n";
+        printf "\t.quad l%d_%d\n", obj, j;
+      }
+  }' > $dir/r$i.s
+  $AS -o $dir/r$i.o $dir/r$i.s || exit 1
+  i=`expr $i + 1`
+done
+
+status=0
+for threads in 0 1 2 4 8; do
+  if test $threads -eq 0; then
+    opts="--no-threads"
+  else
+    opts="--threads --thread-count=$threads"
+  fi
+  start=`date +%s%N`
+  $LD $opts -o $dir/out$threads $dir/*.o || exit 1
+  end=`date +%s%N`
+  echo "$opts: `expr \( $end - $start \) / 1000000` ms"
+  if ! cmp -s $dir/out0 $dir/out$threads; then
+    echo "output with $opts differs from --no-threads output"
+    status=1
+  fi
+done
+
+exit $status
@@ -0,0 +1,42 @@
+#!/bin/sh
+
+# reloc_scan_threads_test.sh -- test scanning PIC relocs with threads
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+
+# With --threads the relocs against local symbols are prescanned on
+# several threads, and only the remaining relocs are scanned serially.
+# The GOT, PLT and dynamic relocations must come out exactly as with
+# --no-threads, both for a shared library and for a PIE.
+
+check()
+{
+    if ! cmp -s $1 $2
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check reloc_scan_threads_test_1.so reloc_scan_threads_test_2.so
+check reloc_scan_threads_test_1 reloc_scan_threads_test_2
+
+exit 0
@@ -0,0 +1,41 @@
+# reloc_scan_threads_test_1.s: x86_64 test case for scanning the
+# relocations of PIC code with and without threads.  The relocations
+# against local symbols which need no GOT entry or dynamic relocation
+# are dropped by the prescan; the others are scanned in order.
+
+	.text
+	.globl	reloc_scan_threads_f1
+	.type	reloc_scan_threads_f1, @function
+reloc_scan_threads_f1:
+	call	reloc_scan_threads_f2@PLT
+	movq	reloc_scan_threads_v2@GOTPCREL(%rip), %rax
+	movq	reloc_scan_threads_weak@GOTPCREL(%rip), %rax
+	movq	local_v1@GOTPCREL(%rip), %rax
+	leaq	local_v1(%rip), %rax
+	call	local_f1
+	ret
+	.size	reloc_scan_threads_f1, .-reloc_scan_threads_f1
+
+	.type	local_f1, @function
+local_f1:
+	movq	reloc_scan_threads_f1@GOTPCREL(%rip), %rax
+	ret
+	.size	local_f1, .-local_f1
+
+	.weak	reloc_scan_threads_weak
+
+	.data
+	.align	8
+	.type	local_v1, @object
+local_v1:
+	.quad	1
+	.size	local_v1, 8
+
+	.globl	reloc_scan_threads_v1
+	.type	reloc_scan_threads_v1, @object
+reloc_scan_threads_v1:
+	.quad	local_v1
+	.quad	local_f1
+	.quad	reloc_scan_threads_v2
+	.quad	reloc_scan_threads_f2
+	.size	reloc_scan_threads_v1, 32
@@ -0,0 +1,41 @@
+# reloc_scan_threads_test_2.s: x86_64 test case for scanning the
+# relocations of PIC code with and without threads.  The relocations
+# against local symbols which need no GOT entry or dynamic relocation
+# are dropped by the prescan; the others are scanned in order.
+
+	.text
+	.globl	reloc_scan_threads_f2
+	.type	reloc_scan_threads_f2, @function
+reloc_scan_threads_f2:
+	call	reloc_scan_threads_f1@PLT
+	movq	reloc_scan_threads_v1@GOTPCREL(%rip), %rax
+	movq	reloc_scan_threads_weak@GOTPCREL(%rip), %rax
+	movq	local_v2@GOTPCREL(%rip), %rax
+	leaq	local_v2(%rip), %rax
+	call	local_f2
+	ret
+	.size	reloc_scan_threads_f2, .-reloc_scan_threads_f2
+
+	.type	local_f2, @function
+local_f2:
+	movq	reloc_scan_threads_f2@GOTPCREL(%rip), %rax
+	ret
+	.size	local_f2, .-local_f2
+
+	.weak	reloc_scan_threads_weak
+
+	.data
+	.align	8
+	.type	local_v2, @object
+local_v2:
+	.quad	2
+	.size	local_v2, 8
+
+	.globl	reloc_scan_threads_v2
+	.type	reloc_scan_threads_v2, @object
+reloc_scan_threads_v2:
+	.quad	local_v2
+	.quad	local_f2
+	.quad	reloc_scan_threads_v1
+	.quad	reloc_scan_threads_f1
+	.size	reloc_scan_threads_v2, 32
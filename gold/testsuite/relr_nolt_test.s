@@ -0,0 +1,46 @@
+# relr_nolt_test.s: x86_64 test case for -z pack-relative-relocs
+# without a linker script.
+
+# The data holds pointers into SHF_MERGE string sections, which need
+# R_X86_64_RELATIVE relocs in a shared library.  The strings are
+# duplicated so that they are merged.  The pointers come in dense runs
+# separated by gaps, so that the packed encoding needs both addresses
+# and bitmaps, and the .relr.dyn section grows when the sections are
+# laid out again.
+
+	.section .rodata.str1.1,"aMS",@progbits,1
+.Lstr1:
+	.string	"first string"
+.Lstr2:
+	.string	"second string"
+.Lstr3:
+	.string	"first string"
+.Lstr4:
+	.string	"string"
+
+	.section .rodata.str1.8,"aMS",@progbits,1
+	.align	8
+.Lstr5:
+	.string	"aligned string"
+	.align	8
+.Lstr6:
+	.string	"aligned string"
+
+	.data
+	.align	8
+
+	.global	strings
+	.type	strings,@object
+strings:
+	.rept	12
+	.rept	70
+	.quad	.Lstr1
+	.quad	.Lstr2
+	.quad	.Lstr3
+	.quad	.Lstr4
+	.quad	.Lstr5
+	.quad	.Lstr6
+	.endr
+	.zero	4096
+	.endr
+	.size	strings,. - strings
@@ -0,0 +1,109 @@
+#!/bin/sh
+
+# relr_nolt_test.sh -- test -z pack-relative-relocs without a linker script
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# relr_test_1.so and relr_test_2.so are linked from the same object,
+
+# relr_nolt_test_1.so and relr_nolt_test_2.so are linked from the same
+# object, without and with -z pack-relative-relocs, and without a
+# linker script, so the sections are at different addresses in the two
+# links.  The data holds pointers into merged string sections.  We
+# check that the dynamic linker would relocate the same words, relative
+# to the start of .data, to the same strings, relative to the start of
+# .rodata, in both.
+
+check()
+{
+  if ! egrep "$1" "$2" >/dev/null 2>&1; then
+    echo 1>&2 "could not find '$1' in $2"
+    exit 1
+  fi
+}
+
+# Print the offset in .data and the offset in .rodata of the target of
+# each relocated word in the readelf output in $1, one per line.
+relocated_words()
+{
+  awk '
+    function hex(s,    i, n) {
+      n = 0
+      s = tolower(s)
+      sub(/^0x/, "", s)
+      for (i = 1; i <= length(s); i++)
+	n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+      return n
+    }
+    / \.data +PROGBITS / { sub(/.*PROGBITS +/, ""); data = hex($1); next }
+    / \.rodata +PROGBITS / { sub(/.*PROGBITS +/, ""); rodata = hex($1); next }
+    /^Relocation section/ { relr = ($0 ~ /\.relr\.dyn/); next }
+    relr && /^  [0-9]+ offsets$/ { next }
+    relr && /^[0-9a-f]+$/ { packed[npacked++] = $1; next }
+    /^$/ { relr = 0 }
+    $3 == "R_X86_64_RELATIVE" { print hex($1) - data, hex($4) - rodata; next }
+    /^  0x[0-9a-f]+ / {
+      addr = hex($1)
+      bytes = substr($0, 14, 35)
+      gsub(/ /, "", bytes)
+      for (i = 0; 2 * i < length(bytes); i++)
+	mem[addr + i] = substr(bytes, 2 * i + 1, 2)
+    }
+    END {
+      for (i = 0; i < npacked; i++) {
+	addr = hex(packed[i])
+	val = ""
+	for (j = 7; j >= 0; j--)
+	  val = val (((addr + j) in mem) ? mem[addr + j] : "??")
+	print addr - data, hex(val) - rodata
+      }
+    }' "$1" | sort -n
+}
+
+check "Relocation section '.relr.dyn'" relr_nolt_test_2.stdout
+
+relocated_words relr_nolt_test_1.stdout > relr_nolt_test_1.words
+relocated_words relr_nolt_test_2.stdout > relr_nolt_test_2.words
+
+count=`wc -l < relr_nolt_test_1.words`
+if test "$count" -ne 5040; then
+  echo 1>&2 "expected 5040 relative relocs in relr_nolt_test_1.so, found $count"
+  exit 1
+fi
+
+if ! cmp -s relr_nolt_test_1.words relr_nolt_test_2.words; then
+  echo 1>&2 "relr_nolt_test_1.so and relr_nolt_test_2.so relocate different words"
+  diff relr_nolt_test_1.words relr_nolt_test_2.words 1>&2
+  exit 1
+fi
+
+# The duplicate strings were merged.
+count=`awk '{ print $2 }' relr_nolt_test_2.words | sort -u | wc -l`
+if test "$count" -ne 4; then
+  echo 1>&2 "expected pointers to 4 strings in relr_nolt_test_2.so, found $count"
+  exit 1
+fi
+
+if grep R_X86_64_RELATIVE relr_nolt_test_2.stdout >/dev/null 2>&1; then
+  echo 1>&2 "unexpected unpacked relative reloc in relr_nolt_test_2.so"
+  exit 1
+fi
+
+exit 0
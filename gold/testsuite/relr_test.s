@@ -0,0 +1,66 @@
+# relr_test.s: x86_64 test case for -z pack-relative-relocs.
+
+# The data holds pointers which need R_X86_64_RELATIVE relocs in a
+# shared library, arranged to exercise the packed encoding: a dense
+# run which needs several bitmaps, sparse pointers which need new
+# addresses, a pointer which is not word aligned, and a pointer at
+# an odd address which can not be packed.  The GOT entries for local
+# and protected symbols also need R_X86_64_RELATIVE relocs.
+
+	.text
+
+	.global	fn1
+	.protected fn1
+	.type	fn1,@function
+fn1:
+	movq	local_var@GOTPCREL(%rip),%rax
+	movq	prot_var@GOTPCREL(%rip),%rax
+	retq
+	.size	fn1,. - fn1
+
+	.type	fn2,@function
+fn2:
+	retq
+	.size	fn2,. - fn2
+
+	.data
+	.align	8
+
+	.type	local_var,@object
+local_var:
+	.quad	1
+	.size	local_var,. - local_var
+
+	.global	prot_var
+	.protected prot_var
+	.type	prot_var,@object
+prot_var:
+	.quad	2
+	.size	prot_var,. - prot_var
+
+	.global	dense
+	.type	dense,@object
+dense:
+	.rept	150
+	.quad	fn2
+	.quad	local_var + 8
+	.endr
+	.size	dense,. - dense
+
+	.global	sparse
+	.type	sparse,@object
+sparse:
+	.rept	10
+	.quad	prot_var
+	.zero	1000
+	.endr
+	.size	sparse,. - sparse
+
+	.global	unaligned
+	.type	unaligned,@object
+unaligned:
+	.long	0
+	.quad	fn2
+	.byte	0
+	.quad	local_var
+	.size	unaligned,. - unaligned
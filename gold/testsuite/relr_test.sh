@@ -0,0 +1,106 @@
+#!/bin/sh
+
+# relr_test.sh -- test -z pack-relative-relocs for x86_64
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# relr_test_1.so and relr_test_2.so are linked from the same object,
+# without and with -z pack-relative-relocs, using a linker script which
+# puts the data at the same addresses.  We check that the dynamic
+# linker would relocate the same words to the same values in both.
+# For an R_X86_64_RELATIVE reloc the value is the addend; for a packed
+# reloc it is the link-time value stored in the word.
+
+check()
+{
+  if ! egrep "$1" "$2" >/dev/null 2>&1; then
+    echo 1>&2 "could not find '$1' in $2"
+    exit 1
+  fi
+}
+
+# Print the address and value of each relocated word in the readelf
+# output in $1, one per line.
+relocated_words()
+{
+  awk '
+    function hex(s,    i, n) {
+      n = 0
+      s = tolower(s)
+      sub(/^0x/, "", s)
+      for (i = 1; i <= length(s); i++)
+	n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+      return n
+    }
+    function strip(s) {
+      s = tolower(s)
+      sub(/^0x/, "", s)
+      sub(/^0+/, "", s)
+      return s == "" ? "0" : s
+    }
+    /^Relocation section/ { relr = ($0 ~ /\.relr\.dyn/); next }
+    relr && /^  [0-9]+ offsets$/ { next }
+    relr && /^[0-9a-f]+$/ { packed[npacked++] = $1; next }
+    /^$/ { relr = 0 }
+    $3 == "R_X86_64_RELATIVE" { print strip($1), strip($4); next }
+    /^  0x[0-9a-f]+ / {
+      addr = hex($1)
+      bytes = substr($0, 14, 35)
+      gsub(/ /, "", bytes)
+      for (i = 0; 2 * i < length(bytes); i++)
+	mem[addr + i] = substr(bytes, 2 * i + 1, 2)
+    }
+    END {
+      for (i = 0; i < npacked; i++) {
+	addr = hex(packed[i])
+	val = ""
+	for (j = 7; j >= 0; j--)
+	  val = val (((addr + j) in mem) ? mem[addr + j] : "??")
+	print strip(packed[i]), strip(val)
+      }
+    }' "$1" | sort
+}
+
+check "Relocation section '.relr.dyn'" relr_test_2.stdout
+
+relocated_words relr_test_1.stdout > relr_test_1.words
+relocated_words relr_test_2.stdout > relr_test_2.words
+
+# The dense and sparse pointers and the GOT entry for local_var.
+count=`wc -l < relr_test_1.words`
+if test "$count" -ne 313; then
+  echo 1>&2 "expected 313 relative relocs in relr_test_1.so, found $count"
+  exit 1
+fi
+
+if ! cmp -s relr_test_1.words relr_test_2.words; then
+  echo 1>&2 "relr_test_1.so and relr_test_2.so relocate different words"
+  diff relr_test_1.words relr_test_2.words 1>&2
+  exit 1
+fi
+
+# Only the pointer at an odd address should remain unpacked.
+count=`grep -c R_X86_64_RELATIVE relr_test_2.stdout`
+if test "$count" -ne 1; then
+  echo 1>&2 "expected 1 unpacked relative reloc in relr_test_2.so, found $count"
+  exit 1
+fi
+
+exit 0
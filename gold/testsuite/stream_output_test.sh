@@ -0,0 +1,37 @@
+#!/bin/sh
+
+# stream_output_test.sh -- test --stream-output
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# stream_output_test is linked with --stream-output and a small
+# buffer, so that the output is written in many pieces, and
+# stream_output_test_mmap is linked from the same objects without it.
+# Both are linked with --build-id.  The two files must be identical,
+# and stream_output_test must run.
+
+if ! cmp -s stream_output_test stream_output_test_mmap; then
+    echo "--stream-output changed the output file"
+    exit 1
+fi
+
+./stream_output_test || exit 1
+
+exit 0
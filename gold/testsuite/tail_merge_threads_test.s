@@ -0,0 +1,39 @@
+# tail_merge_threads_test.s: x86_64 test case for tail merging
+# SHF_MERGE string sections on several threads.
+
+# This file is assembled twice, with N set to 1 and 2.  Each string
+# "string K has a shared suffix" is a suffix of the string "object N
+# string K has a shared suffix" which precedes it, and appears in both
+# objects, so there are 72000 different strings in all.  That is
+# enough for the strings to be sorted for tail merging on several
+# threads.  The data section points to the shorter strings, so the
+# mapping from input offsets to output offsets is checked too.
+
+	.altmacro
+
+	.macro	strings n
+	.string	"object \n string \@ has a shared suffix"
+.Lstring_\@:
+	.string	"string \@ has a shared suffix"
+	.pushsection .data
+	.quad	.Lstring_\@
+	.popsection
+	.endm
+
+	.if	N == 1
+	.text
+	.globl	_start
+	.type	_start,@function
+_start:
+	retq
+	.size	_start,. - _start
+	.endif
+
+	.data
+	.align	8
+
+	.section .rodata.str1.1,"aMS",@progbits,1
+	.rept	24000
+	strings	%N
+	.endr
+	.string	"has a shared suffix"
@@ -0,0 +1,102 @@
+#!/bin/sh
+
+# tail_merge_threads_test.sh -- test tail merging strings with --threads
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the strings of SHF_MERGE sections are hashed and
+# With --threads the strings of a large SHF_MERGE section are sorted
+# for tail merging on several threads.  The output must be the same as
+# with --no-threads, every shorter string must be merged into the tail
+# of a longer one, and the data must point to the right strings.
+
+if ! cmp -s tail_merge_threads_test_1 tail_merge_threads_test_2
+then
+    echo "output differs with --threads"
+    diff tail_merge_threads_test_1.stdout tail_merge_threads_test_2.stdout
+    exit 1
+fi
+
+if ! cmp -s tail_merge_threads_test_1.stdout tail_merge_threads_test_2.stdout
+then
+    echo "section dumps differ with --threads"
+    diff tail_merge_threads_test_1.stdout tail_merge_threads_test_2.stdout
+    exit 1
+fi
+
+count=`grep -c "\]  object [12] string [0-9]* has a shared suffix\$" \
+	 tail_merge_threads_test_2.stdout`
+if test "$count" != "48000"
+then
+    echo "found $count long strings, expected 48000"
+    exit 1
+fi
+
+if grep "\]  \(string [0-9]* \)*has a shared suffix\$" \
+     tail_merge_threads_test_2.stdout > /dev/null
+then
+    echo "short strings were not tail merged"
+    exit 1
+fi
+
+# The first word of .data points to "string 0 has a shared suffix" in
+# tail_merge_threads_test_a.o.  Print the string it points into and
+# the offset within that string.
+target=`awk '
+  function hex(s,    i, n) {
+    n = 0
+    s = tolower(s)
+    sub(/^0x/, "", s)
+    for (i = 1; i <= length(s); i++)
+      n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    return n
+  }
+  / \.rodata +PROGBITS / { sub(/.*PROGBITS +/, ""); rodata = hex($1); next }
+  /^  \[ *[0-9a-f]+\]  / {
+    off = $0
+    sub(/^  \[ */, "", off)
+    sub(/\].*/, "", off)
+    str = $0
+    sub(/^  \[ *[0-9a-f]+\]  /, "", str)
+    strings[hex(off)] = str
+    next
+  }
+  /^  0x[0-9a-f]+ / && !seen {
+    seen = 1
+    w = $2 $3
+    val = ""
+    for (i = 15; i >= 1; i -= 2)
+      val = val substr(w, i, 2)
+    addr = hex(val) - rodata
+  }
+  END {
+    for (off in strings)
+      if (off + 0 <= addr && addr < off + length(strings[off]))
+	print addr - off, strings[off]
+  }' tail_merge_threads_test_2.stdout`
+case "$target" in
+"9 object "[12]" string 0 has a shared suffix") ;;
+*)
+    echo "first pointer in .data points to \"$target\""
+    exit 1
+    ;;
+esac
+
+exit 0
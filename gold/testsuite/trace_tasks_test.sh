@@ -0,0 +1,86 @@
+#!/bin/sh
+
+# trace_tasks_test.sh -- test --trace-tasks
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# trace_tasks_test_1.json was written by a link with --no-threads, and
+# trace_tasks_test_2.json by a link with four threads.  Each must be a
+# complete trace in the Chrome trace event format: a JSON object whose
+# traceEvents array holds one event per line.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_trace()
+{
+    first=`sed -n '1p' "$1"`
+    if test "$first" != '{"displayTimeUnit":"ms","traceEvents":['; then
+	echo "$1: bad first line: $first"
+	exit 1
+    fi
+    last=`sed -n '$p' "$1"`
+    if test "$last" != ']}'; then
+	echo "$1: bad last line: $last"
+	exit 1
+    fi
+
+    # Each line in between is a single object, and all but the last
+    # are followed by a comma.
+    lines=`wc -l < "$1"`
+    awk -v lines=$lines '
+      NR > 1 && NR < lines {
+	line = $0
+	if (NR < lines - 1 && sub(/,$/, "", line) != 1)
+	  bad = 1
+	if (line !~ /^{"name":.*}$/)
+	  bad = 1
+	if (gsub(/{/, "{", line) != gsub(/}/, "}", line))
+	  bad = 1
+	if (bad) {
+	  print FILENAME ":" NR ": bad event: " $0
+	  exit 1
+	}
+      }' "$1" || exit 1
+
+    check "$1" '{"name":"process_name","ph":"M","pid":1,'
+    check "$1" '{"name":"Task_function Close_task_runner","cat":"task","ph":"X"'
+
+    # Every thread which ran a task must be named.
+    tids=`grep '"ph":"X"' "$1" | sed -e 's/.*"tid":\([0-9]*\),.*/\1/' | sort -u`
+    for tid in $tids; do
+	check "$1" "\"tid\":$tid,\"args\":{\"name\":\"thread $tid\"}}"
+    done
+}
+
+check_trace trace_tasks_test_1.json
+check_trace trace_tasks_test_2.json
+
+exit 0
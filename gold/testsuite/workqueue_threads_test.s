@@ -0,0 +1,61 @@
+# workqueue_threads_test.s: x86_64 test case for running the link on
+# several workqueue threads.
+
+# This file is assembled eight times, with N set to 1 through 8, so
+# that there are enough input objects to keep eight threads busy
+# reading symbols, scanning relocs and relocating sections, and for
+# idle threads to take tasks from the others.  Each object has code
+# with unwind information, data which points to the code and to the
+# other objects, and merged strings.
+
+	.altmacro
+
+	.macro	define_object n
+	.section .text.func_\n,"ax",@progbits
+	.globl	func_\n
+	.type	func_\n,@function
+func_\n:
+	.cfi_startproc
+	pushq	%rbp
+	.cfi_def_cfa_offset 16
+	movq	%rsp, %rbp
+	leaq	table_\n(%rip), %rax
+	popq	%rbp
+	.cfi_def_cfa 7, 8
+	retq
+	.cfi_endproc
+	.size	func_\n,. - func_\n
+
+	.section .rodata.str1.1,"aMS",@progbits,1
+.Lname_\n:
+	.string	"object \n"
+.Lshared_\n:
+	.string	"shared by all objects"
+
+	.data
+	.align	8
+	.globl	table_\n
+	.type	table_\n,@object
+table_\n:
+	.quad	func_\n
+	.quad	.Lname_\n
+	.quad	.Lshared_\n
+	.irp	i, 1, 2, 3, 4, 5, 6, 7, 8
+	.quad	table_\i
+	.endr
+	.size	table_\n,. - table_\n
+	.endm
+
+	define_object %N
+
+	.if	N == 1
+	.text
+	.globl	_start
+	.type	_start,@function
+_start:
+	.irp	i, 1, 2, 3, 4, 5, 6, 7, 8
+	callq	func_\i
+	.endr
+	retq
+	.size	_start,. - _start
+	.endif
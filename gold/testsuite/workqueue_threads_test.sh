@@ -0,0 +1,54 @@
+#!/bin/sh
+
+# workqueue_threads_test.sh -- test a link on eight workqueue threads
+
+# Copyright 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads the strings of SHF_MERGE sections are hashed and
+# With --threads each workqueue thread has its own list of tasks, and
+# an idle thread takes tasks from the others.  Which thread runs which
+# task varies from one link to the next, but the output must be the
+# same as with --no-threads.
+
+if ! cmp -s workqueue_threads_test_1 workqueue_threads_test_2
+then
+    echo "output differs with --threads"
+    diff workqueue_threads_test_1.stdout workqueue_threads_test_2.stdout
+    exit 1
+fi
+
+if ! cmp -s workqueue_threads_test_1.stdout workqueue_threads_test_2.stdout
+then
+    echo "section dumps differ with --threads"
+    diff workqueue_threads_test_1.stdout workqueue_threads_test_2.stdout
+    exit 1
+fi
+
+# --stats reports the tasks run by each of the eight threads.
+count=`grep -c "thread [0-7]: tasks run: [0-9]*; steals: [0-9]*;" \
+	 workqueue_threads_test_2.err`
+if test "$count" != "8"
+then
+    echo "found statistics for $count threads, expected 8"
+    cat workqueue_threads_test_2.err
+    exit 1
+fi
+
+exit 0
@@ -22,6 +22,12 @@
 
 #include "gold.h"
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/time.h>
+
 #include "debug.h"
 #include "options.h"
 #include "timer.h"
@@ -114,6 +120,24 @@ class Workqueue_threader_single : public Workqueue_threader
   { return false; }
 };
 
+// Return the current time in microseconds, for --stats and
+// --trace-tasks.  We use a monotonic clock when there is one, so that
+// changes to the system time do not show up as idle time.
+
+static long long
+monotonic_time()
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+    return (static_cast<long long>(ts.tv_sec) * 1000000
+	    + ts.tv_nsec / 1000);
+#endif
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
 // Workqueue methods.
 
 Workqueue::Workqueue(const General_options& options)
@@ -123,18 +147,39 @@ Workqueue::Workqueue(const General_options& options)
     running_(0),
     waiting_(0),
     condvar_(this->lock_),
+    thread_states_(NULL),
+    thread_state_count_(0),
+    old_thread_states_(),
+    threaded_(false),
+    parallel_jobs_(),
+    collect_stats_(options.stats()),
+    trace_(options.user_set_trace_tasks()),
+    trace_origin_(0),
+    trace_events_(),
+    task_traces_(),
     threader_(NULL)
 {
+  if (this->trace_)
+    this->trace_origin_ = monotonic_time();
+
   bool threads = options.threads();
 #ifndef ENABLE_THREADS
   threads = false;
 #endif
+  this->threaded_ = threads;
+
+  {
+    Hold_lock hl(this->lock_);
+    this->add_thread_states(1);
+  }
+
   if (!threads)
     this->threader_ = new Workqueue_threader_single(this);
   else
     {
 #ifdef ENABLE_THREADS
       this->threader_ = new Workqueue_threader_threadpool(this);
+      set_parallel_job_runner(this);
 #else
       gold_unreachable();
 #endif
@@ -143,6 +188,105 @@ Workqueue::Workqueue(const General_options& options)
 
 Workqueue::~Workqueue()
 {
+  if (this->threaded_)
+    set_parallel_job_runner(NULL);
+  for (int i = 0; i < this->thread_state_count_; ++i)
+    delete this->thread_states_[i];
+  delete[] this->thread_states_;
+  for (size_t i = 0; i < this->old_thread_states_.size(); ++i)
+    delete[] this->old_thread_states_[i];
+}
+
+// Make sure that there is a Thread_state for each of the first COUNT
+// thread numbers.  The workqueue lock must be held when this is
+// called.
+
+void
+Workqueue::add_thread_states(int count)
+{
+  int old_count = this->thread_state_count_;
+  if (count <= old_count)
+    return;
+
+  Thread_state** states = new Thread_state*[count];
+  for (int i = 0; i < old_count; ++i)
+    states[i] = this->thread_states_[i];
+  for (int i = old_count; i < count; ++i)
+    states[i] = new Thread_state();
+
+  if (this->thread_states_ != NULL)
+    this->old_thread_states_.push_back(this->thread_states_);
+
+  // A thread looking for a task to steal reads the count before the
+  // array, so store the array first.  The old array stays valid, so a
+  // thread which sees the old count and the new array is fine.
+  this->thread_states_ = states;
+#ifdef ENABLE_THREADS
+  __sync_synchronize();
+#endif
+  this->thread_state_count_ = count;
+}
+
+// Return the scheduling state for THREAD_NUMBER.  This may be called
+// without holding the workqueue lock.
+
+Workqueue::Thread_state*
+Workqueue::thread_state(int thread_number) const
+{
+  gold_assert(thread_number >= 0
+	      && thread_number < this->thread_state_count_);
+  return this->thread_states_[thread_number];
+}
+
+// Return whether any task is queued to run, either on the shared
+// lists or on the list of some thread, or has been taken from the
+// list of some thread and not yet dealt with.  The workqueue lock
+// must be held when this is called.
+
+bool
+Workqueue::any_queued_tasks() const
+{
+  if (!this->first_tasks_.empty() || !this->tasks_.empty())
+    return true;
+  for (int i = 0; i < this->thread_state_count_; ++i)
+    {
+      Thread_state* ts = this->thread_states_[i];
+      Hold_lock hl(ts->lock);
+      if (!ts->tasks.empty() || ts->in_transit > 0)
+	return true;
+    }
+  return false;
+}
+
+// Return whether a task is queued on the shared lists or on the list
+// of the thread with state TS.  The workqueue lock must be held when
+// this is called.
+
+bool
+Workqueue::any_local_tasks(Thread_state* ts)
+{
+  if (!this->first_tasks_.empty() || !this->tasks_.empty())
+    return true;
+  Hold_lock hl(ts->lock);
+  return !ts->tasks.empty();
+}
+
+// Return whether a thread other than THREAD_NUMBER has a task queued
+// on its list.  The workqueue lock must be held when this is called.
+
+bool
+Workqueue::any_stealable_tasks(int thread_number)
+{
+  for (int i = 0; i < this->thread_state_count_; ++i)
+    {
+      if (i == thread_number)
+	continue;
+      Thread_state* ts = this->thread_states_[i];
+      Hold_lock hl(ts->lock);
+      if (!ts->tasks.empty())
+	return true;
+    }
+  return false;
 }
 
 // Add a task to the end of a specific queue, or put it on the list
@@ -153,15 +297,12 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 {
   Hold_lock hl(this->lock_);
 
+  if (this->trace_)
+    this->task_traces_[t].queued = monotonic_time();
+
   Task_token* token = t->is_runnable();
   if (token != NULL)
-    {
-      if (front)
-	token->add_waiting_front(t);
-      else
-	token->add_waiting(t);
-      ++this->waiting_;
-    }
+    this->add_waiting(token, t, front);
   else
     {
       if (front)
@@ -173,6 +314,42 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
     }
 }
 
+// Make T wait for TOKEN.  The workqueue lock must be held when this
+// is called.
+
+void
+Workqueue::add_waiting(Task_token* token, Task* t, bool front)
+{
+  if (front)
+    token->add_waiting_front(t);
+  else
+    token->add_waiting(t);
+  ++this->waiting_;
+
+  if (this->trace_)
+    this->task_traces_[t].blocked_since = monotonic_time();
+}
+
+// Note that T, which was waiting for a token, has been removed from
+// its list of waiting tasks.  The workqueue lock must be held when
+// this is called.
+
+void
+Workqueue::remove_waiting(Task* t)
+{
+  --this->waiting_;
+
+  if (this->trace_)
+    {
+      Task_trace& tt(this->task_traces_[t]);
+      if (tt.blocked_since >= 0)
+	{
+	  tt.blocked += monotonic_time() - tt.blocked_since;
+	  tt.blocked_since = -1;
+	}
+    }
+}
+
 // Add a task to the queue.
 
 void
@@ -222,40 +399,209 @@ Workqueue::find_runnable_in_list(Task_list* tasks)
       if (token == NULL)
 	return t;
 
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t, false);
     }
 
   // We couldn't find any runnable task.
   return NULL;
 }
 
-// Find a runnable task.  Return NULL if none could be found.  The
+// Find a runnable task for the thread with state TS.  Return NULL
+// if none could be found.  We look at the shared lists first, then at
+// the tasks released by this thread.  Tasks released by other threads
+// are taken by steal_task, without holding the workqueue lock.  The
 // workqueue lock must be held when this is called.
 
 Task*
-Workqueue::find_runnable()
+Workqueue::find_runnable(Thread_state* ts)
 {
   Task* t = this->find_runnable_in_list(&this->first_tasks_);
   if (t == NULL)
     t = this->find_runnable_in_list(&this->tasks_);
+  if (t == NULL)
+    {
+      Hold_lock hl(ts->lock);
+      t = this->find_runnable_in_list(&ts->tasks);
+    }
   return t;
 }
 
-// Find a runnable a task, and wait until we find one.  Return NULL if
-// we should exit.  The workqueue lock must be held when this is
-// called.
+// Take a task from the list of a thread other than THREAD_NUMBER,
+// starting with the next thread, so that the threads do not all steal
+// from the same list.  Set *VICTIM to the state of the thread we took
+// it from.  Return NULL if there is nothing to steal.  This is called
+// without holding the workqueue lock, so the task may no longer be
+// runnable; the caller must pass it to adopt_stolen_task.
 
 Task*
-Workqueue::find_runnable_or_wait(int thread_number)
+Workqueue::steal_task(int thread_number, Thread_state** victim)
 {
-  Task* t = this->find_runnable();
+  int count = this->thread_state_count_;
+#ifdef ENABLE_THREADS
+  __sync_synchronize();
+#endif
+  Thread_state** states = this->thread_states_;
+  for (int i = 1; i < count; ++i)
+    {
+      Thread_state* ts = states[(thread_number + i) % count];
+      Hold_lock hl(ts->lock);
+      Task* t = ts->tasks.pop_front();
+      if (t != NULL)
+	{
+	  ++ts->in_transit;
+	  *victim = ts;
+	  return t;
+	}
+    }
+  return NULL;
+}
+
+// Finish taking T from the thread with state VICTIM.  Return true if
+// T may be run now.  Otherwise make T wait for the token which blocks
+// it, and return false.  The workqueue lock must be held when this is
+// called.
+
+bool
+Workqueue::adopt_stolen_task(Task* t, Thread_state* victim)
+{
+  {
+    Hold_lock hl(victim->lock);
+    --victim->in_transit;
+  }
+
+  Task_token* token = t->is_runnable();
+  if (token == NULL)
+    return true;
+
+  this->add_waiting(token, t, false);
+
+  // A thread may be waiting to see whether all the work is done.
+  this->condvar_.broadcast();
+  return false;
+}
+
+// Offer the Parallel_job STATE to idle threads.  This is called by
+// run_in_parallel, which then runs pieces of the job itself.
+
+void
+Workqueue::offer_parallel_job(Parallel_job_state* state)
+{
+  Hold_lock hl(this->lock_);
+  this->parallel_jobs_.push_back(Parallel_job_entry(state));
+  this->condvar_.broadcast();
+}
+
+// Stop offering the Parallel_job STATE, and wait for the threads
+// helping with it to finish their pieces.  This is called by
+// run_in_parallel once it has found no more pieces to start.
 
-  while (t == NULL)
+void
+Workqueue::withdraw_parallel_job(Parallel_job_state* state)
+{
+  Hold_lock hl(this->lock_);
+  Parallel_job_entry* pje = this->find_parallel_job(state);
+  pje->exhausted = true;
+  while (pje->helpers > 0)
     {
-      if (this->running_ == 0
-	  && this->first_tasks_.empty()
-	  && this->tasks_.empty())
+      this->condvar_.wait();
+      // The vector may have changed while we were waiting.
+      pje = this->find_parallel_job(state);
+    }
+  this->parallel_jobs_.erase(this->parallel_jobs_.begin()
+			     + (pje - &this->parallel_jobs_[0]));
+}
+
+// Return the entry for the Parallel_job STATE.  The workqueue lock
+// must be held when this is called.
+
+Workqueue::Parallel_job_entry*
+Workqueue::find_parallel_job(Parallel_job_state* state)
+{
+  for (size_t i = 0; i < this->parallel_jobs_.size(); ++i)
+    if (this->parallel_jobs_[i].state == state)
+      return &this->parallel_jobs_[i];
+  gold_unreachable();
+}
+
+// Run pieces of a Parallel_job offered by a running task, if there
+// is one with pieces left to start.  Return false if there is none.
+// The workqueue lock must be held when this is called; it is
+// released while the pieces run.
+
+bool
+Workqueue::help_parallel_job(int thread_number)
+{
+  Parallel_job_state* state = NULL;
+  for (size_t i = 0; i < this->parallel_jobs_.size(); ++i)
+    {
+      Parallel_job_entry& pje(this->parallel_jobs_[i]);
+      if (!pje.exhausted)
+	{
+	  state = pje.state;
+	  ++pje.helpers;
+	  break;
+	}
+    }
+  if (state == NULL)
+    return false;
+
+  gold_debug(DEBUG_TASK, "%3d helping   parallel job", thread_number);
+
+  this->lock_.release();
+  run_parallel_job_pieces(state);
+  this->lock_.acquire();
+
+  // We only get here once every piece has been started, so there is
+  // no point in other threads trying to help.
+  Parallel_job_entry* pje = this->find_parallel_job(state);
+  pje->exhausted = true;
+  --pje->helpers;
+  if (pje->helpers == 0)
+    this->condvar_.broadcast();
+
+  return true;
+}
+
+// Find a runnable a task for THREAD_NUMBER, whose state is TS, and
+// wait until we find one.  Return NULL if we should exit.  The
+// workqueue lock must be held when this is called.  It is released
+// while we look for a task to steal.
+
+Task*
+Workqueue::find_runnable_or_wait(int thread_number, Thread_state* ts)
+{
+  while (true)
+    {
+      Task* t = this->find_runnable(ts);
+      if (t != NULL)
+	return t;
+
+      if (this->thread_state_count_ > 1)
+	{
+	  Thread_state* victim = NULL;
+	  this->lock_.release();
+	  t = this->steal_task(thread_number, &victim);
+	  this->lock_.acquire();
+	  if (t != NULL)
+	    {
+	      if (this->adopt_stolen_task(t, victim))
+		{
+		  ++ts->steals;
+		  gold_debug(DEBUG_TASK, "%3d stole     task %s",
+			     thread_number, t->name().c_str());
+		  return t;
+		}
+	      continue;
+	    }
+
+	  // Tasks may have been queued while we were not holding the
+	  // lock.  They were queued with the lock held, so if we see
+	  // none now we will not miss the signal for the next one.
+	  if (this->any_local_tasks(ts))
+	    continue;
+	}
+
+      if (this->running_ == 0 && !this->any_queued_tasks())
 	{
 	  // Kick all the threads to make them exit.
 	  this->condvar_.broadcast();
@@ -267,16 +613,35 @@ Workqueue::find_runnable_or_wait(int thread_number)
       if (this->should_cancel_thread(thread_number))
 	return NULL;
 
+      // If another thread queued a task while we were looking for
+      // one to steal, try again rather than waiting.
+      if (this->any_stealable_tasks(thread_number))
+	continue;
+
+      // Rather than sleeping, help a task which is running a
+      // Parallel_job.
+      if (this->help_parallel_job(thread_number))
+	continue;
+
       gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
+      long long start = 0;
+      if (this->collect_stats_ || this->trace_)
+	start = monotonic_time();
+
       this->condvar_.wait();
 
-      gold_debug(DEBUG_TASK, "%3d awake", thread_number);
+      if (this->collect_stats_ || this->trace_)
+	{
+	  long long end = monotonic_time();
+	  if (this->collect_stats_)
+	    ts->idle_time += end - start;
+	  if (this->trace_)
+	    this->add_trace_event(NULL, "", thread_number, start, end);
+	}
 
-      t = this->find_runnable();
+      gold_debug(DEBUG_TASK, "%3d awake", thread_number);
     }
-
-  return t;
 }
 
 // Find and run tasks.  If we can't find a runnable task, wait for one
@@ -288,6 +653,7 @@ Workqueue::find_runnable_or_wait(int thread_number)
 bool
 Workqueue::find_and_run_task(int thread_number)
 {
+  Thread_state* ts = this->thread_state(thread_number);
   Task* t;
   Task_locker tl;
 
@@ -295,7 +661,7 @@ Workqueue::find_and_run_task(int thread_number)
     Hold_lock hl(this->lock_);
 
     // Find a runnable task.
-    t = this->find_runnable_or_wait(thread_number);
+    t = this->find_runnable_or_wait(thread_number, ts);
 
     if (t == NULL)
       return false;
@@ -305,6 +671,7 @@ Workqueue::find_and_run_task(int thread_number)
     t->locks(&tl);
 
     ++this->running_;
+    ++ts->tasks_run;
   }
 
   while (t != NULL)
@@ -316,8 +683,18 @@ Workqueue::find_and_run_task(int thread_number)
       if (is_debugging_enabled(DEBUG_TASK))
         timer.start();
 
+      std::string name;
+      long long start = 0;
+      if (this->trace_)
+	{
+	  name = t->name();
+	  start = monotonic_time();
+	}
+
       t->run(this);
 
+      long long end = this->trace_ ? monotonic_time() : 0;
+
       if (is_debugging_enabled(DEBUG_TASK))
         {
           Timer::TimeStats elapsed = timer.get_elapsed_time();
@@ -337,12 +714,15 @@ Workqueue::find_and_run_task(int thread_number)
 
 	--this->running_;
 
+	if (this->trace_)
+	  this->add_trace_event(t, name, thread_number, start, end);
+
 	// Release the locks for the task.  This must be done with the
 	// workqueue lock held.  Get the next Task to run if any.
-	next = this->release_locks(t, &tl);
+	next = this->release_locks(t, &tl, ts);
 
 	if (next == NULL)
-	  next = this->find_runnable();
+	  next = this->find_runnable(ts);
 
 	// If we have another Task to run, get the Locks.  This must
 	// be called while we are still holding the Workqueue lock.
@@ -352,6 +732,7 @@ Workqueue::find_and_run_task(int thread_number)
 	    next->locks(&tl);
 
 	    ++this->running_;
+	    ++ts->tasks_run;
 	  }
       }
 
@@ -371,7 +752,8 @@ Workqueue::find_and_run_task(int thread_number)
 
 // 2) Otherwise, T is runnable.  If *PRET is not NULL, then we have
 // already decided which Task to run next.  Add T to the list of
-// runnable tasks, and signal another thread.
+// runnable tasks of the thread with state TS, and signal another
+// thread, which may steal it.
 
 // 3) Otherwise, *PRET is NULL.  If IS_BLOCKER is false, then T was
 // waiting on a write lock.  We can grab that lock now, so we run T
@@ -394,14 +776,14 @@ Workqueue::find_and_run_task(int thread_number)
 // Return true if we set *PRET to T, false otherwise.
 
 bool
-Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
+Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret,
+			   Thread_state* ts)
 {
   Task_token* token = t->is_runnable();
 
   if (token != NULL)
     {
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t, false);
       return false;
     }
 
@@ -414,7 +796,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     should_return = true;
   else if (t->should_run_soon())
     should_return = true;
-  else if (!this->first_tasks_.empty() || !this->tasks_.empty())
+  else if (this->any_local_tasks(ts))
     should_queue = true;
   else
     should_return = true;
@@ -430,7 +812,10 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
       if (t->should_run_soon())
 	this->first_tasks_.push_back(t);
       else
-	this->tasks_.push_back(t);
+	{
+	  Hold_lock hl(ts->lock);
+	  ts->tasks.push_back(t);
+	}
       this->condvar_.signal();
       return false;
     }
@@ -438,13 +823,14 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
   gold_unreachable();
 }
 
-// Release the locks associated with a Task.  Return the first
-// runnable Task that we find.  If we find more runnable tasks, add
-// them to the run queue and signal any other threads.  This must be
-// called with the Workqueue lock held.
+// Release the locks associated with a Task run by the thread with
+// state TS.  Return the first runnable Task that we find.  If we find
+// more runnable tasks, add them to the run queue of that thread and
+// signal any other threads.  This must be called with the Workqueue
+// lock held.
 
 Task*
-Workqueue::release_locks(Task* t, Task_locker* tl)
+Workqueue::release_locks(Task* t, Task_locker* tl, Thread_state* ts)
 {
   Task* ret = NULL;
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
@@ -459,8 +845,8 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      Task* t;
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
-		  --this->waiting_;
-		  this->return_or_queue(t, true, &ret);
+		  this->remove_waiting(t);
+		  this->return_or_queue(t, true, &ret, ts);
 		}
 	    }
 	}
@@ -476,8 +862,8 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	  Task* t;
 	  while ((t = token->remove_first_waiting()) != NULL)
 	    {
-	      --this->waiting_;
-	      if (this->return_or_queue(t, false, &ret))
+	      this->remove_waiting(t);
+	      if (this->return_or_queue(t, false, &ret, ts))
 		break;
 	    }
 	}
@@ -504,6 +890,10 @@ Workqueue::set_thread_count(int threads)
 {
   Hold_lock hl(this->lock_);
 
+  // The new threads must have their state before they start looking
+  // for tasks.
+  if (this->threaded_)
+    this->add_thread_states(threads);
   this->threader_->set_thread_count(threads);
   // Wake up all the threads, since something has changed.
   this->condvar_.broadcast();
@@ -518,4 +908,135 @@ Workqueue::add_blocker(Task_token* token)
   token->add_blocker();
 }
 
+// Print the number of tasks each thread ran, the number it stole from
+// other threads, and the time it spent waiting for work.
+
+void
+Workqueue::print_stats()
+{
+  Hold_lock hl(this->lock_);
+  for (int i = 0; i < this->thread_state_count_; ++i)
+    {
+      const Thread_state* ts = this->thread_states_[i];
+      // Skip threads which were never started.
+      if (ts->tasks_run == 0 && ts->idle_time == 0)
+	continue;
+      fprintf(stderr,
+	      _("%s: thread %d: tasks run: %u; steals: %u; "
+		"idle wall: %lld.%06lld\n"),
+	      program_name, i, ts->tasks_run, ts->steals,
+	      ts->idle_time / 1000000, ts->idle_time % 1000000);
+    }
+}
+
+// Record an event for --trace-tasks: T, named NAME, ran on
+// THREAD_NUMBER from START to END.  If T is NULL the thread was
+// waiting for a task to run.  The workqueue lock must be held when
+// this is called.
+
+void
+Workqueue::add_trace_event(const Task* t, const std::string& name,
+			   int thread_number, long long start, long long end)
+{
+  Trace_event ev;
+  ev.name = name;
+  ev.thread_number = thread_number;
+  ev.start = start - this->trace_origin_;
+  ev.end = end - this->trace_origin_;
+  ev.queued = 0;
+  ev.blocked = 0;
+  if (t != NULL)
+    {
+      Task_trace_map::iterator p = this->task_traces_.find(t);
+      if (p != this->task_traces_.end())
+	{
+	  if (p->second.queued != 0)
+	    ev.queued = start - p->second.queued;
+	  ev.blocked = p->second.blocked;
+	  this->task_traces_.erase(p);
+	}
+    }
+  this->trace_events_.push_back(ev);
+}
+
+// Write S to F as a JSON string.
+
+static void
+write_json_string(FILE* f, const std::string& s)
+{
+  putc('"', f);
+  for (std::string::const_iterator p = s.begin(); p != s.end(); ++p)
+    {
+      unsigned char c = *p;
+      if (c == '"' || c == '\\')
+	fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf(f, "\\u%04x", c);
+      else
+	putc(c, f);
+    }
+  putc('"', f);
+}
+
+// Write the events recorded for --trace-tasks to FILENAME, in the
+// Chrome trace event format, which may be viewed with
+// chrome://tracing or Perfetto.  Each task is a complete event on the
+// thread which ran it, with the time it spent queued and the part of
+// that time it spent waiting for a token as arguments.  The time each
+// thread spent waiting for a task to run is shown as an "idle" event.
+
+void
+Workqueue::write_trace(const char* filename)
+{
+  Hold_lock hl(this->lock_);
+
+  FILE* f = fopen(filename, "w");
+  if (f == NULL)
+    {
+      gold_error(_("cannot open trace file %s: %s"), filename,
+		 strerror(errno));
+      return;
+    }
+
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	  "\"args\":{\"name\":");
+  write_json_string(f, program_name);
+  fprintf(f, "}}");
+
+  for (int i = 0; i < this->thread_state_count_; ++i)
+    fprintf(f,
+	    ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+	    "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+	    i, i);
+
+  for (std::vector<Trace_event>::const_iterator p =
+	 this->trace_events_.begin();
+       p != this->trace_events_.end();
+       ++p)
+    {
+      fprintf(f, ",\n{\"name\":");
+      if (p->name.empty())
+	fprintf(f, "\"idle\",\"cat\":\"idle\"");
+      else
+	{
+	  write_json_string(f, p->name);
+	  fprintf(f, ",\"cat\":\"task\"");
+	}
+      fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+	      "\"ts\":%lld,\"dur\":%lld",
+	      p->thread_number, p->start, p->end - p->start);
+      if (!p->name.empty())
+	fprintf(f, ",\"args\":{\"queued_us\":%lld,\"blocked_us\":%lld}",
+		p->queued, p->blocked);
+      fprintf(f, "}");
+    }
+
+  fprintf(f, "\n]}\n");
+
+  if (fclose(f) != 0)
+    gold_error(_("cannot close trace file %s: %s"), filename,
+	       strerror(errno));
+}
+
 } // End namespace gold.
@@ -28,6 +28,7 @@
 #define GOLD_WORKQUEUE_H
 
 #include <string>
+#include <vector>
 
 #include "gold-threads.h"
 #include "token.h"
@@ -195,7 +196,7 @@ class Task_function : public Task
 
 class Workqueue_threader;
 
-class Workqueue
+class Workqueue : public Parallel_job_runner
 {
  public:
   Workqueue(const General_options&);
@@ -233,22 +234,163 @@ class Workqueue
   void
   add_blocker(Task_token*);
 
+  // Print per-thread statistics to stderr.
+  void
+  print_stats();
+
+  // Write the trace of the tasks run, for --trace-tasks.
+  void
+  write_trace(const char* filename);
+
+  // Let idle threads help run a Parallel_job.  These are called by
+  // run_in_parallel.
+  void
+  offer_parallel_job(Parallel_job_state*);
+
+  void
+  withdraw_parallel_job(Parallel_job_state*);
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
   Workqueue& operator=(const Workqueue&);
 
+  // The scheduling state kept for each thread which processes tasks.
+  struct Thread_state
+  {
+    Thread_state()
+      : lock(), tasks(), in_transit(0), tasks_run(0), steals(0), idle_time(0)
+    { }
+
+    // Controls access to TASKS and IN_TRANSIT.  This may be acquired
+    // while holding the Workqueue lock, but the Workqueue lock may
+    // not be acquired while holding this one.
+    Lock lock;
+    // Runnable tasks released by the tasks run on this thread.  Other
+    // threads steal from this list when they have nothing else to do.
+    Task_list tasks;
+    // The number of tasks which other threads have taken from TASKS,
+    // but have not yet started or made to wait for a token.
+    int in_transit;
+    // The remaining fields are only changed by the thread itself.
+    // The number of tasks run on this thread.
+    unsigned int tasks_run;
+    // The number of tasks this thread took from another thread's list.
+    unsigned int steals;
+    // The time this thread spent waiting for a task, in microseconds.
+    long long idle_time;
+  };
+
+  // An event recorded for --trace-tasks.  Times are in microseconds
+  // since the Workqueue was created.
+  struct Trace_event
+  {
+    // The name of the task, or empty for time spent waiting for a
+    // task to run.
+    std::string name;
+    // The thread which ran the task.
+    int thread_number;
+    // When the task started and finished.
+    long long start;
+    long long end;
+    // The time from when the task was queued until it started.
+    long long queued;
+    // The part of that time spent waiting for a token.
+    long long blocked;
+  };
+
+  // The times recorded for a task which has been queued but has not
+  // yet run, for --trace-tasks.
+  struct Task_trace
+  {
+    Task_trace()
+      : queued(0), blocked_since(-1), blocked(0)
+    { }
+
+    long long queued;
+    long long blocked_since;
+    long long blocked;
+  };
+
+  typedef Unordered_map<const Task*, Task_trace> Task_trace_map;
+
+  // A Parallel_job which idle threads may help run.
+  struct Parallel_job_entry
+  {
+    Parallel_job_entry(Parallel_job_state* s)
+      : state(s), helpers(0), exhausted(false)
+    { }
+
+    // The job.
+    Parallel_job_state* state;
+    // The number of threads running pieces of the job for us.
+    int helpers;
+    // Whether all the pieces of the job have been started.
+    bool exhausted;
+  };
+
+  // Make sure that there is a Thread_state for COUNT threads.
+  void
+  add_thread_states(int count);
+
+  // Return the state for THREAD_NUMBER.
+  Thread_state*
+  thread_state(int thread_number) const;
+
+  // Return whether any task is queued to run.
+  bool
+  any_queued_tasks() const;
+
+  // Return whether any task is queued where THREAD_STATE would find
+  // it without stealing.
+  bool
+  any_local_tasks(Thread_state* thread_state);
+
+  // Return whether another thread has a task which could be stolen.
+  bool
+  any_stealable_tasks(int thread_number);
+
+  // Take a task queued by another thread.
+  Task*
+  steal_task(int thread_number, Thread_state** victim);
+
+  // Check whether a stolen task may run.
+  bool
+  adopt_stolen_task(Task* t, Thread_state* victim);
+
   // Add a task to a queue.
   void
   add_to_queue(Task_list* queue, Task* t, bool front);
 
+  // Make a task wait for a token.
+  void
+  add_waiting(Task_token* token, Task* t, bool front);
+
+  // Note that a task is no longer waiting for a token.
+  void
+  remove_waiting(Task* t);
+
+  // Record an event for --trace-tasks.
+  void
+  add_trace_event(const Task* t, const std::string& name, int thread_number,
+		  long long start, long long end);
+
+  // Return the entry for the Parallel_job STATE.
+  Parallel_job_entry*
+  find_parallel_job(Parallel_job_state* state);
+
+  // Help run an offered Parallel_job.  Return false if there is
+  // none to help with.
+  bool
+  help_parallel_job(int thread_number);
+
   // Find a runnable task, or wait for one.
   Task*
-  find_runnable_or_wait(int thread_number);
+  find_runnable_or_wait(int thread_number, Thread_state*);
 
   // Find a runnable task.
   Task*
-  find_runnable();
+  find_runnable(Thread_state*);
 
   // Find a runnable task in a list.
   Task*
@@ -260,11 +402,11 @@ class Workqueue
 
   // Release the locks for a Task.  Return the next Task to run.
   Task*
-  release_locks(Task*, Task_locker*);
+  release_locks(Task*, Task_locker*, Thread_state*);
 
   // Store T into *PRET, or queue it as appropriate.
   bool
-  return_or_queue(Task* t, bool is_blocker, Task** pret);
+  return_or_queue(Task* t, bool is_blocker, Task** pret, Thread_state*);
 
   // Return whether to cancel this thread.
   bool
@@ -284,6 +426,31 @@ class Workqueue
   // Condition variable associated with lock_.  This is signalled when
   // there may be a new Task to execute.
   Condvar condvar_;
+  // The scheduling state of each thread, indexed by thread number.
+  // Threads look through this array for tasks to steal without
+  // holding lock_, so when threads are added we replace it with a
+  // larger copy rather than changing it; the old copies are kept in
+  // old_thread_states_ until the Workqueue is destroyed.  The array
+  // is replaced, and thread_state_count_ increased, with lock_ held.
+  Thread_state** thread_states_;
+  // The number of entries in thread_states_.
+  int thread_state_count_;
+  // Earlier versions of thread_states_.
+  std::vector<Thread_state**> old_thread_states_;
+  // Whether we are using threads.
+  bool threaded_;
+  // The Parallel_jobs which idle threads may help run.
+  std::vector<Parallel_job_entry> parallel_jobs_;
+  // Whether to collect the idle time of each thread, for --stats.
+  bool collect_stats_;
+  // Whether to record the events for --trace-tasks.
+  bool trace_;
+  // The time at which we started recording events.
+  long long trace_origin_;
+  // The events recorded for --trace-tasks.
+  std::vector<Trace_event> trace_events_;
+  // The times recorded for tasks which have not yet run.
+  Task_trace_map task_traces_;
 
   // The threading implementation.  This is set at construction time
   // and not changed thereafter.
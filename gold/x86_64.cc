@@ -390,12 +390,14 @@ class Target_x86_64 : public Sized_target<size, false>
   // In the x86_64 ABI (p 68), it says "The AMD64 ABI architectures
   // uses only Elf64_Rela relocation entries with explicit addends."
   typedef Output_data_reloc<elfcpp::SHT_RELA, true, size, false> Reloc_section;
+  typedef Output_data_relr<size, false> Relr_section;
 
   Target_x86_64(const Target::Target_info* info = &x86_64_info)
     : Sized_target<size, false>(info),
       got_(NULL), plt_(NULL), got_plt_(NULL), got_irelative_(NULL),
       got_tlsdesc_(NULL), global_offset_table_(NULL), rela_dyn_(NULL),
-      rela_irelative_(NULL), copy_relocs_(elfcpp::R_X86_64_COPY),
+      rela_irelative_(NULL), relr_dyn_(NULL),
+      copy_relocs_(elfcpp::R_X86_64_COPY),
       got_mod_index_offset_(-1U), tlsdesc_reloc_info_(),
       tls_base_symbol_defined_(false)
   { }
@@ -418,6 +420,16 @@ class Target_x86_64 : public Sized_target<size, false>
 		    size_t local_symbol_count,
 		    const unsigned char* plocal_symbols);
 
+  // Drop the relocations which scan_relocs would ignore.
+  bool
+  prescan_relocs(Sized_relobj_file<size, false>* object,
+		 unsigned int sh_type,
+		 const unsigned char* prelocs,
+		 size_t reloc_count,
+		 size_t local_symbol_count,
+		 const unsigned char* plocal_symbols,
+		 std::vector<unsigned char>* deferred);
+
   // Scan the relocations to look for symbol adjustments.
   void
   scan_relocs(Symbol_table* symtab,
@@ -436,6 +448,22 @@ class Target_x86_64 : public Sized_target<size, false>
   void
   do_finalize_sections(Layout*, const Input_objects*, Symbol_table*);
 
+  // We lay out the sections again if the size of the packed relative
+  // relocs changes.  This must not depend on whether the .relr.dyn
+  // section has been created yet: the input sections are laid out
+  // before the relocs are scanned, and merge sections only keep their
+  // input sections for relaxation if this is already true then.
+  bool
+  do_may_relax() const
+  {
+    return ((size == 64 && parameters->options().pack_relative_relocs())
+	    || Target::do_may_relax());
+  }
+
+  bool
+  do_relax(int, const Input_objects*, Symbol_table*, Layout*, const Task*)
+  { return this->relr_dyn_ != NULL && this->relr_dyn_->update_packed_size(); }
+
   // Return the value to use for a dynamic which requires special
   // treatment.
   uint64_t
@@ -670,6 +698,10 @@ class Target_x86_64 : public Sized_target<size, false>
     static inline int
     get_reference_flags(unsigned int r_type);
 
+    static inline bool
+    local_reloc_needs_scan(unsigned int r_type,
+			   const elfcpp::Sym<size, false>& lsym);
+
     inline void
     local(Symbol_table* symtab, Layout* layout, Target_x86_64* target,
 	  Sized_relobj_file<size, false>* object,
@@ -910,6 +942,27 @@ class Target_x86_64 : public Sized_target<size, false>
   Reloc_section*
   rela_irelative_section(Layout*);
 
+  // Get the section to use for packed relative relocations, creating
+  // it if necessary.
+  Relr_section*
+  relr_dyn_section(Layout*);
+
+  // Return whether a relative reloc for the word at OFFSET in section
+  // SHNDX of OBJECT may be packed into the .relr.dyn section.  If
+  // OBJECT is NULL, the word is in a section we create, such as the
+  // GOT.
+  bool
+  may_pack_relative_reloc(Sized_relobj_file<size, false>* object,
+			  unsigned int shndx, uint64_t offset) const
+  {
+    // We only pack relocs for 64-bit words.  Under x32 the
+    // R_X86_64_RELATIVE64 relocs for 64-bit words can not be packed.
+    if (size != 64 || !parameters->options().pack_relative_relocs())
+      return false;
+    return (object == NULL
+	    || (offset % 2 == 0 && object->section_addralign(shndx) >= 2));
+  }
+
   // Add a potential copy relocation.
   void
   copy_reloc(Symbol_table* symtab, Layout* layout,
@@ -970,6 +1023,8 @@ class Target_x86_64 : public Sized_target<size, false>
   Reloc_section* rela_dyn_;
   // The section to use for IRELATIVE relocs.
   Reloc_section* rela_irelative_;
+  // The section for packed relative relocs, for -z pack-relative-relocs.
+  Relr_section* relr_dyn_;
   // Relocs saved to avoid a COPY reloc.
   Copy_relocs<elfcpp::SHT_RELA, size, false> copy_relocs_;
   // Offset of the GOT entry for the TLS module index.
@@ -1140,6 +1195,24 @@ Target_x86_64<size>::rela_dyn_section(Layout* layout)
   return this->rela_dyn_;
 }
 
+// Get the section to use for packed relative relocs, creating it if
+// necessary.  This goes next to .rela.dyn.
+
+template<int size>
+typename Target_x86_64<size>::Relr_section*
+Target_x86_64<size>::relr_dyn_section(Layout* layout)
+{
+  if (this->relr_dyn_ == NULL)
+    {
+      gold_assert(layout != NULL);
+      this->relr_dyn_ = new Relr_section();
+      layout->add_output_section_data(".relr.dyn", elfcpp::SHT_RELR,
+				      elfcpp::SHF_ALLOC, this->relr_dyn_,
+				      ORDER_DYNAMIC_RELOCS, false);
+    }
+  return this->relr_dyn_;
+}
+
 // Get the section to use for IRELATIVE relocs, creating it if
 // necessary.  These go in .rela.dyn, but only after all other dynamic
 // relocations.  They need to follow the other dynamic relocations so
@@ -1747,6 +1820,8 @@ template<int size>
 unsigned int
 Target_x86_64<size>::first_plt_entry_offset() const
 {
+  if (this->plt_ == NULL)
+    return 0;
   return this->plt_->first_plt_entry_offset();
 }
 
@@ -1756,6 +1831,8 @@ template<int size>
 unsigned int
 Target_x86_64<size>::plt_entry_size() const
 {
+  if (this->plt_ == NULL)
+    return 0;
   return this->plt_->get_plt_entry_size();
 }
 
@@ -2283,6 +2360,51 @@ Target_x86_64<size>::Scan::reloc_needs_plt_for_ifunc(
 
 // Scan a relocation for a local symbol.
 
+// Return whether local would do anything for a relocation of type
+// R_TYPE against the local symbol LSYM, other than report an error.
+// This must only look at its arguments, since it is called while
+// other objects are being scanned.
+
+template<int size>
+inline bool
+Target_x86_64<size>::Scan::local_reloc_needs_scan(
+    unsigned int r_type,
+    const elfcpp::Sym<size, false>& lsym)
+{
+  // A local STT_GNU_IFUNC symbol may require a PLT entry.
+  if (lsym.get_st_type() == elfcpp::STT_GNU_IFUNC)
+    return true;
+
+  switch (r_type)
+    {
+    case elfcpp::R_X86_64_NONE:
+    case elfcpp::R_X86_64_GNU_VTINHERIT:
+    case elfcpp::R_X86_64_GNU_VTENTRY:
+    case elfcpp::R_X86_64_PC64:
+    case elfcpp::R_X86_64_PC32:
+    case elfcpp::R_X86_64_PC32_BND:
+    case elfcpp::R_X86_64_PC16:
+    case elfcpp::R_X86_64_PC8:
+    case elfcpp::R_X86_64_PLT32:
+    case elfcpp::R_X86_64_PLT32_BND:
+    case elfcpp::R_X86_64_DTPOFF32:
+    case elfcpp::R_X86_64_DTPOFF64:
+    case elfcpp::R_X86_64_TLSDESC_CALL:
+      return false;
+
+    case elfcpp::R_X86_64_64:
+    case elfcpp::R_X86_64_32:
+    case elfcpp::R_X86_64_32S:
+    case elfcpp::R_X86_64_16:
+    case elfcpp::R_X86_64_8:
+      // These only need a dynamic relocation.
+      return parameters->options().output_is_position_independent();
+
+    default:
+      return true;
+    }
+}
+
 template<int size>
 inline void
 Target_x86_64<size>::Scan::local(Symbol_table* symtab,
@@ -2324,6 +2446,15 @@ Target_x86_64<size>::Scan::local(Symbol_table* symtab,
       if (parameters->options().output_is_position_independent())
 	{
 	  unsigned int r_sym = elfcpp::elf_r_sym<size>(reloc.get_r_info());
+	  if (!is_ifunc
+	      && target->may_pack_relative_reloc(object, data_shndx,
+						 reloc.get_r_offset()))
+	    {
+	      Relr_section* relr_dyn = target->relr_dyn_section(layout);
+	      relr_dyn->add_relative(output_section, object, data_shndx,
+				     reloc.get_r_offset());
+	      break;
+	    }
 	  Reloc_section* rela_dyn = target->rela_dyn_section(layout);
 	  rela_dyn->add_local_relative(object, r_sym,
 				       (size == 32
@@ -2438,9 +2569,15 @@ Target_x86_64<size>::Scan::local(Symbol_table* symtab,
 		  {
 		    unsigned int got_offset =
 		      object->local_got_offset(r_sym, GOT_TYPE_STANDARD);
-		    rela_dyn->add_local_relative(object, r_sym,
-						 elfcpp::R_X86_64_RELATIVE,
-						 got, got_offset, 0, is_ifunc);
+		    if (!is_ifunc
+			&& target->may_pack_relative_reloc(NULL, 0, got_offset))
+		      target->relr_dyn_section(layout)->add_relative(got,
+								     got_offset);
+		    else
+		      rela_dyn->add_local_relative(object, r_sym,
+						   elfcpp::R_X86_64_RELATIVE,
+						   got, got_offset, 0,
+						   is_ifunc);
 		  }
 		else
 		  {
@@ -2765,12 +2902,24 @@ Target_x86_64<size>::Scan::global(Symbol_table* symtab,
 		      || (size == 32 && r_type == elfcpp::R_X86_64_32))
 		     && gsym->can_use_relative_reloc(false))
 	      {
-		Reloc_section* rela_dyn = target->rela_dyn_section(layout);
-		rela_dyn->add_global_relative(gsym, elfcpp::R_X86_64_RELATIVE,
-					      output_section, object,
-					      data_shndx,
-					      reloc.get_r_offset(),
-					      reloc.get_r_addend(), false);
+		if (gsym->type() != elfcpp::STT_GNU_IFUNC
+		    && target->may_pack_relative_reloc(object, data_shndx,
+						       reloc.get_r_offset()))
+		  {
+		    Relr_section* relr_dyn = target->relr_dyn_section(layout);
+		    relr_dyn->add_relative(output_section, object, data_shndx,
+					   reloc.get_r_offset());
+		  }
+		else
+		  {
+		    Reloc_section* rela_dyn = target->rela_dyn_section(layout);
+		    rela_dyn->add_global_relative(gsym,
+						  elfcpp::R_X86_64_RELATIVE,
+						  output_section, object,
+						  data_shndx,
+						  reloc.get_r_offset(),
+						  reloc.get_r_addend(), false);
+		  }
 	      }
 	    else
 	      {
@@ -2876,9 +3025,14 @@ Target_x86_64<size>::Scan::global(Symbol_table* symtab,
 		if (is_new)
 		  {
 		    unsigned int got_off = gsym->got_offset(GOT_TYPE_STANDARD);
-		    rela_dyn->add_global_relative(gsym,
-						  elfcpp::R_X86_64_RELATIVE,
-						  got, got_off, 0, false);
+		    if (gsym->type() != elfcpp::STT_GNU_IFUNC
+			&& target->may_pack_relative_reloc(NULL, 0, got_off))
+		      target->relr_dyn_section(layout)->add_relative(got,
+								     got_off);
+		    else
+		      rela_dyn->add_global_relative(gsym,
+						    elfcpp::R_X86_64_RELATIVE,
+						    got, got_off, 0, false);
 		  }
 	      }
 	  }
@@ -3093,6 +3247,32 @@ Target_x86_64<size>::gc_process_relocs(Symbol_table* symtab,
     plocal_symbols);
 
 }
+// Prescan relocations for a section.
+
+template<int size>
+bool
+Target_x86_64<size>::prescan_relocs(Sized_relobj_file<size, false>*,
+				    unsigned int sh_type,
+				    const unsigned char* prelocs,
+				    size_t reloc_count,
+				    size_t local_symbol_count,
+				    const unsigned char* plocal_symbols,
+				    std::vector<unsigned char>* deferred)
+{
+  // Leave it to scan_relocs to report the error.
+  if (sh_type == elfcpp::SHT_REL)
+    return false;
+
+  gold::prescan_relocs<size, false, elfcpp::SHT_RELA,
+      typename Target_x86_64<size>::Scan>(
+    prelocs,
+    reloc_count,
+    local_symbol_count,
+    plocal_symbols,
+    deferred);
+  return true;
+}
+
 // Scan relocations for a section.
 
 template<int size>
@@ -3150,6 +3330,14 @@ Target_x86_64<size>::do_finalize_sections(
   Output_data_dynamic* const odyn = layout->dynamic_data();
   if (odyn != NULL)
     {
+      if (this->relr_dyn_ != NULL)
+	{
+	  Output_section* os = this->relr_dyn_->output_section();
+	  odyn->add_section_address(elfcpp::DT_RELR, os);
+	  odyn->add_section_size(elfcpp::DT_RELRSZ, os);
+	  odyn->add_constant(elfcpp::DT_RELRENT, Relr_section::word_size);
+	}
+
       if (this->plt_ != NULL
 	  && this->plt_->output_section() != NULL
 	  && this->plt_->has_tlsdesc_entry())